@@ -101,6 +101,15 @@ typedef size_t(*OnGraphicsRenderDraw)(
 	GraphicsPipeline graphicsPipeline,
 	const Mat4F* model,
 	const Mat4F* viewProj);
+/*
+ * Graphics renderer flush function.
+ * Draws renders deferred by the draw function.
+ * Returns rendered index count.
+ *
+ * graphicsPipeline - graphics pipeline instance.
+ */
+typedef size_t(*OnGraphicsRendererFlush)(
+	GraphicsPipeline graphicsPipeline);
 /*
  * Graphics renderer enumeration function.
  *
@@ -117,8 +126,10 @@ typedef void(*OnGraphicsRendererItem)(
  * pipeline - graphics pipeline instance.
  * sorting - graphics render sorting type.
  * useCulling - use frustum culling.
- * onDestroy - on graphics render destroy function.
+ * onDestroy - on graphics render destroy function or NULL.
  * onDraw - on graphics render draw function.
+ * onFlush - on graphics renderer flush function or NULL.
+ * handleSize - inline render handle size or 0.
  * capacity - initial render array capacity .
  * threadPool - thread pool instance or NULL.
  */
@@ -128,6 +139,8 @@ GraphicsRenderer createGraphicsRenderer(
 	bool useCulling,
 	OnGraphicsRenderDestroy onDestroy,
 	OnGraphicsRenderDraw onDraw,
+	OnGraphicsRendererFlush onFlush,
+	size_t handleSize,
 	size_t capacity,
 	ThreadPool threadPool);
 /*
@@ -151,6 +164,11 @@ OnGraphicsRenderDestroy getGraphicsRendererOnDestroy(GraphicsRenderer renderer);
  * renderer - graphics renderer instance.
  */
 OnGraphicsRenderDraw getGraphicsRendererOnDraw(GraphicsRenderer renderer);
+/*
+ * Returns graphics renderer on flush function.
+ * renderer - graphics renderer instance.
+ */
+OnGraphicsRendererFlush getGraphicsRendererOnFlush(GraphicsRenderer renderer);
 /*
  * Returns graphics renderer thread pool instance.
  * renderer - graphics renderer instance.
@@ -218,15 +236,30 @@ void destroyAllGraphicsRendererItems(
 GraphicsRendererResult drawGraphicsRenderer(
 	GraphicsRenderer renderer,
 	const GraphicsRendererData* data);
+/*
+ * Draws several graphics renderers renders in the merged order.
+ * Renders are drawn in the order shared by all renderers, and
+ * pipelines are bound only when the pipeline changes.
+ * (Renderers should use the same sorting, up to 8 renderers)
+ *
+ * renderers - graphics renderer array.
+ * rendererCount - renderer array size.
+ * data - graphics renderer data.
+ */
+GraphicsRendererResult drawGraphicsRenderers(
+	GraphicsRenderer* renderers,
+	size_t rendererCount,
+	const GraphicsRendererData* data);
 
 /*
  * Create a new graphics render instance.
+ * Inline handle is zero initialized and freed with the render.
  * Returns graphics render instance on success, otherwise NULL.
  *
  * renderer - graphics renderer instance.
  * transform - transform instance.
  * bounds - graphics render bounds.
- * handle - graphics render handle.
+ * handle - graphics render handle or NULL. (inline handle)
  */
 GraphicsRender createGraphicsRender(
 	GraphicsRenderer renderer,
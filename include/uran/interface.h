@@ -86,6 +86,54 @@ static const InterfaceElementEvents emptyInterfaceElementEvents = {
 	NULL, NULL, NULL, NULL, NULL, NULL, NULL,
 };
 
+/*
+ * Interface layout types.
+ */
+typedef enum InterfaceLayoutType_T
+{
+	NO_INTERFACE_LAYOUT_TYPE = 0,
+	HORIZONTAL_INTERFACE_LAYOUT_TYPE = 1,
+	VERTICAL_INTERFACE_LAYOUT_TYPE = 2,
+	GRID_INTERFACE_LAYOUT_TYPE = 3,
+	INTERFACE_LAYOUT_TYPE_COUNT = 4,
+} InterfaceLayoutType_T;
+/*
+ * Interface layout type.
+ */
+typedef uint8_t InterfaceLayoutType;
+
+/*
+ * Interface layout structure.
+ *
+ * Layout container arranges elements whose transform
+ * parent is the container transform. Horizontal layout
+ * places them from left to right, vertical from top to
+ * bottom, and grid by rows of columnCount cells.
+ * Element alignment is used inside the row or cell.
+ *
+ * padding - inner padding. (left, bottom, right, top)
+ * spacing - space between the elements.
+ * columnCount - grid layout column count.
+ * isFitting - container is resized to fit the elements.
+ * isStretched - container fills its parent or the window.
+ */
+typedef struct InterfaceLayout
+{
+	InterfaceLayoutType type;
+	Vec4F padding;
+	cmmt_float_t spacing;
+	uint32_t columnCount;
+	bool isFitting;
+	bool isStretched;
+} InterfaceLayout;
+
+/*
+ * Empty interface layout.
+ */
+static const InterfaceLayout emptyInterfaceLayout = {
+	NO_INTERFACE_LAYOUT_TYPE, { 0, 0, 0, 0 }, 0, 0, false, false,
+};
+
 /*
  * Create a new interface instance.
  * Returns interface instance on success, otherwise NULL.
@@ -187,13 +235,20 @@ Vec2F getInterfaceCursorPosition(Interface interface);
  * interface - interface instance.
  */
 void updateInterface(Interface interface);
+/*
+ * Finds layout container elements again.
+ * (Call it after changing element transform parent)
+ *
+ * interface - interface instance.
+ */
+void invalidateInterfaceLayouts(Interface interface);
 
 /*
  * Create a new interface element instance.
  * Returns interface element instance on success, otherwise NUL.
  *
  * interface - interface instance.
- * transform - transform instance.
+ * transform - transform instance. (Same transformer for all elements)
  * alignment - interface element alignment type.
  * position - interface element position.
  * bounds - interface element bounds.
@@ -270,6 +325,7 @@ Vec3F getInterfaceElementPosition(
 	InterfaceElement element);
 /*
  * Sets interface element position.
+ * (Elements inside the layout use only Z value)
  *
  * element - interface element instance.
  * position - interface element position.
@@ -302,6 +358,7 @@ bool isInterfaceElementEnabled(
 	InterfaceElement element);
 /*
  * Sets interface element enabled value.
+ * Disabled element is removed from the update list.
  *
  * element - interface element instance.
  * isEnabled - is interface element enabled.
@@ -310,6 +367,77 @@ void setInterfaceElementEnabled(
 	InterfaceElement element,
 	bool isEnabled);
 
+/*
+ * Returns interface element layout.
+ * element - interface element instance.
+ */
+InterfaceLayout getInterfaceElementLayout(
+	InterfaceElement element);
+/*
+ * Sets interface element layout, making it a container.
+ * Returns true on success, otherwise false.
+ *
+ * element - interface element instance.
+ * layout - interface layout or NULL. (no layout)
+ */
+bool setInterfaceElementLayout(
+	InterfaceElement element,
+	const InterfaceLayout* layout);
+
+/*
+ * Returns interface element layout grow factor.
+ * element - interface element instance.
+ */
+cmmt_float_t getInterfaceElementGrow(
+	InterfaceElement element);
+/*
+ * Sets interface element layout grow factor.
+ * Free container space is shared between the
+ * horizontal or vertical layout elements by it.
+ *
+ * element - interface element instance.
+ * grow - layout grow factor.
+ */
+void setInterfaceElementGrow(
+	InterfaceElement element,
+	cmmt_float_t grow);
+
+/*
+ * Returns interface element layout shrink factor.
+ * element - interface element instance.
+ */
+cmmt_float_t getInterfaceElementShrink(
+	InterfaceElement element);
+/*
+ * Sets interface element layout shrink factor.
+ * Overflow of the horizontal or vertical layout is
+ * removed from elements by it and by their size.
+ *
+ * element - interface element instance.
+ * shrink - layout shrink factor.
+ */
+void setInterfaceElementShrink(
+	InterfaceElement element,
+	cmmt_float_t shrink);
+
+/*
+ * Returns true if layout can resize interface element.
+ * element - interface element instance.
+ */
+bool isInterfaceElementResizable(
+	InterfaceElement element);
+/*
+ * Sets interface element layout resizable state.
+ * Not resizable element is only positioned by the
+ * layout, its size is the element bounds size.
+ *
+ * element - interface element instance.
+ * isResizable - is element resizable by the layout.
+ */
+void setInterfaceElementResizable(
+	InterfaceElement element,
+	bool isResizable);
+
 /*
  * Bake specific interface element.
  * element - interface element instance.
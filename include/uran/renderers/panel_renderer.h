@@ -33,6 +33,24 @@ GraphicsRenderer createPanelRenderer(
 	bool useCulling,
 	size_t capacity,
 	ThreadPool threadPool);
+/*
+ * Create a new batched panel renderer instance.
+ * Panels are drawn as solid quads into the text batch,
+ * so they share draws with the texts of the same pipeline.
+ * Returns panel renderer instance in success, otherwise NULL.
+ *
+ * textPipeline - text pipeline instance. (not packed)
+ * sorting - render sorting type.
+ * useCulling - use frustum culling.
+ * capacity - initial render array capacity.
+ * threadPool - thread pool instance or NULL.
+ */
+GraphicsRenderer createBatchedPanelRenderer(
+	GraphicsPipeline textPipeline,
+	GraphicsRenderSorting sorting,
+	bool useCulling,
+	size_t capacity,
+	ThreadPool threadPool);
 
 /*
  * Create a new panel render instance.
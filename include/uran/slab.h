@@ -0,0 +1,76 @@
+// Copyright 2020-2022 Nikita Fediuchin. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <stddef.h>
+
+/*
+ * Slab allocator structure.
+ */
+typedef struct Slab_T Slab_T;
+/*
+ * Slab allocator instance.
+ */
+typedef Slab_T* Slab;
+
+/*
+ * Create a new slab allocator instance.
+ * Objects of the same size are allocated from the
+ * blocks, and freed objects are reused by the next ones.
+ * Returns slab allocator instance on success, otherwise NULL.
+ *
+ * objectSize - slab object size in bytes.
+ * blockLength - object count in one slab block.
+ */
+Slab createSlab(
+	size_t objectSize,
+	size_t blockLength);
+/*
+ * Destroys slab allocator instance, and all its objects.
+ * slab - slab allocator instance or NULL.
+ */
+void destroySlab(Slab slab);
+
+/*
+ * Returns slab allocator object size.
+ * slab - slab allocator instance.
+ */
+size_t getSlabObjectSize(Slab slab);
+/*
+ * Returns slab allocator allocated object count.
+ * slab - slab allocator instance.
+ */
+size_t getSlabObjectCount(Slab slab);
+
+/*
+ * Allocates a new zero initialized slab object.
+ * Returns slab object on success, otherwise NULL.
+ *
+ * slab - slab allocator instance.
+ */
+void* allocateSlabObject(Slab slab);
+/*
+ * Frees slab object, it will be reused.
+ *
+ * slab - slab allocator instance.
+ * object - slab object or NULL.
+ */
+void freeSlabObject(
+	Slab slab,
+	void* object);
+/*
+ * Frees all slab objects, keeping the first block.
+ * slab - slab allocator instance.
+ */
+void resetSlab(Slab slab);
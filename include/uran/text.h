@@ -16,6 +16,7 @@
 #include "mpgx/window.h"
 #include "pack/reader.h"
 #include "logy/logger.h"
+#include "mpmt/thread_pool.h"
 #include "cmmt/color.h"
 #include "cmmt/bounding.h"
 
@@ -50,6 +51,15 @@ typedef union Text_T Text_T;
  */
 typedef Text_T* Text;
 
+/*
+ * Text document structure.
+ */
+typedef struct TextDocument_T TextDocument_T;
+/*
+ * Text document instance.
+ */
+typedef TextDocument_T* TextDocument;
+
 /*
  * Alignment types.
  */
@@ -71,6 +81,22 @@ typedef enum AlignmentType_T
  */
 typedef uint8_t AlignmentType;
 
+/*
+ * Text wrap types.
+ */
+typedef enum TextWrapType_T
+{
+	NONE_TEXT_WRAP_TYPE = 0,
+	WORD_TEXT_WRAP_TYPE = 1,
+	CHAR_TEXT_WRAP_TYPE = 2,
+	ELLIPSIS_TEXT_WRAP_TYPE = 3,
+	TEXT_WRAP_TYPE_COUNT = 4,
+} TextWrapType_T;
+/*
+ * Text wrap type.
+ */
+typedef uint8_t TextWrapType;
+
 /*
  * Text pipeline enumeration function.
  */
@@ -189,6 +215,7 @@ Font createFont(
 /*
  * Create a new font instance from the file.
  * Returns font instance on success, otherwise NULL.
+ * (File is memory mapped as read only, if supported)
  *
  * path - file path string.
  * index - font face index.
@@ -212,6 +239,19 @@ Font createFontFromPack(
 	size_t index,
 	PackReader packReader,
 	Logger logger);
+/*
+ * Create a new font instance sharing data with another font.
+ * Returns font instance on success, otherwise NULL.
+ * (Data is released when all sharing fonts are destroyed)
+ *
+ * font - source font instance.
+ * index - font face index.
+ * logger - logger instance or NULL.
+ */
+Font createSharedFont(
+	Font font,
+	size_t index,
+	Logger logger);
 /*
  * Destroys font instance.
  * font - font instance or NULL.
@@ -298,6 +338,148 @@ MpgxResult createAsciiFontAtlas(
 	uint32_t fontSize,
 	Logger logger,
 	FontAtlas* fontAtlas);
+/*
+ * Returns font atlas cache key.
+ * Key changes with fonts, size, chars and FreeType version.
+ *
+ * regularFonts - regular font array.
+ * boldFonts - bold font array.
+ * italicFonts - italic font array.
+ * boldItalicFonts - bold italic font array.
+ * fontCount - font array size.
+ * fontSize - font pixel size.
+ * chars - atlas char array.
+ * charCount - char array size.
+ */
+uint64_t getFontAtlasCacheKey(
+	Font* regularFonts,
+	Font* boldFonts,
+	Font* italicFonts,
+	Font* boldItalicFonts,
+	size_t fontCount,
+	uint32_t fontSize,
+	const uint32_t* chars,
+	size_t charCount);
+/*
+ * Create a new UTF-32 font atlas instance from the cache data.
+ * Skips glyph rasterization, fonts are stored for generated texts.
+ * Returns operation MPGX result. (BAD_VALUE if cache is stale)
+ *
+ * textPipeline - text pipeline instance.
+ * regularFonts - regular font array.
+ * boldFonts - bold font array.
+ * italicFonts - italic font array.
+ * boldItalicFonts - bold italic font array.
+ * fontCount - font array size.
+ * fontSize - font pixel size.
+ * chars - atlas char array.
+ * charCount - char array size.
+ * data - font atlas cache data.
+ * size - cache data size in bytes.
+ * logger - logger instance or NULL.
+ * fontAtlas - pointer to the font atlas instance.
+ */
+MpgxResult createFontAtlasFromCache(
+	GraphicsPipeline textPipeline,
+	Font* regularFonts,
+	Font* boldFonts,
+	Font* italicFonts,
+	Font* boldItalicFonts,
+	size_t fontCount,
+	uint32_t fontSize,
+	const uint32_t* chars,
+	size_t charCount,
+	const void* data,
+	size_t size,
+	Logger logger,
+	FontAtlas* fontAtlas);
+/*
+ * Create a new UTF-32 font atlas instance using cache file.
+ * Rebuilds and writes cache file if it is missing or stale.
+ * Returns operation MPGX result.
+ *
+ * textPipeline - text pipeline instance.
+ * regularFonts - regular font array.
+ * boldFonts - bold font array.
+ * italicFonts - italic font array.
+ * boldItalicFonts - bold italic font array.
+ * fontCount - font array size.
+ * fontSize - font pixel size.
+ * chars - atlas char array.
+ * charCount - char array size.
+ * cachePath - font atlas cache file path.
+ * logger - logger instance or NULL.
+ * fontAtlas - pointer to the font atlas instance.
+ */
+MpgxResult createCachedFontAtlas(
+	GraphicsPipeline textPipeline,
+	Font* regularFonts,
+	Font* boldFonts,
+	Font* italicFonts,
+	Font* boldItalicFonts,
+	size_t fontCount,
+	uint32_t fontSize,
+	const uint32_t* chars,
+	size_t charCount,
+	const char* cachePath,
+	Logger logger,
+	FontAtlas* fontAtlas);
+/*
+ * Generates font atlas cache file without graphics.
+ * Used at pack time to ship the cache with resources,
+ * mapped font keys also depend on the file time.
+ * Returns operation MPGX result.
+ *
+ * regularFonts - regular font array.
+ * boldFonts - bold font array.
+ * italicFonts - italic font array.
+ * boldItalicFonts - bold italic font array.
+ * fontCount - font array size.
+ * fontSize - font pixel size.
+ * chars - atlas char array.
+ * charCount - char array size.
+ * cachePath - font atlas cache file path.
+ * logger - logger instance or NULL.
+ */
+MpgxResult generateFontAtlasCache(
+	Font* regularFonts,
+	Font* boldFonts,
+	Font* italicFonts,
+	Font* boldItalicFonts,
+	size_t fontCount,
+	uint32_t fontSize,
+	const uint32_t* chars,
+	size_t charCount,
+	const char* cachePath,
+	Logger logger);
+/*
+ * Create a new dynamic font atlas instance with fixed size.
+ * Glyphs are baked on demand, least recently used glyphs
+ * are evicted when the atlas is full.
+ * Returns operation MPGX result.
+ *
+ * textPipeline - text pipeline instance.
+ * regularFonts - regular font array.
+ * boldFonts - bold font array.
+ * italicFonts - italic font array.
+ * boldItalicFonts - bold italic font array.
+ * fontCount - font array size.
+ * fontSize - font pixel size.
+ * glyphCapacity - maximum atlas glyph count.
+ * logger - logger instance or NULL.
+ * fontAtlas - pointer to the font atlas instance.
+ */
+MpgxResult createDynamicFontAtlas(
+	GraphicsPipeline textPipeline,
+	Font* regularFonts,
+	Font* boldFonts,
+	Font* italicFonts,
+	Font* boldItalicFonts,
+	size_t fontCount,
+	uint32_t fontSize,
+	size_t glyphCapacity,
+	Logger logger,
+	FontAtlas* fontAtlas);
 /*
  * Destroys font atlas instance.
  * fontAtlas - font atlas instance or NULL.
@@ -339,6 +521,11 @@ size_t getFontAtlasFontCount(FontAtlas fontAtlas);
  * fontAtlas - font atlas instance.
  */
 uint32_t getFontAtlasFontSize(FontAtlas fontAtlas);
+/*
+ * Returns font atlas new line advance. (in font sizes)
+ * fontAtlas - font atlas instance.
+ */
+float getFontAtlasLineAdvance(FontAtlas fontAtlas);
 /*
  * Returns font atlas logger.
  * fontAtlas - font atlas instance.
@@ -349,6 +536,78 @@ Logger getFontAtlasLogger(FontAtlas fontAtlas);
  * fontAtlas - font atlas instance.
  */
 bool isFontAtlasGenerated(FontAtlas fontAtlas);
+/*
+ * Returns true if font atlas is dynamic.
+ * fontAtlas - font atlas instance.
+ */
+bool isFontAtlasDynamic(FontAtlas fontAtlas);
+
+/*
+ * Advances dynamic font atlas frame and bakes again
+ * texts drawn in the previous frame with evicted glyphs.
+ * Should be called once per frame, before drawing texts.
+ * Returns operation MPGX result.
+ *
+ * fontAtlas - dynamic font atlas instance.
+ */
+MpgxResult updateFontAtlas(FontAtlas fontAtlas);
+
+/*
+ * Measures UTF-32 text using font atlas metrics only.
+ * Does not allocate memory or access GPU, so it can be called
+ * from worker threads, while atlas is not being baked.
+ * Not baked characters are measured as the missing glyph.
+ * Returns true on success.
+ *
+ * fontAtlas - font atlas instance.
+ * string - text string or NULL.
+ * length - string length or 0.
+ * isBold - is text bold initially.
+ * isItalic - is text italic initially.
+ * useTags - use HTML tags.
+ * size - pointer to the text size.
+ * lineCount - pointer to the line count or NULL.
+ * lineWidths - line width array or NULL.
+ * lineCapacity - line width array capacity or 0.
+ */
+bool measureText(
+	FontAtlas fontAtlas,
+	const uint32_t* string,
+	size_t length,
+	bool isBold,
+	bool isItalic,
+	bool useTags,
+	Vec2F* size,
+	size_t* lineCount,
+	float* lineWidths,
+	size_t lineCapacity);
+/*
+ * Measures UTF-8 text using font atlas metrics only.
+ * Allocates memory only for long strings.
+ * Returns true on success.
+ *
+ * fontAtlas - font atlas instance.
+ * string - text string or NULL.
+ * length - string length or 0.
+ * isBold - is text bold initially.
+ * isItalic - is text italic initially.
+ * useTags - use HTML tags.
+ * size - pointer to the text size.
+ * lineCount - pointer to the line count or NULL.
+ * lineWidths - line width array or NULL.
+ * lineCapacity - line width array capacity or 0.
+ */
+bool measureText8(
+	FontAtlas fontAtlas,
+	const char* string,
+	size_t length,
+	bool isBold,
+	bool isItalic,
+	bool useTags,
+	Vec2F* size,
+	size_t* lineCount,
+	float* lineWidths,
+	size_t lineCapacity);
 
 // TODO: shrinkAtlasIndexBuffer
 
@@ -644,6 +903,23 @@ void setTextUseTags(
 	Text text,
 	bool useTags);
 
+/*
+ * Returns text mask symbol, or 0 if not masked.
+ * text - text instance.
+ */
+uint32_t getTextMask(Text text);
+/*
+ * Sets text mask symbol. Masked text is displayed
+ * as the mask symbol repeated for each character,
+ * while keeping the real text string. (0 - no mask)
+ *
+ * text - text instance.
+ * mask - text mask symbol.
+ */
+void setTextMask(
+	Text text,
+	uint32_t mask);
+
 /*
  * Returns text atlas font size.
  * text - text instance.
@@ -659,6 +935,39 @@ void setTextFontSize(
 	Text text,
 	uint32_t fontSize);
 
+/*
+ * Returns text wrap type.
+ * text - text instance.
+ */
+TextWrapType getTextWrap(Text text);
+/*
+ * Sets text wrap type.
+ * Lines longer than the max width are wrapped
+ * by words or characters, or cut with ellipsis.
+ *
+ * text - text instance.
+ * wrap - text wrap type.
+ */
+void setTextWrap(
+	Text text,
+	TextWrapType wrap);
+
+/*
+ * Returns text max line width. (in font sizes)
+ * text - text instance.
+ */
+float getTextMaxWidth(Text text);
+/*
+ * Sets text max line width. (in font sizes)
+ * Changing only the width does not look up glyphs again.
+ *
+ * text - text instance.
+ * maxWidth - max line width.
+ */
+void setTextMaxWidth(
+	Text text,
+	float maxWidth);
+
 /*
  * Get text cursor advance.
  * Returns true on success.
@@ -689,13 +998,196 @@ bool getTextCursorIndex(
  * Returns operation MPGX result.
  */
 MpgxResult bakeText(Text text);
+/*
+ * Recreate changed texts mesh data.
+ * Texts are laid out in parallel, then uploaded in order.
+ * Repeated texts in the array are baked once.
+ * Returns operation MPGX result.
+ *
+ * textPipeline - text pipeline instance.
+ * texts - text instance array.
+ * textCount - text array size.
+ * threadPool - thread pool instance or NULL.
+ */
+MpgxResult bakeTexts(
+	GraphicsPipeline textPipeline,
+	Text* texts,
+	size_t textCount,
+	ThreadPool threadPool);
 /*
  * Draw text mesh. (rendering command)
+ * Text with evicted dynamic atlas glyphs is skipped.
+ * Pending text batch is drawn before the text.
  * Returns drawn index count.
  *
  * text - text instance.
  */
 size_t drawText(Text text);
+/*
+ * Add text mesh to the pipeline text batch. (rendering command)
+ * Consecutive texts with the same font atlas and scissor are
+ * drawn with one indexed draw. Texts with an affine MVP and
+ * color in the [0, 1] range are transformed into the batch
+ * buffer with the baked color, other texts are merged only if
+ * they have the same MVP, color and adjacent vertices.
+ * Returns drawn index count of the previous batch.
+ *
+ * text - text instance.
+ * mvp - model view projection matrix value.
+ * color - text color value.
+ * scissor - text scissor. (used with dynamic pipeline scissor)
+ */
+size_t drawBatchedText(
+	Text text,
+	const Mat4F* mvp,
+	LinearColor color,
+	Vec4I scissor);
+/*
+ * Add solid quad to the pipeline text batch. (rendering command)
+ * Quad samples the font atlas white texel, so it is drawn in
+ * the same stream with the texts, in the submission order.
+ * Quad is skipped if pipeline has no font atlas or vertices
+ * are packed, or if MVP is not affine or color is not in the
+ * [0, 1] range, or if batch buffer is full until the next frame.
+ * Returns drawn index count of the previous batch.
+ *
+ * textPipeline - text pipeline instance.
+ * mvp - model view projection matrix value. (one size square)
+ * color - quad color value.
+ * scissor - quad scissor. (used with dynamic pipeline scissor)
+ */
+size_t drawBatchedQuad(
+	GraphicsPipeline textPipeline,
+	const Mat4F* mvp,
+	LinearColor color,
+	Vec4I scissor);
+/*
+ * Draw pending text batch. (rendering command)
+ * Should be called before the pipeline is changed.
+ * Returns drawn index count.
+ *
+ * textPipeline - text pipeline instance.
+ */
+size_t flushTextBatch(GraphicsPipeline textPipeline);
+
+/*
+ * Create a new text document instance.
+ * Document string is not laid out, only visible
+ * view lines are copied to the view text instance.
+ * Returns operation MPGX result.
+ *
+ * fontAtlas - font atlas instance.
+ * alignment - top text alignment.
+ * color - initial text color.
+ * isBold - is text bold initially.
+ * isItalic - is text italic initially.
+ * useTags - use HTML tags.
+ * textDocument - pointer to the text document instance.
+ */
+MpgxResult createTextDocument(
+	FontAtlas fontAtlas,
+	AlignmentType alignment,
+	SrgbColor color,
+	bool isBold,
+	bool isItalic,
+	bool useTags,
+	TextDocument* textDocument);
+/*
+ * Destroys text document instance.
+ * textDocument - text document instance or NULL.
+ */
+void destroyTextDocument(TextDocument textDocument);
+
+/*
+ * Returns text document view text instance.
+ * Use it to bake and draw visible document lines.
+ * textDocument - text document instance.
+ */
+Text getTextDocumentText(TextDocument textDocument);
+/*
+ * Returns text document string.
+ * textDocument - text document instance.
+ */
+const uint32_t* getTextDocumentString(TextDocument textDocument);
+/*
+ * Returns text document string length.
+ * textDocument - text document instance.
+ */
+size_t getTextDocumentLength(TextDocument textDocument);
+/*
+ * Returns text document line count.
+ * textDocument - text document instance.
+ */
+size_t getTextDocumentLineCount(TextDocument textDocument);
+
+/*
+ * Appends UTF-32 string to the text document.
+ * Returns true on success.
+ *
+ * textDocument - text document instance.
+ * string - string to append or NULL.
+ * length - string length or 0.
+ */
+bool appendTextDocument(
+	TextDocument textDocument,
+	const uint32_t* string,
+	size_t length);
+/*
+ * Appends UTF-8 string to the text document.
+ * Returns true on success.
+ *
+ * textDocument - text document instance.
+ * string - string to append or NULL.
+ * length - string length or 0.
+ */
+bool appendTextDocument8(
+	TextDocument textDocument,
+	const char* string,
+	size_t length);
+/*
+ * Removes all text document lines.
+ * Returns true on success.
+ *
+ * textDocument - text document instance.
+ */
+bool clearTextDocument(TextDocument textDocument);
+
+/*
+ * Get text document size, measuring only
+ * line blocks changed since the last call.
+ * Returns true on success.
+ *
+ * textDocument - text document instance.
+ * size - pointer to the text document size.
+ */
+bool getTextDocumentSize(
+	TextDocument textDocument,
+	Vec2F* size);
+
+/*
+ * Returns text document first view line.
+ * textDocument - text document instance.
+ */
+size_t getTextDocumentViewLine(TextDocument textDocument);
+/*
+ * Returns text document view line count.
+ * textDocument - text document instance.
+ */
+size_t getTextDocumentViewLineCount(TextDocument textDocument);
+/*
+ * Sets text document visible line range.
+ * View text top is offset from the document top
+ * by the first line multiplied by the line advance.
+ * Returns true on success.
+ *
+ * textDocument - text document instance.
+ * firstLine - first visible line index.
+ * lineCount - visible line count.
+ */
+bool setTextDocumentView(
+	TextDocument textDocument,
+	size_t firstLine,
+	size_t lineCount);
 
 // TODO: shrink text buffers
 
@@ -720,8 +1212,15 @@ MpgxResult createTextSampler(
  * sampler - image sampler instance.
  * state - sprite pipeline state or NULL.
  * useScissors - use scissors for text rendering.
+ * usePackedVertices - use 12 byte quantized text vertices.
  * capacity - initial text array capacity.
  * textPipeline - pointer to the text pipeline.
+ *
+ * Packed vertices require the packed vertex shader variant,
+ * which is not in the default resource pack. Text width and
+ * height are limited to 8191 font size pixels, bigger text
+ * bake fails with the bad value result. Texts still keep
+ * full CPU vertex copy, only GPU buffer is smaller.
  */
 MpgxResult createTextPipeline(
 	Framebuffer framebuffer,
@@ -730,6 +1229,7 @@ MpgxResult createTextPipeline(
 	Sampler sampler,
 	const GraphicsPipelineState* state,
 	bool useScissors,
+	bool usePackedVertices,
 	size_t capacity,
 	GraphicsPipeline* textPipeline);
 
@@ -738,6 +1238,11 @@ MpgxResult createTextPipeline(
  * textPipeline - text pipeline instance.
  */
 Sampler getTextPipelineSampler(GraphicsPipeline textPipeline);
+/*
+ * Returns true if text pipeline uses packed vertices.
+ * textPipeline - text pipeline instance.
+ */
+bool isTextPipelinePacked(GraphicsPipeline textPipeline);
 /*
  * Returns text pipeline text count.
  * textPipeline - text pipeline instance.
@@ -98,6 +98,13 @@ Transform getTransformerCamera(
 void setTransformerCamera(
 	Transformer transformer,
 	Transform camera);
+/*
+ * Returns transformer change version. It is incremented
+ * when any transform is created, destroyed or changed.
+ * transformer - transformer instance.
+ */
+uint64_t getTransformerVersion(
+	Transformer transformer);
 
 /*
  * Enumerates transformer transforms.
@@ -314,6 +321,15 @@ void setTransformActive(
 	Transform transform,
 	bool isActive);
 
+/*
+ * Returns transformer version of the last transform change.
+ * Version is greater than of any previous change, so the
+ * greatest version of the parents shows if any is changed.
+ * transform - transform instance.
+ */
+uint64_t getTransformVersion(
+	Transform transform);
+
 /*
  * Returns transform model matrix.
  * transform - transform instance.
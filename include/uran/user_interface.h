@@ -38,6 +38,8 @@
 #define DEFAULT_UI_PRESSED_CHECKBOX_COLOR srgbColor(24, 24, 24, 255)
 #define DEFAULT_UI_CHECKBOX_FOCUS_COLOR srgbColor(80, 80, 80, 255)
 #define DEFAULT_UI_CHECKBOX_CHECK_COLOR srgbColor(128, 128, 128, 255)
+#define DEFAULT_UI_LIST_PANEL_COLOR srgbColor(32, 32, 32, 255)
+#define DEFAULT_UI_LIST_ROW_HEIGHT 20
 
 /*
  * Use interface element types.
@@ -50,7 +52,8 @@ typedef enum UiType_T
 	BUTTON_UI_TYPE = 3,
 	INPUT_FIELD_UI_TYPE = 4,
 	CHECKBOX_UI_TYPE = 5,
-	CUSTOM_UI_TYPES = 6,
+	LIST_UI_TYPE = 6,
+	CUSTOM_UI_TYPES = 7,
 	// Note: your custom UI types...
 } UiType_T;
 /*
@@ -67,35 +70,88 @@ typedef struct UserInterface_T UserInterface_T;
  */
 typedef UserInterface_T* UserInterface;
 
+/*
+ * User interface font atlas create function.
+ * Returns operation MPGX result.
+ *
+ * textPipeline - text pipeline instance.
+ * regularFonts - regular font array.
+ * boldFonts - bold font array.
+ * italicFonts - italic font array.
+ * boldItalicFonts - bold italic font array.
+ * fontCount - font array size.
+ * fontSize - font pixel size.
+ * logger - logger instance or NULL.
+ * handle - function argument or NULL.
+ * fontAtlas - pointer to the font atlas instance.
+ */
+typedef MpgxResult(*OnUserInterfaceFontAtlasCreate)(
+	GraphicsPipeline textPipeline,
+	Font* regularFonts,
+	Font* boldFonts,
+	Font* italicFonts,
+	Font* boldItalicFonts,
+	size_t fontCount,
+	uint32_t fontSize,
+	Logger logger,
+	void* handle,
+	FontAtlas* fontAtlas);
+
 /*
  * Create a new user interface instance.
+ * Font atlases are created on first use of their size,
+ * default size atlas is created with the interface
+ * if panels are batched with the texts.
  * Returns operation MPGX result.
  *
  * panelPipeline - panel pipeline instance.
  * textPipeline - text pipeline instance.
- * fontAtlases - font atlas array.
- * fontAtlasCount - font atlas array size.
+ * regularFonts - regular font array.
+ * boldFonts - bold font array.
+ * italicFonts - italic font array.
+ * boldItalicFonts - bold italic font array.
+ * fontCount - font array size.
+ * fontSizes - font atlas pixel size array.
+ * fontAtlasCount - font atlas pixel size array size.
+ * onFontAtlasCreate - font atlas create function or NULL.
+ * fontAtlasHandle - font atlas create function argument or NULL.
  * scale - interface scale.
  * capacity - initial element array capacity.
  * threadPool - thread pool instance or NULL.
+ * logger - logger instance or NULL.
  * ui - pointer to the UI instance.
  */
 MpgxResult createUserInterface(
 	GraphicsPipeline panelPipeline,
 	GraphicsPipeline textPipeline,
-	FontAtlas* fontAtlases,
+	Font* regularFonts,
+	Font* boldFonts,
+	Font* italicFonts,
+	Font* boldItalicFonts,
+	size_t fontCount,
+	const uint32_t* fontSizes,
 	size_t fontAtlasCount,
+	OnUserInterfaceFontAtlasCreate onFontAtlasCreate,
+	void* fontAtlasHandle,
 	cmmt_float_t scale,
 	size_t capacity,
 	ThreadPool threadPool,
+	Logger logger,
 	UserInterface* ui);
 /*
  * Destroys user interface instance.
  * ui - user interface instance or NULL.
  */
 void destroyUserInterface(UserInterface ui);
+/*
+ * Returns user interface panel pipeline.
+ * ui - user interface instance.
+ */
+GraphicsPipeline getUserInterfacePanelPipeline(UserInterface ui);
 /*
  * Returns user interface panel renderer.
+ * Panels are drawn with the text pipeline
+ * if its vertices are not packed.
  * ui - user interface instance.
  */
 GraphicsRenderer getUserInterfacePanelRenderer(UserInterface ui);
@@ -104,16 +160,63 @@ GraphicsRenderer getUserInterfacePanelRenderer(UserInterface ui);
  * ui - user interface instance.
  */
 GraphicsRenderer getUserInterfaceTextRenderer(UserInterface ui);
+/*
+ * Returns user interface regular font array.
+ * ui - user interface instance.
+ */
+Font* getUserInterfaceRegularFonts(UserInterface ui);
+/*
+ * Returns user interface bold font array.
+ * ui - user interface instance.
+ */
+Font* getUserInterfaceBoldFonts(UserInterface ui);
+/*
+ * Returns user interface italic font array.
+ * ui - user interface instance.
+ */
+Font* getUserInterfaceItalicFonts(UserInterface ui);
+/*
+ * Returns user interface bold italic font array.
+ * ui - user interface instance.
+ */
+Font* getUserInterfaceBoldItalicFonts(UserInterface ui);
+/*
+ * Returns user interface font array size.
+ * ui - user interface instance.
+ */
+size_t getUserInterfaceFontCount(UserInterface ui);
 /*
  * Returns user interface font atlas array.
+ * Not yet used font atlases are NULL.
  * ui - user interface instance.
  */
 FontAtlas* getUserInterfaceFontAtlases(UserInterface ui);
+/*
+ * Returns user interface font atlas pixel size array.
+ * ui - user interface instance.
+ */
+const uint32_t* getUserInterfaceFontSizes(UserInterface ui);
 /*
  * Returns user interface font atlas array size.
  * ui - user interface instance.
  */
 size_t getUserInterfaceFontAtlasCount(UserInterface ui);
+/*
+ * Returns user interface logger.
+ * ui - user interface instance.
+ */
+Logger getUserInterfaceLogger(UserInterface ui);
+/*
+ * Creates user interface font atlas for the font scale
+ * ahead of its first use, for example on loading screen.
+ * Returns operation MPGX result.
+ *
+ * ui - user interface instance.
+ * fontScale - text font scale.
+ */
+MpgxResult warmUserInterfaceFontAtlas(
+	UserInterface ui,
+	cmmt_float_t fontScale);
 /*
  * Returns user interface transformer.
  * ui - user interface instance.
@@ -131,7 +234,8 @@ Interface getUserInterface(UserInterface ui);
 GraphicsRender getUserInterfaceCursor(UserInterface ui);
 
 /*
- * Processes user interface events.
+ * Processes user interface events and updates
+ * dynamic font atlases. Should be called once per frame.
  * ui - user interface instance.
  */
 void updateUserInterface(UserInterface ui);
@@ -318,6 +422,39 @@ MpgxResult setUiLabelText8(
 	const char* string,
 	size_t length);
 
+/*
+ * Set UI label texts UTF-32 strings and bake them together.
+ * Texts are laid out across the interface thread pool,
+ * use it for the mass label updates. (language switch)
+ * Returns operation MPGX result.
+ *
+ * labels - UI label array of the same user interface.
+ * strings - text string array.
+ * lengths - string length array.
+ * labelCount - label array size.
+ */
+MpgxResult setUiLabelTexts(
+	InterfaceElement* labels,
+	const uint32_t** strings,
+	const size_t* lengths,
+	size_t labelCount);
+/*
+ * Set UI label texts UTF-8 strings and bake them together.
+ * Texts are laid out across the interface thread pool,
+ * use it for the mass label updates. (language switch)
+ * Returns operation MPGX result.
+ *
+ * labels - UI label array of the same user interface.
+ * strings - text string array.
+ * lengths - string length array.
+ * labelCount - label array size.
+ */
+MpgxResult setUiLabelTexts8(
+	InterfaceElement* labels,
+	const char** strings,
+	const size_t* lengths,
+	size_t labelCount);
+
 /*
  * Create a new UTF-32 UI window instance.
  * Returns operation MPGX result.
@@ -719,6 +856,22 @@ OnInterfaceElementEvent getUiInputFieldOnDefocusEvent(InterfaceElement inputFiel
  * inputField - UI input field instance.
  */
 size_t getUiInputFieldMaxLength(InterfaceElement inputField);
+/*
+ * Returns UI input field tab index.
+ * inputField - UI input field instance.
+ */
+uint32_t getUiInputFieldTabIndex(InterfaceElement inputField);
+/*
+ * Sets UI input field tab index.
+ * Fields are focused with Tab in the tab index order,
+ * and then in the creation order. (Shift+Tab reverses)
+ *
+ * inputField - UI input field instance.
+ * tabIndex - tab index value.
+ */
+void setUiInputFieldTabIndex(
+	InterfaceElement inputField,
+	uint32_t tabIndex);
 /*
  * Returns true if input field is currently focused.
  * inputField - UI input field instance.
@@ -1031,5 +1184,141 @@ void setCheckboxChecked(
 	InterfaceElement checkbox,
 	bool isChecked);
 
+/*
+ * User interface list row function.
+ * Sets row text string of the data row.
+ * Returns true on success.
+ *
+ * list - UI list instance.
+ * index - data row index.
+ * text - row text instance.
+ */
+typedef bool(*OnUiListRow)(
+	InterfaceElement list,
+	size_t index,
+	Text text);
+
+/*
+ * Create a new UI list instance.
+ * Rows are created only for the visible range, and
+ * recycled while list is scrolled. (virtualized list)
+ * Returns operation MPGX result.
+ *
+ * ui - user interface instance.
+ * alignment - alignment type.
+ * position - list position.
+ * scale - list scale.
+ * rowHeight - list row height.
+ * rowCount - data row count.
+ * onRow - row function.
+ * parent - parent instance or NULL.
+ * events - interface events or NULL.
+ * handle - list handle or NULL.
+ * isActive - is list active.
+ * uiList - pointer to the UI list.
+ */
+MpgxResult createUiList(
+	UserInterface ui,
+	AlignmentType alignment,
+	Vec3F position,
+	Vec2F scale,
+	cmmt_float_t rowHeight,
+	size_t rowCount,
+	OnUiListRow onRow,
+	Transform parent,
+	const InterfaceElementEvents* events,
+	void* handle,
+	bool isActive,
+	InterfaceElement* uiList);
+
+/*
+ * Returns UI list handle.
+ * list - UI list instance.
+ */
+void* getUiListHandle(InterfaceElement list);
+/*
+ * Returns UI list panel render instance.
+ * list - UI list instance.
+ */
+GraphicsRender getUiListPanelRender(InterfaceElement list);
+/*
+ * Returns UI list row function.
+ * list - UI list instance.
+ */
+OnUiListRow getUiListOnRow(InterfaceElement list);
+/*
+ * Returns UI list on update event function.
+ * list - UI list instance.
+ */
+OnInterfaceElementEvent getUiListOnUpdateEvent(InterfaceElement list);
+/*
+ * Returns UI list on press event function.
+ * list - UI list instance.
+ */
+OnInterfaceElementEvent getUiListOnPressEvent(InterfaceElement list);
+/*
+ * Returns UI list row height.
+ * list - UI list instance.
+ */
+cmmt_float_t getUiListRowHeight(InterfaceElement list);
+/*
+ * Returns UI list created row count.
+ * list - UI list instance.
+ */
+size_t getUiListRowPoolCount(InterfaceElement list);
+
+/*
+ * Returns UI list data row count.
+ * list - UI list instance.
+ */
+size_t getUiListRowCount(
+	InterfaceElement list);
+/*
+ * Sets UI list data row count.
+ * Returns operation MPGX result.
+ *
+ * list - UI list instance.
+ * rowCount - data row count.
+ */
+MpgxResult setUiListRowCount(
+	InterfaceElement list,
+	size_t rowCount);
+
+/*
+ * Returns UI list scroll offset.
+ * list - UI list instance.
+ */
+cmmt_float_t getUiListScroll(
+	InterfaceElement list);
+/*
+ * Sets UI list scroll offset.
+ * Value is clamped to the content height.
+ * Returns operation MPGX result.
+ *
+ * list - UI list instance.
+ * scroll - scroll offset from the top.
+ */
+MpgxResult setUiListScroll(
+	InterfaceElement list,
+	cmmt_float_t scroll);
+
+/*
+ * Rebinds all visible UI list rows.
+ * Call it if the data rows are changed.
+ * Returns operation MPGX result.
+ *
+ * list - UI list instance.
+ */
+MpgxResult refreshUiList(InterfaceElement list);
+/*
+ * Returns true if cursor is over the UI list data row.
+ *
+ * list - UI list instance.
+ * index - pointer to the data row index.
+ */
+bool getUiListCursorRow(
+	InterfaceElement list,
+	size_t* index);
+
 // TODO: mask (only transform with masking)
-// TODO: InputBox, ScrollBox
+// TODO: InputBox
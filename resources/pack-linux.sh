@@ -76,7 +76,7 @@ fi
 echo ""
 echo "Packing resources..."
 
-files=$(find * -type f -name "*.spv" -o -name "*.webp" -o -name "*.ttf")
+files=$(find * -type f -name "*.spv" -o -name "*.webp" -o -name "*.ttf" -o -name "*.cache")
 files="$files $(find shaders/opengl/* -type f -name "*.vert" -o -name "*.frag")"
 ./linux/packer resources.pack $files
 
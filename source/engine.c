@@ -25,6 +25,7 @@
 #endif
 
 #include <stdio.h>
+#include <string.h>
 
 #if __linux__ || __APPLE__
 #include <sys/utsname.h>
@@ -45,6 +46,7 @@ struct Engine_T
 	ThreadPool backgroundThreadPool;
 	Window window;
 	PackReader packReader;
+	char* dataDirectoryPath;
 	Transformer transformer;
 	UserInterface ui;
 #ifndef NDEBUG
@@ -52,17 +54,22 @@ struct Engine_T
 #endif
 };
 
-inline static Logger createLoggerInstance(const char* appName)
+inline static const char* getDataDirectoryPath(const char* appName)
 {
 	assert(appName);
 
-	Logger logger;
-
 #if __linux__ || _WIN32
-	const char* logDirectoryPath = ".";
+	return ".";
 #elif __APPLE__
-	const char* logDirectoryPath = appName;
+	return appName;
 #endif
+}
+inline static Logger createLoggerInstance(const char* appName)
+{
+	assert(appName);
+
+	Logger logger;
+	const char* logDirectoryPath = getDataDirectoryPath(appName);
 
 #ifndef NDEBUG
 	LogLevel logLevel = ALL_LOG_LEVEL;
@@ -328,6 +335,7 @@ inline static GraphicsPipeline createTextPipelineInstance(
 		sampler,
 		NULL,
 		true,
+		false,
 		1,
 		&pipeline);
 
@@ -358,16 +366,147 @@ inline static void destroyTextPipelineInstance(
 	destroyShader(fragmentShader);
 	destroyShader(vertexShader);
 }
-inline static bool createFontAtlasInstances(
+inline static MpgxResult createFontAtlasInstance(
 	Logger logger,
 	PackReader packReader,
 	GraphicsPipeline textPipeline,
-	FontAtlas* fontAtlases)
+	Font regularFont,
+	Font boldFont,
+	Font italicFont,
+	Font boldItalicFont,
+	uint32_t fontSize,
+	const char* dataDirectoryPath,
+	FontAtlas* fontAtlas)
 {
 	assert(logger);
-	assert(packReader);
 	assert(textPipeline);
-	assert(fontAtlases);
+	assert(regularFont);
+	assert(boldFont);
+	assert(italicFont);
+	assert(boldItalicFont);
+	assert(dataDirectoryPath);
+	assert(fontAtlas);
+
+	size_t charCount = sizeof(printableAscii32) / sizeof(uint32_t);
+
+	uint64_t cacheKey = getFontAtlasCacheKey(
+		&regularFont,
+		&boldFont,
+		&italicFont,
+		&boldItalicFont,
+		1,
+		fontSize,
+		printableAscii32,
+		charCount);
+
+	char cachePath[256];
+
+	// Prebuilt atlas cache can be packed by the offline step.
+	snprintf(cachePath, sizeof(cachePath),
+		"fonts/font-atlas-%016llx.cache",
+		(unsigned long long)cacheKey);
+
+	const uint8_t* data;
+	uint32_t size;
+	MpgxResult mpgxResult;
+
+	// Pack reader can be already destroyed by the application.
+	if (packReader && readPackPathItemData(packReader, cachePath,
+		&data, &size) == SUCCESS_PACK_RESULT)
+	{
+		mpgxResult = createFontAtlasFromCache(
+			textPipeline,
+			&regularFont,
+			&boldFont,
+			&italicFont,
+			&boldItalicFont,
+			1,
+			fontSize,
+			printableAscii32,
+			charCount,
+			data,
+			size,
+			logger,
+			fontAtlas);
+
+		free((void*)data);
+
+		if (mpgxResult == SUCCESS_MPGX_RESULT)
+			return SUCCESS_MPGX_RESULT;
+	}
+
+	snprintf(cachePath, sizeof(cachePath),
+		"%s/font-atlas-%016llx.cache",
+		dataDirectoryPath,
+		(unsigned long long)cacheKey);
+
+	mpgxResult = createCachedFontAtlas(
+		textPipeline,
+		&regularFont,
+		&boldFont,
+		&italicFont,
+		&boldItalicFont,
+		1,
+		fontSize,
+		printableAscii32,
+		charCount,
+		cachePath,
+		logger,
+		fontAtlas);
+
+	if (mpgxResult != SUCCESS_MPGX_RESULT)
+	{
+		logMessage(logger, ERROR_LOG_LEVEL,
+			"Failed to create %up font atlas. (error: %s)",
+			fontSize, mpgxResultToString(mpgxResult));
+		return mpgxResult;
+	}
+
+	return SUCCESS_MPGX_RESULT;
+}
+static MpgxResult onEngineFontAtlasCreate(
+	GraphicsPipeline textPipeline,
+	Font* regularFonts,
+	Font* boldFonts,
+	Font* italicFonts,
+	Font* boldItalicFonts,
+	size_t fontCount,
+	uint32_t fontSize,
+	Logger logger,
+	void* handle,
+	FontAtlas* fontAtlas)
+{
+	assert(textPipeline);
+	assert(regularFonts);
+	assert(boldFonts);
+	assert(italicFonts);
+	assert(boldItalicFonts);
+	assert(fontCount == 1);
+	assert(handle);
+	assert(fontAtlas);
+
+	Engine engine = (Engine)handle;
+
+	return createFontAtlasInstance(
+		logger,
+		engine->packReader,
+		textPipeline,
+		regularFonts[0],
+		boldFonts[0],
+		italicFonts[0],
+		boldItalicFonts[0],
+		fontSize,
+		engine->dataDirectoryPath,
+		fontAtlas);
+}
+inline static bool createFontInstances(
+	Logger logger,
+	PackReader packReader,
+	Font* fonts)
+{
+	assert(logger);
+	assert(packReader);
+	assert(fonts);
 
 	Font regularFont = createFontFromPack(
 		"fonts/dejavu-regular.ttf", 0,
@@ -409,121 +548,28 @@ inline static bool createFontAtlasInstances(
 		return false;
 	}
 
-	cmmt_float_t platformScale = getPlatformScale(
-		getGraphicsPipelineFramebuffer(textPipeline));
-
-	MpgxResult mpgxResult = createAsciiFontAtlas(
-		textPipeline,
-		&regularFont,
-		&boldFont,
-		&italicFont,
-		&boldItalicFont,
-		1,
-		getPlatformFontSize(
-			platformScale, 12),
-		logger,
-		&fontAtlases[0]);
-
-	if (mpgxResult != SUCCESS_MPGX_RESULT)
-	{
-		logMessage(logger, ERROR_LOG_LEVEL,
-			"Failed to create 12p font atlas. (error: %s)",
-			mpgxResultToString(mpgxResult));
-		destroyFont(boldItalicFont);
-		destroyFont(italicFont);
-		destroyFont(boldFont);
-		destroyFont(regularFont);
-		return false;
-	}
-
-	mpgxResult = createAsciiFontAtlas(
-		textPipeline,
-		&regularFont,
-		&boldFont,
-		&italicFont,
-		&boldItalicFont,
-		1,
-		getPlatformFontSize(
-			platformScale, 14),
-		logger,
-		&fontAtlases[1]);
-
-	if (mpgxResult != SUCCESS_MPGX_RESULT)
-	{
-		logMessage(logger, ERROR_LOG_LEVEL,
-			"Failed to create 14p font atlas. (error: %s)",
-			mpgxResultToString(mpgxResult));
-		destroyFontAtlas(fontAtlases[0]);
-		destroyFont(boldItalicFont);
-		destroyFont(italicFont);
-		destroyFont(boldFont);
-		destroyFont(regularFont);
-		return false;
-	}
-
-	mpgxResult = createAsciiFontAtlas(
-		textPipeline,
-		&regularFont,
-		&boldFont,
-		&italicFont,
-		&boldItalicFont,
-		1,
-		getPlatformFontSize(
-			platformScale, 16),
-		logger,
-		&fontAtlases[2]);
-
-	if (mpgxResult != SUCCESS_MPGX_RESULT)
-	{
-		logMessage(logger, ERROR_LOG_LEVEL,
-			"Failed to create 16p font atlas. (error: %s)",
-			mpgxResultToString(mpgxResult));
-		destroyFontAtlas(fontAtlases[1]);
-		destroyFontAtlas(fontAtlases[0]);
-		destroyFont(boldItalicFont);
-		destroyFont(italicFont);
-		destroyFont(boldFont);
-		destroyFont(regularFont);
-		return false;
-	}
-
+	fonts[0] = regularFont;
+	fonts[1] = boldFont;
+	fonts[2] = italicFont;
+	fonts[3] = boldItalicFont;
 	return true;
 }
-inline static void destroyFontAtlasInstances(
-	FontAtlas* fontAtlases)
+inline static void destroyFontInstances(
+	Font* fonts)
 {
-	assert(fontAtlases);
-
-	Font regularFont = NULL, boldFont = NULL,
-		italicFont = NULL, boldItalicFont = NULL;
-
-	if (fontAtlases[0])
-	{
-		FontAtlas fontAtlas = fontAtlases[0];
-		regularFont = getFontAtlasRegularFonts(fontAtlas)[0];
-		boldFont = getFontAtlasBoldFonts(fontAtlas)[0];
-		italicFont = getFontAtlasItalicFonts(fontAtlas)[0];
-		boldItalicFont = getFontAtlasBoldItalicFonts(fontAtlas)[0];
-	}
-
-	destroyFontAtlas(fontAtlases[2]);
-	destroyFontAtlas(fontAtlases[1]);
-	destroyFontAtlas(fontAtlases[0]);
-	destroyFont(boldItalicFont);
-	destroyFont(italicFont);
-	destroyFont(boldFont);
-	destroyFont(regularFont);
+	assert(fonts);
+	destroyFont(fonts[3]);
+	destroyFont(fonts[2]);
+	destroyFont(fonts[1]);
+	destroyFont(fonts[0]);
 }
-inline static UserInterface createUserInterfaceInstance(
-	Logger logger,
-	ThreadPool threadPool,
-	Window window,
-	PackReader packReader)
+inline static UserInterface createUserInterfaceInstance(Engine engine)
 {
-	assert(logger);
-	assert(threadPool);
-	assert(window);
-	assert(packReader);
+	assert(engine);
+
+	Logger logger = engine->logger;
+	Window window = engine->window;
+	PackReader packReader = engine->packReader;
 
 	GraphicsPipeline panelPipeline = createPanelPipelineInstance(
 		logger, window, packReader);
@@ -540,10 +586,10 @@ inline static UserInterface createUserInterfaceInstance(
 		return NULL;
 	}
 
-	FontAtlas fontAtlases[ENGINE_FONT_ATLAS_COUNT];
+	Font fonts[4];
 
-	bool result = createFontAtlasInstances(
-		logger, packReader, textPipeline, fontAtlases);
+	bool result = createFontInstances(
+		logger, packReader, fonts);
 
 	if (!result)
 	{
@@ -552,16 +598,35 @@ inline static UserInterface createUserInterfaceInstance(
 		return NULL;
 	}
 
+	cmmt_float_t platformScale = getPlatformScale(
+		getGraphicsPipelineFramebuffer(textPipeline));
+
+	uint32_t fontSizes[ENGINE_FONT_ATLAS_COUNT] = {
+		12, 14, 16,
+	};
+
+	for (size_t i = 0; i < ENGINE_FONT_ATLAS_COUNT; i++)
+		fontSizes[i] = getPlatformFontSize(platformScale, fontSizes[i]);
+
 	UserInterface ui;
 
+	// Font atlases are created by the UI on the first use.
 	MpgxResult mpgxResult = createUserInterface(
 		panelPipeline,
 		textPipeline,
-		fontAtlases,
+		&fonts[0],
+		&fonts[1],
+		&fonts[2],
+		&fonts[3],
+		1,
+		fontSizes,
 		ENGINE_FONT_ATLAS_COUNT,
+		onEngineFontAtlasCreate,
+		engine,
 		1.0f,
 		1,
-		threadPool,
+		engine->renderingThreadPool,
+		logger,
 		&ui);
 
 	if (mpgxResult != SUCCESS_MPGX_RESULT)
@@ -569,7 +634,7 @@ inline static UserInterface createUserInterfaceInstance(
 		logMessage(logger, ERROR_LOG_LEVEL,
 			"Failed to create user interface. (error: %s)",
 			mpgxResultToString(mpgxResult));
-		destroyFontAtlasInstances(fontAtlases);
+		destroyFontInstances(fonts);
 		destroyTextPipelineInstance(textPipeline);
 		destroyPanelPipelineInstance(panelPipeline);
 		return NULL;
@@ -582,13 +647,20 @@ inline static void destroyUserInterfaceInstance(UserInterface ui)
 	if (!ui)
 		return;
 
-	GraphicsPipeline panelPipeline = getGraphicsRendererPipeline(
-		getUserInterfacePanelRenderer(ui));
+	GraphicsPipeline panelPipeline =
+		getUserInterfacePanelPipeline(ui);
 	GraphicsPipeline textPipeline = getGraphicsRendererPipeline(
 		getUserInterfaceTextRenderer(ui));
-	FontAtlas* fontAtlases = getUserInterfaceFontAtlases(ui);
-	destroyFontAtlasInstances(fontAtlases);
+
+	Font fonts[4] = {
+		getUserInterfaceRegularFonts(ui)[0],
+		getUserInterfaceBoldFonts(ui)[0],
+		getUserInterfaceItalicFonts(ui)[0],
+		getUserInterfaceBoldItalicFonts(ui)[0],
+	};
+
 	destroyUserInterface(ui);
+	destroyFontInstances(fonts);
 	destroyTextPipelineInstance(textPipeline);
 	destroyPanelPipelineInstance(panelPipeline);
 }
@@ -814,8 +886,20 @@ Engine createEngine(
 
 	engine->transformer = transformer;
 
-	UserInterface ui = createUserInterfaceInstance(
-		logger, renderingThreadPool, window, packReader);
+	const char* dataDirectoryPath = getDataDirectoryPath(appName);
+	size_t pathLength = strlen(dataDirectoryPath);
+	char* dataDirectoryPathCopy = malloc(pathLength + 1);
+
+	if (!dataDirectoryPathCopy)
+	{
+		destroyEngine(engine);
+		return NULL;
+	}
+
+	memcpy(dataDirectoryPathCopy, dataDirectoryPath, pathLength + 1);
+	engine->dataDirectoryPath = dataDirectoryPathCopy;
+
+	UserInterface ui = createUserInterfaceInstance(engine);
 
 	if (!ui)
 	{
@@ -863,6 +947,7 @@ void destroyEngine(Engine engine)
 	destroyUserInterfaceInstance(engine->ui);
 	destroyTransformer(engine->transformer);
 	destroyPackReader(engine->packReader);
+	free(engine->dataDirectoryPath);
 	destroyWindow(engine->window);
 	terminateText(engine->logger);
 	terminateGraphics();
@@ -13,11 +13,19 @@
 // limitations under the License.
 
 #include "uran/graphics_renderer.h"
+#include "uran/slab.h"
 #include "mpmt/atomic.h"
 
 #include <assert.h>
 #include <string.h>
 
+#define GRAPHICS_RENDERER_MERGE_COUNT 8
+
+// Inline render handle is stored after the render,
+// with the same alignment as the slab objects.
+#define GRAPHICS_RENDER_HANDLE_OFFSET \
+	((sizeof(GraphicsRender_T) + 15) & ~((size_t)15))
+
 struct GraphicsRender_T
 {
 	GraphicsRenderer renderer;
@@ -36,6 +44,9 @@ struct GraphicsRenderer_T
 	GraphicsPipeline pipeline;
 	OnGraphicsRenderDestroy onDestroy;
 	OnGraphicsRenderDraw onDraw;
+	OnGraphicsRendererFlush onFlush;
+	Slab renderSlab;
+	size_t handleSize;
 	GraphicsRender* renders;
 	GraphicsRenderElement* renderElements;
 	size_t renderCapacity;
@@ -54,12 +65,14 @@ GraphicsRenderer createGraphicsRenderer(
 	bool useCulling,
 	OnGraphicsRenderDestroy onDestroy,
 	OnGraphicsRenderDraw onDraw,
+	OnGraphicsRendererFlush onFlush,
+	size_t handleSize,
 	size_t capacity,
 	ThreadPool threadPool)
 {
 	assert(pipeline);
 	assert(sorting < GRAPHICS_RENDER_SORTING_COUNT);
-	assert(onDestroy);
+	assert(onDestroy || handleSize > 0);
 	assert(onDraw);
 	assert(capacity > 0);
 
@@ -72,6 +85,8 @@ GraphicsRenderer createGraphicsRenderer(
 	graphicsRenderer->pipeline = pipeline;
 	graphicsRenderer->onDestroy = onDestroy;
 	graphicsRenderer->onDraw = onDraw;
+	graphicsRenderer->onFlush = onFlush;
+	graphicsRenderer->handleSize = handleSize;
 	graphicsRenderer->threadPool = threadPool;
 	graphicsRenderer->sorting = sorting;
 	graphicsRenderer->useCulling = useCulling;
@@ -102,6 +117,21 @@ GraphicsRenderer createGraphicsRenderer(
 	}
 
 	graphicsRenderer->renderElements = renderElements;
+
+	// Renders and their inline handles are allocated
+	// from the blocks, so they are close in memory.
+	Slab renderSlab = createSlab(
+		handleSize > 0 ? GRAPHICS_RENDER_HANDLE_OFFSET +
+		handleSize : sizeof(GraphicsRender_T),
+		capacity);
+
+	if (!renderSlab)
+	{
+		destroyGraphicsRenderer(graphicsRenderer);
+		return NULL;
+	}
+
+	graphicsRenderer->renderSlab = renderSlab;
 	return graphicsRenderer;
 }
 void destroyGraphicsRenderer(GraphicsRenderer renderer)
@@ -112,6 +142,7 @@ void destroyGraphicsRenderer(GraphicsRenderer renderer)
 	assert(renderer->renderCount == 0);
 	assert(!renderer->isEnumerating);
 
+	destroySlab(renderer->renderSlab);
 	free(renderer->renderElements);
 	free(renderer->renders);
 	free(renderer);
@@ -132,6 +163,11 @@ OnGraphicsRenderDraw getGraphicsRendererOnDraw(GraphicsRenderer renderer)
 	assert(renderer);
 	return renderer->onDraw;
 }
+OnGraphicsRendererFlush getGraphicsRendererOnFlush(GraphicsRenderer renderer)
+{
+	assert(renderer);
+	return renderer->onFlush;
+}
 ThreadPool getGraphicsRendererThreadPool(GraphicsRenderer renderer)
 {
 	assert(renderer);
@@ -207,17 +243,19 @@ void destroyAllGraphicsRendererItems(
 	if (renderCount == 0)
 		return;
 
+	OnGraphicsRenderDestroy onDestroy = renderer->onDestroy;
+
 	for (size_t i = 0; i < renderCount; i++)
 	{
 		GraphicsRender render = renders[i];
-		renderer->onDestroy(render->handle);
 
+		if (onDestroy)
+			onDestroy(render->handle);
 		if (destroyTransforms)
 			destroyTransform(render->transform);
-
-		free(render);
 	}
 
+	resetSlab(renderer->renderSlab);
 	renderer->renderCount = 0;
 }
 
@@ -439,23 +477,21 @@ static void onRendererDraw(void* argument)
 		renderElements[index] = element;
 	}
 }
-GraphicsRendererResult drawGraphicsRenderer(
+/*
+ * Collects and sorts visible graphics renderer renders.
+ * Returns visible render count.
+ */
+inline static size_t prepareGraphicsRenderer(
 	GraphicsRenderer renderer,
 	const GraphicsRendererData* data)
 {
 	assert(renderer);
 	assert(data);
-	assert(!renderer->isEnumerating);
-
-	GraphicsRendererResult result;
-	result.drawCount = 0;
-	result.indexCount = 0;
-	result.passCount = 0;
 
 	size_t renderCount = renderer->renderCount;
 
 	if (!renderCount)
-		return result;
+		return 0;
 
 	Vec3F rendererPosition = negVec3F(
 		getTranslationMat4F(data->view));
@@ -522,7 +558,7 @@ GraphicsRendererResult drawGraphicsRenderer(
 	}
 
 	if (elementCount == 0)
-		return result;
+		return 0;
 
 	GraphicsRenderSorting sorting = renderer->sorting;
 
@@ -562,35 +598,207 @@ GraphicsRendererResult drawGraphicsRenderer(
 		}
 	}
 
+	return elementCount;
+}
+inline static void drawGraphicsRenderElement(
+	GraphicsRenderer renderer,
+	GraphicsRender render,
+	const Mat4F* viewProj,
+	GraphicsRendererResult* result)
+{
+	assert(renderer);
+	assert(render);
+	assert(viewProj);
+	assert(result);
+
+	Mat4F model = getTransformModel(
+		render->transform);
+
+	size_t indexCount = renderer->onDraw(
+		render,
+		renderer->pipeline,
+		&model,
+		viewProj);
+
+	if (indexCount > 0)
+	{
+		result->drawCount++;
+		result->indexCount += indexCount;
+	}
+}
+/*
+ * Draws renders deferred by the renderer draw function,
+ * has to be called before the pipeline is changed.
+ */
+inline static void flushGraphicsRenderer(
+	GraphicsRenderer renderer,
+	GraphicsRendererResult* result)
+{
+	assert(renderer);
+	assert(result);
+
+	if (!renderer->onFlush)
+		return;
+
+	size_t indexCount = renderer->onFlush(
+		renderer->pipeline);
+
+	if (indexCount > 0)
+	{
+		result->drawCount++;
+		result->indexCount += indexCount;
+	}
+}
+GraphicsRendererResult drawGraphicsRenderer(
+	GraphicsRenderer renderer,
+	const GraphicsRendererData* data)
+{
+	assert(renderer);
+	assert(data);
+	assert(!renderer->isEnumerating);
+
+	GraphicsRendererResult result;
+	result.drawCount = 0;
+	result.indexCount = 0;
+	result.passCount = 0;
+
+	size_t elementCount = prepareGraphicsRenderer(
+		renderer,
+		data);
+
+	if (elementCount == 0)
+		return result;
+
+	GraphicsRenderElement* renderElements = renderer->renderElements;
 	Mat4F viewProj = data->viewProj;
-	GraphicsPipeline pipeline = renderer->pipeline;
-	OnGraphicsRenderDraw onDraw = renderer->onDraw;
 
 	// TODO: also multi-thread this code,
 	// this is possible with Vulkan multiple command buffers
 
-	bindGraphicsPipeline(pipeline);
+	bindGraphicsPipeline(renderer->pipeline);
 
 	for (size_t i = 0; i < elementCount; i++)
 	{
-		GraphicsRender render = renderElements[i].render;
+		drawGraphicsRenderElement(
+			renderer,
+			renderElements[i].render,
+			&viewProj,
+			&result);
+	}
 
-		Mat4F model = getTransformModel(
-			render->transform);
+	flushGraphicsRenderer(renderer, &result);
+	return result;
+}
+GraphicsRendererResult drawGraphicsRenderers(
+	GraphicsRenderer* renderers,
+	size_t rendererCount,
+	const GraphicsRendererData* data)
+{
+	assert(renderers);
+	assert(rendererCount > 0);
+	assert(rendererCount <= GRAPHICS_RENDERER_MERGE_COUNT);
+	assert(data);
 
-		size_t indexCount = onDraw(
-			render,
-			pipeline,
-			&model,
-			&viewProj);
+	GraphicsRendererResult result;
+	result.drawCount = 0;
+	result.indexCount = 0;
+	result.passCount = 0;
+
+	GraphicsRenderSorting sorting = renderers[0]->sorting;
+	size_t elementCounts[GRAPHICS_RENDERER_MERGE_COUNT];
+	size_t elementIndices[GRAPHICS_RENDERER_MERGE_COUNT];
+
+	for (size_t i = 0; i < rendererCount; i++)
+	{
+		GraphicsRenderer renderer = renderers[i];
+		assert(renderer);
+		assert(!renderer->isEnumerating);
+		assert(renderer->sorting == sorting);
+
+		elementCounts[i] = prepareGraphicsRenderer(
+			renderer,
+			data);
+		elementIndices[i] = 0;
+	}
+
+	int(*compare)(const void*, const void*);
+
+	if (sorting == ASCENDING_GRAPHICS_RENDER_SORTING)
+		compare = ascendingRenderCompare;
+	else if (sorting == DESCENDING_GRAPHICS_RENDER_SORTING)
+		compare = descendingRenderCompare;
+	else if (sorting == UI_ASCENDING_GRAPHICS_RENDER_SORTING)
+		compare = uiAscendingRenderCompare;
+	else if (sorting == UI_DESCENDING_GRAPHICS_RENDER_SORTING)
+		compare = uiDescendingRenderCompare;
+	else
+		compare = NULL;
+
+	Mat4F viewProj = data->viewProj;
+	GraphicsRenderer boundRenderer = NULL;
+
+	// Sorted renders are merged, so they are drawn in the
+	// shared order, and pipeline is bound only on change.
+	// Earlier renderer is drawn first on the same distance.
+	// Renderers of one pipeline with the same flush function
+	// share its deferred draws, they are not flushed between.
+	while (true)
+	{
+		size_t rendererIndex = rendererCount;
 
-		if (indexCount > 0)
+		for (size_t i = 0; i < rendererCount; i++)
 		{
-			result.drawCount++;
-			result.indexCount += indexCount;
+			if (elementIndices[i] == elementCounts[i])
+				continue;
+
+			if (rendererIndex == rendererCount)
+			{
+				rendererIndex = i;
+
+				if (!compare)
+					break;
+				continue;
+			}
+
+			const GraphicsRenderElement* element =
+				&renderers[i]->renderElements[elementIndices[i]];
+			const GraphicsRenderElement* bestElement =
+				&renderers[rendererIndex]->renderElements[
+				elementIndices[rendererIndex]];
+
+			if (compare(bestElement, element) > 0)
+				rendererIndex = i;
 		}
+
+		if (rendererIndex == rendererCount)
+			break;
+
+		GraphicsRenderer renderer = renderers[rendererIndex];
+
+		if (!boundRenderer || renderer->pipeline != boundRenderer->pipeline)
+		{
+			if (boundRenderer)
+				flushGraphicsRenderer(boundRenderer, &result);
+
+			bindGraphicsPipeline(renderer->pipeline);
+		}
+		else if (renderer->onFlush != boundRenderer->onFlush)
+		{
+			flushGraphicsRenderer(boundRenderer, &result);
+		}
+
+		boundRenderer = renderer;
+
+		drawGraphicsRenderElement(
+			renderer,
+			renderer->renderElements[
+				elementIndices[rendererIndex]++].render,
+			&viewProj,
+			&result);
 	}
 
+	if (boundRenderer)
+		flushGraphicsRenderer(boundRenderer, &result);
 	return result;
 }
 
@@ -602,15 +810,21 @@ GraphicsRender createGraphicsRender(
 {
 	assert(renderer);
 	assert(transform);
-	assert(handle);
+	assert(handle || renderer->handleSize > 0);
 	assert(!renderer->isEnumerating);
 
-	GraphicsRender graphicsRender = malloc(
-		sizeof(GraphicsRender_T));
+	GraphicsRender graphicsRender = allocateSlabObject(
+		renderer->renderSlab);
 
 	if (!graphicsRender)
 		return NULL;
 
+	if (!handle)
+	{
+		handle = (uint8_t*)graphicsRender +
+			GRAPHICS_RENDER_HANDLE_OFFSET;
+	}
+
 	graphicsRender->renderer = renderer;
 	graphicsRender->transform = transform;
 	graphicsRender->handle = handle;
@@ -628,7 +842,7 @@ GraphicsRender createGraphicsRender(
 
 		if (!renders)
 		{
-			free(graphicsRender);
+			freeSlabObject(renderer->renderSlab, graphicsRender);
 			return NULL;
 		}
 
@@ -640,7 +854,7 @@ GraphicsRender createGraphicsRender(
 
 		if (!renderElements)
 		{
-			free(graphicsRender);
+			freeSlabObject(renderer->renderSlab, graphicsRender);
 			return NULL;
 		}
 
@@ -671,9 +885,10 @@ void destroyGraphicsRender(GraphicsRender render)
 		for (size_t j = i + 1; j < renderCount; j++)
 			renders[j - 1] = renders[j];
 
-		renderer->onDestroy(render->handle);
+		if (renderer->onDestroy)
+			renderer->onDestroy(render->handle);
 
-		free(render);
+		freeSlabObject(renderer->renderSlab, render);
 		renderer->renderCount--;
 		return;
 	}
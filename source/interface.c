@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include "uran/interface.h"
+#include "uran/slab.h"
 #include "mpmt/atomic.h"
 
 #include <assert.h>
@@ -22,6 +23,19 @@
 #undef interface
 #endif
 
+/*
+ * Interface grid cell size in the scaled units.
+ * Elements are added to the all overlapped cells.
+ */
+#define INTERFACE_GRID_CELL_SIZE 32
+
+typedef struct InterfaceGridCell
+{
+	InterfaceElement* elements;
+	size_t capacity;
+	size_t count;
+} InterfaceGridCell;
+
 struct InterfaceElement_T
 {
 	Interface interface;
@@ -31,19 +45,60 @@ struct InterfaceElement_T
 	Transform transform;
 	Vec3F position;
 	Box2F bounds;
+	Box2F gridBounds;
+	Vec4I gridCells;
+	uint64_t order;
+	size_t updateIndex;
+	InterfaceLayout layout;
+	InterfaceElement* layoutItems;
+	size_t layoutItemCapacity;
+	size_t layoutItemCount;
+	Vec2F arrangedSize;
+	InterfaceElement layoutParent;
+	Vec2F layoutBasis;
+	Vec2F layoutSize;
+	Vec2F layoutOffset;
+	cmmt_float_t grow;
+	cmmt_float_t shrink;
 	AlignmentType alignment;
 	bool isEnabled;
+	bool isInGrid;
+	bool isLayoutDirty;
+	bool isLayoutActive;
+	bool isResizable;
 };
 struct Interface_T
 {
 	Window window;
 	ThreadPool threadPool;
+	Transformer transformer;
+	Slab elementSlab;
 	InterfaceElement* elements;
 	size_t elementCapacity;
 	size_t elementCount;
+	InterfaceElement* layoutElements;
+	size_t layoutCapacity;
+	size_t layoutCount;
+	InterfaceElement* updateElements;
+	size_t updateCapacity;
+	size_t updateCount;
+	size_t updateEventCount;
+	size_t updatePosition;
+	InterfaceElement* changedElements;
+	InterfaceGridCell* gridCells;
+	Vec2I gridSize;
+	Vec2I gridWindowSize;
+	cmmt_float_t gridScale;
+	uint64_t gridVersion;
+	uint64_t layoutVersion;
+	Vec2F layoutWindowSize;
+	uint64_t elementOrder;
 	InterfaceElement lastElement;
 	cmmt_float_t scale;
 	bool isPressed;
+	bool isLayoutChanged;
+	bool isLayoutDirty;
+	bool isGridDirty;
 #ifndef NDEBUG
 	bool isEnumerating;
 #endif
@@ -67,6 +122,7 @@ Interface createInterface(
 
 	interface->window = window;
 	interface->threadPool = threadPool;
+	interface->transformer = NULL;
 	interface->scale = scale;
 	interface->lastElement = NULL;
 	interface->isPressed = false;
@@ -86,6 +142,48 @@ Interface createInterface(
 	interface->elements = elements;
 	interface->elementCapacity = capacity;
 	interface->elementCount = 0;
+
+	Slab elementSlab = createSlab(
+		sizeof(InterfaceElement_T),
+		capacity);
+
+	if (!elementSlab)
+	{
+		destroyInterface(interface);
+		return NULL;
+	}
+
+	interface->elementSlab = elementSlab;
+
+	InterfaceElement* changedElements = malloc(
+		sizeof(InterfaceElement) * capacity);
+
+	if (!changedElements)
+	{
+		destroyInterface(interface);
+		return NULL;
+	}
+
+	interface->changedElements = changedElements;
+	interface->layoutElements = NULL;
+	interface->layoutCapacity = 0;
+	interface->layoutCount = 0;
+	interface->isLayoutChanged = false;
+	interface->isLayoutDirty = false;
+	interface->layoutVersion = 0;
+	interface->layoutWindowSize = zeroVec2F;
+	interface->updateElements = NULL;
+	interface->updateCapacity = 0;
+	interface->updateCount = 0;
+	interface->updateEventCount = 0;
+	interface->updatePosition = 0;
+	interface->gridCells = NULL;
+	interface->gridSize = zeroVec2I;
+	interface->gridWindowSize = zeroVec2I;
+	interface->gridScale = (cmmt_float_t)0.0;
+	interface->gridVersion = 0;
+	interface->isGridDirty = true;
+	interface->elementOrder = 0;
 	return interface;
 }
 void destroyInterface(Interface interface)
@@ -96,6 +194,22 @@ void destroyInterface(Interface interface)
 	assert(interface->elementCount == 0);
 	assert(!interface->isEnumerating);
 
+	InterfaceGridCell* gridCells = interface->gridCells;
+
+	if (gridCells)
+	{
+		size_t cellCount = (size_t)interface->gridSize.x *
+			(size_t)interface->gridSize.y;
+
+		for (size_t i = 0; i < cellCount; i++)
+			free(gridCells[i].elements);
+		free(gridCells);
+	}
+
+	destroySlab(interface->elementSlab);
+	free(interface->layoutElements);
+	free(interface->changedElements);
+	free(interface->updateElements);
 	free(interface->elements);
 	free(interface);
 }
@@ -252,10 +366,23 @@ void destroyAllInterfaceElements(
 		if (destroyTransforms)
 			destroyTransform(element->transform);
 
-		free(element);
+		free(element->layoutItems);
 	}
 
+	resetSlab(interface->elementSlab);
+
+	InterfaceGridCell* gridCells = interface->gridCells;
+	size_t cellCount = (size_t)interface->gridSize.x *
+		(size_t)interface->gridSize.y;
+
+	for (size_t i = 0; i < cellCount; i++)
+		gridCells[i].count = 0;
+
 	interface->elementCount = 0;
+	interface->layoutCount = 0;
+	interface->updateCount = 0;
+	interface->updateEventCount = 0;
+	interface->lastElement = NULL;
 }
 
 Camera createInterfaceCamera(
@@ -330,9 +457,27 @@ inline static void updateInterfaceElementPosition(
 		}
 	}
 
-	AlignmentType alignment = element->alignment;
 	Vec3F position = element->position;
 
+	if (element->layoutParent)
+	{
+		// Layout offset is the bounds center, which
+		// is not the origin for the aligned text.
+		Box2F bounds = element->bounds;
+		Vec3F scale = getTransformScale(transform);
+		Vec2F layoutOffset = element->layoutOffset;
+
+		setTransformPosition(transform, vec3F(
+			layoutOffset.x - (bounds.minimum.x + bounds.maximum.x) *
+				scale.x * (cmmt_float_t)0.5,
+			layoutOffset.y - (bounds.minimum.y + bounds.maximum.y) *
+				scale.y * (cmmt_float_t)0.5,
+			position.z));
+		return;
+	}
+
+	AlignmentType alignment = element->alignment;
+
 	switch (alignment)
 	{
 	default:
@@ -434,261 +579,1344 @@ static void onInterfacePositionsUpdate(void* argument)
 			false);
 	}
 }
-void updateInterface(Interface interface)
+inline static bool isInterfaceElementActive(
+	InterfaceElement element)
 {
-	assert(interface);
-
-	InterfaceElement* elements = interface->elements;
-	size_t elementCount = interface->elementCount;
-	Window window = interface->window;
-
-	if (elementCount == 0)
-		return;
-
-	cmmt_float_t interfaceScale = interface->scale;
-	Vec2I windowSize = getWindowSize(window);
-	Vec2F cursorPosition = getWindowCursorPosition(window);
+	assert(element);
 
-	Vec2F size = vec2F(
-		(cmmt_float_t)windowSize.x / interfaceScale,
-		(cmmt_float_t)windowSize.y / interfaceScale);
-	Vec2F halfSize = mulValVec2F(size, (cmmt_float_t)0.5);
+	Transform transform = element->transform;
 
-	cursorPosition = vec2F(
-		(cursorPosition.x / interfaceScale) - halfSize.x,
-		(size.y - (cursorPosition.y / interfaceScale)) - halfSize.y);
+	if (!element->isEnabled | !isTransformActive(transform))
+		return false;
 
-	InterfaceElement newElement = NULL;
-	cmmt_float_t elementDistance = INFINITY;
+	Transform parent = getTransformParent(transform);
 
-	for (size_t i = 0; i < elementCount; i++)
+	while (parent)
 	{
-		InterfaceElement element = elements[i];
-		Transform transform = element->transform;
-
-		if (!element->isEnabled | !isTransformActive(transform))
-			continue;
-
-		Transform parent = getTransformParent(transform);
+		if (!isTransformActive(parent))
+			return false;
+		parent = getTransformParent(parent);
+	}
 
-		while (parent)
-		{
-			if (!isTransformActive(parent))
-				goto CONTINUE;
-			parent = getTransformParent(parent);
-		}
+	return true;
+}
+inline static Box2F getInterfaceElementWorldBounds(
+	InterfaceElement element,
+	Vec3F position)
+{
+	assert(element);
 
-		if (element->events.onUpdate)
-			element->events.onUpdate(element);
+	Vec3F scale = getTransformScale(element->transform);
+	Box2F bounds = element->bounds;
+
+	bounds.minimum = vec2F(
+		bounds.minimum.x * scale.x,
+		bounds.minimum.y * scale.y);
+	bounds.minimum = vec2F(
+		bounds.minimum.x + position.x,
+		bounds.minimum.y + position.y);
+	bounds.maximum = vec2F(
+		bounds.maximum.x * scale.x,
+		bounds.maximum.y * scale.y);
+	bounds.maximum = vec2F(
+		bounds.maximum.x + position.x,
+		bounds.maximum.y + position.y);
+	return bounds;
+}
+inline static int32_t getInterfaceGridCell(
+	cmmt_float_t position,
+	cmmt_float_t halfSize,
+	int32_t gridSize)
+{
+	cmmt_float_t cell = (position + halfSize) /
+		(cmmt_float_t)INTERFACE_GRID_CELL_SIZE;
+
+	// Outside bounds are clamped to the border cells.
+	if (!(cell > (cmmt_float_t)0.0))
+		return 0;
+	if (cell >= (cmmt_float_t)gridSize)
+		return gridSize - 1;
+	return (int32_t)cell;
+}
+inline static Vec4I getInterfaceGridCells(
+	Interface interface,
+	Box2F bounds,
+	Vec2F halfSize)
+{
+	assert(interface);
 
-		Vec3F position = getTranslationMat4F(
-			getTransformModel(transform));
-		Vec3F scale = getTransformScale(transform);
+	Vec2I gridSize = interface->gridSize;
 
-		Box2F bounds = element->bounds;
+	return vec4I(
+		getInterfaceGridCell(bounds.minimum.x, halfSize.x, gridSize.x),
+		getInterfaceGridCell(bounds.minimum.y, halfSize.y, gridSize.y),
+		getInterfaceGridCell(bounds.maximum.x, halfSize.x, gridSize.x),
+		getInterfaceGridCell(bounds.maximum.y, halfSize.y, gridSize.y));
+}
+inline static void removeInterfaceGridElement(
+	Interface interface,
+	InterfaceElement element)
+{
+	assert(interface);
+	assert(element);
+	assert(element->isInGrid);
 
-		bounds.minimum = vec2F(
-			bounds.minimum.x * scale.x,
-			bounds.minimum.y * scale.y);
-		bounds.minimum = vec2F(
-			bounds.minimum.x + position.x,
-			bounds.minimum.y + position.y);
-		bounds.maximum = vec2F(
-			bounds.maximum.x * scale.x,
-			bounds.maximum.y * scale.y);
-		bounds.maximum = vec2F(
-			bounds.maximum.x + position.x,
-			bounds.maximum.y + position.y);
-
-		if (!isPointInBox2F(bounds, cursorPosition))
-			continue;
+	InterfaceGridCell* gridCells = interface->gridCells;
+	int32_t gridSizeX = interface->gridSize.x;
+	Vec4I cells = element->gridCells;
 
-		if (newElement)
+	for (int32_t y = cells.y; y <= cells.w; y++)
+	{
+		for (int32_t x = cells.x; x <= cells.z; x++)
 		{
-			if (position.z < elementDistance)
+			InterfaceGridCell* cell = &gridCells[
+				(size_t)y * gridSizeX + x];
+			InterfaceElement* elements = cell->elements;
+			size_t count = cell->count;
+
+			for (size_t i = 0; i < count; i++)
 			{
-				newElement = element;
-				elementDistance = position.z;
+				if (elements[i] != element)
+					continue;
+
+				elements[i] = elements[count - 1];
+				cell->count = count - 1;
+				break;
 			}
 		}
-		else
-		{
-			newElement = element;
-		}
-
-	CONTINUE:
-		continue;
 	}
 
-	if (isWindowFocused(window) && getWindowCursorMode(window) == DEFAULT_CURSOR_MODE)
-	{
-		bool isLeftButtonPressed = getWindowMouseButton(
-			window, LEFT_MOUSE_BUTTON);
-		InterfaceElement lastElement = interface->lastElement;
-
-		bool isChanged;
-
-		if (isLeftButtonPressed)
-		{
-			if (!interface->isPressed)
-			{
-				isChanged = true;
-				interface->isPressed = true;
-			}
-			else
-			{
-				isChanged = false;
-			}
-		}
-		else
-		{
-			if (interface->isPressed)
-			{
-				isChanged = true;
-				interface->isPressed = false;
-			}
-			else
-			{
-				isChanged = false;
-			}
-		}
+	element->isInGrid = false;
+}
+inline static bool addInterfaceGridElement(
+	Interface interface,
+	InterfaceElement element,
+	Vec2F halfSize)
+{
+	assert(interface);
+	assert(element);
+	assert(!element->isInGrid);
 
-		if (lastElement)
-		{
-			if (lastElement != newElement)
-			{
-				interface->lastElement = newElement;
+	InterfaceGridCell* gridCells = interface->gridCells;
+	int32_t gridSizeX = interface->gridSize.x;
 
-				if (lastElement->events.onExit)
-					lastElement->events.onExit(lastElement);
-				if (newElement && newElement->events.onEnter)
-					newElement->events.onEnter(newElement);
-			}
-			else
-			{
-				if (isLeftButtonPressed)
-				{
-					if (isChanged)
-					{
-						if (lastElement->events.onPress)
-							lastElement->events.onPress(lastElement);
-					}
-					else
-					{
-						if (lastElement->events.onStay)
-							lastElement->events.onStay(lastElement);
-					}
-				}
-				else
-				{
-					if (isChanged)
-					{
-						if (lastElement->events.onRelease)
-							lastElement->events.onRelease(lastElement);
-					}
-					else
-					{
-						if (lastElement->events.onStay)
-							lastElement->events.onStay(lastElement);
-					}
-				}
-			}
-		}
-		else
-		{
-			if (newElement)
-			{
-				interface->lastElement = newElement;
+	Vec4I cells = getInterfaceGridCells(
+		interface,
+		element->gridBounds,
+		halfSize);
 
-				if (newElement->events.onEnter)
-					newElement->events.onEnter(newElement);
-			}
-		}
-	}
-	else
+	// Cells are reserved first, to not leave
+	// partially added element on failure.
+	for (int32_t y = cells.y; y <= cells.w; y++)
 	{
-		if (interface->lastElement)
+		for (int32_t x = cells.x; x <= cells.z; x++)
 		{
-			InterfaceElement lastElement = interface->lastElement;
-			interface->lastElement = NULL;
+			InterfaceGridCell* cell = &gridCells[
+				(size_t)y * gridSizeX + x];
 
-			if (lastElement->events.onExit)
-				lastElement->events.onExit(lastElement);
-		}
-	}
+			if (cell->count < cell->capacity)
+				continue;
 
-	ThreadPool threadPool = interface->threadPool;
+			size_t capacity = cell->capacity > 0 ?
+				cell->capacity * 2 : 4;
 
-	if (threadPool && elementCount >= getThreadPoolThreadCount(threadPool))
-	{
-		size_t threadCount = getThreadPoolThreadCount(threadPool);
+			InterfaceElement* elements = realloc(
+				cell->elements,
+				sizeof(InterfaceElement) * capacity);
 
-		UpdateData data = {
-			interface,
-			0,
-		};
-		ThreadPoolTask task = {
-			onInterfacePositionsUpdate,
-			&data,
-		};
-		addThreadPoolTaskNumber(
-			threadPool,
-			task,
-			threadCount);
-		waitThreadPool(threadPool);
+			if (!elements)
+				return false;
+
+			cell->elements = elements;
+			cell->capacity = capacity;
+		}
 	}
-	else
+
+	for (int32_t y = cells.y; y <= cells.w; y++)
 	{
-		for (size_t i = 0; i < elementCount; i++)
+		for (int32_t x = cells.x; x <= cells.z; x++)
 		{
-			InterfaceElement element = elements[i];
-			Transform transform = element->transform;
-
-			if (!isTransformActive(transform))
-				continue;
-
-			updateInterfaceElementPosition(
-				element,
-				transform,
-				halfSize,
-				false);
+			InterfaceGridCell* cell = &gridCells[
+				(size_t)y * gridSizeX + x];
+			cell->elements[cell->count++] = element;
 		}
 	}
-}
 
-InterfaceElement createInterfaceElement(
+	element->gridCells = cells;
+	element->isInGrid = true;
+	return true;
+}
+/*
+ * Recreates interface grid cells, all
+ * elements are added again by the update.
+ */
+inline static void resizeInterfaceGrid(
 	Interface interface,
-	Transform transform,
-	AlignmentType alignment,
-	Vec3F position,
-	Box2F bounds,
-	bool isEnabled,
-	OnInterfaceElementDestroy onDestroy,
-	const InterfaceElementEvents* events,
-	void* handle)
+	Vec2I windowSize,
+	Vec2F size)
 {
 	assert(interface);
-	assert(transform);
-	assert(alignment < ALIGNMENT_TYPE_COUNT);
-	assert(onDestroy);
-	assert(handle);
-	assert(!interface->isEnumerating);
 
-	InterfaceElement element = malloc(
-		sizeof(InterfaceElement_T));
+	InterfaceElement* elements = interface->elements;
+	size_t elementCount = interface->elementCount;
 
-	if (!element)
-		return NULL;
+	for (size_t i = 0; i < elementCount; i++)
+		elements[i]->isInGrid = false;
 
-	element->interface = interface;
+	InterfaceGridCell* gridCells = interface->gridCells;
+	Vec2I gridSize = interface->gridSize;
+	size_t cellCount = (size_t)gridSize.x * (size_t)gridSize.y;
+
+	Vec2I newGridSize = vec2I(
+		(int32_t)ceil(size.x / (cmmt_float_t)INTERFACE_GRID_CELL_SIZE),
+		(int32_t)ceil(size.y / (cmmt_float_t)INTERFACE_GRID_CELL_SIZE));
+
+	if (newGridSize.x < 1)
+		newGridSize.x = 1;
+	if (newGridSize.y < 1)
+		newGridSize.y = 1;
+
+	interface->gridWindowSize = windowSize;
+	interface->gridScale = interface->scale;
+
+	if (gridCells && newGridSize.x == gridSize.x &&
+		newGridSize.y == gridSize.y)
+	{
+		for (size_t i = 0; i < cellCount; i++)
+			gridCells[i].count = 0;
+		return;
+	}
+
+	for (size_t i = 0; i < cellCount; i++)
+		free(gridCells[i].elements);
+	free(gridCells);
+
+	// Elements are scanned without the grid on failure.
+	gridCells = calloc(
+		(size_t)newGridSize.x * (size_t)newGridSize.y,
+		sizeof(InterfaceGridCell));
+
+	interface->gridCells = gridCells;
+	interface->gridSize = gridCells ? newGridSize : zeroVec2I;
+}
+
+typedef struct GridData
+{
+	Interface interface;
+	atomic_int64 threadIndex;
+	atomic_int64 changedCount;
+} GridData;
+inline static void checkInterfaceElementBounds(
+	InterfaceElement element,
+	GridData* data)
+{
+	assert(element);
+	assert(data);
+
+	Transform transform = element->transform;
+
+	if (!isTransformActive(transform))
+		return;
+
+	Vec3F position = getTranslationMat4F(
+		getTransformModel(transform));
+	Box2F bounds = getInterfaceElementWorldBounds(
+		element,
+		position);
+	Box2F gridBounds = element->gridBounds;
+
+	if (element->isInGrid &&
+		bounds.minimum.x == gridBounds.minimum.x &&
+		bounds.minimum.y == gridBounds.minimum.y &&
+		bounds.maximum.x == gridBounds.maximum.x &&
+		bounds.maximum.y == gridBounds.maximum.y)
+	{
+		return;
+	}
+
+	element->gridBounds = bounds;
+
+	size_t index = (size_t)atomicFetchAdd64(
+		&data->changedCount, 1);
+	data->interface->changedElements[index] = element;
+}
+static void onInterfaceBoundsCheck(void* argument)
+{
+	assert(argument);
+
+	GridData* data = (GridData*)argument;
+	Interface interface = data->interface;
+	InterfaceElement* elements = interface->elements;
+	size_t elementCount = interface->elementCount;
+
+	size_t threadCount = getThreadPoolThreadCount(
+		interface->threadPool);
+	size_t threadIndex = (size_t)atomicFetchAdd64(
+		&data->threadIndex, 1);
+
+	for (size_t i = threadIndex; i < elementCount; i += threadCount)
+		checkInterfaceElementBounds(elements[i], data);
+}
+/*
+ * Moves elements with the changed bounds
+ * in the grid. Bounds are only compared,
+ * so unchanged elements are not touched.
+ * Nothing is checked until transforms,
+ * bounds, scale or window size are changed.
+ */
+inline static void updateInterfaceGrid(
+	Interface interface,
+	Vec2I windowSize,
+	Vec2F size,
+	Vec2F halfSize)
+{
+	assert(interface);
+
+	bool isChanged = false;
+
+	if (windowSize.x != interface->gridWindowSize.x ||
+		windowSize.y != interface->gridWindowSize.y ||
+		interface->scale != interface->gridScale)
+	{
+		resizeInterfaceGrid(
+			interface,
+			windowSize,
+			size);
+		isChanged = true;
+	}
+
+	if (!interface->gridCells)
+		return;
+
+	uint64_t version = getTransformerVersion(
+		interface->transformer);
+
+	if (version != interface->gridVersion)
+		isChanged = true;
+
+	if (!isChanged && !interface->isGridDirty)
+		return;
+
+	// Models are baked after the interface update, so
+	// changed transforms are checked again on the next.
+	interface->gridVersion = version;
+	interface->isGridDirty = isChanged;
+
+	InterfaceElement* elements = interface->elements;
+	size_t elementCount = interface->elementCount;
+	ThreadPool threadPool = interface->threadPool;
+
+	GridData data = {
+		interface,
+		0,
+		0,
+	};
+
+	if (threadPool && elementCount >= getThreadPoolThreadCount(threadPool))
+	{
+		size_t threadCount = getThreadPoolThreadCount(threadPool);
+
+		ThreadPoolTask task = {
+			onInterfaceBoundsCheck,
+			&data,
+		};
+		addThreadPoolTaskNumber(
+			threadPool,
+			task,
+			threadCount);
+		waitThreadPool(threadPool);
+	}
+	else
+	{
+		for (size_t i = 0; i < elementCount; i++)
+			checkInterfaceElementBounds(elements[i], &data);
+	}
+
+	InterfaceElement* changedElements = interface->changedElements;
+	size_t changedCount = (size_t)data.changedCount;
+
+	// Failed element is not in the grid, so it is added again
+	// on the next update. Until then it can not be hovered.
+	for (size_t i = 0; i < changedCount; i++)
+	{
+		InterfaceElement element = changedElements[i];
+
+		if (element->isInGrid)
+			removeInterfaceGridElement(interface, element);
+
+		if (!addInterfaceGridElement(interface, element, halfSize))
+			interface->isGridDirty = true;
+	}
+}
+inline static void checkHoveredElement(
+	InterfaceElement element,
+	Vec2F cursorPosition,
+	InterfaceElement* newElement,
+	cmmt_float_t* elementDistance)
+{
+	assert(element);
+	assert(newElement);
+	assert(elementDistance);
+
+	if (!isInterfaceElementActive(element))
+		return;
+
+	Vec3F position = getTranslationMat4F(
+		getTransformModel(element->transform));
+	Box2F bounds = getInterfaceElementWorldBounds(
+		element,
+		position);
+
+	if (!isPointInBox2F(bounds, cursorPosition))
+		return;
+
+	InterfaceElement lastElement = *newElement;
+
+	// Element created first is preferred at the same
+	// distance, grid cell order is not stable.
+	if (lastElement)
+	{
+		if (position.z < *elementDistance ||
+			(position.z == *elementDistance &&
+			element->order < lastElement->order))
+		{
+			*newElement = element;
+			*elementDistance = position.z;
+		}
+	}
+	else
+	{
+		*newElement = element;
+		*elementDistance = position.z;
+	}
+}
+inline static size_t getTransformDepth(Transform transform)
+{
+	assert(transform);
+
+	Transform parent = getTransformParent(transform);
+	size_t depth = 0;
+
+	while (parent)
+	{
+		parent = getTransformParent(parent);
+		depth++;
+	}
+
+	return depth;
+}
+inline static void markInterfaceLayoutDirty(
+	InterfaceElement container)
+{
+	assert(container);
+	container->isLayoutDirty = true;
+	container->interface->isLayoutDirty = true;
+}
+inline static bool addInterfaceLayoutItem(
+	InterfaceElement container,
+	InterfaceElement item)
+{
+	assert(container);
+	assert(item);
+
+	size_t count = container->layoutItemCount;
+
+	if (count == container->layoutItemCapacity)
+	{
+		size_t capacity = count > 0 ? count * 2 : 4;
+
+		InterfaceElement* layoutItems = realloc(
+			container->layoutItems,
+			sizeof(InterfaceElement) * capacity);
+
+		if (!layoutItems)
+			return false;
+
+		container->layoutItems = layoutItems;
+		container->layoutItemCapacity = capacity;
+	}
+
+	container->layoutItems[count] = item;
+	container->layoutItemCount = count + 1;
+	item->layoutParent = container;
+	markInterfaceLayoutDirty(container);
+	return true;
+}
+/*
+ * Finds elements of the layout containers, containers
+ * are sorted by the transform depth, parents first.
+ */
+inline static bool updateInterfaceLayoutItems(Interface interface)
+{
+	assert(interface);
+
+	InterfaceElement* layoutElements = interface->layoutElements;
+	size_t layoutCount = interface->layoutCount;
+
+	for (size_t i = 1; i < layoutCount; i++)
+	{
+		InterfaceElement layoutElement = layoutElements[i];
+		size_t depth = getTransformDepth(layoutElement->transform);
+		size_t j = i;
+
+		while (j > 0 && getTransformDepth(
+			layoutElements[j - 1]->transform) > depth)
+		{
+			layoutElements[j] = layoutElements[j - 1];
+			j--;
+		}
+
+		layoutElements[j] = layoutElement;
+	}
+
+	for (size_t i = 0; i < layoutCount; i++)
+	{
+		InterfaceElement layoutElement = layoutElements[i];
+		layoutElement->layoutItemCount = 0;
+		markInterfaceLayoutDirty(layoutElement);
+	}
+
+	InterfaceElement* elements = interface->elements;
+	size_t elementCount = interface->elementCount;
+
+	// Cleared before the search, so on failure no element
+	// points to a container that does not contain it.
+	for (size_t i = 0; i < elementCount; i++)
+		elements[i]->layoutParent = NULL;
+
+	for (size_t i = 0; i < elementCount; i++)
+	{
+		InterfaceElement element = elements[i];
+		Transform parent = getTransformParent(element->transform);
+
+		if (!parent)
+			continue;
+
+		for (size_t j = 0; j < layoutCount; j++)
+		{
+			InterfaceElement layoutElement = layoutElements[j];
+
+			if (layoutElement->transform != parent)
+				continue;
+
+			if (!addInterfaceLayoutItem(layoutElement, element))
+				return false;
+			break;
+		}
+	}
+
+	interface->isLayoutChanged = false;
+	return true;
+}
+inline static bool isInterfaceLayoutResizable(
+	InterfaceElement element)
+{
+	assert(element);
+	return element->isResizable &&
+		(element->layout.type == NO_INTERFACE_LAYOUT_TYPE ||
+		!element->layout.isFitting);
+}
+/*
+ * Returns layout element size, which is the element
+ * bounds size, scale is not the size for the text.
+ */
+inline static Vec2F getInterfaceLayoutItemSize(
+	InterfaceElement item)
+{
+	assert(item);
+	Box2F bounds = item->bounds;
+	Vec3F scale = getTransformScale(item->transform);
+
+	return vec2F(
+		(bounds.maximum.x - bounds.minimum.x) * scale.x,
+		(bounds.maximum.y - bounds.minimum.y) * scale.y);
+}
+inline static cmmt_float_t alignInterfaceLayoutX(
+	AlignmentType alignment,
+	cmmt_float_t center,
+	cmmt_float_t space,
+	cmmt_float_t size)
+{
+	switch (alignment)
+	{
+	default:
+		return center;
+	case LEFT_ALIGNMENT_TYPE:
+	case LEFT_BOTTOM_ALIGNMENT_TYPE:
+	case LEFT_TOP_ALIGNMENT_TYPE:
+		return center + (size - space) * (cmmt_float_t)0.5;
+	case RIGHT_ALIGNMENT_TYPE:
+	case RIGHT_BOTTOM_ALIGNMENT_TYPE:
+	case RIGHT_TOP_ALIGNMENT_TYPE:
+		return center + (space - size) * (cmmt_float_t)0.5;
+	}
+}
+inline static cmmt_float_t alignInterfaceLayoutY(
+	AlignmentType alignment,
+	cmmt_float_t center,
+	cmmt_float_t space,
+	cmmt_float_t size)
+{
+	switch (alignment)
+	{
+	default:
+		return center;
+	case BOTTOM_ALIGNMENT_TYPE:
+	case LEFT_BOTTOM_ALIGNMENT_TYPE:
+	case RIGHT_BOTTOM_ALIGNMENT_TYPE:
+		return center + (size - space) * (cmmt_float_t)0.5;
+	case TOP_ALIGNMENT_TYPE:
+	case LEFT_TOP_ALIGNMENT_TYPE:
+	case RIGHT_TOP_ALIGNMENT_TYPE:
+		return center + (space - size) * (cmmt_float_t)0.5;
+	}
+}
+inline static Vec2F measureInterfaceLayout(
+	InterfaceElement element)
+{
+	assert(element);
+
+	const InterfaceLayout* layout = &element->layout;
+	InterfaceElement* layoutItems = element->layoutItems;
+	size_t layoutItemCount = element->layoutItemCount;
+	cmmt_float_t spacing = layout->spacing;
+	Vec2F size = zeroVec2F;
+	size_t activeCount = 0;
+
+	if (layout->type == GRID_INTERFACE_LAYOUT_TYPE)
+	{
+		size_t columnCount = layout->columnCount > 0 ?
+			layout->columnCount : 1;
+		cmmt_float_t cellWidth = (cmmt_float_t)0.0;
+		cmmt_float_t rowHeight = (cmmt_float_t)0.0;
+
+		for (size_t i = 0; i < layoutItemCount; i++)
+		{
+			InterfaceElement item = layoutItems[i];
+
+			if (!item->isLayoutActive)
+				continue;
+
+			Vec2F basis = item->layoutBasis;
+
+			if (cellWidth < basis.x)
+				cellWidth = basis.x;
+			if (rowHeight < basis.y)
+				rowHeight = basis.y;
+
+			if (++activeCount % columnCount == 0)
+			{
+				size.y += rowHeight;
+				rowHeight = (cmmt_float_t)0.0;
+			}
+		}
+
+		if (activeCount > 0)
+		{
+			size_t rowCount = (activeCount + columnCount - 1) / columnCount;
+			size.x = cellWidth * (cmmt_float_t)columnCount +
+				spacing * (cmmt_float_t)(columnCount - 1);
+			size.y += rowHeight + spacing * (cmmt_float_t)(rowCount - 1);
+		}
+	}
+	else
+	{
+		bool isVertical = layout->type == VERTICAL_INTERFACE_LAYOUT_TYPE;
+
+		for (size_t i = 0; i < layoutItemCount; i++)
+		{
+			InterfaceElement item = layoutItems[i];
+
+			if (!item->isLayoutActive)
+				continue;
+
+			Vec2F basis = item->layoutBasis;
+
+			if (isVertical)
+			{
+				size.y += basis.y;
+
+				if (size.x < basis.x)
+					size.x = basis.x;
+			}
+			else
+			{
+				size.x += basis.x;
+
+				if (size.y < basis.y)
+					size.y = basis.y;
+			}
+
+			activeCount++;
+		}
+
+		if (activeCount > 1)
+		{
+			cmmt_float_t spaces = spacing * (cmmt_float_t)(activeCount - 1);
+
+			if (isVertical)
+				size.y += spaces;
+			else
+				size.x += spaces;
+		}
+	}
+
+	Vec4F padding = layout->padding;
+	size.x += padding.x + padding.z;
+	size.y += padding.y + padding.w;
+	return size;
+}
+inline static void setInterfaceLayoutItemSize(
+	InterfaceElement item,
+	Vec2F size)
+{
+	assert(item);
+
+	Box2F bounds = item->bounds;
+	Vec2F boundsSize = vec2F(
+		bounds.maximum.x - bounds.minimum.x,
+		bounds.maximum.y - bounds.minimum.y);
+
+	if (item->isResizable && boundsSize.x > (cmmt_float_t)0.0 &&
+		boundsSize.y > (cmmt_float_t)0.0)
+	{
+		Transform transform = item->transform;
+		Vec3F scale = getTransformScale(transform);
+
+		Vec2F newScale = vec2F(
+			size.x / boundsSize.x,
+			size.y / boundsSize.y);
+
+		if (scale.x != newScale.x || scale.y != newScale.y)
+		{
+			setTransformScale(transform,
+				vec3F(newScale.x, newScale.y, scale.z));
+		}
+	}
+
+	// Read back, so rounded size is not a new content size.
+	item->layoutSize = getInterfaceLayoutItemSize(item);
+}
+inline static void arrangeInterfaceLayout(
+	InterfaceElement element,
+	Vec2F size)
+{
+	assert(element);
+
+	const InterfaceLayout* layout = &element->layout;
+	InterfaceElement* layoutItems = element->layoutItems;
+	size_t layoutItemCount = element->layoutItemCount;
+	cmmt_float_t spacing = layout->spacing;
+	Vec4F padding = layout->padding;
+
+	Vec2F space = vec2F(
+		size.x - (padding.x + padding.z),
+		size.y - (padding.y + padding.w));
+
+	if (space.x < (cmmt_float_t)0.0)
+		space.x = (cmmt_float_t)0.0;
+	if (space.y < (cmmt_float_t)0.0)
+		space.y = (cmmt_float_t)0.0;
+
+	Vec2F center = vec2F(
+		(padding.x - padding.z) * (cmmt_float_t)0.5,
+		(padding.y - padding.w) * (cmmt_float_t)0.5);
+
+	if (layout->type == GRID_INTERFACE_LAYOUT_TYPE)
+	{
+		size_t columnCount = layout->columnCount > 0 ?
+			layout->columnCount : 1;
+		cmmt_float_t cellWidth = (space.x - spacing *
+			(cmmt_float_t)(columnCount - 1)) / (cmmt_float_t)columnCount;
+
+		if (cellWidth < (cmmt_float_t)0.0)
+			cellWidth = (cmmt_float_t)0.0;
+
+		cmmt_float_t left = center.x - space.x * (cmmt_float_t)0.5;
+		cmmt_float_t top = center.y + space.y * (cmmt_float_t)0.5;
+		size_t i = 0;
+
+		while (i < layoutItemCount)
+		{
+			cmmt_float_t rowHeight = (cmmt_float_t)0.0;
+			size_t rowEnd = i, column = 0;
+
+			while (rowEnd < layoutItemCount && column < columnCount)
+			{
+				InterfaceElement item = layoutItems[rowEnd++];
+
+				if (!item->isLayoutActive)
+					continue;
+
+				if (rowHeight < item->layoutBasis.y)
+					rowHeight = item->layoutBasis.y;
+				column++;
+			}
+
+			cmmt_float_t cellY = top - rowHeight * (cmmt_float_t)0.5;
+			column = 0;
+
+			for (; i < rowEnd; i++)
+			{
+				InterfaceElement item = layoutItems[i];
+
+				if (!item->isLayoutActive)
+					continue;
+
+				Vec2F basis = item->layoutBasis;
+
+				cmmt_float_t cellX = left + (cellWidth + spacing) *
+					(cmmt_float_t)column + cellWidth * (cmmt_float_t)0.5;
+
+				item->layoutOffset = vec2F(
+					alignInterfaceLayoutX(item->alignment,
+						cellX, cellWidth, basis.x),
+					alignInterfaceLayoutY(item->alignment,
+						cellY, rowHeight, basis.y));
+				setInterfaceLayoutItemSize(item, basis);
+				column++;
+			}
+
+			if (column > 0)
+				top -= rowHeight + spacing;
+		}
+	}
+	else
+	{
+		bool isVertical = layout->type == VERTICAL_INTERFACE_LAYOUT_TYPE;
+		cmmt_float_t basisSum = (cmmt_float_t)0.0;
+		cmmt_float_t growSum = (cmmt_float_t)0.0;
+		cmmt_float_t shrinkSum = (cmmt_float_t)0.0;
+		size_t activeCount = 0;
+
+		for (size_t i = 0; i < layoutItemCount; i++)
+		{
+			InterfaceElement item = layoutItems[i];
+
+			if (!item->isLayoutActive)
+				continue;
+
+			cmmt_float_t basis = isVertical ?
+				item->layoutBasis.y : item->layoutBasis.x;
+			basisSum += basis;
+
+			if (isInterfaceLayoutResizable(item))
+			{
+				growSum += item->grow;
+				shrinkSum += item->shrink * basis;
+			}
+
+			activeCount++;
+		}
+
+		cmmt_float_t freeSpace = (isVertical ? space.y : space.x) - basisSum;
+
+		if (activeCount > 1)
+			freeSpace -= spacing * (cmmt_float_t)(activeCount - 1);
+
+		cmmt_float_t position = isVertical ?
+			center.y + space.y * (cmmt_float_t)0.5 :
+			center.x - space.x * (cmmt_float_t)0.5;
+
+		for (size_t i = 0; i < layoutItemCount; i++)
+		{
+			InterfaceElement item = layoutItems[i];
+
+			if (!item->isLayoutActive)
+				continue;
+
+			Vec2F itemSize = item->layoutBasis;
+			cmmt_float_t basis = isVertical ? itemSize.y : itemSize.x;
+			cmmt_float_t mainSize = basis;
+
+			// Free space is shared by the grow factors, and
+			// overflow is removed by the shrink factors and size.
+			if (isInterfaceLayoutResizable(item))
+			{
+				if (freeSpace > (cmmt_float_t)0.0 && growSum > (cmmt_float_t)0.0)
+				{
+					mainSize += freeSpace * (item->grow / growSum);
+				}
+				else if (freeSpace < (cmmt_float_t)0.0 && shrinkSum > (cmmt_float_t)0.0)
+				{
+					mainSize += freeSpace * (item->shrink * basis / shrinkSum);
+
+					if (mainSize < (cmmt_float_t)0.0)
+						mainSize = (cmmt_float_t)0.0;
+				}
+			}
+
+			if (isVertical)
+			{
+				itemSize.y = mainSize;
+				item->layoutOffset = vec2F(
+					alignInterfaceLayoutX(item->alignment,
+						center.x, space.x, itemSize.x),
+					position - mainSize * (cmmt_float_t)0.5);
+				position -= mainSize + spacing;
+			}
+			else
+			{
+				itemSize.x = mainSize;
+				item->layoutOffset = vec2F(
+					position + mainSize * (cmmt_float_t)0.5,
+					alignInterfaceLayoutY(item->alignment,
+						center.y, space.y, itemSize.y));
+				position += mainSize + spacing;
+			}
+
+			setInterfaceLayoutItemSize(item, itemSize);
+		}
+	}
+}
+/*
+ * Arranges only layout containers whose elements
+ * are changed, or which size or layout is changed.
+ */
+inline static void updateInterfaceLayouts(
+	Interface interface,
+	Vec2F size)
+{
+	assert(interface);
+
+	size_t layoutCount = interface->layoutCount;
+
+	if (layoutCount == 0)
+		return;
+
+	if (interface->isLayoutChanged &&
+		!updateInterfaceLayoutItems(interface))
+	{
+		return;
+	}
+
+	uint64_t version = getTransformerVersion(
+		interface->transformer);
+	Vec2F windowSize = interface->layoutWindowSize;
+
+	// Item sizes and activity are changed only through the
+	// transforms, other changes mark the container dirty.
+	if (!interface->isLayoutDirty && version == interface->layoutVersion &&
+		size.x == windowSize.x && size.y == windowSize.y)
+	{
+		return;
+	}
+
+	// Layout changes scales, so containers are checked once
+	// more on the next update and then stay unchanged.
+	interface->layoutVersion = version;
+	interface->layoutWindowSize = size;
+	interface->isLayoutDirty = false;
+
+	InterfaceElement* layoutElements = interface->layoutElements;
+
+	// Containers are measured from the deepest, so fitting
+	// container size is known before its parent is measured.
+	for (int64_t i = (int64_t)layoutCount - 1; i >= 0; i--)
+	{
+		InterfaceElement element = layoutElements[i];
+		Transform transform = element->transform;
+
+		if (!isTransformActive(transform))
+			continue;
+
+		InterfaceElement* layoutItems = element->layoutItems;
+		size_t layoutItemCount = element->layoutItemCount;
+		bool isDirty = element->isLayoutDirty;
+
+		for (size_t j = 0; j < layoutItemCount; j++)
+		{
+			InterfaceElement item = layoutItems[j];
+			Transform itemTransform = item->transform;
+			bool isActive = isTransformActive(itemTransform);
+			Vec2F itemSize = getInterfaceLayoutItemSize(item);
+			Vec2F layoutSize = item->layoutSize;
+
+			if (isActive != item->isLayoutActive)
+			{
+				item->isLayoutActive = isActive;
+				isDirty = true;
+			}
+
+			// Changed element size is a new content size,
+			// otherwise the size was set by the layout.
+			if (itemSize.x != layoutSize.x || itemSize.y != layoutSize.y)
+			{
+				item->layoutBasis = itemSize;
+				item->layoutSize = itemSize;
+				isDirty = true;
+			}
+		}
+
+		if (isDirty && element->layout.isFitting)
+		{
+			Vec2F fitSize = measureInterfaceLayout(element);
+			Vec3F scale = getTransformScale(transform);
+
+			if (scale.x != fitSize.x || scale.y != fitSize.y)
+			{
+				setTransformScale(transform,
+					vec3F(fitSize.x, fitSize.y, scale.z));
+			}
+		}
+
+		element->isLayoutDirty = isDirty;
+	}
+
+	// Containers are arranged from the parents, so the
+	// size given by the parent layout is already set.
+	for (size_t i = 0; i < layoutCount; i++)
+	{
+		InterfaceElement element = layoutElements[i];
+		Transform transform = element->transform;
+
+		if (!isTransformActive(transform))
+			continue;
+
+		Vec3F scale = getTransformScale(transform);
+
+		if (element->layout.isStretched && !element->layout.isFitting &&
+			!element->layoutParent)
+		{
+			Transform parent = getTransformParent(transform);
+			Vec2F stretchSize;
+
+			if (parent)
+			{
+				Vec3F parentScale = getTransformScale(parent);
+				stretchSize = vec2F(parentScale.x, parentScale.y);
+			}
+			else
+			{
+				stretchSize = size;
+			}
+
+			if (scale.x != stretchSize.x || scale.y != stretchSize.y)
+			{
+				scale = vec3F(stretchSize.x, stretchSize.y, scale.z);
+				setTransformScale(transform, scale);
+			}
+		}
+
+		Vec2F arrangedSize = element->arrangedSize;
+
+		if (!element->isLayoutDirty && scale.x == arrangedSize.x &&
+			scale.y == arrangedSize.y)
+		{
+			continue;
+		}
+
+		arrangeInterfaceLayout(
+			element,
+			vec2F(scale.x, scale.y));
+
+		element->arrangedSize = vec2F(scale.x, scale.y);
+		element->isLayoutDirty = false;
+	}
+}
+void invalidateInterfaceLayouts(Interface interface)
+{
+	assert(interface);
+
+	if (interface->layoutCount > 0)
+		interface->isLayoutChanged = true;
+}
+void updateInterface(Interface interface)
+{
+	assert(interface);
+
+	InterfaceElement* elements = interface->elements;
+	size_t elementCount = interface->elementCount;
+	Window window = interface->window;
+
+	if (elementCount == 0)
+		return;
+
+	// Disabled elements are not in the list, update event
+	// can enable, disable or create elements.
+	while (interface->updatePosition < interface->updateCount)
+	{
+		InterfaceElement element = interface->updateElements[
+			interface->updatePosition++];
+
+		if (isInterfaceElementActive(element))
+			element->events.onUpdate(element);
+	}
+
+	interface->updatePosition = 0;
+
+	cmmt_float_t interfaceScale = interface->scale;
+	Vec2I windowSize = getWindowSize(window);
+	Vec2F cursorPosition = getWindowCursorPosition(window);
+
+	Vec2F size = vec2F(
+		(cmmt_float_t)windowSize.x / interfaceScale,
+		(cmmt_float_t)windowSize.y / interfaceScale);
+	Vec2F halfSize = mulValVec2F(size, (cmmt_float_t)0.5);
+
+	cursorPosition = vec2F(
+		(cursorPosition.x / interfaceScale) - halfSize.x,
+		(size.y - (cursorPosition.y / interfaceScale)) - halfSize.y);
+
+	updateInterfaceGrid(
+		interface,
+		windowSize,
+		size,
+		halfSize);
+
+	InterfaceElement newElement = NULL;
+	cmmt_float_t elementDistance = INFINITY;
+
+	if (interface->gridCells)
+	{
+		Vec2I gridSize = interface->gridSize;
+
+		int32_t cellX = getInterfaceGridCell(
+			cursorPosition.x,
+			halfSize.x,
+			gridSize.x);
+		int32_t cellY = getInterfaceGridCell(
+			cursorPosition.y,
+			halfSize.y,
+			gridSize.y);
+
+		InterfaceGridCell* cell = &interface->gridCells[
+			(size_t)cellY * gridSize.x + cellX];
+		InterfaceElement* cellElements = cell->elements;
+		size_t cellCount = cell->count;
+
+		for (size_t i = 0; i < cellCount; i++)
+		{
+			checkHoveredElement(
+				cellElements[i],
+				cursorPosition,
+				&newElement,
+				&elementDistance);
+		}
+	}
+	else
+	{
+		for (size_t i = 0; i < elementCount; i++)
+		{
+			checkHoveredElement(
+				elements[i],
+				cursorPosition,
+				&newElement,
+				&elementDistance);
+		}
+	}
+
+	if (isWindowFocused(window) && getWindowCursorMode(window) == DEFAULT_CURSOR_MODE)
+	{
+		bool isLeftButtonPressed = getWindowMouseButton(
+			window, LEFT_MOUSE_BUTTON);
+		InterfaceElement lastElement = interface->lastElement;
+
+		bool isChanged;
+
+		if (isLeftButtonPressed)
+		{
+			if (!interface->isPressed)
+			{
+				isChanged = true;
+				interface->isPressed = true;
+			}
+			else
+			{
+				isChanged = false;
+			}
+		}
+		else
+		{
+			if (interface->isPressed)
+			{
+				isChanged = true;
+				interface->isPressed = false;
+			}
+			else
+			{
+				isChanged = false;
+			}
+		}
+
+		if (lastElement)
+		{
+			if (lastElement != newElement)
+			{
+				interface->lastElement = newElement;
+
+				if (lastElement->events.onExit)
+					lastElement->events.onExit(lastElement);
+				if (newElement && newElement->events.onEnter)
+					newElement->events.onEnter(newElement);
+			}
+			else
+			{
+				if (isLeftButtonPressed)
+				{
+					if (isChanged)
+					{
+						if (lastElement->events.onPress)
+							lastElement->events.onPress(lastElement);
+					}
+					else
+					{
+						if (lastElement->events.onStay)
+							lastElement->events.onStay(lastElement);
+					}
+				}
+				else
+				{
+					if (isChanged)
+					{
+						if (lastElement->events.onRelease)
+							lastElement->events.onRelease(lastElement);
+					}
+					else
+					{
+						if (lastElement->events.onStay)
+							lastElement->events.onStay(lastElement);
+					}
+				}
+			}
+		}
+		else
+		{
+			if (newElement)
+			{
+				interface->lastElement = newElement;
+
+				if (newElement->events.onEnter)
+					newElement->events.onEnter(newElement);
+			}
+		}
+	}
+	else
+	{
+		if (interface->lastElement)
+		{
+			InterfaceElement lastElement = interface->lastElement;
+			interface->lastElement = NULL;
+
+			if (lastElement->events.onExit)
+				lastElement->events.onExit(lastElement);
+		}
+	}
+
+	updateInterfaceLayouts(interface, size);
+
+	ThreadPool threadPool = interface->threadPool;
+
+	if (threadPool && elementCount >= getThreadPoolThreadCount(threadPool))
+	{
+		size_t threadCount = getThreadPoolThreadCount(threadPool);
+
+		UpdateData data = {
+			interface,
+			0,
+		};
+		ThreadPoolTask task = {
+			onInterfacePositionsUpdate,
+			&data,
+		};
+		addThreadPoolTaskNumber(
+			threadPool,
+			task,
+			threadCount);
+		waitThreadPool(threadPool);
+	}
+	else
+	{
+		for (size_t i = 0; i < elementCount; i++)
+		{
+			InterfaceElement element = elements[i];
+			Transform transform = element->transform;
+
+			if (!isTransformActive(transform))
+				continue;
+
+			updateInterfaceElementPosition(
+				element,
+				transform,
+				halfSize,
+				false);
+		}
+	}
+}
+
+inline static void addInterfaceUpdateElement(
+	Interface interface,
+	InterfaceElement element)
+{
+	assert(interface);
+	assert(element);
+	assert(element->updateIndex == SIZE_MAX);
+
+	size_t updateCount = interface->updateCount;
+	assert(updateCount < interface->updateCapacity);
+
+	interface->updateElements[updateCount] = element;
+	interface->updateCount = updateCount + 1;
+	element->updateIndex = updateCount;
+}
+InterfaceElement createInterfaceElement(
+	Interface interface,
+	Transform transform,
+	AlignmentType alignment,
+	Vec3F position,
+	Box2F bounds,
+	bool isEnabled,
+	OnInterfaceElementDestroy onDestroy,
+	const InterfaceElementEvents* events,
+	void* handle)
+{
+	assert(interface);
+	assert(transform);
+	assert(alignment < ALIGNMENT_TYPE_COUNT);
+	assert(onDestroy);
+	assert(handle);
+	assert(!interface->isEnumerating);
+
+	assert(!interface->transformer || interface->transformer ==
+		getTransformTransformer(transform));
+
+	InterfaceElement element = allocateSlabObject(
+		interface->elementSlab);
+
+	if (!element)
+		return NULL;
+
+	interface->transformer = getTransformTransformer(transform);
+	interface->isGridDirty = true;
+
+	element->interface = interface;
 	element->onDestroy = onDestroy;
 	element->events = events ? *events : emptyInterfaceElementEvents;
 	element->handle = handle;
 	element->transform = transform;
 	element->position = position;
 	element->bounds = bounds;
+	element->gridBounds = zeroBox2F;
+	element->gridCells = zeroVec4I;
+	element->order = interface->elementOrder;
+	element->updateIndex = SIZE_MAX;
 	element->alignment = alignment;
 	element->isEnabled = isEnabled;
+	element->isInGrid = false;
+	element->layout = emptyInterfaceLayout;
+	element->layoutItems = NULL;
+	element->layoutItemCapacity = 0;
+	element->layoutItemCount = 0;
+	element->arrangedSize = zeroVec2F;
+	element->layoutParent = NULL;
+	element->layoutBasis = zeroVec2F;
+	element->layoutSize = zeroVec2F;
+	element->layoutOffset = zeroVec2F;
+	element->grow = (cmmt_float_t)0.0;
+	element->shrink = (cmmt_float_t)0.0;
+	element->isLayoutDirty = false;
+	element->isLayoutActive = false;
+	element->isResizable = true;
 
 	cmmt_float_t interfaceScale = interface->scale;
 	Vec2I windowSize = getWindowSize(interface->window);
@@ -717,18 +1945,188 @@ InterfaceElement createInterfaceElement(
 
 		if (!elements)
 		{
-			free(element);
+			freeSlabObject(interface->elementSlab, element);
 			return NULL;
 		}
 
 		interface->elements = elements;
+
+		InterfaceElement* changedElements = realloc(
+			interface->changedElements,
+			sizeof(InterfaceElement) * capacity);
+
+		if (!changedElements)
+		{
+			freeSlabObject(interface->elementSlab, element);
+			return NULL;
+		}
+
+		interface->changedElements = changedElements;
 		interface->elementCapacity = capacity;
 	}
 
+	// Only enabled elements with the update event are enumerated
+	// each frame, order changes when one is destroyed or disabled.
+	if (element->events.onUpdate)
+	{
+		size_t updateEventCount = interface->updateEventCount;
+
+		// Capacity is kept for the disabled elements too,
+		// so enabled element is added without allocation.
+		if (updateEventCount == interface->updateCapacity)
+		{
+			size_t capacity = interface->updateCapacity > 0 ?
+				interface->updateCapacity * 2 : 16;
+
+			InterfaceElement* updateElements = realloc(
+				interface->updateElements,
+				sizeof(InterfaceElement) * capacity);
+
+			if (!updateElements)
+			{
+				freeSlabObject(interface->elementSlab, element);
+				return NULL;
+			}
+
+			interface->updateElements = updateElements;
+			interface->updateCapacity = capacity;
+		}
+
+		interface->updateEventCount = updateEventCount + 1;
+
+		if (isEnabled)
+			addInterfaceUpdateElement(interface, element);
+	}
+
 	interface->elements[count] = element;
 	interface->elementCount = count + 1;
+	interface->elementOrder++;
+
+	Transform parent = getTransformParent(transform);
+
+	// Only the parent container gets a new item, containers
+	// are searched again if it can not be added.
+	if (parent && !interface->isLayoutChanged)
+	{
+		InterfaceElement* layoutElements = interface->layoutElements;
+		size_t layoutCount = interface->layoutCount;
+
+		for (size_t i = 0; i < layoutCount; i++)
+		{
+			InterfaceElement layoutElement = layoutElements[i];
+
+			if (layoutElement->transform != parent)
+				continue;
+
+			if (!addInterfaceLayoutItem(layoutElement, element))
+				interface->isLayoutChanged = true;
+			break;
+		}
+	}
+
 	return element;
 }
+inline static void removeInterfaceUpdateElement(
+	Interface interface,
+	InterfaceElement element)
+{
+	assert(interface);
+	assert(element);
+
+	InterfaceElement* updateElements = interface->updateElements;
+	size_t updateCount = interface->updateCount;
+	size_t updateIndex = element->updateIndex;
+	size_t updatePosition = interface->updatePosition;
+	size_t lastIndex = updateCount - 1;
+
+	assert(updateIndex < updateCount);
+	assert(updateElements[updateIndex] == element);
+
+	// Elements before the position are already updated, so the
+	// last updated one fills the place and the last is not skipped.
+	if (updateIndex < updatePosition)
+	{
+		size_t updatedIndex = updatePosition - 1;
+		InterfaceElement updatedElement = updateElements[updatedIndex];
+		updateElements[updateIndex] = updatedElement;
+		updatedElement->updateIndex = updateIndex;
+		interface->updatePosition = updatedIndex;
+		updateIndex = updatedIndex;
+	}
+
+	// Last element is moved to the removed place.
+	if (updateIndex != lastIndex)
+	{
+		InterfaceElement lastElement = updateElements[lastIndex];
+		updateElements[updateIndex] = lastElement;
+		lastElement->updateIndex = updateIndex;
+	}
+
+	interface->updateCount = lastIndex;
+	element->updateIndex = SIZE_MAX;
+}
+inline static void removeInterfaceLayoutItem(
+	InterfaceElement container,
+	InterfaceElement item)
+{
+	assert(container);
+	assert(item);
+
+	InterfaceElement* layoutItems = container->layoutItems;
+	size_t layoutItemCount = container->layoutItemCount;
+
+	for (int64_t i = (int64_t)layoutItemCount - 1; i >= 0; i--)
+	{
+		if (layoutItems[i] != item)
+			continue;
+
+		for (size_t j = i + 1; j < layoutItemCount; j++)
+			layoutItems[j - 1] = layoutItems[j];
+
+		container->layoutItemCount--;
+		markInterfaceLayoutDirty(container);
+		item->layoutParent = NULL;
+		return;
+	}
+
+	abort();
+}
+inline static void removeInterfaceLayoutElement(
+	Interface interface,
+	InterfaceElement element)
+{
+	assert(interface);
+	assert(element);
+
+	InterfaceElement* layoutItems = element->layoutItems;
+	size_t layoutItemCount = element->layoutItemCount;
+
+	for (size_t i = 0; i < layoutItemCount; i++)
+		layoutItems[i]->layoutParent = NULL;
+
+	free(layoutItems);
+	element->layoutItems = NULL;
+	element->layoutItemCapacity = 0;
+	element->layoutItemCount = 0;
+
+	InterfaceElement* layoutElements = interface->layoutElements;
+	size_t layoutCount = interface->layoutCount;
+
+	for (int64_t i = (int64_t)layoutCount - 1; i >= 0; i--)
+	{
+		if (layoutElements[i] != element)
+			continue;
+
+		for (size_t j = i + 1; j < layoutCount; j++)
+			layoutElements[j - 1] = layoutElements[j];
+
+		interface->layoutCount--;
+		interface->isLayoutChanged = true;
+		return;
+	}
+
+	abort();
+}
 void destroyInterfaceElement(InterfaceElement element)
 {
 	if (!element)
@@ -748,9 +2146,22 @@ void destroyInterfaceElement(InterfaceElement element)
 		for (size_t j = i + 1; j < elementCount; j++)
 			elements[j - 1] = elements[j];
 
+		if (element->events.onUpdate)
+			interface->updateEventCount--;
+		if (element->updateIndex != SIZE_MAX)
+			removeInterfaceUpdateElement(interface, element);
+		if (element->isInGrid)
+			removeInterfaceGridElement(interface, element);
+		if (interface->lastElement == element)
+			interface->lastElement = NULL;
+		if (element->layout.type != NO_INTERFACE_LAYOUT_TYPE)
+			removeInterfaceLayoutElement(interface, element);
+		if (element->layoutParent)
+			removeInterfaceLayoutItem(element->layoutParent, element);
+
 		element->onDestroy(element->handle);
 
-		free(element);
+		freeSlabObject(interface->elementSlab, element);
 		interface->elementCount--;
 		return;
 	}
@@ -797,6 +2208,9 @@ void setInterfaceElementAlignment(
 	assert(element);
 	assert(alignment < ALIGNMENT_TYPE_COUNT);
 	element->alignment = alignment;
+
+	if (element->layoutParent)
+		markInterfaceLayoutDirty(element->layoutParent);
 }
 
 Vec3F getInterfaceElementPosition(
@@ -825,6 +2239,10 @@ void setInterfaceElementBounds(
 {
 	assert(element);
 	element->bounds = bounds;
+	element->interface->isGridDirty = true;
+
+	if (element->layoutParent)
+		markInterfaceLayoutDirty(element->layoutParent);
 }
 
 bool isInterfaceElementEnabled(
@@ -845,6 +2263,8 @@ void setInterfaceElementEnabled(
 		{
 			if (element->events.onEnable)
 				element->events.onEnable(element);
+			if (element->events.onUpdate)
+				addInterfaceUpdateElement(element->interface, element);
 			element->isEnabled = true;
 		}
 	}
@@ -854,11 +2274,125 @@ void setInterfaceElementEnabled(
 		{
 			if (element->events.onDisable)
 				element->events.onDisable(element);
+			if (element->events.onUpdate)
+				removeInterfaceUpdateElement(element->interface, element);
 			element->isEnabled = false;
 		}
 	}
 }
 
+InterfaceLayout getInterfaceElementLayout(
+	InterfaceElement element)
+{
+	assert(element);
+	return element->layout;
+}
+bool setInterfaceElementLayout(
+	InterfaceElement element,
+	const InterfaceLayout* layout)
+{
+	assert(element);
+	assert(!layout || layout->type < INTERFACE_LAYOUT_TYPE_COUNT);
+	assert(!element->interface->isEnumerating);
+
+	Interface interface = element->interface;
+
+	InterfaceLayoutType type = layout ?
+		layout->type : NO_INTERFACE_LAYOUT_TYPE;
+	bool isContainer = element->layout.type !=
+		NO_INTERFACE_LAYOUT_TYPE;
+
+	if (type == NO_INTERFACE_LAYOUT_TYPE)
+	{
+		if (isContainer)
+			removeInterfaceLayoutElement(interface, element);
+
+		element->layout = emptyInterfaceLayout;
+		return true;
+	}
+
+	if (!isContainer)
+	{
+		size_t count = interface->layoutCount;
+
+		if (count == interface->layoutCapacity)
+		{
+			size_t capacity = count > 0 ? count * 2 : 4;
+
+			InterfaceElement* layoutElements = realloc(
+				interface->layoutElements,
+				sizeof(InterfaceElement) * capacity);
+
+			if (!layoutElements)
+				return false;
+
+			interface->layoutElements = layoutElements;
+			interface->layoutCapacity = capacity;
+		}
+
+		interface->layoutElements[count] = element;
+		interface->layoutCount = count + 1;
+		interface->isLayoutChanged = true;
+	}
+
+	element->layout = *layout;
+	markInterfaceLayoutDirty(element);
+	return true;
+}
+
+cmmt_float_t getInterfaceElementGrow(
+	InterfaceElement element)
+{
+	assert(element);
+	return element->grow;
+}
+void setInterfaceElementGrow(
+	InterfaceElement element,
+	cmmt_float_t grow)
+{
+	assert(element);
+	assert(grow >= (cmmt_float_t)0.0);
+	element->grow = grow;
+
+	if (element->layoutParent)
+		markInterfaceLayoutDirty(element->layoutParent);
+}
+
+cmmt_float_t getInterfaceElementShrink(
+	InterfaceElement element)
+{
+	assert(element);
+	return element->shrink;
+}
+void setInterfaceElementShrink(
+	InterfaceElement element,
+	cmmt_float_t shrink)
+{
+	assert(element);
+	assert(shrink >= (cmmt_float_t)0.0);
+	element->shrink = shrink;
+
+	if (element->layoutParent)
+		markInterfaceLayoutDirty(element->layoutParent);
+}
+
+bool isInterfaceElementResizable(
+	InterfaceElement element)
+{
+	assert(element);
+	return element->isResizable;
+}
+void setInterfaceElementResizable(
+	InterfaceElement element,
+	bool isResizable)
+{
+	assert(element);
+	element->isResizable = isResizable;
+
+	if (element->layoutParent)
+		markInterfaceLayoutDirty(element->layoutParent);
+}
+
 void bakeInterfaceElement(InterfaceElement element)
 {
 	assert(element);
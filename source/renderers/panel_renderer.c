@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include "uran/renderers/panel_renderer.h"
+#include "uran/text.h"
 
 #include "mpgx/_source/window.h"
 #include "mpgx/_source/graphics_mesh.h"
@@ -28,10 +29,18 @@ typedef struct Handle_T
 
 typedef Handle_T* Handle;
 
-static void onDestroy(void* handle)
+#ifndef NDEBUG
+// Batched panels are drawn with the text pipeline.
+inline static bool isPanelRendererPipeline(
+	GraphicsPipeline pipeline)
 {
-	free((Handle)handle);
+	const char* name = getGraphicsPipelineName(pipeline);
+
+	return strcmp(name, PANEL_PIPELINE_NAME) == 0 ||
+		strcmp(name, TEXT_PIPELINE_NAME) == 0;
 }
+#endif
+
 static size_t onDraw(
 	GraphicsRender graphicsRender,
 	GraphicsPipeline graphicsPipeline,
@@ -106,6 +115,38 @@ static size_t onDraw(
 
 	return mesh->base.indexCount;
 }
+static size_t onBatchedDraw(
+	GraphicsRender graphicsRender,
+	GraphicsPipeline graphicsPipeline,
+	const Mat4F* model,
+	const Mat4F* viewProj)
+{
+	assert(graphicsRender);
+	assert(graphicsPipeline);
+	assert(model);
+	assert(viewProj);
+
+	Handle handle = getGraphicsRenderHandle(graphicsRender);
+	Mat4F mvp = dotMat4F(*viewProj, *model);
+
+#ifndef NDEBUG
+	Vec4I stateScissor = graphicsPipeline->base.state.scissor;
+
+	if (stateScissor.z + stateScissor.w == 0)
+	{
+		Vec4I panelScissor = handle->scissor;
+		Vec2I framebufferSize = graphicsPipeline->base.framebuffer->base.size;
+		assert(panelScissor.x + panelScissor.z <= framebufferSize.x);
+		assert(panelScissor.y + panelScissor.w <= framebufferSize.y);
+	}
+#endif
+
+	return drawBatchedQuad(
+		graphicsPipeline,
+		&mvp,
+		handle->color,
+		handle->scissor);
+}
 GraphicsRenderer createPanelRenderer(
 	GraphicsPipeline panelPipeline,
 	GraphicsRenderSorting sorting,
@@ -125,8 +166,37 @@ GraphicsRenderer createPanelRenderer(
 		panelPipeline,
 		sorting,
 		useCulling,
-		onDestroy,
+		NULL,
 		onDraw,
+		NULL,
+		sizeof(Handle_T),
+		capacity,
+		threadPool);
+}
+GraphicsRenderer createBatchedPanelRenderer(
+	GraphicsPipeline textPipeline,
+	GraphicsRenderSorting sorting,
+	bool useCulling,
+	size_t capacity,
+	ThreadPool threadPool)
+{
+	assert(textPipeline);
+	assert(sorting < GRAPHICS_RENDER_SORTING_COUNT);
+	assert(capacity > 0);
+
+	assert(strcmp(getGraphicsPipelineName(
+		textPipeline),
+		TEXT_PIPELINE_NAME) == 0);
+	assert(!isTextPipelinePacked(textPipeline));
+
+	return createGraphicsRenderer(
+		textPipeline,
+		sorting,
+		useCulling,
+		NULL,
+		onBatchedDraw,
+		flushTextBatch,
+		sizeof(Handle_T),
 		capacity,
 		threadPool);
 }
@@ -141,30 +211,22 @@ GraphicsRender createPanelRender(
 	assert(panelRenderer);
 	assert(transform);
 
-	assert(strcmp(getGraphicsPipelineName(
+	assert(isPanelRendererPipeline(
 		getGraphicsRendererPipeline(
-		panelRenderer)),
-		PANEL_PIPELINE_NAME) == 0);
-
-	Handle handle = calloc(1, sizeof(Handle_T));
-
-	if (!handle)
-		return NULL;
-
-	handle->color = color;
-	handle->scissor = scissor;
+		panelRenderer)));
 
 	GraphicsRender render = createGraphicsRender(
 		panelRenderer,
 		transform,
 		bounds,
-		handle);
+		NULL);
 
 	if (!render)
-	{
-		onDestroy(handle);
 		return NULL;
-	}
+
+	Handle handle = getGraphicsRenderHandle(render);
+	handle->color = color;
+	handle->scissor = scissor;
 
 	return render;
 }
@@ -173,11 +235,10 @@ LinearColor getPanelRenderColor(
 	GraphicsRender panelRender)
 {
 	assert(panelRender);
-	assert(strcmp(getGraphicsPipelineName(
+	assert(isPanelRendererPipeline(
 		getGraphicsRendererPipeline(
 		getGraphicsRenderRenderer(
-		panelRender))),
-		PANEL_PIPELINE_NAME) == 0);
+		panelRender))));
 	Handle handle = getGraphicsRenderHandle(
 		panelRender);
 	return handle->color;
@@ -187,11 +248,10 @@ void setPanelRenderColor(
 	LinearColor color)
 {
 	assert(panelRender);
-	assert(strcmp(getGraphicsPipelineName(
+	assert(isPanelRendererPipeline(
 		getGraphicsRendererPipeline(
 		getGraphicsRenderRenderer(
-		panelRender))),
-		PANEL_PIPELINE_NAME) == 0);
+		panelRender))));
 	Handle handle = getGraphicsRenderHandle(
 		panelRender);
 	handle->color = color;
@@ -201,11 +261,10 @@ Vec4I getPanelRenderScissor(
 	GraphicsRender panelRender)
 {
 	assert(panelRender);
-	assert(strcmp(getGraphicsPipelineName(
+	assert(isPanelRendererPipeline(
 		getGraphicsRendererPipeline(
 		getGraphicsRenderRenderer(
-		panelRender))),
-		PANEL_PIPELINE_NAME) == 0);
+		panelRender))));
 	Handle handle = getGraphicsRenderHandle(
 		panelRender);
 	return handle->scissor;
@@ -215,11 +274,10 @@ void setPanelRenderScissor(
 	Vec4I scissor)
 {
 	assert(panelRender);
-	assert(strcmp(getGraphicsPipelineName(
+	assert(isPanelRendererPipeline(
 		getGraphicsRendererPipeline(
 		getGraphicsRenderRenderer(
-		panelRender))),
-		PANEL_PIPELINE_NAME) == 0);
+		panelRender))));
 	Handle handle = getGraphicsRenderHandle(
 		panelRender);
 	handle->scissor = scissor;
@@ -27,10 +27,6 @@ typedef struct Handle_T
 
 typedef Handle_T* Handle;
 
-static void onDestroy(void* handle)
-{
-	free((Handle)handle);
-}
 static size_t onDraw(
 	GraphicsRender graphicsRender,
 	GraphicsPipeline graphicsPipeline,
@@ -45,6 +41,9 @@ static size_t onDraw(
 	Vec2I framebufferSize = graphicsPipeline->base.framebuffer->base.size;
 	Vec2I halfFramebufferSize = divValVec2I(framebufferSize, 2);
 	Handle handle = getGraphicsRenderHandle(graphicsRender);
+	assert(getFontAtlasPipeline(getTextFontAtlas(
+		handle->text)) == graphicsPipeline);
+
 	Mat4F mvp = dotMat4F(*viewProj, *model);
 	Vec3F position = getTranslationMat4F(mvp);
 	position.x = cmmtFloor(position.x *
@@ -54,21 +53,18 @@ static size_t onDraw(
 		(cmmt_float_t)halfFramebufferSize.y) /
 		(cmmt_float_t)halfFramebufferSize.y;
 	mvp = setTranslationMat4F(mvp, position);
-	setTextPipelineMVP(graphicsPipeline, &mvp);
-	setTextPipelineColor(graphicsPipeline, handle->color);
-
-	Vec4I stateScissor = graphicsPipeline->base.state.scissor;
-	bool dynamicScissor = stateScissor.z + stateScissor.w == 0;
 
-	if (dynamicScissor)
-	{
-		Vec4I panelScissor = handle->scissor;
-		assert(panelScissor.x + panelScissor.z <= framebufferSize.x);
-		assert(panelScissor.y + panelScissor.w <= framebufferSize.y);
-		setWindowScissor(graphicsPipeline->base.window, panelScissor);
-	}
-
-	return drawText(handle->text);
+	Vec4I panelScissor = handle->scissor;
+	assert(panelScissor.x + panelScissor.z <= framebufferSize.x);
+	assert(panelScissor.y + panelScissor.w <= framebufferSize.y);
+
+	// Texts are merged into the pipeline batch,
+	// which is drawn on the scissor or atlas change.
+	return drawBatchedText(
+		handle->text,
+		&mvp,
+		handle->color,
+		panelScissor);
 }
 GraphicsRenderer createTextRenderer(
 	GraphicsPipeline textPipeline,
@@ -89,8 +85,10 @@ GraphicsRenderer createTextRenderer(
 		textPipeline,
 		sorting,
 		useCulling,
-		onDestroy,
+		NULL,
 		onDraw,
+		flushTextBatch,
+		sizeof(Handle_T),
 		capacity,
 		threadPool);
 }
@@ -122,26 +120,19 @@ GraphicsRender createTextRender(
 		textRenderer)),
 		TEXT_PIPELINE_NAME) == 0);
 
-	Handle handle = calloc(1, sizeof(Handle_T));
-
-	if (!handle)
-		return NULL;
-
-	handle->text = text;
-	handle->color = color;
-	handle->scissor = scissor;
-
 	GraphicsRender render = createGraphicsRender(
 		textRenderer,
 		transform,
 		bounds,
-		handle);
+		NULL);
 
 	if (!render)
-	{
-		onDestroy(handle);
 		return NULL;
-	}
+
+	Handle handle = getGraphicsRenderHandle(render);
+	handle->text = text;
+	handle->color = color;
+	handle->scissor = scissor;
 
 	return render;
 }
@@ -0,0 +1,189 @@
+// Copyright 2020-2022 Nikita Fediuchin. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "uran/slab.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+// Objects are aligned as the malloc result,
+// which is enough for any engine structure.
+#define SLAB_OBJECT_ALIGNMENT 16
+
+typedef struct SlabObject
+{
+	struct SlabObject* next;
+} SlabObject;
+struct Slab_T
+{
+	uint8_t** blocks;
+	size_t blockCapacity;
+	size_t blockCount;
+	size_t blockLength;
+	size_t objectSize;
+	size_t blockOffset;
+	size_t objectCount;
+	SlabObject* freeObject;
+};
+
+Slab createSlab(
+	size_t objectSize,
+	size_t blockLength)
+{
+	assert(objectSize > 0);
+	assert(blockLength > 0);
+
+	Slab slab = calloc(1, sizeof(Slab_T));
+
+	if (!slab)
+		return NULL;
+
+	if (objectSize < sizeof(SlabObject))
+		objectSize = sizeof(SlabObject);
+
+	objectSize = (objectSize + (SLAB_OBJECT_ALIGNMENT - 1)) &
+		~((size_t)SLAB_OBJECT_ALIGNMENT - 1);
+
+	slab->blocks = NULL;
+	slab->blockCapacity = 0;
+	slab->blockCount = 0;
+	slab->blockLength = blockLength;
+	slab->objectSize = objectSize;
+	slab->blockOffset = blockLength;
+	slab->objectCount = 0;
+	slab->freeObject = NULL;
+	return slab;
+}
+void destroySlab(Slab slab)
+{
+	if (!slab)
+		return;
+
+	uint8_t** blocks = slab->blocks;
+	size_t blockCount = slab->blockCount;
+
+	for (size_t i = 0; i < blockCount; i++)
+		free(blocks[i]);
+
+	free(blocks);
+	free(slab);
+}
+
+size_t getSlabObjectSize(Slab slab)
+{
+	assert(slab);
+	return slab->objectSize;
+}
+size_t getSlabObjectCount(Slab slab)
+{
+	assert(slab);
+	return slab->objectCount;
+}
+
+void* allocateSlabObject(Slab slab)
+{
+	assert(slab);
+
+	size_t objectSize = slab->objectSize;
+	void* object;
+
+	if (slab->freeObject)
+	{
+		SlabObject* freeObject = slab->freeObject;
+		slab->freeObject = freeObject->next;
+		object = freeObject;
+	}
+	else
+	{
+		size_t blockLength = slab->blockLength;
+		size_t blockOffset = slab->blockOffset;
+
+		if (blockOffset == blockLength)
+		{
+			size_t blockCount = slab->blockCount;
+
+			if (blockCount == slab->blockCapacity)
+			{
+				size_t capacity = slab->blockCapacity > 0 ?
+					slab->blockCapacity * 2 : 4;
+
+				uint8_t** blocks = realloc(
+					slab->blocks,
+					capacity * sizeof(uint8_t*));
+
+				if (!blocks)
+					return NULL;
+
+				slab->blocks = blocks;
+				slab->blockCapacity = capacity;
+			}
+
+			uint8_t* block = malloc(
+				objectSize * blockLength);
+
+			if (!block)
+				return NULL;
+
+			slab->blocks[blockCount] = block;
+			slab->blockCount = blockCount + 1;
+			blockOffset = 0;
+		}
+
+		object = slab->blocks[slab->blockCount - 1] +
+			blockOffset * objectSize;
+		slab->blockOffset = blockOffset + 1;
+	}
+
+	memset(object, 0, objectSize);
+	slab->objectCount++;
+	return object;
+}
+void freeSlabObject(
+	Slab slab,
+	void* object)
+{
+	assert(slab);
+
+	if (!object)
+		return;
+
+	assert(slab->objectCount > 0);
+
+	SlabObject* freeObject = object;
+	freeObject->next = slab->freeObject;
+	slab->freeObject = freeObject;
+	slab->objectCount--;
+}
+void resetSlab(Slab slab)
+{
+	assert(slab);
+
+	if (slab->blockCount == 0)
+		return;
+
+	// Blocks except the first one are released,
+	// it is enough for the most of the rebuilds.
+	uint8_t** blocks = slab->blocks;
+	size_t blockCount = slab->blockCount;
+
+	for (size_t i = 1; i < blockCount; i++)
+		free(blocks[i]);
+
+	slab->blockCount = 1;
+	slab->blockOffset = 0;
+	slab->objectCount = 0;
+	slab->freeObject = NULL;
+}
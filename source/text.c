@@ -22,14 +22,57 @@
 #define FT_CONFIG_OPTION_ERROR_STRINGS
 #include "ft2build.h"
 #include FT_FREETYPE_H
+#include FT_TRUETYPE_TABLES_H
 
 #include "cmmt/common.h"
+#include "mpio/file.h"
+#include "mpmt/atomic.h"
 #include <assert.h>
 
+#if __linux__ || __APPLE__
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#elif _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#endif
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+#define FONT_COVERAGE_PAGE_SIZE 4096
+#define FONT_COVERAGE_PAGE_COUNT (0x110000 / FONT_COVERAGE_PAGE_SIZE)
+#define MEASURE_TEXT_STACK_LENGTH 256
+
+/*
+ * Font data is shared between the fonts created from
+ * the same data, it is either owned or memory mapped.
+ */
+typedef struct FontData
+{
+	const uint8_t* bytes;
+	size_t size;
+	size_t referenceCount;
+	uint64_t hash;
+	uint64_t modifiedTime;
+	bool isMapped;
+	bool isHashed;
+	uint8_t _alignment[6];
+} FontData;
+
 struct Font_T
 {
-	uint8_t* data;
+	FontData* data;
 	FT_Face face;
+	uint8_t** coverage;
 };
 
 typedef struct Glyph
@@ -47,6 +90,32 @@ typedef struct Glyph
 	bool isVisible;
 	uint8_t _alignment[3];
 } Glyph;
+
+typedef struct GlyphSource
+{
+	uint32_t value;
+	uint32_t charIndex;
+	uint32_t fontIndex;
+} GlyphSource;
+typedef struct GlyphSourceMap
+{
+	GlyphSource* sources;
+	size_t capacity;
+	size_t count;
+} GlyphSourceMap;
+/*
+ * Dynamic font atlas cell, storing the glyph
+ * value and the frame index of its last use.
+ */
+typedef struct FontAtlasCell
+{
+	uint64_t frame;
+	uint32_t value;
+	uint32_t index;
+} FontAtlasCell;
+
+#define FREE_FONT_ATLAS_CELL UINT32_MAX
+
 struct FontAtlas_T
 {
 	Logger logger;
@@ -56,12 +125,22 @@ struct FontAtlas_T
 	Glyph* glyphs;
 	size_t glyphCapacity;
 	size_t glyphCount;
+	GlyphSourceMap sourceMaps[4];
 	Image image;
+	FontAtlasCell* cells;
+	FontAtlasCell* cellBuffer;
+	uint32_t* glyphCells;
+	uint32_t* valueBuffer;
+	size_t valueCapacity;
+	uint8_t* pixels;
+	uint64_t frameIndex;
+	uint32_t cellLength;
 	uint32_t fontSize;
 	float newLineAdvance;
 	bool isGenerated;
+	bool isDynamic;
 #if MPGX_SUPPORT_VULKAN
-	uint8_t _alignment[7];
+	uint8_t _alignment[2];
 	VkDescriptorPool descriptorPool;
 	VkDescriptorSet descriptorSet;
 #endif
@@ -73,70 +152,157 @@ typedef struct TextVertex
 	Vec3F texCoords;
 	SrgbColor color;
 } TextVertex;
+/*
+ * Positions are in the quarter pixels of the font size,
+ * texture coordinates are 15 bit unorm values with
+ * the atlas index bits stored in the lowest bits.
+ */
+typedef struct PackedTextVertex
+{
+	int16_t positionX;
+	int16_t positionY;
+	uint16_t texCoordsX;
+	uint16_t texCoordsY;
+	SrgbColor color;
+} PackedTextVertex;
 
-typedef struct BaseText
+#define PACKED_TEXT_POSITION_STEPS 4.0f
+typedef struct TextStyle
 {
-	FontAtlas fontAtlas;
-	uint32_t* string;
-	size_t capacity;
-	size_t length;
-	Vec2F size;
 	SrgbColor color;
-	AlignmentType alignment;
 	bool isBold;
 	bool isItalic;
-	bool useTags;
-	bool isConstant;
-} BaseText;
-#if MPGX_SUPPORT_VULKAN
-typedef struct VkText
+	uint8_t _alignment[2];
+} TextStyle;
+typedef struct TextLine
 {
-	FontAtlas fontAtlas;
-	uint32_t* string;
-	size_t capacity;
+	size_t offset;
 	size_t length;
-	Vec2F size;
-	SrgbColor color;
-	AlignmentType alignment;
-	bool isBold;
-	bool isItalic;
-	bool useTags;
-	bool isConstant;
+	uint32_t vertexOffset;
+	uint32_t vertexCount;
+	float width;
+	TextStyle style;
+	bool isWrapped;
+} TextLine;
+
+typedef struct TextRun
+{
+	size_t offset;
+	size_t length;
+	TextStyle style;
+} TextRun;
+/*
+ * Cached glyph array index and line break
+ * opportunity of the string character.
+ */
+typedef struct TextGlyph
+{
+	uint32_t index;
+	uint8_t breakType;
 	uint8_t _alignment[3];
-	uint32_t indexCount;
-	Buffer vertexBuffer;
-} VkText;
-#endif
-#if MPGX_SUPPORT_OPENGL
-typedef struct GlText
+} TextGlyph;
+
+typedef enum TextBreakType_T
+{
+	NONE_TEXT_BREAK_TYPE = 0,
+	SPACE_TEXT_BREAK_TYPE = 1,
+	TAB_TEXT_BREAK_TYPE = 2,
+	HYPHEN_TEXT_BREAK_TYPE = 3,
+	IDEOGRAPH_TEXT_BREAK_TYPE = 4,
+} TextBreakType_T;
+
+typedef struct TextRange
+{
+	size_t offset;
+	size_t count;
+} TextRange;
+
+typedef struct BaseText
 {
 	FontAtlas fontAtlas;
 	uint32_t* string;
 	size_t capacity;
 	size_t length;
+	TextLine* lines;
+	size_t lineCapacity;
+	size_t lineCount;
+	TextVertex* vertices;
+	size_t vertexCapacity;
+	size_t vertexCount;
+	size_t cleanPrefix;
+	size_t cleanSuffix;
+	float* advances;
+	size_t advanceCapacity;
+	TextRun* runs;
+	size_t runCapacity;
+	size_t runCount;
+	size_t runPrefix;
+	TextGlyph* glyphCache;
+	size_t glyphCacheCapacity;
+	size_t uploadOffset;
+	size_t uploadCount;
+	size_t arenaOffset;
+	size_t arenaCapacity;
+	uint64_t drawFrame;
 	Vec2F size;
+	float maxWidth;
 	SrgbColor color;
 	AlignmentType alignment;
+	TextWrapType wrap;
+	uint32_t mask;
 	bool isBold;
 	bool isItalic;
 	bool useTags;
 	bool isConstant;
-	uint8_t _alignment[3];
-	GraphicsMesh mesh;
-} GlText;
-#endif
+	bool isGlyphCacheValid;
+	bool isEvicted;
+	uint32_t indexCount;
+	size_t bakeIndex;
+} BaseText;
 
 union Text_T
 {
 	BaseText base;
-#if MPGX_SUPPORT_VULKAN
-	VkText vk;
-#endif
-#if MPGX_SUPPORT_OPENGL
-	GlText gl;
-#endif
 };
 
+/*
+ * Document lines are grouped into blocks, each
+ * storing the style at its first line and the lazily
+ * measured width of the widest block line.
+ */
+#define TEXT_DOCUMENT_BLOCK_LINE_COUNT 64
+
+struct TextDocument_T
+{
+	Text text;
+	uint32_t* string;
+	size_t capacity;
+	size_t length;
+	size_t* lineOffsets;
+	size_t lineCapacity;
+	size_t lineCount;
+	TextStyle* blockStyles;
+	float* blockWidths;
+	size_t blockCapacity;
+	uint32_t* viewString;
+	size_t viewCapacity;
+	size_t viewLine;
+	size_t viewLineCount;
+	TextStyle lastLineStyle;
+};
+
+/*
+ * Text layout scratch buffers, one is used
+ * by the each thread baking texts in parallel.
+ */
+typedef struct TextScratch
+{
+	TextVertex* vertexBuffer;
+	size_t vertexCapacity;
+	TextLine* lineBuffer;
+	size_t lineCapacity;
+} TextScratch;
+
 typedef struct VertexPushConstants
 {
 	mat4 mvp;
@@ -145,6 +311,32 @@ typedef struct FragmentPushConstants
 {
 	vec4 color;
 } FragmentPushConstants;
+
+typedef enum TextBatchType_T
+{
+	NONE_TEXT_BATCH_TYPE = 0,
+	ARENA_TEXT_BATCH_TYPE = 1,
+	STREAM_TEXT_BATCH_TYPE = 2,
+} TextBatchType_T;
+
+typedef uint8_t TextBatchType;
+
+/*
+ * Pending text draw, consecutive texts are merged into it.
+ * Arena batch draws adjacent arena ranges with the same MVP,
+ * stream batch draws texts transformed into the batch buffer.
+ */
+typedef struct TextBatch
+{
+	mat4 mvp;
+	vec4 color;
+	Vec4I scissor;
+	FontAtlas fontAtlas;
+	size_t offset;
+	size_t count;
+	TextBatchType type;
+	bool isChanged;
+} TextBatch;
 typedef struct BaseHandle
 {
 	Sampler sampler;
@@ -153,11 +345,30 @@ typedef struct BaseHandle
 	Text* texts;
 	size_t textCapacity;
 	size_t textCount;
-	TextVertex* vertexBuffer;
-	size_t vertexCapacity;
+	TextScratch scratch;
+	TextScratch* threadScratches;
+	size_t threadScratchCount;
 	uint8_t* pixelBuffer;
 	size_t pixelCapacity;
 	Buffer indexBuffer;
+	Buffer arenaBuffer;
+	uint8_t* arenaVertices;
+	size_t arenaCapacity;
+	TextRange* freeRanges;
+	size_t freeRangeCapacity;
+	size_t freeRangeCount;
+	FontAtlas boundAtlas;
+	Buffer boundBuffer;
+	size_t vertexSize;
+	Buffer batchBuffer;
+	TextVertex* batchVertices;
+	size_t batchCapacity;
+	size_t batchCount;
+	size_t batchDemand;
+	double batchTime;
+	TextBatch batch;
+	FontAtlas quadAtlas;
+	bool isBatchSynced;
 #ifndef NDEBUG
 	bool isEnumerating;
 #endif
@@ -171,11 +382,30 @@ typedef struct VkHandle
 	Text* texts;
 	size_t textCapacity;
 	size_t textCount;
-	TextVertex* vertexBuffer;
-	size_t vertexCapacity;
+	TextScratch scratch;
+	TextScratch* threadScratches;
+	size_t threadScratchCount;
 	uint8_t* pixelBuffer;
 	size_t pixelCapacity;
 	Buffer indexBuffer;
+	Buffer arenaBuffer;
+	uint8_t* arenaVertices;
+	size_t arenaCapacity;
+	TextRange* freeRanges;
+	size_t freeRangeCapacity;
+	size_t freeRangeCount;
+	FontAtlas boundAtlas;
+	Buffer boundBuffer;
+	size_t vertexSize;
+	Buffer batchBuffer;
+	TextVertex* batchVertices;
+	size_t batchCapacity;
+	size_t batchCount;
+	size_t batchDemand;
+	double batchTime;
+	TextBatch batch;
+	FontAtlas quadAtlas;
+	bool isBatchSynced;
 #ifndef NDEBUG
 	bool isEnumerating;
 #endif
@@ -191,17 +421,37 @@ typedef struct GlHandle
 	Text* texts;
 	size_t textCapacity;
 	size_t textCount;
-	TextVertex* vertexBuffer;
-	size_t vertexCapacity;
+	TextScratch scratch;
+	TextScratch* threadScratches;
+	size_t threadScratchCount;
 	uint8_t* pixelBuffer;
 	size_t pixelCapacity;
 	Buffer indexBuffer;
+	Buffer arenaBuffer;
+	uint8_t* arenaVertices;
+	size_t arenaCapacity;
+	TextRange* freeRanges;
+	size_t freeRangeCapacity;
+	size_t freeRangeCount;
+	FontAtlas boundAtlas;
+	Buffer boundBuffer;
+	size_t vertexSize;
+	Buffer batchBuffer;
+	TextVertex* batchVertices;
+	size_t batchCapacity;
+	size_t batchCount;
+	size_t batchDemand;
+	double batchTime;
+	TextBatch batch;
+	FontAtlas quadAtlas;
+	bool isBatchSynced;
 #ifndef NDEBUG
 	bool isEnumerating;
 #endif
 	GLint mvpLocation;
 	GLint atlasLocation;
 	GLint colorLocation;
+	GraphicsMesh mesh;
 } GlHandle;
 #endif
 typedef union Handle_T
@@ -267,68 +517,249 @@ bool isTextInitialized()
 	return textInitialized;
 }
 
-size_t stringUTF8toUTF32(
+inline static size_t getAsciiLengthUTF8(
+	const char* string,
+	size_t stringLength)
+{
+	assert(string);
+
+	size_t i = 0;
+
+#if defined(__AVX2__)
+	for (; i + 32 <= stringLength; i += 32)
+	{
+		__m256i bytes = _mm256_loadu_si256(
+			(const __m256i*)(string + i));
+
+		if (_mm256_movemask_epi8(bytes) != 0)
+			break;
+	}
+#elif defined(__SSE2__) || defined(_M_X64)
+	for (; i + 16 <= stringLength; i += 16)
+	{
+		__m128i bytes = _mm_loadu_si128(
+			(const __m128i*)(string + i));
+
+		if (_mm_movemask_epi8(bytes) != 0)
+			break;
+	}
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+	for (; i + 16 <= stringLength; i += 16)
+	{
+		uint8x16_t bytes = vld1q_u8(
+			(const uint8_t*)(string + i));
+
+		if (vmaxvq_u8(bytes) >= 0b10000000)
+			break;
+	}
+#endif
+
+	while (i < stringLength && (string[i] & 0b10000000) == 0)
+		i++;
+
+	return i;
+}
+inline static size_t convertAsciiUTF8(
 	const char* source,
 	size_t sourceLength,
 	uint32_t* destination)
 {
 	assert(source);
-	assert(sourceLength > 0);
 	assert(destination);
 
-	size_t i = 0, length = 0;
+	size_t i = 0;
 
-	while(i < sourceLength)
+#if defined(__AVX2__)
+	for (; i + 32 <= sourceLength; i += 32)
 	{
-		char value = source[i];
+		const char* bytes = source + i;
+		__m256i values = _mm256_loadu_si256((const __m256i*)bytes);
 
-		if ((value & 0b10000000) == 0)
-		{
-			destination[length] = (uint32_t)source[i];
-			i += 1;
-		}
-		else if (i + 1 < sourceLength &&
-			!((value & 0b11100000) ^ 0b11000000 ||
-			(source[i + 1] & 0b11000000) ^ 0b10000000))
-		{
-			destination[length] =
-				(uint32_t)(source[i] & 0b00011111) << 6 |
-				(uint32_t)(source[i + 1] & 0b00111111);
-			i += 2;
-		}
-		else if (i + 2 < sourceLength &&
-			!((value & 0b11110000) ^ 0b11100000 ||
-			(source[i + 1] & 0b11000000) ^ 0b10000000 ||
-			(source[i + 2] & 0b11000000) ^ 0b10000000))
-		{
-			destination[length] =
-				(uint32_t)(source[i] & 0b00001111) << 12 |
-				(uint32_t)(source[i + 1] & 0b00111111) << 6 |
-				(uint32_t)(source[i + 2] & 0b00111111);
-			i += 3;
-		}
-		else if (i + 3 < sourceLength &&
-			!((value & 0b11111000) ^ 0b11110000 ||
-			(source[i + 1] & 0b11000000) ^ 0b10000000 ||
-			(source[i + 2] & 0b11000000) ^ 0b10000000 ||
-			(source[i + 3] & 0b11000000) ^ 0b10000000))
+		if (_mm256_movemask_epi8(values) != 0)
+			break;
+
+		__m256i* chars = (__m256i*)(destination + i);
+
+		for (uint8_t j = 0; j < 4; j++)
 		{
-			destination[length] =
-				(uint32_t)(source[i] & 0b00000111) << 18 |
-				(uint32_t)(source[i + 1] & 0b00111111) << 12 |
-				(uint32_t)(source[i + 2] & 0b00111111) << 6 |
-				(uint32_t)(source[i + 3] & 0b00111111);
-			i += 4;
+			__m128i value = _mm_loadl_epi64(
+				(const __m128i*)(bytes + j * 8));
+			_mm256_storeu_si256(chars + j,
+				_mm256_cvtepu8_epi32(value));
 		}
-		else
-		{
+	}
+#elif defined(__SSE2__) || defined(_M_X64)
+	__m128i zero = _mm_setzero_si128();
+
+	for (; i + 16 <= sourceLength; i += 16)
+	{
+		__m128i values = _mm_loadu_si128(
+			(const __m128i*)(source + i));
+
+		if (_mm_movemask_epi8(values) != 0)
+			break;
+
+		__m128i low = _mm_unpacklo_epi8(values, zero);
+		__m128i high = _mm_unpackhi_epi8(values, zero);
+		__m128i* chars = (__m128i*)(destination + i);
+		_mm_storeu_si128(chars, _mm_unpacklo_epi16(low, zero));
+		_mm_storeu_si128(chars + 1, _mm_unpackhi_epi16(low, zero));
+		_mm_storeu_si128(chars + 2, _mm_unpacklo_epi16(high, zero));
+		_mm_storeu_si128(chars + 3, _mm_unpackhi_epi16(high, zero));
+	}
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+	for (; i + 16 <= sourceLength; i += 16)
+	{
+		uint8x16_t values = vld1q_u8(
+			(const uint8_t*)(source + i));
+
+		if (vmaxvq_u8(values) >= 0b10000000)
+			break;
+
+		uint16x8_t low = vmovl_u8(vget_low_u8(values));
+		uint16x8_t high = vmovl_u8(vget_high_u8(values));
+		uint32_t* chars = destination + i;
+		vst1q_u32(chars, vmovl_u16(vget_low_u16(low)));
+		vst1q_u32(chars + 4, vmovl_u16(vget_high_u16(low)));
+		vst1q_u32(chars + 8, vmovl_u16(vget_low_u16(high)));
+		vst1q_u32(chars + 12, vmovl_u16(vget_high_u16(high)));
+	}
+#endif
+
+	for (; i < sourceLength; i++)
+	{
+		char value = source[i];
+
+		if ((value & 0b10000000) != 0)
+			break;
+
+		destination[i] = (uint32_t)value;
+	}
+
+	return i;
+}
+inline static size_t decodeCharUTF8(
+	const char* source,
+	size_t sourceLength,
+	uint32_t* destination)
+{
+	assert(source);
+	assert(sourceLength > 0);
+	assert(destination);
+
+	char value = source[0];
+
+	if ((value & 0b10000000) == 0)
+	{
+		*destination = (uint32_t)value;
+		return 1;
+	}
+	else if (1 < sourceLength &&
+		!((value & 0b11100000) ^ 0b11000000 ||
+		(source[1] & 0b11000000) ^ 0b10000000))
+	{
+		*destination =
+			(uint32_t)(value & 0b00011111) << 6 |
+			(uint32_t)(source[1] & 0b00111111);
+		return 2;
+	}
+	else if (2 < sourceLength &&
+		!((value & 0b11110000) ^ 0b11100000 ||
+		(source[1] & 0b11000000) ^ 0b10000000 ||
+		(source[2] & 0b11000000) ^ 0b10000000))
+	{
+		*destination =
+			(uint32_t)(value & 0b00001111) << 12 |
+			(uint32_t)(source[1] & 0b00111111) << 6 |
+			(uint32_t)(source[2] & 0b00111111);
+		return 3;
+	}
+	else if (3 < sourceLength &&
+		!((value & 0b11111000) ^ 0b11110000 ||
+		(source[1] & 0b11000000) ^ 0b10000000 ||
+		(source[2] & 0b11000000) ^ 0b10000000 ||
+		(source[3] & 0b11000000) ^ 0b10000000))
+	{
+		*destination =
+			(uint32_t)(value & 0b00000111) << 18 |
+			(uint32_t)(source[1] & 0b00111111) << 12 |
+			(uint32_t)(source[2] & 0b00111111) << 6 |
+			(uint32_t)(source[3] & 0b00111111);
+		return 4;
+	}
+
+	return 0;
+}
+inline static size_t countCharsUTF8(
+	const char* string,
+	size_t stringLength)
+{
+	assert(string);
+	assert(stringLength > 0);
+
+	size_t i = 0, length = 0;
+
+	while (true)
+	{
+		size_t count = getAsciiLengthUTF8(
+			string + i, stringLength - i);
+
+		i += count;
+		length += count;
+
+		if (i >= stringLength)
+			return length;
+
+		uint32_t value;
+
+		size_t size = decodeCharUTF8(
+			string + i,
+			stringLength - i,
+			&value);
+
+		if (size == 0)
 			return 0;
-		}
 
+		i += size;
 		length++;
 	}
+}
+
+size_t stringUTF8toUTF32(
+	const char* source,
+	size_t sourceLength,
+	uint32_t* destination)
+{
+	assert(source);
+	assert(sourceLength > 0);
+	assert(destination);
+
+	size_t i = 0, length = 0;
+
+	while (true)
+	{
+		size_t count = convertAsciiUTF8(
+			source + i,
+			sourceLength - i,
+			destination + length);
 
-	return length;
+		i += count;
+		length += count;
+
+		if (i >= sourceLength)
+			return length;
+
+		size_t size = decodeCharUTF8(
+			source + i,
+			sourceLength - i,
+			destination + length);
+
+		if (size == 0)
+			return 0;
+
+		i += size;
+		length++;
+	}
 }
 
 MpgxResult allocateStringUTF8(
@@ -405,33 +836,7 @@ bool validateStringUTF8(
 {
 	assert(string);
 	assert(stringLength > 0);
-
-	for (size_t i = 0; i < stringLength; i++)
-	{
-		char value = string[i];
-
-		if ((value & 0b10000000) ^ 0 ||
-
-			(i + 1 >= stringLength ||
-			(value & 0b11100000) ^ 0b11000000 ||
-			(string[i + 1] & 0b11000000) ^ 0b10000000) ||
-
-			(i + 2 >= stringLength ||
-			(value & 0b11110000) ^ 0b11100000 ||
-			(string[i + 1] & 0b11000000) ^ 0b10000000 ||
-			(string[i + 2] & 0b11000000) ^ 0b10000000) ||
-
-			(i + 3 >= stringLength ||
-			(value & 0b11111000) ^ 0b11110000 ||
-			(string[i + 1] & 0b11000000) ^ 0b10000000 ||
-			(string[i + 2] & 0b11000000) ^ 0b10000000 ||
-			(string[i + 3] & 0b11000000) ^ 0b10000000))
-		{
-			return false;
-		}
-	}
-
-	return true;
+	return countCharsUTF8(string, stringLength) > 0;
 }
 
 MpgxResult allocateStringUTF32(
@@ -445,44 +850,11 @@ MpgxResult allocateStringUTF32(
 	assert(destination);
 	assert(destinationLength);
 
-	size_t length = 0;
-
-	for (size_t i = 0; i < sourceLength;)
-	{
-		char value = source[i];
-
-		if ((value & 0b10000000) == 0)
-		{
-			i += 1;
-		}
-		else if (i + 1 < sourceLength &&
-			!((value & 0b11100000) ^ 0b11000000 ||
-			(source[i + 1] & 0b11000000) ^ 0b10000000))
-		{
-			i += 2;
-		}
-		else if (i + 2 < sourceLength &&
-			!((value & 0b11110000) ^ 0b11100000 ||
-			(source[i + 1] & 0b11000000) ^ 0b10000000 ||
-			(source[i + 2] & 0b11000000) ^ 0b10000000))
-		{
-			i += 3;
-		}
-		else if (i + 3 < sourceLength &&
-			!((value & 0b11111000) ^ 0b11110000 ||
-			(source[i + 1] & 0b11000000) ^ 0b10000000 ||
-			(source[i + 2] & 0b11000000) ^ 0b10000000 ||
-			(source[i + 3] & 0b11000000) ^ 0b10000000))
-		{
-			i += 4;
-		}
-		else
-		{
-			return BAD_VALUE_MPGX_RESULT;
-		}
+	size_t length = countCharsUTF8(
+		source, sourceLength);
 
-		length++;
-	}
+	if (length == 0)
+		return BAD_VALUE_MPGX_RESULT;
 
 	uint32_t* destinationArray = malloc(
 		(length + 1) * sizeof(uint32_t));
@@ -490,41 +862,10 @@ MpgxResult allocateStringUTF32(
 	if (!destinationArray)
 		return OUT_OF_HOST_MEMORY_MPGX_RESULT;
 
-	for (size_t i = 0, j = 0; i < sourceLength; j++)
-	{
-		char value = source[i];
-
-		if ((value & 0b10000000) == 0)
-		{
-			destinationArray[j] = (uint32_t)source[i];
-			i += 1;
-		}
-		else if ((value & 0b11100000) == 0b11000000)
-		{
-			destinationArray[j] =
-				(uint32_t)(source[i] & 0b00011111) << 6 |
-				(uint32_t)(source[i + 1] & 0b00111111);
-			i += 2;
-		}
-		else if ((value & 0b11110000) == 0b11100000)
-		{
-			destinationArray[j] =
-				(uint32_t)(source[i] & 0b00001111) << 12 |
-				(uint32_t)(source[i + 1] & 0b00111111) << 6 |
-				(uint32_t)(source[i + 2] & 0b00111111);
-			i += 3;
-		}
-		else
-		{
-			destinationArray[j] =
-				(uint32_t)(source[i] & 0b00000111) << 18 |
-				(uint32_t)(source[i + 1] & 0b00111111) << 12 |
-				(uint32_t)(source[i + 2] & 0b00111111) << 6 |
-				(uint32_t)(source[i + 3] & 0b00111111);
-			i += 4;
-		}
-	}
-
+	stringUTF8toUTF32(
+		source,
+		sourceLength,
+		destinationArray);
 	destinationArray[length] = 0;
 
 	*destination = destinationArray;
@@ -549,42 +890,196 @@ bool validateStringUTF32(
 	return true;
 }
 
-Font createFont(
+inline static uint64_t hashFontAtlasData(
+	uint64_t hash,
 	const void* data,
-	size_t size,
-	size_t index,
-	Logger logger)
+	size_t size)
 {
-	assert(data);
-	assert(size > 0);
+	assert(data || size == 0);
 
-	if (!textInitialized)
-		return NULL;
+	const uint8_t* bytes = data;
 
-	Font font = calloc(1,
-		sizeof(Font_T));
+	// FNV-1a hash, enough to detect changed fonts.
+	for (size_t i = 0; i < size; i++)
+	{
+		hash ^= bytes[i];
+		hash *= 0x100000001B3u;
+	}
 
-	if (!font)
-		return NULL;
+	return hash;
+}
+inline static FontData* createFontData(
+	uint8_t* bytes,
+	size_t size)
+{
+	assert(bytes);
+	assert(size > 0);
 
-	uint8_t* dataArray = malloc(
-		size * sizeof(uint8_t));
+	FontData* data = malloc(sizeof(FontData));
 
-	if (!dataArray)
+	if (!data)
+		return NULL;
+
+	data->bytes = bytes;
+	data->size = size;
+	data->referenceCount = 1;
+	data->hash = 0;
+	data->modifiedTime = 0;
+	data->isMapped = false;
+	data->isHashed = false;
+	return data;
+}
+/*
+ * Maps font file to the read only memory, pages
+ * are loaded lazily and shared between processes.
+ */
+inline static FontData* mapFontData(const char* path)
+{
+	assert(path);
+
+#if __linux__ || __APPLE__
+	int file = open(path, O_RDONLY);
+
+	if (file == -1)
+		return NULL;
+
+	struct stat fileStat;
+
+	if (fstat(file, &fileStat) != 0 || fileStat.st_size <= 0)
 	{
-		destroyFont(font);
+		close(file);
 		return NULL;
 	}
 
-	font->data = dataArray;
-	memcpy(dataArray, data, size * sizeof(uint8_t));
+	size_t size = (size_t)fileStat.st_size;
+	uint64_t modifiedTime = (uint64_t)fileStat.st_mtime;
+
+	void* bytes = mmap(NULL, size,
+		PROT_READ, MAP_PRIVATE, file, 0);
+	close(file);
+
+	if (bytes == MAP_FAILED)
+		return NULL;
+#elif _WIN32
+	HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ,
+		NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+
+	if (file == INVALID_HANDLE_VALUE)
+		return NULL;
+
+	LARGE_INTEGER fileSize;
+
+	if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart <= 0)
+	{
+		CloseHandle(file);
+		return NULL;
+	}
+
+	size_t size = (size_t)fileSize.QuadPart;
+	FILETIME writeTime;
+
+	if (!GetFileTime(file, NULL, NULL, &writeTime))
+	{
+		CloseHandle(file);
+		return NULL;
+	}
+
+	uint64_t modifiedTime = (uint64_t)writeTime.dwHighDateTime << 32u |
+		(uint64_t)writeTime.dwLowDateTime;
+
+	HANDLE mapping = CreateFileMappingA(file,
+		NULL, PAGE_READONLY, 0, 0, NULL);
+	CloseHandle(file);
+
+	if (!mapping)
+		return NULL;
+
+	// View stays valid after the mapping handle is closed.
+	void* bytes = MapViewOfFile(mapping,
+		FILE_MAP_READ, 0, 0, 0);
+	CloseHandle(mapping);
+
+	if (!bytes)
+		return NULL;
+#else
+	return NULL;
+#endif
+
+#if __linux__ || __APPLE__ || _WIN32
+	FontData* data = malloc(sizeof(FontData));
+
+	if (!data)
+	{
+#if _WIN32
+		UnmapViewOfFile(bytes);
+#else
+		munmap(bytes, size);
+#endif
+		return NULL;
+	}
+
+	data->bytes = bytes;
+	data->size = size;
+	data->referenceCount = 1;
+	data->hash = 0;
+	data->modifiedTime = modifiedTime;
+	data->isMapped = true;
+	data->isHashed = false;
+	return data;
+#endif
+}
+inline static void releaseFontData(FontData* data)
+{
+	if (!data)
+		return;
+
+	assert(data->referenceCount > 0);
+
+	if (--data->referenceCount > 0)
+		return;
+
+	if (data->isMapped)
+	{
+#if __linux__ || __APPLE__
+		munmap((void*)data->bytes, data->size);
+#elif _WIN32
+		UnmapViewOfFile(data->bytes);
+#else
+		abort();
+#endif
+	}
+	else
+	{
+		free((void*)data->bytes);
+	}
+
+	free(data);
+}
+inline static Font createDataFont(
+	FontData* data,
+	size_t index,
+	const char* path,
+	Logger logger)
+{
+	assert(data);
+
+	Font font = calloc(1,
+		sizeof(Font_T));
+
+	if (!font)
+	{
+		releaseFontData(data);
+		return NULL;
+	}
+
+	font->data = data;
 
 	FT_Face face;
 
 	FT_Error ftResult = FT_New_Memory_Face(
 		ftLibrary,
-		dataArray,
-		(FT_Long)size,
+		data->bytes,
+		(FT_Long)data->size,
 		(FT_Long)index,
 		&face);
 
@@ -593,8 +1088,9 @@ Font createFont(
 		if (logger)
 		{
 			logMessage(logger, ERROR_LOG_LEVEL,
-				"Failed to create FreeType memory face. (error: %s)",
-				FT_Error_String(ftResult));
+				"Failed to create FreeType memory face. "
+				"(error: %s, path: %s)",
+				FT_Error_String(ftResult), path);
 		}
 		destroyFont(font);
 		return NULL;
@@ -610,8 +1106,9 @@ Font createFont(
 		if (logger)
 		{
 			logMessage(logger, ERROR_LOG_LEVEL,
-				"Failed to select FreeType char map. (error: %s)",
-				FT_Error_String(ftResult));
+				"Failed to select FreeType char map. "
+				"(error: %s, path: %s)",
+				FT_Error_String(ftResult), path);
 		}
 		destroyFont(font);
 		return NULL;
@@ -619,6 +1116,43 @@ Font createFont(
 
 	return font;
 }
+
+Font createFont(
+	const void* data,
+	size_t size,
+	size_t index,
+	Logger logger)
+{
+	assert(data);
+	assert(size > 0);
+
+	if (!textInitialized)
+		return NULL;
+
+	uint8_t* dataArray = malloc(
+		size * sizeof(uint8_t));
+
+	if (!dataArray)
+		return NULL;
+
+	memcpy(dataArray, data, size * sizeof(uint8_t));
+
+	FontData* fontData = createFontData(
+		dataArray,
+		size);
+
+	if (!fontData)
+	{
+		free(dataArray);
+		return NULL;
+	}
+
+	return createDataFont(
+		fontData,
+		index,
+		"memory",
+		logger);
+}
 Font createFontFromFile(
 	const char* path,
 	size_t index,
@@ -629,6 +1163,19 @@ Font createFontFromFile(
 	if (!textInitialized)
 		return NULL;
 
+	FontData* fontData = mapFontData(path);
+
+	if (fontData)
+	{
+		return createDataFont(
+			fontData,
+			index,
+			path,
+			logger);
+	}
+
+	// Fallback to the FreeType file stream,
+	// if memory mapping is not available.
 	Font font = calloc(1,
 		sizeof(Font_T));
 
@@ -684,10 +1231,12 @@ Font createFontFromPack(
 	PackReader packReader,
 	Logger logger)
 {
-
 	assert(path);
 	assert(packReader);
 
+	if (!textInitialized)
+		return NULL;
+
 	const uint8_t* data;
 	uint32_t size;
 
@@ -709,10 +1258,50 @@ Font createFontFromPack(
 		return NULL;
 	}
 
-	return createFont(
+	// Pack item data is decompressed to the
+	// allocated array, font takes its ownership.
+	FontData* fontData = createFontData(
+		(uint8_t*)data,
+		size);
+
+	if (!fontData)
+	{
+		free((void*)data);
+		return NULL;
+	}
+
+	return createDataFont(
+		fontData,
+		index,
+		path,
+		logger);
+}
+Font createSharedFont(
+	Font font,
+	size_t index,
+	Logger logger)
+{
+	assert(font);
+	assert(textInitialized);
+
+	FontData* data = font->data;
+
+	if (!data)
+	{
+		if (logger)
+		{
+			logMessage(logger, ERROR_LOG_LEVEL,
+				"Failed to share not memory font data.");
+		}
+		return NULL;
+	}
+
+	data->referenceCount++;
+
+	return createDataFont(
 		data,
-		size,
 		index,
+		"shared",
 		logger);
 }
 void destroyFont(Font font)
@@ -722,9 +1311,19 @@ void destroyFont(Font font)
 
 	assert(textInitialized);
 
+	uint8_t** coverage = font->coverage;
+
+	if (coverage)
+	{
+		for (size_t i = 0; i < FONT_COVERAGE_PAGE_COUNT; i++)
+			free(coverage[i]);
+		free(coverage);
+	}
+
+	// Face should be destroyed before its data.
 	if (font->face)
 		FT_Done_Face(font->face);
-	free(font->data);
+	releaseFontData(font->data);
 	free(font);
 }
 
@@ -742,14 +1341,13 @@ static int compareGlyph(const void* a, const void* b)
 inline static size_t bakeGlyphs(
 	const uint32_t* string,
 	size_t length,
-	Glyph* glyphs)
+	Glyph* glyphs,
+	size_t count)
 {
 	assert(string);
 	assert(length > 0);
 	assert(glyphs);
 
-	size_t count = 0;
-
 	for (size_t i = 0; i < length; i++)
 	{
 		uint32_t value = string[i];
@@ -804,170 +1402,518 @@ inline static bool setFtPixelSize(
 
 	return true;
 }
-inline static bool fillPixels(
-	Font* fonts,
-	size_t fontCount,
-	uint32_t fontSize,
-	Glyph* glyphs,
-	size_t glyphCount,
-	uint32_t glyphLength,
-	uint32_t pixelLength,
-	uint8_t fontIndex,
-	uint8_t* pixelBuffer,
-	Logger logger)
+/*
+ * Builds font codepoint coverage bitmap from the char map,
+ * with pages allocated only for the covered codepoint ranges.
+ */
+inline static bool createFontCoverage(Font font)
 {
-	assert(fonts);
-	assert(fontCount > 0);
-	assert(fontSize > 0);
-	assert(glyphs);
-	assert(glyphCount > 0);
-	assert(glyphLength > 0);
-	assert(pixelBuffer);
+	assert(font);
+	assert(!font->coverage);
 
-	for (size_t i = 0; i < fontCount; i++)
-	{
-		bool result = setFtPixelSize(
-			fonts[i]->face,
-			fontSize,
-			logger);
-
-		if (!result)
-			return false;
-	}
+	uint8_t** coverage = calloc(
+		FONT_COVERAGE_PAGE_COUNT,
+		sizeof(uint8_t*));
 
-	FT_Face mainFace = fonts[0]->face;
+	if (!coverage)
+		return false;
 
-	for (size_t i = 0; i < glyphCount; i++)
-	{
-		Glyph glyph;
-		glyph.value = glyphs[i].value;
+	FT_Face face = font->face;
+	FT_UInt charIndex;
 
-		FT_UInt charIndex = FT_Get_Char_Index(
-			mainFace,
-			glyph.value);
-		FT_Face charFace = mainFace;
+	FT_ULong value = FT_Get_First_Char(
+		face,
+		&charIndex);
 
-		if (charIndex == 0 && glyph.value != '\0')
+	while (charIndex != 0)
+	{
+		if (value < FONT_COVERAGE_PAGE_SIZE * FONT_COVERAGE_PAGE_COUNT)
 		{
-			for (size_t j = 1; j < fontCount; j++)
-			{
-				FT_Face face = fonts[j]->face;
+			uint8_t* page = coverage[value / FONT_COVERAGE_PAGE_SIZE];
 
-				charIndex = FT_Get_Char_Index(
-					face,
-					glyph.value);
+			if (!page)
+			{
+				page = calloc(
+					FONT_COVERAGE_PAGE_SIZE / 8,
+					sizeof(uint8_t));
 
-				if (charIndex != 0)
+				if (!page)
 				{
-					charFace = face;
-					break;
+					for (size_t i = 0; i < FONT_COVERAGE_PAGE_COUNT; i++)
+						free(coverage[i]);
+					free(coverage);
+					return false;
 				}
-			}
-		}
 
-		FT_Error ftResult = FT_Load_Glyph(
-			charFace,
-			charIndex,
-			FT_LOAD_RENDER);
-
-		if (ftResult != 0)
-		{
-			if (logger)
-			{
-				logMessage(logger, ERROR_LOG_LEVEL,
-					"Failed to load FreeType glyph. (error: %s)",
-					FT_Error_String(ftResult));
+				coverage[value / FONT_COVERAGE_PAGE_SIZE] = page;
 			}
-			return false;
+
+			size_t pageIndex = value % FONT_COVERAGE_PAGE_SIZE;
+			page[pageIndex / 8] |= (uint8_t)(1u << (pageIndex % 8));
 		}
 
-		FT_GlyphSlot glyphSlot = charFace->glyph;
-		uint32_t glyphWidth = glyphSlot->bitmap.width;
-		uint32_t glyphHeight = glyphSlot->bitmap.rows;
-		uint32_t baseWidth = glyphWidth;
+		value = FT_Get_Next_Char(
+			face,
+			value,
+			&charIndex);
+	}
 
-		if (glyphWidth > fontSize)
-			glyphWidth = fontSize;
-		if (glyphHeight > fontSize)
-			glyphHeight = fontSize;
+	font->coverage = coverage;
+	return true;
+}
+inline static bool isFontCovering(
+	Font font,
+	uint32_t value)
+{
+	// Note: skipping assertions for debug build speed.
 
-		glyph.advance = ((float)glyphSlot->advance.x /
-			64.0f) / (float)fontSize;
+	if (value >= FONT_COVERAGE_PAGE_SIZE * FONT_COVERAGE_PAGE_COUNT)
+		return false;
 
-		if (glyphWidth * glyphHeight == 0)
-		{
-			glyph.isVisible = false;
-		}
-		else
-		{
-			uint8_t* bitmap = glyphSlot->bitmap.buffer;
-			uint32_t glyphPosY = (uint32_t)(i / glyphLength);
-			uint32_t glyphPosX = (uint32_t)(i - (size_t)glyphPosY * glyphLength);
-			uint32_t pixelPosX = glyphPosX * fontSize;
-			uint32_t pixelPosY = glyphPosY * fontSize;
-
-			glyph.positionX = (float)glyphSlot->bitmap_left / (float)fontSize;
-			glyph.positionY = ((float)glyphSlot->bitmap_top - (float)glyphHeight) / (float)fontSize;
-			glyph.positionZ = glyph.positionX + (float)glyphWidth / (float)fontSize;
-			glyph.positionW = glyph.positionY + (float)glyphHeight /(float)fontSize;
-			glyph.texCoordsX = (float)pixelPosX / (float)pixelLength;
-			glyph.texCoordsY = (float)pixelPosY / (float)pixelLength;
-			glyph.texCoordsZ = glyph.texCoordsX + (float)glyphWidth / (float)pixelLength;
-			glyph.texCoordsW = glyph.texCoordsY + (float)glyphHeight / (float)pixelLength;
-			glyph.isVisible = true;
-
-			for (uint32_t y = 0; y < glyphHeight; y++)
-			{
-				for (uint32_t x = 0; x < glyphWidth; x++)
-				{
-					pixelBuffer[fontIndex + ((x + pixelPosX) +
-						(y + pixelPosY) * pixelLength) * 4] =
-						bitmap[x + y * baseWidth];
-				}
-			}
-		}
+	const uint8_t* page = font->coverage[value / FONT_COVERAGE_PAGE_SIZE];
 
-		glyphs[i] = glyph;
-	}
+	if (!page)
+		return false;
 
-	return true;
+	size_t pageIndex = value % FONT_COVERAGE_PAGE_SIZE;
+	return (page[pageIndex / 8] >> (pageIndex % 8)) & 1u;
 }
 
-#if MPGX_SUPPORT_VULKAN
-inline static MpgxResult createVkDescriptorPool(
-	VkDevice device,
-	VkDescriptorPool* descriptorPool)
+inline static size_t hashGlyphSource(uint32_t value)
 {
-	assert(device);
-	assert(descriptorPool);
+	return (size_t)(value * 2654435761u);
+}
+inline static bool resizeGlyphSourceMap(
+	GlyphSourceMap* map,
+	size_t capacity)
+{
+	assert(map);
+	assert(capacity > map->count * 2);
+	assert((capacity & (capacity - 1)) == 0);
 
-	VkDescriptorPoolSize descriptorPoolSizes[1] = {
-		{
-			VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-			1,
-		},
-	};
-	VkDescriptorPoolCreateInfo descriptorPoolCreateInfo = {
-		VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
-		NULL,
-		0,
-		1,
-		1,
-		descriptorPoolSizes,
-	};
+	GlyphSource* sources = malloc(
+		capacity * sizeof(GlyphSource));
 
-	VkDescriptorPool descriptorPoolInstance;
+	if (!sources)
+		return false;
 
-	VkResult vkResult = vkCreateDescriptorPool(
-		device,
-		&descriptorPoolCreateInfo,
-		NULL,
-		&descriptorPoolInstance);
+	for (size_t i = 0; i < capacity; i++)
+		sources[i].value = UINT32_MAX;
 
-	if (vkResult != VK_SUCCESS)
-		return vkToMpgxResult(vkResult);
+	GlyphSource* oldSources = map->sources;
+	size_t oldCapacity = map->capacity;
 
-	*descriptorPool = descriptorPoolInstance;
+	for (size_t i = 0; i < oldCapacity; i++)
+	{
+		GlyphSource source = oldSources[i];
+
+		if (source.value == UINT32_MAX)
+			continue;
+
+		size_t index = hashGlyphSource(source.value) & (capacity - 1);
+
+		while (sources[index].value != UINT32_MAX)
+			index = (index + 1) & (capacity - 1);
+
+		sources[index] = source;
+	}
+
+	free(oldSources);
+	map->sources = sources;
+	map->capacity = capacity;
+	return true;
+}
+/*
+ * Returns font and char index of the glyph, falling back to
+ * the next fonts if the main one does not contain it.
+ * Result is stored in the font atlas map, to not resolve
+ * known glyphs again on the font atlas rebuild.
+ */
+inline static bool getGlyphSource(
+	Font* fonts,
+	size_t fontCount,
+	GlyphSourceMap* map,
+	uint32_t value,
+	GlyphSource* _source)
+{
+	assert(fonts);
+	assert(fontCount > 0);
+	assert(map);
+	assert(_source);
+
+	size_t capacity = map->capacity;
+
+	if (capacity > 0)
+	{
+		size_t index = hashGlyphSource(value) & (capacity - 1);
+		const GlyphSource* sources = map->sources;
+
+		while (sources[index].value != UINT32_MAX)
+		{
+			if (sources[index].value == value)
+			{
+				*_source = sources[index];
+				return true;
+			}
+
+			index = (index + 1) & (capacity - 1);
+		}
+	}
+
+	GlyphSource source;
+	source.value = value;
+	source.charIndex = 0;
+	source.fontIndex = 0;
+
+	if (value != '\0')
+	{
+		for (size_t i = 0; i < fontCount; i++)
+		{
+			Font font = fonts[i];
+
+			if (!font->coverage && !createFontCoverage(font))
+				return false;
+
+			if (isFontCovering(font, value))
+			{
+				source.charIndex = FT_Get_Char_Index(
+					font->face,
+					value);
+				source.fontIndex = (uint32_t)i;
+				break;
+			}
+		}
+	}
+
+	if ((map->count + 1) * 2 > capacity)
+	{
+		bool result = resizeGlyphSourceMap(
+			map,
+			capacity > 0 ? capacity * 2 : 64);
+
+		if (!result)
+			return false;
+
+		capacity = map->capacity;
+	}
+
+	size_t index = hashGlyphSource(value) & (capacity - 1);
+	GlyphSource* sources = map->sources;
+
+	while (sources[index].value != UINT32_MAX)
+		index = (index + 1) & (capacity - 1);
+
+	sources[index] = source;
+	map->count++;
+
+	*_source = source;
+	return true;
+}
+inline static bool setFontsPixelSize(
+	Font* fonts,
+	size_t fontCount,
+	uint32_t fontSize,
+	Logger logger)
+{
+	assert(fonts);
+	assert(fontCount > 0);
+	assert(fontSize > 0);
+
+	for (size_t i = 0; i < fontCount; i++)
+	{
+		bool result = setFtPixelSize(
+			fonts[i]->face,
+			fontSize,
+			logger);
+
+		if (!result)
+			return false;
+	}
+
+	return true;
+}
+inline static bool fillGlyphPixels(
+	Font* fonts,
+	size_t fontCount,
+	uint32_t fontSize,
+	uint32_t pixelPosX,
+	uint32_t pixelPosY,
+	uint32_t pixelLength,
+	uint8_t fontIndex,
+	uint8_t* pixelBuffer,
+	GlyphSourceMap* sourceMap,
+	Logger logger,
+	Glyph* glyph)
+{
+	assert(fonts);
+	assert(fontCount > 0);
+	assert(fontSize > 0);
+	assert(pixelBuffer);
+	assert(sourceMap);
+	assert(glyph);
+
+	GlyphSource source;
+
+	bool result = getGlyphSource(
+		fonts,
+		fontCount,
+		sourceMap,
+		glyph->value,
+		&source);
+
+	if (!result)
+	{
+		if (logger)
+		{
+			logMessage(logger, ERROR_LOG_LEVEL,
+				"Failed to allocate font coverage.");
+		}
+		return false;
+	}
+
+	FT_Face charFace = fonts[source.fontIndex]->face;
+
+	FT_Error ftResult = FT_Load_Glyph(
+		charFace,
+		source.charIndex,
+		FT_LOAD_RENDER);
+
+	if (ftResult != 0)
+	{
+		if (logger)
+		{
+			logMessage(logger, ERROR_LOG_LEVEL,
+				"Failed to load FreeType glyph. (error: %s)",
+				FT_Error_String(ftResult));
+		}
+		return false;
+	}
+
+	FT_GlyphSlot glyphSlot = charFace->glyph;
+	uint32_t glyphWidth = glyphSlot->bitmap.width;
+	uint32_t glyphHeight = glyphSlot->bitmap.rows;
+	uint32_t baseWidth = glyphWidth;
+
+	if (glyphWidth > fontSize)
+		glyphWidth = fontSize;
+	if (glyphHeight > fontSize)
+		glyphHeight = fontSize;
+
+	glyph->advance = ((float)glyphSlot->advance.x /
+		64.0f) / (float)fontSize;
+
+	if (glyphWidth * glyphHeight == 0)
+	{
+		glyph->isVisible = false;
+		return true;
+	}
+
+	uint8_t* bitmap = glyphSlot->bitmap.buffer;
+
+	glyph->positionX = (float)glyphSlot->bitmap_left / (float)fontSize;
+	glyph->positionY = ((float)glyphSlot->bitmap_top - (float)glyphHeight) / (float)fontSize;
+	glyph->positionZ = glyph->positionX + (float)glyphWidth / (float)fontSize;
+	glyph->positionW = glyph->positionY + (float)glyphHeight /(float)fontSize;
+	glyph->texCoordsX = (float)pixelPosX / (float)pixelLength;
+	glyph->texCoordsY = (float)pixelPosY / (float)pixelLength;
+	glyph->texCoordsZ = glyph->texCoordsX + (float)glyphWidth / (float)pixelLength;
+	glyph->texCoordsW = glyph->texCoordsY + (float)glyphHeight / (float)pixelLength;
+	glyph->isVisible = true;
+
+	for (uint32_t y = 0; y < glyphHeight; y++)
+	{
+		for (uint32_t x = 0; x < glyphWidth; x++)
+		{
+			pixelBuffer[fontIndex + ((x + pixelPosX) +
+				(y + pixelPosY) * pixelLength) * 4] =
+				bitmap[x + y * baseWidth];
+		}
+	}
+
+	return true;
+}
+/*
+ * Fills atlas bottom right texel with white in all channels,
+ * it is sampled by the solid quads drawn with the glyphs.
+ * Last atlas cell is reserved, so glyphs never cover it.
+ */
+inline static void fillWhiteTexel(
+	uint8_t* pixelBuffer,
+	uint32_t pixelLength)
+{
+	assert(pixelBuffer);
+	assert(pixelLength > 0);
+
+	memset(pixelBuffer + ((size_t)pixelLength *
+		pixelLength - 1) * 4, 255, 4 * sizeof(uint8_t));
+}
+inline static bool fillPixels(
+	Font* fonts,
+	size_t fontCount,
+	uint32_t fontSize,
+	Glyph* glyphs,
+	size_t glyphCount,
+	uint32_t glyphLength,
+	uint32_t pixelLength,
+	uint8_t fontIndex,
+	uint8_t* pixelBuffer,
+	GlyphSourceMap* sourceMap,
+	Logger logger)
+{
+	assert(fonts);
+	assert(fontCount > 0);
+	assert(fontSize > 0);
+	assert(glyphs);
+	assert(glyphCount > 0);
+	assert(glyphLength > 0);
+	assert(pixelBuffer);
+	assert(sourceMap);
+
+	bool result = setFontsPixelSize(
+		fonts,
+		fontCount,
+		fontSize,
+		logger);
+
+	if (!result)
+		return false;
+
+	for (size_t i = 0; i < glyphCount; i++)
+	{
+		Glyph glyph;
+		glyph.value = glyphs[i].value;
+
+		uint32_t glyphPosY = (uint32_t)(i / glyphLength);
+		uint32_t glyphPosX = (uint32_t)(i - (size_t)glyphPosY * glyphLength);
+
+		result = fillGlyphPixels(
+			fonts,
+			fontCount,
+			fontSize,
+			glyphPosX * fontSize,
+			glyphPosY * fontSize,
+			pixelLength,
+			fontIndex,
+			pixelBuffer,
+			sourceMap,
+			logger,
+			&glyph);
+
+		if (!result)
+			return false;
+
+		glyphs[i] = glyph;
+	}
+
+	return true;
+}
+
+static int compareGlyphValue(const void* a, const void* b)
+{
+	// NOTE: a and b should not be NULL!
+	// Skipping assertion for debug build speed.
+
+	uint32_t av = *(const uint32_t*)a;
+	uint32_t bv = *(const uint32_t*)b;
+	if (av < bv) return -1;
+	if (av > bv) return 1;
+	return 0;
+}
+static int compareFontAtlasCell(const void* a, const void* b)
+{
+	// NOTE: a and b should not be NULL!
+	// Skipping assertion for debug build speed.
+
+	uint64_t af = ((const FontAtlasCell*)a)->frame;
+	uint64_t bf = ((const FontAtlasCell*)b)->frame;
+	if (af < bf) return -1;
+	if (af > bf) return 1;
+	return 0;
+}
+inline static bool fillFontAtlasCell(
+	FontAtlas fontAtlas,
+	size_t glyphIndex)
+{
+	assert(fontAtlas);
+	assert(glyphIndex < fontAtlas->glyphCount);
+
+	uint32_t cellIndex = fontAtlas->glyphCells[glyphIndex];
+	uint32_t cellLength = fontAtlas->cellLength;
+	uint32_t fontSize = fontAtlas->fontSize;
+	uint32_t pixelLength = cellLength * fontSize;
+	uint32_t pixelPosX = (cellIndex % cellLength) * fontSize;
+	uint32_t pixelPosY = (cellIndex / cellLength) * fontSize;
+	uint8_t* pixels = fontAtlas->pixels;
+
+	// Cell can contain the evicted glyph pixels.
+	for (uint32_t y = 0; y < fontSize; y++)
+	{
+		memset(pixels + (pixelPosX + (size_t)(y + pixelPosY) *
+			pixelLength) * 4, 0, (size_t)fontSize * 4);
+	}
+
+	Font* fonts = fontAtlas->fonts;
+	size_t fontCount = fontAtlas->fontCount;
+	Glyph* glyphs = fontAtlas->glyphs;
+	size_t glyphCapacity = fontAtlas->glyphCapacity;
+
+	for (uint8_t i = 0; i < 4; i++)
+	{
+		bool result = fillGlyphPixels(
+			fonts + fontCount * i,
+			fontCount,
+			fontSize,
+			pixelPosX,
+			pixelPosY,
+			pixelLength,
+			i,
+			pixels,
+			&fontAtlas->sourceMaps[i],
+			fontAtlas->logger,
+			glyphs + glyphCapacity * i + glyphIndex);
+
+		if (!result)
+			return false;
+	}
+
+	return true;
+}
+
+#if MPGX_SUPPORT_VULKAN
+inline static MpgxResult createVkDescriptorPool(
+	VkDevice device,
+	VkDescriptorPool* descriptorPool)
+{
+	assert(device);
+	assert(descriptorPool);
+
+	VkDescriptorPoolSize descriptorPoolSizes[1] = {
+		{
+			VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+			1,
+		},
+	};
+	VkDescriptorPoolCreateInfo descriptorPoolCreateInfo = {
+		VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+		NULL,
+		0,
+		1,
+		1,
+		descriptorPoolSizes,
+	};
+
+	VkDescriptorPool descriptorPoolInstance;
+
+	VkResult vkResult = vkCreateDescriptorPool(
+		device,
+		&descriptorPoolCreateInfo,
+		NULL,
+		&descriptorPoolInstance);
+
+	if (vkResult != VK_SUCCESS)
+		return vkToMpgxResult(vkResult);
+
+	*descriptorPool = descriptorPoolInstance;
 	return SUCCESS_MPGX_RESULT;
 }
 inline static MpgxResult createVkDescriptorSet(
@@ -1037,22 +1983,382 @@ inline static MpgxResult createVkDescriptorSet(
 }
 #endif
 
-inline static MpgxResult internalCreateFontAtlas(
-	GraphicsPipeline textPipeline,
+inline static bool setFontAtlasFonts(
+	FontAtlas fontAtlas,
 	Font* regularFonts,
 	Font* boldFonts,
 	Font* italicFonts,
 	Font* boldItalicFonts,
-	size_t fontCount,
-	uint32_t fontSize,
+	size_t fontCount)
+{
+	assert(fontAtlas);
+	assert(fontCount > 0);
+
+	Font* fontArray = malloc(
+		fontCount * 4 * sizeof(Font));
+
+	if (!fontArray)
+		return false;
+
+	fontAtlas->fonts = fontArray;
+	fontAtlas->fontCount = fontCount;
+
+	memcpy(fontArray, regularFonts,
+		fontCount * sizeof(Font));
+	memcpy(fontArray + fontCount, boldFonts,
+		fontCount * sizeof(Font));
+	memcpy(fontArray + fontCount * 2, italicFonts,
+		fontCount * sizeof(Font));
+	memcpy(fontArray + fontCount * 3, boldItalicFonts,
+		fontCount * sizeof(Font));
+	return true;
+}
+inline static MpgxResult createFontAtlasImage(
+	FontAtlas fontAtlas,
+	const uint8_t* pixels,
+	uint32_t pixelLength,
+	bool isConstant)
+{
+	assert(fontAtlas);
+	assert(pixels);
+	assert(pixelLength > 0);
+
+	GraphicsPipeline textPipeline = fontAtlas->pipeline;
+	Window window = textPipeline->base.window;
+
+	Image image;
+
+	MpgxResult mpgxResult = createImage(
+		window,
+		SAMPLED_IMAGE_TYPE,
+		IMAGE_2D,
+		R8G8B8A8_UNORM_IMAGE_FORMAT,
+		pixels,
+		vec3I(
+			(cmmt_int_t)pixelLength,
+			(cmmt_int_t)pixelLength,
+			1),
+		1,
+		isConstant,
+		&image);
+
+	if (mpgxResult != SUCCESS_MPGX_RESULT)
+		return mpgxResult;
+
+	fontAtlas->image = image;
+
+	// Solid quads need any atlas with the white texel.
+	Handle pipelineHandle = textPipeline->base.handle;
+
+	if (!pipelineHandle->base.quadAtlas)
+		pipelineHandle->base.quadAtlas = fontAtlas;
+
+#if MPGX_SUPPORT_VULKAN
+	GraphicsAPI api = getGraphicsAPI();
+
+	if (api == VULKAN_GRAPHICS_API)
+	{
+		VkWindow vkWindow = getVkWindow(window);
+
+		VkDescriptorPool descriptorPool;
+
+		mpgxResult = createVkDescriptorPool(
+			vkWindow->device,
+			&descriptorPool);
+
+		if (mpgxResult != SUCCESS_MPGX_RESULT)
+			return mpgxResult;
+
+		fontAtlas->descriptorPool = descriptorPool;
+
+		VkDescriptorSet descriptorSet;
+
+		mpgxResult = createVkDescriptorSet(
+			vkWindow->device,
+			pipelineHandle->vk.descriptorSetLayout,
+			descriptorPool,
+			pipelineHandle->vk.sampler->vk.handle,
+			image->vk.imageView,
+			&descriptorSet);
+
+		if (mpgxResult != SUCCESS_MPGX_RESULT)
+			return mpgxResult;
+
+		fontAtlas->descriptorSet = descriptorSet;
+	}
+	else
+	{
+		fontAtlas->descriptorPool = NULL;
+		fontAtlas->descriptorSet = NULL;
+	}
+#endif
+
+	return SUCCESS_MPGX_RESULT;
+}
+
+/*
+ * Font atlas cache file layout: header, then
+ * glyph array for each font style, then RGBA pixels.
+ */
+#define FONT_ATLAS_CACHE_MAGIC 0x43414655u // "UFAC"
+#define FONT_ATLAS_CACHE_VERSION 2u
+#define FONT_ATLAS_CACHE_MAX_LENGTH 16384u
+
+typedef struct FontAtlasCacheHeader
+{
+	uint32_t magic;
+	uint32_t version;
+	uint64_t key;
+	uint32_t glyphSize;
+	uint32_t fontSize;
+	uint32_t glyphCount;
+	uint32_t pixelLength;
+	float newLineAdvance;
+	uint8_t _alignment[4];
+} FontAtlasCacheHeader;
+
+inline static uint64_t hashFontAtlasFont(
+	uint64_t hash,
+	Font font)
+{
+	assert(font);
+
+	FontData* data = font->data;
+
+	// Owned font data is already in the memory,
+	// so it is hashed once, when key is needed.
+	if (data && !data->isMapped)
+	{
+		if (!data->isHashed)
+		{
+			data->hash = hashFontAtlasData(0xCBF29CE484222325u,
+				data->bytes, data->size);
+			data->isHashed = true;
+		}
+
+		return hashFontAtlasData(hash, &data->hash, sizeof(uint64_t));
+	}
+
+	// File font pages are not read for the key, so the file
+	// modified time, face properties and the head table are used.
+	FT_Face face = font->face;
+	const char* familyName = face->family_name;
+	const char* styleName = face->style_name;
+	const TT_Header* header = FT_Get_Sfnt_Table(face, FT_SFNT_HEAD);
+	uint64_t values[7] = {
+		(uint64_t)face->num_glyphs,
+		(uint64_t)face->units_per_EM,
+		(uint64_t)face->stream->size,
+		data ? data->modifiedTime : 0,
+		header ? (uint64_t)header->CheckSum_Adjust : 0,
+		header ? (uint64_t)header->Modified[0] : 0,
+		header ? (uint64_t)header->Modified[1] : 0,
+	};
+
+	if (familyName)
+		hash = hashFontAtlasData(hash, familyName, strlen(familyName));
+	if (styleName)
+		hash = hashFontAtlasData(hash, styleName, strlen(styleName));
+	return hashFontAtlasData(hash, values, sizeof(values));
+}
+uint64_t getFontAtlasCacheKey(
+	Font* regularFonts,
+	Font* boldFonts,
+	Font* italicFonts,
+	Font* boldItalicFonts,
+	size_t fontCount,
+	uint32_t fontSize,
+	const uint32_t* chars,
+	size_t charCount)
+{
+	assert(regularFonts);
+	assert(boldFonts);
+	assert(italicFonts);
+	assert(boldItalicFonts);
+	assert(fontCount > 0);
+	assert(fontSize > 0);
+	assert(chars);
+	assert(charCount > 0);
+
+	// Glyph bitmaps can differ between FreeType versions.
+	uint32_t values[5] = {
+		FREETYPE_MAJOR,
+		FREETYPE_MINOR,
+		FREETYPE_PATCH,
+		fontSize,
+		(uint32_t)fontCount,
+	};
+
+	uint64_t hash = hashFontAtlasData(
+		0xCBF29CE484222325u,
+		values,
+		sizeof(values));
+	hash = hashFontAtlasData(hash, chars,
+		charCount * sizeof(uint32_t));
+
+	Font* fonts[4] = {
+		regularFonts,
+		boldFonts,
+		italicFonts,
+		boldItalicFonts,
+	};
+
+	for (size_t i = 0; i < 4; i++)
+	{
+		for (size_t j = 0; j < fontCount; j++)
+			hash = hashFontAtlasFont(hash, fonts[i][j]);
+	}
+
+	return hash;
+}
+inline static bool writeFontAtlasCache(
+	FontAtlas fontAtlas,
+	uint64_t key,
+	const uint8_t* pixels,
+	uint32_t pixelLength,
+	const char* path)
+{
+	assert(fontAtlas);
+	assert(pixels);
+	assert(pixelLength > 0);
+	assert(path);
+
+	size_t glyphCapacity = fontAtlas->glyphCapacity;
+	size_t glyphCount = fontAtlas->glyphCount;
+	const Glyph* glyphs = fontAtlas->glyphs;
+
+	FontAtlasCacheHeader header;
+	memset(&header, 0, sizeof(FontAtlasCacheHeader));
+	header.magic = FONT_ATLAS_CACHE_MAGIC;
+	header.version = FONT_ATLAS_CACHE_VERSION;
+	header.key = key;
+	header.glyphSize = (uint32_t)sizeof(Glyph);
+	header.fontSize = fontAtlas->fontSize;
+	header.glyphCount = (uint32_t)glyphCount;
+	header.pixelLength = pixelLength;
+	header.newLineAdvance = fontAtlas->newLineAdvance;
+
+	FILE* file = openFile(path, "wb");
+
+	if (!file)
+		return false;
+
+	bool result = fwrite(&header, sizeof(FontAtlasCacheHeader),
+		1, file) == 1;
+
+	for (size_t i = 0; i < 4 && result; i++)
+	{
+		result = fwrite(glyphs + glyphCapacity * i, sizeof(Glyph),
+			glyphCount, file) == glyphCount;
+	}
+
+	size_t pixelCount = (size_t)pixelLength * pixelLength * 4;
+
+	if (result)
+	{
+		result = fwrite(pixels, sizeof(uint8_t),
+			pixelCount, file) == pixelCount;
+	}
+
+	result &= closeFile(file) == 0;
+
+	// Partially written cache should not be read later.
+	if (!result)
+		remove(path);
+	return result;
+}
+/*
+ * Validates font atlas cache data and
+ * fills glyphs of the font atlas instance.
+ * Returns cached pixels on success, otherwise NULL.
+ */
+inline static const uint8_t* readFontAtlasCache(
+	FontAtlas fontAtlas,
+	uint64_t key,
+	const uint8_t* data,
+	size_t size,
+	size_t charCount,
+	uint32_t* pixelLength)
+{
+	assert(fontAtlas);
+	assert(data);
+	assert(charCount > 0);
+	assert(pixelLength);
+
+	if (size < sizeof(FontAtlasCacheHeader))
+		return NULL;
+
+	FontAtlasCacheHeader header;
+	memcpy(&header, data, sizeof(FontAtlasCacheHeader));
+
+	if (header.magic != FONT_ATLAS_CACHE_MAGIC ||
+		header.version != FONT_ATLAS_CACHE_VERSION ||
+		header.key != key ||
+		header.glyphSize != sizeof(Glyph) ||
+		header.fontSize != fontAtlas->fontSize ||
+		header.glyphCount == 0 ||
+		header.glyphCount > charCount ||
+		header.pixelLength == 0 ||
+		header.pixelLength > FONT_ATLAS_CACHE_MAX_LENGTH)
+	{
+		return NULL;
+	}
+
+	size_t glyphCount = header.glyphCount;
+	uint32_t glyphLength = (uint32_t)ceil(sqrt((double)(glyphCount + 1)));
+
+	// Header comes from the file, sizes are checked before use.
+	if ((uint64_t)glyphLength * fontAtlas->fontSize != header.pixelLength ||
+		glyphCount > SIZE_MAX / (4 * sizeof(Glyph)))
+	{
+		return NULL;
+	}
+
+	size_t glyphsSize = glyphCount * 4 * sizeof(Glyph);
+	size_t imageLength = header.pixelLength;
+
+	if (imageLength > SIZE_MAX / 4 / imageLength)
+		return NULL;
+
+	size_t pixelsSize = imageLength * imageLength * 4;
+	size_t dataSize = size - sizeof(FontAtlasCacheHeader);
+
+	if (glyphsSize > dataSize || dataSize - glyphsSize != pixelsSize)
+		return NULL;
+
+	Glyph* glyphs = malloc(glyphsSize);
+
+	if (!glyphs)
+		return NULL;
+
+	memcpy(glyphs, data + sizeof(FontAtlasCacheHeader), glyphsSize);
+
+	fontAtlas->glyphs = glyphs;
+	fontAtlas->glyphCapacity = glyphCount;
+	fontAtlas->glyphCount = glyphCount;
+	fontAtlas->newLineAdvance = header.newLineAdvance;
+
+	*pixelLength = header.pixelLength;
+	return data + sizeof(FontAtlasCacheHeader) + glyphsSize;
+}
+
+inline static MpgxResult internalCreateFontAtlas(
+	GraphicsPipeline textPipeline,
+	Font* regularFonts,
+	Font* boldFonts,
+	Font* italicFonts,
+	Font* boldItalicFonts,
+	size_t fontCount,
+	uint32_t fontSize,
 	const uint32_t* chars,
 	size_t charCount,
+	const char* cachePath,
 	Logger logger,
 	FontAtlas* fontAtlas,
 	bool isGenerated,
 	bool isConstant)
 {
-	assert(textPipeline);
+	assert(textPipeline || cachePath);
 	assert(regularFonts);
 	assert(boldFonts);
 	assert(italicFonts);
@@ -1061,7 +2367,7 @@ inline static MpgxResult internalCreateFontAtlas(
 	assert(fontSize > 0);
 	assert(chars);
 	assert(charCount > 0);
-	assert(fontAtlas);
+	assert(fontAtlas || !textPipeline);
 	assert(fontSize % 2 == 0);
 	assert(textInitialized);
 
@@ -1093,26 +2399,21 @@ inline static MpgxResult internalCreateFontAtlas(
 		((float)defaultFace->size->metrics.height /
 		64.0f) / (float)fontSize;
 
-	Font* fontArray = malloc(
-		fontCount * 4 * sizeof(Font));
+	result = setFontAtlasFonts(
+		fontAtlasInstance,
+		regularFonts,
+		boldFonts,
+		italicFonts,
+		boldItalicFonts,
+		fontCount);
 
-	if (!fontArray)
+	if (!result)
 	{
 		destroyFontAtlas(fontAtlasInstance);
 		return OUT_OF_HOST_MEMORY_MPGX_RESULT;
 	}
 
-	fontAtlasInstance->fonts = fontArray;
-	fontAtlasInstance->fontCount = fontCount;
-
-	memcpy(fontArray, regularFonts,
-		fontCount * sizeof(Font));
-	memcpy(fontArray + fontCount, boldFonts,
-		fontCount * sizeof(Font));
-	memcpy(fontArray + fontCount * 2, italicFonts,
-		fontCount * sizeof(Font));
-	memcpy(fontArray + fontCount * 3, boldItalicFonts,
-		fontCount * sizeof(Font));
+	Font* fontArray = fontAtlasInstance->fonts;
 
 	Glyph* glyphArray = malloc(
 		charCount * 4 * sizeof(Glyph));
@@ -1129,7 +2430,8 @@ inline static MpgxResult internalCreateFontAtlas(
 	size_t glyphCount = bakeGlyphs(
 		chars,
 		charCount,
-		glyphArray);
+		glyphArray,
+		0);
 
 	if (glyphCount == 0)
 	{
@@ -1146,7 +2448,8 @@ inline static MpgxResult internalCreateFontAtlas(
 	memcpy(glyphArray + charCount * 3, glyphArray,
 		glyphCount * sizeof(Glyph));
 
-	uint32_t glyphLength = (uint32_t)ceil(sqrt((double)glyphCount));
+	// Last cell is reserved for the white texel.
+	uint32_t glyphLength = (uint32_t)ceil(sqrt((double)(glyphCount + 1)));
 	uint32_t pixelLength = glyphLength * fontSize;
 
 	uint8_t* pixelBuffer = calloc(
@@ -1169,6 +2472,7 @@ inline static MpgxResult internalCreateFontAtlas(
 		pixelLength,
 		0,
 		pixelBuffer,
+		&fontAtlasInstance->sourceMaps[0],
 		logger);
 
 	if (!result)
@@ -1188,6 +2492,7 @@ inline static MpgxResult internalCreateFontAtlas(
 		pixelLength,
 		1,
 		pixelBuffer,
+		&fontAtlasInstance->sourceMaps[1],
 		logger);
 
 	if (!result)
@@ -1207,6 +2512,7 @@ inline static MpgxResult internalCreateFontAtlas(
 		pixelLength,
 		2,
 		pixelBuffer,
+		&fontAtlasInstance->sourceMaps[2],
 		logger);
 
 	if (!result)
@@ -1226,6 +2532,7 @@ inline static MpgxResult internalCreateFontAtlas(
 		pixelLength,
 		3,
 		pixelBuffer,
+		&fontAtlasInstance->sourceMaps[3],
 		logger);
 
 	if (!result)
@@ -1235,23 +2542,46 @@ inline static MpgxResult internalCreateFontAtlas(
 		return UNKNOWN_ERROR_MPGX_RESULT;
 	}
 
-	Window window = textPipeline->base.window;
+	fillWhiteTexel(pixelBuffer, pixelLength);
 
-	Image image;
+	if (cachePath)
+	{
+		result = writeFontAtlasCache(
+			fontAtlasInstance,
+			getFontAtlasCacheKey(
+				regularFonts,
+				boldFonts,
+				italicFonts,
+				boldItalicFonts,
+				fontCount,
+				fontSize,
+				chars,
+				charCount),
+			pixelBuffer,
+			pixelLength,
+			cachePath);
 
-	MpgxResult mpgxResult = createImage(
-		window,
-		SAMPLED_IMAGE_TYPE,
-		IMAGE_2D,
-		R8G8B8A8_UNORM_IMAGE_FORMAT,
+		if (!result && logger)
+		{
+			logMessage(logger, WARN_LOG_LEVEL,
+				"Failed to write font atlas cache. (path: %s)",
+				cachePath);
+		}
+	}
+
+	// Cache generator does not create atlas image.
+	if (!textPipeline)
+	{
+		free(pixelBuffer);
+		destroyFontAtlas(fontAtlasInstance);
+		return result ? SUCCESS_MPGX_RESULT : UNKNOWN_ERROR_MPGX_RESULT;
+	}
+
+	MpgxResult mpgxResult = createFontAtlasImage(
+		fontAtlasInstance,
 		pixelBuffer,
-		vec3I(
-			(cmmt_int_t)pixelLength,
-			(cmmt_int_t)pixelLength,
-			1),
-		1,
-		isConstant,
-		&image);
+		pixelLength,
+		isConstant);
 
 	free(pixelBuffer);
 
@@ -1261,55 +2591,6 @@ inline static MpgxResult internalCreateFontAtlas(
 		return mpgxResult;
 	}
 
-	fontAtlasInstance->image = image;
-
-#if MPGX_SUPPORT_VULKAN
-	GraphicsAPI api = getGraphicsAPI();
-
-	if (api == VULKAN_GRAPHICS_API)
-	{
-		VkWindow vkWindow = getVkWindow(window);
-		Handle pipelineHandle = textPipeline->vk.handle;
-
-		VkDescriptorPool descriptorPool;
-
-		mpgxResult = createVkDescriptorPool(
-			vkWindow->device,
-			&descriptorPool);
-
-		if (mpgxResult != SUCCESS_MPGX_RESULT)
-		{
-			destroyFontAtlas(fontAtlasInstance);
-			return mpgxResult;
-		}
-
-		fontAtlasInstance->descriptorPool = descriptorPool;
-
-		VkDescriptorSet descriptorSet;
-
-		mpgxResult = createVkDescriptorSet(
-			vkWindow->device,
-			pipelineHandle->vk.descriptorSetLayout,
-			descriptorPool,
-			pipelineHandle->vk.sampler->vk.handle,
-			image->vk.imageView,
-			&descriptorSet);
-
-		if (mpgxResult != SUCCESS_MPGX_RESULT)
-		{
-			destroyFontAtlas(fontAtlasInstance);
-			return mpgxResult;
-		}
-
-		fontAtlasInstance->descriptorSet = descriptorSet;
-	}
-	else
-	{
-		fontAtlasInstance->descriptorPool = NULL;
-		fontAtlasInstance->descriptorSet = NULL;
-	}
-#endif
-
 	*fontAtlas = fontAtlasInstance;
 	return SUCCESS_MPGX_RESULT;
 }
@@ -1349,6 +2630,7 @@ MpgxResult createFontAtlas(
 		fontSize,
 		chars,
 		charCount,
+		NULL,
 		logger,
 		fontAtlas,
 		false,
@@ -1443,2341 +2725,6447 @@ MpgxResult createAsciiFontAtlas(
 		logger,
 		fontAtlas);
 }
-void destroyFontAtlas(FontAtlas fontAtlas)
-{
-	if (!fontAtlas)
-		return;
-
-	assert(textInitialized);
-
-#if MPGX_SUPPORT_VULKAN
-	GraphicsAPI api = getGraphicsAPI();
-
-	if (api == VULKAN_GRAPHICS_API)
-	{
-		VkWindow vkWindow = getVkWindow(
-			fontAtlas->pipeline->base.window);
-
-		vkDestroyDescriptorPool(
-			vkWindow->device,
-			fontAtlas->descriptorPool,
-			NULL);
-	}
-#endif
-
-	destroyImage(fontAtlas->image);
-	free(fontAtlas->glyphs);
-	free(fontAtlas->fonts);
-	free(fontAtlas);
-}
-
-GraphicsPipeline getFontAtlasPipeline(FontAtlas fontAtlas)
-{
-	assert(fontAtlas);
-	assert(textInitialized);
-	return fontAtlas->pipeline;
-}
-Font* getFontAtlasRegularFonts(FontAtlas fontAtlas)
-{
-	assert(fontAtlas);
-	assert(textInitialized);
-	return fontAtlas->fonts;
-}
-Font* getFontAtlasBoldFonts(FontAtlas fontAtlas)
-{
-	assert(fontAtlas);
-	assert(textInitialized);
-	return fontAtlas->fonts + fontAtlas->fontCount;
-}
-Font* getFontAtlasItalicFonts(FontAtlas fontAtlas)
-{
-	assert(fontAtlas);
-	assert(textInitialized);
-	return fontAtlas->fonts + fontAtlas->fontCount * 2;
-}
-Font* getFontAtlasBoldItalicFonts(FontAtlas fontAtlas)
-{
-	assert(fontAtlas);
-	assert(textInitialized);
-	return fontAtlas->fonts + fontAtlas->fontCount * 3;
-}
-size_t getFontAtlasFontCount(FontAtlas fontAtlas)
-{
-	assert(fontAtlas);
-	assert(textInitialized);
-	return fontAtlas->fontCount;
-}
-uint32_t getFontAtlasFontSize(FontAtlas fontAtlas)
-{
-	assert(fontAtlas);
-	assert(textInitialized);
-	return fontAtlas->fontSize;
-}
-Logger getFontAtlasLogger(FontAtlas fontAtlas)
-{
-	assert(fontAtlas);
-	assert(textInitialized);
-	return fontAtlas->logger;
-}
-bool isFontAtlasGenerated(FontAtlas fontAtlas)
+MpgxResult createFontAtlasFromCache(
+	GraphicsPipeline textPipeline,
+	Font* regularFonts,
+	Font* boldFonts,
+	Font* italicFonts,
+	Font* boldItalicFonts,
+	size_t fontCount,
+	uint32_t fontSize,
+	const uint32_t* chars,
+	size_t charCount,
+	const void* data,
+	size_t size,
+	Logger logger,
+	FontAtlas* fontAtlas)
 {
+	assert(textPipeline);
+	assert(regularFonts);
+	assert(boldFonts);
+	assert(italicFonts);
+	assert(boldItalicFonts);
+	assert(fontCount > 0);
+	assert(fontSize > 0);
+	assert(chars);
+	assert(charCount > 0);
+	assert(data);
+	assert(size > 0);
 	assert(fontAtlas);
+	assert(fontSize % 2 == 0);
 	assert(textInitialized);
-	return fontAtlas->isGenerated;
-}
 
-inline static MpgxResult bakeFontAtlas(
-	FontAtlas fontAtlas,
-	const uint32_t* string,
-	size_t length)
-{
-	assert(fontAtlas);
+	FontAtlas fontAtlasInstance = calloc(
+		1, sizeof(FontAtlas_T));
 
-	assert(length == 0 ||
-		   (length > 0 && string));
+	if (!fontAtlasInstance)
+		return OUT_OF_HOST_MEMORY_MPGX_RESULT;
 
-	if (length == 0)
-		return SUCCESS_MPGX_RESULT;
+	fontAtlasInstance->logger = logger;
+	fontAtlasInstance->pipeline = textPipeline;
+	fontAtlasInstance->fontSize = fontSize;
+	fontAtlasInstance->isGenerated = false;
 
-	Glyph* glyphs = fontAtlas->glyphs;
-	size_t glyphCapacity = fontAtlas->glyphCapacity;
+	bool result = setFontAtlasFonts(
+		fontAtlasInstance,
+		regularFonts,
+		boldFonts,
+		italicFonts,
+		boldItalicFonts,
+		fontCount);
 
-	if (fontAtlas->glyphCapacity < length)
+	if (!result)
 	{
-		glyphCapacity = length;
-
-		Glyph* newGlyphs = realloc(glyphs,
-			glyphCapacity * 4 * sizeof(Glyph));
+		destroyFontAtlas(fontAtlasInstance);
+		return OUT_OF_HOST_MEMORY_MPGX_RESULT;
+	}
 
-		if (!newGlyphs)
-			return OUT_OF_HOST_MEMORY_MPGX_RESULT;
+	uint64_t key = getFontAtlasCacheKey(
+		regularFonts,
+		boldFonts,
+		italicFonts,
+		boldItalicFonts,
+		fontCount,
+		fontSize,
+		chars,
+		charCount);
 
-		fontAtlas->glyphs = glyphs = newGlyphs;
-	}
+	uint32_t pixelLength;
 
-	size_t glyphCount = bakeGlyphs(
-		string,
-		length,
-		glyphs);
+	const uint8_t* pixels = readFontAtlasCache(
+		fontAtlasInstance,
+		key,
+		data,
+		size,
+		charCount,
+		&pixelLength);
 
-	if (glyphCount == 0)
+	if (!pixels)
+	{
+		destroyFontAtlas(fontAtlasInstance);
 		return BAD_VALUE_MPGX_RESULT;
+	}
 
-	fontAtlas->glyphCount = glyphCount;
-	fontAtlas->glyphCapacity = glyphCapacity;
+	MpgxResult mpgxResult = createFontAtlasImage(
+		fontAtlasInstance,
+		pixels,
+		pixelLength,
+		true);
 
-	memcpy(glyphs + glyphCapacity, glyphs,
-		glyphCount * sizeof(Glyph));
-	memcpy(glyphs + glyphCapacity * 2, glyphs,
-		glyphCount * sizeof(Glyph));
-	memcpy(glyphs + glyphCapacity * 3, glyphs,
-		glyphCount * sizeof(Glyph));
+	if (mpgxResult != SUCCESS_MPGX_RESULT)
+	{
+		destroyFontAtlas(fontAtlasInstance);
+		return mpgxResult;
+	}
 
-	uint32_t fontSize = fontAtlas->fontSize;
-	uint32_t glyphLength = (uint32_t)ceil(sqrt((double)glyphCount));
-	uint32_t newPixelLength = glyphLength * fontSize;
-	GraphicsPipeline textPipeline = fontAtlas->pipeline;
-	Handle pipelineHandle = textPipeline->base.handle;
-	uint8_t* pixelBuffer = pipelineHandle->base.pixelBuffer;
-	size_t pixelCapacity = pipelineHandle->base.pixelCapacity;
+	*fontAtlas = fontAtlasInstance;
+	return SUCCESS_MPGX_RESULT;
+}
+MpgxResult createCachedFontAtlas(
+	GraphicsPipeline textPipeline,
+	Font* regularFonts,
+	Font* boldFonts,
+	Font* italicFonts,
+	Font* boldItalicFonts,
+	size_t fontCount,
+	uint32_t fontSize,
+	const uint32_t* chars,
+	size_t charCount,
+	const char* cachePath,
+	Logger logger,
+	FontAtlas* fontAtlas)
+{
+	assert(textPipeline);
+	assert(regularFonts);
+	assert(boldFonts);
+	assert(italicFonts);
+	assert(boldItalicFonts);
+	assert(fontCount > 0);
+	assert(fontSize > 0);
+	assert(chars);
+	assert(charCount > 0);
+	assert(cachePath);
+	assert(fontAtlas);
+	assert(fontSize % 2 == 0);
+	assert(textInitialized);
 
-	if (pixelCapacity < (size_t)newPixelLength * newPixelLength * 4)
+	// Cache is mapped read only, pixels are read once by the upload.
+	FontData* data = mapFontData(cachePath);
+
+	if (data)
 	{
-		pixelCapacity = (size_t)newPixelLength * newPixelLength * 4;
+		MpgxResult mpgxResult = createFontAtlasFromCache(
+			textPipeline,
+			regularFonts,
+			boldFonts,
+			italicFonts,
+			boldItalicFonts,
+			fontCount,
+			fontSize,
+			chars,
+			charCount,
+			data->bytes,
+			data->size,
+			logger,
+			fontAtlas);
 
-		uint8_t* newPixelBuffer;
+		releaseFontData(data);
 
-		if (pixelBuffer)
+		// Stale or broken cache is rebuilt below.
+		if (mpgxResult != BAD_VALUE_MPGX_RESULT)
+			return mpgxResult;
+
+		if (logger)
 		{
-			newPixelBuffer = realloc(
-				pixelBuffer,
-				pixelCapacity * sizeof(uint8_t));
-		}
-		else
-		{
-			newPixelBuffer = malloc(
-				pixelCapacity * sizeof(uint8_t));
+			logMessage(logger, INFO_LOG_LEVEL,
+				"Rebuilding stale font atlas cache. (path: %s)",
+				cachePath);
 		}
+	}
 
-		if (!newPixelBuffer)
-			return OUT_OF_HOST_MEMORY_MPGX_RESULT;
+	return internalCreateFontAtlas(
+		textPipeline,
+		regularFonts,
+		boldFonts,
+		italicFonts,
+		boldItalicFonts,
+		fontCount,
+		fontSize,
+		chars,
+		charCount,
+		cachePath,
+		logger,
+		fontAtlas,
+		false,
+		true);
+}
+MpgxResult generateFontAtlasCache(
+	Font* regularFonts,
+	Font* boldFonts,
+	Font* italicFonts,
+	Font* boldItalicFonts,
+	size_t fontCount,
+	uint32_t fontSize,
+	const uint32_t* chars,
+	size_t charCount,
+	const char* cachePath,
+	Logger logger)
+{
+	assert(regularFonts);
+	assert(boldFonts);
+	assert(italicFonts);
+	assert(boldItalicFonts);
+	assert(fontCount > 0);
+	assert(fontSize > 0);
+	assert(chars);
+	assert(charCount > 0);
+	assert(cachePath);
+	assert(fontSize % 2 == 0);
+	assert(textInitialized);
 
-		pipelineHandle->base.pixelBuffer = pixelBuffer = newPixelBuffer;
-		pipelineHandle->base.pixelCapacity = pixelCapacity;
-	}
+	return internalCreateFontAtlas(
+		NULL,
+		regularFonts,
+		boldFonts,
+		italicFonts,
+		boldItalicFonts,
+		fontCount,
+		fontSize,
+		chars,
+		charCount,
+		cachePath,
+		logger,
+		NULL,
+		false,
+		true);
+}
+MpgxResult createDynamicFontAtlas(
+	GraphicsPipeline textPipeline,
+	Font* regularFonts,
+	Font* boldFonts,
+	Font* italicFonts,
+	Font* boldItalicFonts,
+	size_t fontCount,
+	uint32_t fontSize,
+	size_t glyphCapacity,
+	Logger logger,
+	FontAtlas* fontAtlas)
+{
+	assert(textPipeline);
+	assert(regularFonts);
+	assert(boldFonts);
+	assert(italicFonts);
+	assert(boldItalicFonts);
+	assert(fontCount > 0);
+	assert(fontSize > 0);
+	assert(glyphCapacity > 1);
+	assert(fontAtlas);
+	assert(fontSize % 2 == 0);
+	assert(textInitialized);
 
-	Font* fonts = fontAtlas->fonts;
-	size_t fontCount = fontAtlas->fontCount;
-	Logger logger = fontAtlas->logger;
-	Image image = fontAtlas->image;
-	uint32_t pixelLength = (uint32_t)image->base.size.x;
+	FontAtlas fontAtlasInstance = calloc(
+		1, sizeof(FontAtlas_T));
 
-	uint32_t targetPixelLength =
-		newPixelLength > pixelLength ?
-		newPixelLength : pixelLength;
-	memset(pixelBuffer, 0, sizeof(uint8_t) *
-		targetPixelLength * targetPixelLength * 4);
+	if (!fontAtlasInstance)
+		return OUT_OF_HOST_MEMORY_MPGX_RESULT;
 
-	bool result = fillPixels(
-		fonts,
-		fontCount,
+	fontAtlasInstance->logger = logger;
+	fontAtlasInstance->pipeline = textPipeline;
+	fontAtlasInstance->fontSize = fontSize;
+	fontAtlasInstance->frameIndex = 1;
+	fontAtlasInstance->isGenerated = false;
+	fontAtlasInstance->isDynamic = true;
+
+	FT_Face defaultFace = regularFonts[0]->face;
+
+	bool result = setFtPixelSize(
+		defaultFace,
 		fontSize,
-		glyphs,
-		glyphCount,
-		glyphLength,
-		targetPixelLength,
-		0,
-		pixelBuffer,
 		logger);
 
 	if (!result)
+	{
+		destroyFontAtlas(fontAtlasInstance);
 		return UNKNOWN_ERROR_MPGX_RESULT;
+	}
 
-	result = fillPixels(
-		fonts + fontCount,
-		fontCount,
-		fontSize,
-		glyphs + glyphCapacity,
-		glyphCount,
-		glyphLength,
-		targetPixelLength,
-		1,
-		pixelBuffer,
-		logger);
+	fontAtlasInstance->newLineAdvance =
+		((float)defaultFace->size->metrics.height /
+		64.0f) / (float)fontSize;
+
+	result = setFontAtlasFonts(
+		fontAtlasInstance,
+		regularFonts,
+		boldFonts,
+		italicFonts,
+		boldItalicFonts,
+		fontCount);
 
 	if (!result)
-		return UNKNOWN_ERROR_MPGX_RESULT;
+	{
+		destroyFontAtlas(fontAtlasInstance);
+		return OUT_OF_HOST_MEMORY_MPGX_RESULT;
+	}
 
-	result = fillPixels(
-		fonts + fontCount * 2,
-		fontCount,
+	// Atlas image size is fixed, all square cells are used,
+	// except the last one, reserved for the white texel.
+	uint32_t cellLength = (uint32_t)ceil(sqrt((double)(glyphCapacity + 1)));
+	uint32_t pixelLength = cellLength * fontSize;
+	glyphCapacity = (size_t)cellLength * cellLength - 1;
+
+	fontAtlasInstance->cellLength = cellLength;
+	fontAtlasInstance->glyphCapacity = glyphCapacity;
+
+	Glyph* glyphs = malloc(
+		glyphCapacity * 4 * sizeof(Glyph));
+
+	if (!glyphs)
+	{
+		destroyFontAtlas(fontAtlasInstance);
+		return OUT_OF_HOST_MEMORY_MPGX_RESULT;
+	}
+
+	fontAtlasInstance->glyphs = glyphs;
+
+	uint32_t* glyphCells = malloc(
+		glyphCapacity * sizeof(uint32_t));
+
+	if (!glyphCells)
+	{
+		destroyFontAtlas(fontAtlasInstance);
+		return OUT_OF_HOST_MEMORY_MPGX_RESULT;
+	}
+
+	fontAtlasInstance->glyphCells = glyphCells;
+
+	FontAtlasCell* cells = malloc(
+		glyphCapacity * sizeof(FontAtlasCell));
+
+	if (!cells)
+	{
+		destroyFontAtlas(fontAtlasInstance);
+		return OUT_OF_HOST_MEMORY_MPGX_RESULT;
+	}
+
+	fontAtlasInstance->cells = cells;
+
+	FontAtlasCell* cellBuffer = malloc(
+		glyphCapacity * sizeof(FontAtlasCell));
+
+	if (!cellBuffer)
+	{
+		destroyFontAtlas(fontAtlasInstance);
+		return OUT_OF_HOST_MEMORY_MPGX_RESULT;
+	}
+
+	fontAtlasInstance->cellBuffer = cellBuffer;
+
+	uint8_t* pixels = calloc(
+		(size_t)pixelLength * pixelLength,
+		4 * sizeof(uint8_t));
+
+	if (!pixels)
+	{
+		destroyFontAtlas(fontAtlasInstance);
+		return OUT_OF_HOST_MEMORY_MPGX_RESULT;
+	}
+
+	fontAtlasInstance->pixels = pixels;
+	fillWhiteTexel(pixels, pixelLength);
+
+	for (size_t i = 0; i < glyphCapacity; i++)
+	{
+		FontAtlasCell* cell = &cells[i];
+		cell->frame = 0;
+		cell->value = FREE_FONT_ATLAS_CELL;
+		cell->index = (uint32_t)i;
+	}
+
+	// Missing glyph fallback is never evicted.
+	cells[0].value = '\0';
+	glyphCells[0] = 0;
+
+	for (uint8_t i = 0; i < 4; i++)
+		glyphs[glyphCapacity * i].value = '\0';
+
+	fontAtlasInstance->glyphCount = 1;
+
+	result = setFontsPixelSize(
+		fontAtlasInstance->fonts,
+		fontCount * 4,
 		fontSize,
-		glyphs + glyphCapacity * 2,
-		glyphCount,
-		glyphLength,
-		targetPixelLength,
-		2,
-		pixelBuffer,
 		logger);
 
 	if (!result)
+	{
+		destroyFontAtlas(fontAtlasInstance);
 		return UNKNOWN_ERROR_MPGX_RESULT;
+	}
 
-	result = fillPixels(
-		fonts + fontCount * 3,
-		fontCount,
-		fontSize,
-		glyphs + glyphCapacity * 3,
-		glyphCount,
-		glyphLength,
-		targetPixelLength,
-		3,
-		pixelBuffer,
-		logger);
+	result = fillFontAtlasCell(
+		fontAtlasInstance,
+		0);
 
 	if (!result)
+	{
+		destroyFontAtlas(fontAtlasInstance);
 		return UNKNOWN_ERROR_MPGX_RESULT;
+	}
 
-	Window window = textPipeline->base.window;
-	GraphicsAPI api = getGraphicsAPI();
+	MpgxResult mpgxResult = createFontAtlasImage(
+		fontAtlasInstance,
+		pixels,
+		pixelLength,
+		false);
+
+	if (mpgxResult != SUCCESS_MPGX_RESULT)
+	{
+		destroyFontAtlas(fontAtlasInstance);
+		return mpgxResult;
+	}
+
+	*fontAtlas = fontAtlasInstance;
+	return SUCCESS_MPGX_RESULT;
+}
+void destroyFontAtlas(FontAtlas fontAtlas)
+{
+	if (!fontAtlas)
+		return;
+
+	assert(textInitialized);
+
+	GraphicsPipeline textPipeline = fontAtlas->pipeline;
+
+	if (textPipeline)
+	{
+		Handle handle = textPipeline->base.handle;
+
+		assert(handle->base.batch.type == NONE_TEXT_BATCH_TYPE ||
+			handle->base.batch.fontAtlas != fontAtlas);
+
+		// Quads fall back to the atlas of any other text.
+		if (handle->base.quadAtlas == fontAtlas)
+		{
+			Text* texts = handle->base.texts;
+			size_t textCount = handle->base.textCount;
+			handle->base.quadAtlas = NULL;
+
+			for (size_t i = 0; i < textCount; i++)
+			{
+				FontAtlas textAtlas = texts[i]->base.fontAtlas;
+
+				if (textAtlas != fontAtlas)
+				{
+					handle->base.quadAtlas = textAtlas;
+					break;
+				}
+			}
+		}
+	}
+
+#if MPGX_SUPPORT_VULKAN
+	// Cache generator atlas has no pipeline and graphics.
+	if (fontAtlas->pipeline &&
+		getGraphicsAPI() == VULKAN_GRAPHICS_API)
+	{
+		VkWindow vkWindow = getVkWindow(
+			fontAtlas->pipeline->base.window);
+
+		vkDestroyDescriptorPool(
+			vkWindow->device,
+			fontAtlas->descriptorPool,
+			NULL);
+	}
+#endif
+
+	destroyImage(fontAtlas->image);
+
+	for (size_t i = 0; i < 4; i++)
+		free(fontAtlas->sourceMaps[i].sources);
+
+	free(fontAtlas->pixels);
+	free(fontAtlas->valueBuffer);
+	free(fontAtlas->cellBuffer);
+	free(fontAtlas->cells);
+	free(fontAtlas->glyphCells);
+	free(fontAtlas->glyphs);
+	free(fontAtlas->fonts);
+	free(fontAtlas);
+}
+
+GraphicsPipeline getFontAtlasPipeline(FontAtlas fontAtlas)
+{
+	assert(fontAtlas);
+	assert(textInitialized);
+	return fontAtlas->pipeline;
+}
+Font* getFontAtlasRegularFonts(FontAtlas fontAtlas)
+{
+	assert(fontAtlas);
+	assert(textInitialized);
+	return fontAtlas->fonts;
+}
+Font* getFontAtlasBoldFonts(FontAtlas fontAtlas)
+{
+	assert(fontAtlas);
+	assert(textInitialized);
+	return fontAtlas->fonts + fontAtlas->fontCount;
+}
+Font* getFontAtlasItalicFonts(FontAtlas fontAtlas)
+{
+	assert(fontAtlas);
+	assert(textInitialized);
+	return fontAtlas->fonts + fontAtlas->fontCount * 2;
+}
+Font* getFontAtlasBoldItalicFonts(FontAtlas fontAtlas)
+{
+	assert(fontAtlas);
+	assert(textInitialized);
+	return fontAtlas->fonts + fontAtlas->fontCount * 3;
+}
+size_t getFontAtlasFontCount(FontAtlas fontAtlas)
+{
+	assert(fontAtlas);
+	assert(textInitialized);
+	return fontAtlas->fontCount;
+}
+uint32_t getFontAtlasFontSize(FontAtlas fontAtlas)
+{
+	assert(fontAtlas);
+	assert(textInitialized);
+	return fontAtlas->fontSize;
+}
+float getFontAtlasLineAdvance(FontAtlas fontAtlas)
+{
+	assert(fontAtlas);
+	assert(textInitialized);
+	return fontAtlas->newLineAdvance;
+}
+Logger getFontAtlasLogger(FontAtlas fontAtlas)
+{
+	assert(fontAtlas);
+	assert(textInitialized);
+	return fontAtlas->logger;
+}
+bool isFontAtlasGenerated(FontAtlas fontAtlas)
+{
+	assert(fontAtlas);
+	assert(textInitialized);
+	return fontAtlas->isGenerated;
+}
+bool isFontAtlasDynamic(FontAtlas fontAtlas)
+{
+	assert(fontAtlas);
+	assert(textInitialized);
+	return fontAtlas->isDynamic;
+}
+
+inline static MpgxResult setFontAtlasImageData(
+	FontAtlas fontAtlas,
+	const uint8_t* pixels,
+	Vec3I size,
+	Vec3I offset)
+{
+	assert(fontAtlas);
+	assert(pixels);
+
+	Image image = fontAtlas->image;
+	GraphicsAPI api = getGraphicsAPI();
+
+	if (api == VULKAN_GRAPHICS_API)
+	{
+#if MPGX_SUPPORT_VULKAN
+		VkWindow vkWindow = getVkWindow(
+			fontAtlas->pipeline->vk.window);
+
+		VkResult vkResult = vkQueueWaitIdle(
+			vkWindow->graphicsQueue);
+
+		if (vkResult != VK_SUCCESS)
+			return vkToMpgxResult(vkResult);
+
+		return setVkImageData(
+			vkWindow->device,
+			vkWindow->allocator,
+			vkWindow->transferQueue,
+			vkWindow->transferCommandBuffer,
+			vkWindow->transferFence,
+			image,
+			pixels,
+			size,
+			offset,
+			0);
+#else
+		abort();
+#endif
+	}
+	else
+	{
+#if MPGX_SUPPORT_OPENGL
+		return setGlImageData(
+			image,
+			pixels,
+			size,
+			offset,
+			0);
+#else
+		abort();
+#endif
+	}
+}
+inline static MpgxResult bakeFontAtlas(
+	FontAtlas fontAtlas,
+	const uint32_t* string,
+	const TextRun* runs,
+	size_t runCount)
+{
+	assert(fontAtlas);
+
+	assert(runCount == 0 ||
+		(runCount > 0 && string && runs));
+
+	size_t length = 0;
+
+	for (size_t i = 0; i < runCount; i++)
+		length += runs[i].length;
+
+	if (length == 0)
+		return SUCCESS_MPGX_RESULT;
+
+	Glyph* glyphs = fontAtlas->glyphs;
+	size_t glyphCapacity = fontAtlas->glyphCapacity;
+
+	if (fontAtlas->glyphCapacity < length)
+	{
+		glyphCapacity = length;
+
+		Glyph* newGlyphs = realloc(glyphs,
+			glyphCapacity * 4 * sizeof(Glyph));
+
+		if (!newGlyphs)
+			return OUT_OF_HOST_MEMORY_MPGX_RESULT;
+
+		fontAtlas->glyphs = glyphs = newGlyphs;
+	}
+
+	size_t glyphCount = 0;
+
+	// Only visible characters are baked, without tags.
+	for (size_t i = 0; i < runCount; i++)
+	{
+		glyphCount = bakeGlyphs(
+			string + runs[i].offset,
+			runs[i].length,
+			glyphs,
+			glyphCount);
+	}
+
+	if (glyphCount == 0)
+		return BAD_VALUE_MPGX_RESULT;
+
+	fontAtlas->glyphCount = glyphCount;
+	fontAtlas->glyphCapacity = glyphCapacity;
+
+	memcpy(glyphs + glyphCapacity, glyphs,
+		glyphCount * sizeof(Glyph));
+	memcpy(glyphs + glyphCapacity * 2, glyphs,
+		glyphCount * sizeof(Glyph));
+	memcpy(glyphs + glyphCapacity * 3, glyphs,
+		glyphCount * sizeof(Glyph));
+
+	uint32_t fontSize = fontAtlas->fontSize;
+	uint32_t glyphLength = (uint32_t)ceil(sqrt((double)(glyphCount + 1)));
+	uint32_t newPixelLength = glyphLength * fontSize;
+	GraphicsPipeline textPipeline = fontAtlas->pipeline;
+	Handle pipelineHandle = textPipeline->base.handle;
+	uint8_t* pixelBuffer = pipelineHandle->base.pixelBuffer;
+	size_t pixelCapacity = pipelineHandle->base.pixelCapacity;
+
+	if (pixelCapacity < (size_t)newPixelLength * newPixelLength * 4)
+	{
+		pixelCapacity = (size_t)newPixelLength * newPixelLength * 4;
+
+		uint8_t* newPixelBuffer;
+
+		if (pixelBuffer)
+		{
+			newPixelBuffer = realloc(
+				pixelBuffer,
+				pixelCapacity * sizeof(uint8_t));
+		}
+		else
+		{
+			newPixelBuffer = malloc(
+				pixelCapacity * sizeof(uint8_t));
+		}
+
+		if (!newPixelBuffer)
+			return OUT_OF_HOST_MEMORY_MPGX_RESULT;
+
+		pipelineHandle->base.pixelBuffer = pixelBuffer = newPixelBuffer;
+		pipelineHandle->base.pixelCapacity = pixelCapacity;
+	}
+
+	Font* fonts = fontAtlas->fonts;
+	size_t fontCount = fontAtlas->fontCount;
+	Logger logger = fontAtlas->logger;
+	Image image = fontAtlas->image;
+	uint32_t pixelLength = (uint32_t)image->base.size.x;
+
+	uint32_t targetPixelLength =
+		newPixelLength > pixelLength ?
+		newPixelLength : pixelLength;
+	memset(pixelBuffer, 0, sizeof(uint8_t) *
+		targetPixelLength * targetPixelLength * 4);
+
+	bool result = fillPixels(
+		fonts,
+		fontCount,
+		fontSize,
+		glyphs,
+		glyphCount,
+		glyphLength,
+		targetPixelLength,
+		0,
+		pixelBuffer,
+		&fontAtlas->sourceMaps[0],
+		logger);
+
+	if (!result)
+		return UNKNOWN_ERROR_MPGX_RESULT;
+
+	result = fillPixels(
+		fonts + fontCount,
+		fontCount,
+		fontSize,
+		glyphs + glyphCapacity,
+		glyphCount,
+		glyphLength,
+		targetPixelLength,
+		1,
+		pixelBuffer,
+		&fontAtlas->sourceMaps[1],
+		logger);
+
+	if (!result)
+		return UNKNOWN_ERROR_MPGX_RESULT;
+
+	result = fillPixels(
+		fonts + fontCount * 2,
+		fontCount,
+		fontSize,
+		glyphs + glyphCapacity * 2,
+		glyphCount,
+		glyphLength,
+		targetPixelLength,
+		2,
+		pixelBuffer,
+		&fontAtlas->sourceMaps[2],
+		logger);
+
+	if (!result)
+		return UNKNOWN_ERROR_MPGX_RESULT;
+
+	result = fillPixels(
+		fonts + fontCount * 3,
+		fontCount,
+		fontSize,
+		glyphs + glyphCapacity * 3,
+		glyphCount,
+		glyphLength,
+		targetPixelLength,
+		3,
+		pixelBuffer,
+		&fontAtlas->sourceMaps[3],
+		logger);
+
+	if (!result)
+		return UNKNOWN_ERROR_MPGX_RESULT;
+
+	fillWhiteTexel(pixelBuffer, targetPixelLength);
+
+	Window window = textPipeline->base.window;
+	GraphicsAPI api = getGraphicsAPI();
+
+	if (newPixelLength > pixelLength)
+	{
+		Image newImage;
+
+		MpgxResult mpgxResult = createImage(
+			window,
+			SAMPLED_IMAGE_TYPE,
+			IMAGE_2D,
+			R8G8B8A8_UNORM_IMAGE_FORMAT,
+			pixelBuffer,
+			vec3I(
+				(cmmt_int_t)newPixelLength,
+				(cmmt_int_t)newPixelLength,
+				1),
+			1,
+			false,
+			&newImage);
+
+		if (mpgxResult != SUCCESS_MPGX_RESULT)
+			return mpgxResult;
+
+#if MPGX_SUPPORT_VULKAN
+		if (api == VULKAN_GRAPHICS_API)
+		{
+			VkWindow vkWindow = getVkWindow(window);
+			VkDevice device = vkWindow->device;
+
+			VkDescriptorPool descriptorPool;
+
+			mpgxResult = createVkDescriptorPool(
+				vkWindow->device,
+				&descriptorPool);
+
+			if (mpgxResult != SUCCESS_MPGX_RESULT)
+			{
+				destroyImage(newImage);
+				return mpgxResult;
+			}
+
+			VkDescriptorSet descriptorSet;
+
+			mpgxResult = createVkDescriptorSet(
+				device,
+				pipelineHandle->vk.descriptorSetLayout,
+				descriptorPool,
+				pipelineHandle->vk.sampler->vk.handle,
+				newImage->vk.imageView,
+				&descriptorSet);
+
+			if (mpgxResult != SUCCESS_MPGX_RESULT)
+			{
+				vkDestroyDescriptorPool(
+					device,
+					descriptorPool,
+					NULL);
+				destroyImage(newImage);
+				return mpgxResult;
+			}
+
+			VkResult vkResult = vkQueueWaitIdle(
+				vkWindow->graphicsQueue);
+
+			if (vkResult != VK_SUCCESS)
+			{
+				vkDestroyDescriptorPool(
+					device,
+					descriptorPool,
+					NULL);
+				destroyImage(newImage);
+				return vkToMpgxResult(vkResult);
+			}
+
+			vkDestroyDescriptorPool(
+				device,
+				fontAtlas->descriptorPool,
+				NULL);
+
+			fontAtlas->descriptorPool = descriptorPool;
+			fontAtlas->descriptorSet = descriptorSet;
+		}
+
+		destroyImage(image);
+		fontAtlas->image = newImage;
+#endif
+	}
+	else
+	{
+		MpgxResult mpgxResult = setFontAtlasImageData(
+			fontAtlas,
+			pixelBuffer,
+			vec3I(
+				(cmmt_int_t)pixelLength,
+				(cmmt_int_t)pixelLength,
+				1),
+			zeroVec3I);
+
+		if (mpgxResult != SUCCESS_MPGX_RESULT)
+			return mpgxResult;
+	}
+
+	return SUCCESS_MPGX_RESULT;
+}
+
+inline static bool hexToColor(
+	const uint32_t* string,
+	uint8_t* _value)
+{
+	// Note: skipping assertions for debug build speed.
+
+	uint8_t value = 0;
+	uint32_t charValue = string[0];
+
+	if (charValue > '/' && charValue < ':')
+		value = (charValue - '0') << 4u;
+	else if (charValue > '`' && charValue < 'g')
+		value = (charValue - 'W') << 4u;
+	else
+		return false;
+
+	charValue = string[1];
+
+	if (charValue > '/' && charValue < ':')
+		value |= charValue - '0';
+	else if (charValue > '`' && charValue < 'g')
+		value |= charValue - 'W';
+	else
+		return false;
+
+	*_value = value;
+	return true;
+}
+inline static const Glyph* getStyleGlyphs(
+	const Glyph* glyphs,
+	size_t glyphCapacity,
+	bool isBold,
+	bool isItalic,
+	float* atlasIndex)
+{
+	// Note: skipping assertions for debug build speed.
+
+	uint8_t styleIndex = (uint8_t)isBold | (uint8_t)isItalic << 1u;
+	*atlasIndex = (float)styleIndex;
+	return glyphs + glyphCapacity * styleIndex;
+}
+inline static float getLineOffsetX(
+	AlignmentType alignment,
+	float lineSizeX,
+	float fontSize)
+{
+	// Note: skipping assertions for debug build speed.
+
+	switch (alignment)
+	{
+	default:
+		abort();
+	case CENTER_ALIGNMENT_TYPE:
+	case BOTTOM_ALIGNMENT_TYPE:
+	case TOP_ALIGNMENT_TYPE:
+		return floorf(lineSizeX * -0.5f * fontSize) / fontSize;
+	case LEFT_ALIGNMENT_TYPE:
+	case LEFT_BOTTOM_ALIGNMENT_TYPE:
+	case LEFT_TOP_ALIGNMENT_TYPE:
+		return 0.0f;
+	case RIGHT_ALIGNMENT_TYPE:
+	case RIGHT_BOTTOM_ALIGNMENT_TYPE:
+	case RIGHT_TOP_ALIGNMENT_TYPE:
+		return -lineSizeX;
+	}
+}
+inline static float getTextOffsetY(
+	AlignmentType alignment,
+	float sizeY,
+	float fontSize)
+{
+	// Note: skipping assertions for debug build speed.
+
+	switch (alignment)
+	{
+	default:
+		abort();
+	case CENTER_ALIGNMENT_TYPE:
+	case LEFT_ALIGNMENT_TYPE:
+	case RIGHT_ALIGNMENT_TYPE:
+		return floorf(sizeY * 0.5f * fontSize) / fontSize;
+	case BOTTOM_ALIGNMENT_TYPE:
+	case LEFT_BOTTOM_ALIGNMENT_TYPE:
+	case RIGHT_BOTTOM_ALIGNMENT_TYPE:
+		return sizeY;
+	case TOP_ALIGNMENT_TYPE:
+	case LEFT_TOP_ALIGNMENT_TYPE:
+	case RIGHT_TOP_ALIGNMENT_TYPE:
+		return 0.0f;
+	}
+}
+inline static float getFirstLineOffsetY(
+	float newLineAdvance,
+	float fontSize)
+{
+	return -floorf(newLineAdvance * 0.5f * fontSize) / fontSize;
+}
+inline static float getTextSizeY(
+	size_t lineCount,
+	float newLineAdvance,
+	float fontSize)
+{
+	assert(lineCount > 0);
+
+	return -(getFirstLineOffsetY(newLineAdvance, fontSize) -
+		(float)(lineCount - 1) * newLineAdvance);
+}
+inline static bool isTextStyleEqual(
+	TextStyle a,
+	TextStyle b)
+{
+	return a.color.r == b.color.r && a.color.g == b.color.g &&
+		a.color.b == b.color.b && a.color.a == b.color.a &&
+		a.isBold == b.isBold && a.isItalic == b.isItalic;
+}
+
+inline static uint8_t getTextBreakType(uint32_t value)
+{
+	// Note: skipping assertions for debug build speed.
+
+	if (value == ' ' || value == 0x3000)
+		return SPACE_TEXT_BREAK_TYPE;
+	if (value == '\t')
+		return TAB_TEXT_BREAK_TYPE;
+	if (value == '-' || value == 0x2010)
+		return HYPHEN_TEXT_BREAK_TYPE;
+
+	// CJK ideographs, kana and hangul can
+	// be broken before and after any character.
+	if ((value >= 0x2E80 && value <= 0x9FFF) ||
+		(value >= 0xAC00 && value <= 0xD7AF) ||
+		(value >= 0xF900 && value <= 0xFAFF) ||
+		(value >= 0xFF00 && value <= 0xFFEF) ||
+		(value >= 0x20000 && value <= 0x3FFFF))
+	{
+		return IDEOGRAPH_TEXT_BREAK_TYPE;
+	}
+
+	return NONE_TEXT_BREAK_TYPE;
+}
+inline static void fillGlyphVertices(
+	const Glyph* glyph,
+	float offsetX,
+	float atlasIndex,
+	SrgbColor color,
+	TextVertex* vertices)
+{
+	// Note: skipping assertions for debug build speed.
+
+	float positionX = offsetX + glyph->positionX;
+	float positionY = glyph->positionY;
+	float positionZ = offsetX + glyph->positionZ;
+	float positionW = glyph->positionW;
+	float texCoordsX = glyph->texCoordsX;
+	float texCoordsY = glyph->texCoordsY;
+	float texCoordsZ = glyph->texCoordsZ;
+	float texCoordsW = glyph->texCoordsW;
+
+	TextVertex vertex;
+	vertex.position.x = positionX;
+	vertex.position.y = positionY;
+	vertex.texCoords.x = texCoordsX;
+	vertex.texCoords.y = texCoordsW;
+	vertex.texCoords.z = atlasIndex;
+	vertex.color = color;
+	vertices[0] = vertex;
+
+	vertex.position.x = positionX;
+	vertex.position.y = positionW;
+	vertex.texCoords.x = texCoordsX;
+	vertex.texCoords.y = texCoordsY;
+	vertices[1] = vertex;
+
+	vertex.position.x = positionZ;
+	vertex.position.y = positionW;
+	vertex.texCoords.x = texCoordsZ;
+	vertex.texCoords.y = texCoordsY;
+	vertices[2] = vertex;
+
+	vertex.position.x = positionZ;
+	vertex.position.y = positionY;
+	vertex.texCoords.x = texCoordsZ;
+	vertex.texCoords.y = texCoordsW;
+	vertices[3] = vertex;
+}
+/*
+ * Returns ellipsis glyph and its count, falling
+ * back to the three dots, or NULL if none is baked.
+ */
+inline static const Glyph* getEllipsisGlyph(
+	const Glyph* glyphs,
+	size_t glyphCount,
+	uint8_t* count)
+{
+	// Note: skipping assertions for debug build speed.
+
+	uint32_t value = 0x2026;
+
+	const Glyph* glyph = bsearch(
+		&value,
+		glyphs,
+		glyphCount,
+		sizeof(Glyph),
+		compareGlyph);
+
+	if (glyph)
+	{
+		*count = 1;
+		return glyph;
+	}
+
+	value = '.';
+
+	glyph = bsearch(
+		&value,
+		glyphs,
+		glyphCount,
+		sizeof(Glyph),
+		compareGlyph);
+
+	*count = glyph ? 3 : 0;
+	return glyph;
+}
+
+/*
+ * Lays out one line, starting at the line offset and ending
+ * at the next new line character, at the wrap break or at the
+ * end of the string. Only characters of the text runs are
+ * visible, the rest are tags. Vertex positions are relative
+ * to the line origin, with horizontal alignment already
+ * applied. Cursor advances are written for each line index
+ * including line end, which belongs to the next wrapped line.
+ * Glyph cache is read if valid, otherwise written if not NULL.
+ */
+inline static bool fillLineVertices(
+	const uint32_t* string,
+	size_t length,
+	uint32_t mask,
+	const TextRun* runs,
+	size_t runCount,
+	const Glyph* _glyphs,
+	size_t glyphCapacity,
+	size_t glyphCount,
+	TextGlyph* glyphCache,
+	bool isGlyphCacheValid,
+	TextWrapType wrap,
+	float maxWidth,
+	float fontSize,
+	AlignmentType alignment,
+	TextLine* line,
+	size_t* _runIndex,
+	TextStyle* style,
+	TextVertex* vertices,
+	float* advances)
+{
+	assert(_glyphs);
+	assert(glyphCount > 0);
+	assert(glyphCache || !isGlyphCacheValid);
+	assert(wrap < TEXT_WRAP_TYPE_COUNT);
+	assert(fontSize > 0);
+	assert(alignment < ALIGNMENT_TYPE_COUNT);
+	assert(line);
+	assert(_runIndex);
+	assert(style);
+	assert(line->offset <= length);
+	assert(vertices || line->offset == length);
+	assert(advances);
+
+	assert(length == 0 ||
+		(length > 0 && string));
+	assert(runCount == 0 ||
+		(runCount > 0 && runs));
+
+	SrgbColor useColor = style->color;
+	const Glyph* glyphs = _glyphs;
+	float vertexOffsetX = 0.0f, contentWidth = 0.0f, atlasIndex = 0.0f;
+	uint32_t vertexIndex = 0;
+	bool isWrapped = false;
+
+	size_t lineOffset = line->offset, runIndex = *_runIndex;
+	size_t i = lineOffset, advanceIndex = lineOffset, runEnd = lineOffset;
+
+	// Last wrap break opportunity or the last
+	// position where ellipsis still fits the line.
+	size_t breakIndex = lineOffset, breakRunIndex = runIndex;
+	uint32_t breakVertexIndex = 0;
+	float breakWidth = 0.0f;
+	SrgbColor breakColor = useColor;
+
+	const Glyph* ellipsisGlyph = NULL;
+	float ellipsisAtlasIndex = 0.0f, ellipsisWidth = 0.0f;
+	uint8_t ellipsisCount = 0;
+	bool hasEllipsis = wrap != ELLIPSIS_TEXT_WRAP_TYPE, isCut = false;
+	float cutWidth = 0.0f;
+
+	for (; i < length; i++)
+	{
+		if (i == runEnd)
+		{
+			while (runIndex < runCount &&
+				runs[runIndex].offset + runs[runIndex].length <= i)
+			{
+				runIndex++;
+			}
+
+			// Only tags are left, they can not contain new line.
+			if (runIndex == runCount)
+			{
+				i = length;
+				break;
+			}
+
+			const TextRun* run = &runs[runIndex];
+
+			if (i < run->offset)
+				i = run->offset;
+
+			runEnd = run->offset + run->length;
+			useColor = run->style.color;
+
+			glyphs = getStyleGlyphs(
+				_glyphs,
+				glyphCapacity,
+				run->style.isBold,
+				run->style.isItalic,
+				&atlasIndex);
+
+			// Ellipsis uses style of the first line run.
+			if (!hasEllipsis)
+			{
+				ellipsisGlyph = getEllipsisGlyph(
+					glyphs,
+					glyphCount,
+					&ellipsisCount);
+				ellipsisAtlasIndex = atlasIndex;
+				ellipsisWidth = ellipsisGlyph ?
+					ellipsisGlyph->advance * ellipsisCount : 0.0f;
+				breakColor = useColor;
+				hasEllipsis = true;
+			}
+		}
+
+		// Skipped tag characters share the advance
+		// of the next character, as tags are invisible.
+		while (advanceIndex <= i)
+			advances[(advanceIndex++) - lineOffset] = vertexOffsetX;
+
+		uint32_t value = mask != 0 ? mask : string[i];
+
+		if (value == '\n')
+		{
+			*style = runs[runIndex].style;
+			break;
+		}
+
+		const Glyph* glyph;
+		uint8_t breakType;
+
+		if (isGlyphCacheValid)
+		{
+			glyph = _glyphs + glyphCache[i].index;
+			breakType = glyphCache[i].breakType;
+		}
+		else
+		{
+			breakType = getTextBreakType(value);
+
+			if (breakType == TAB_TEXT_BREAK_TYPE)
+				value = ' ';
+
+			glyph = bsearch(
+				&value,
+				glyphs,
+				glyphCount,
+				sizeof(Glyph),
+				compareGlyph);
+
+			if (!glyph)
+			{
+				if (breakType == TAB_TEXT_BREAK_TYPE)
+					return false;
+
+				value = '\0';
+
+				glyph = bsearch(
+					&value,
+					glyphs,
+					glyphCount,
+					sizeof(Glyph),
+					compareGlyph);
+
+				if (!glyph)
+					return false;
+			}
+
+			if (glyphCache)
+			{
+				TextGlyph* textGlyph = &glyphCache[i];
+				textGlyph->index = (uint32_t)(glyph - _glyphs);
+				textGlyph->breakType = breakType;
+			}
+		}
+
+		bool isSpace = breakType == SPACE_TEXT_BREAK_TYPE ||
+			breakType == TAB_TEXT_BREAK_TYPE;
+		float advance = breakType == TAB_TEXT_BREAK_TYPE ?
+			glyph->advance * 4 : glyph->advance;
+
+		if (wrap == WORD_TEXT_WRAP_TYPE || wrap == CHAR_TEXT_WRAP_TYPE)
+		{
+			bool hasChars = contentWidth > 0.0f || vertexIndex > 0;
+
+			if (hasChars && (wrap == CHAR_TEXT_WRAP_TYPE ||
+				breakType == IDEOGRAPH_TEXT_BREAK_TYPE))
+			{
+				breakIndex = i;
+				breakRunIndex = runIndex;
+				breakVertexIndex = vertexIndex;
+				breakWidth = contentWidth;
+			}
+
+			// Spaces are not wrapped, they hang at the line end.
+			if (hasChars && !isSpace && vertexOffsetX + advance > maxWidth)
+			{
+				// Words without break opportunity are broken anywhere.
+				if (breakIndex == lineOffset)
+				{
+					breakIndex = i;
+					breakRunIndex = runIndex;
+					breakVertexIndex = vertexIndex;
+					breakWidth = contentWidth;
+				}
+
+				i = breakIndex;
+				runIndex = breakRunIndex;
+				vertexIndex = breakVertexIndex;
+				vertexOffsetX = contentWidth = breakWidth;
+				*style = runs[runIndex].style;
+				isWrapped = true;
+				break;
+			}
+		}
+		else if (wrap == ELLIPSIS_TEXT_WRAP_TYPE)
+		{
+			// Hidden characters are still looked up
+			// to fill the glyph cache for all string.
+			if (isCut)
+				continue;
+
+			if (!isSpace && vertexOffsetX + advance > maxWidth)
+			{
+				vertexIndex = breakVertexIndex;
+				vertexOffsetX = breakWidth;
+				cutWidth = vertexOffsetX;
+
+				if (ellipsisGlyph && vertexOffsetX + ellipsisWidth <= maxWidth)
+				{
+					float offsetX = vertexOffsetX;
+
+					if (ellipsisGlyph->isVisible)
+					{
+						for (uint8_t j = 0; j < ellipsisCount; j++)
+						{
+							fillGlyphVertices(
+								ellipsisGlyph,
+								offsetX,
+								ellipsisAtlasIndex,
+								breakColor,
+								vertices + vertexIndex);
+							offsetX += ellipsisGlyph->advance;
+							vertexIndex += 4;
+						}
+					}
+
+					cutWidth += ellipsisWidth;
+				}
+
+				// Hidden characters share the cut advance.
+				for (size_t j = breakIndex + 1; j < advanceIndex; j++)
+					advances[j - lineOffset] = vertexOffsetX;
+
+				isCut = true;
+				continue;
+			}
+		}
+
+		if (breakType == TAB_TEXT_BREAK_TYPE)
+		{
+			vertexOffsetX += advance;
+		}
+		else
+		{
+			if (glyph->isVisible)
+			{
+				fillGlyphVertices(
+					glyph,
+					vertexOffsetX,
+					atlasIndex,
+					useColor,
+					vertices + vertexIndex);
+				vertexIndex += 4;
+			}
+
+			vertexOffsetX += advance;
+		}
+
+		if (!isSpace)
+			contentWidth = vertexOffsetX;
+
+		if (wrap == WORD_TEXT_WRAP_TYPE)
+		{
+			if (breakType != NONE_TEXT_BREAK_TYPE)
+			{
+				breakIndex = i + 1;
+				breakRunIndex = runIndex;
+				breakVertexIndex = vertexIndex;
+				breakWidth = contentWidth;
+			}
+		}
+		else if (wrap == ELLIPSIS_TEXT_WRAP_TYPE)
+		{
+			if (vertexOffsetX + ellipsisWidth <= maxWidth)
+			{
+				breakIndex = i + 1;
+				breakVertexIndex = vertexIndex;
+				breakWidth = vertexOffsetX;
+				breakColor = useColor;
+			}
+		}
+	}
+
+	if (!isWrapped)
+	{
+		while (advanceIndex <= i)
+			advances[(advanceIndex++) - lineOffset] = vertexOffsetX;
+	}
+
+	float lineWidth;
+
+	if (isWrapped)
+		lineWidth = contentWidth;
+	else if (isCut)
+		lineWidth = cutWidth;
+	else
+		lineWidth = vertexOffsetX;
+
+	float offset = getLineOffsetX(
+		alignment,
+		lineWidth,
+		fontSize);
+
+	if (offset != 0.0f)
+	{
+		for (uint32_t j = 0; j < vertexIndex; j++)
+			vertices[j].position.x += offset;
+	}
+
+	line->length = i - lineOffset;
+	line->vertexCount = vertexIndex;
+	line->width = lineWidth;
+	line->isWrapped = isWrapped;
+
+	*_runIndex = runIndex;
+	return true;
+}
+
+/*
+ * Returns index of the first text run
+ * ending after the specified string index.
+ */
+inline static size_t findTextRun(
+	const TextRun* runs,
+	size_t runCount,
+	size_t index)
+{
+	assert(runs || runCount == 0);
+
+	size_t left = 0, right = runCount;
+
+	while (left < right)
+	{
+		size_t middle = left + (right - left) / 2;
+
+		if (runs[middle].offset + runs[middle].length <= index)
+			left = middle + 1;
+		else
+			right = middle;
+	}
+
+	return left;
+}
+/*
+ * Applies text tag starting at the specified string index
+ * to the style. Returns tag length, or 0 if it is not a tag.
+ */
+inline static size_t parseTextTag(
+	const uint32_t* string,
+	size_t length,
+	size_t index,
+	SrgbColor baseColor,
+	TextStyle* style)
+{
+	// Note: skipping assertions for debug build speed.
+
+	size_t i = index;
+
+	if (i + 2 < length && string[i + 2] == '>')
+	{
+		uint32_t tag = string[i + 1];
+
+		if (tag == 'b')
+		{
+			style->isBold = true;
+			return 3;
+		}
+		else if (tag == 'i')
+		{
+			style->isItalic = true;
+			return 3;
+		}
+	}
+	else if (i + 3 < length && string[i + 1] == '/' && string[i + 3] == '>')
+	{
+		uint32_t tag = string[i + 2];
+
+		if (tag == 'b')
+		{
+			style->isBold = false;
+			return 4;
+		}
+		else if (tag == 'i')
+		{
+			style->isItalic = false;
+			return 4;
+		}
+		else if (tag == '#')
+		{
+			style->color = baseColor;
+			return 4;
+		}
+	}
+	else if (i + 8 < length && string[i + 1] == '#' && string[i + 8] == '>')
+	{
+		SrgbColor newColor;
+
+		bool result = hexToColor(
+			string + i + 2,
+			&newColor.r);
+		result &= hexToColor(
+			string + i + 4,
+			&newColor.g);
+		result &= hexToColor(
+			string + i + 6,
+			&newColor.b);
+
+		if (result)
+		{
+			newColor.a = UINT8_MAX;
+			style->color = newColor;
+			return 9;
+		}
+	}
+	else if (i + 10 < length && string[i + 1] == '#' && string[i + 10] == '>')
+	{
+		SrgbColor newColor;
+
+		bool result = hexToColor(
+			string + i + 2,
+			&newColor.r);
+		result &= hexToColor(
+			string + i + 4,
+			&newColor.g);
+		result &= hexToColor(
+			string + i + 6,
+			&newColor.b);
+		result &= hexToColor(
+			string + i + 8,
+			&newColor.a);
+
+		if (result)
+		{
+			style->color = newColor;
+			return 11;
+		}
+	}
+
+	return 0;
+}
+/*
+ * Parses text tags into the runs of visible characters,
+ * starting from the first changed string character.
+ * Runs are split by tags, even if the style is the same.
+ */
+inline static MpgxResult updateTextRuns(Text text)
+{
+	assert(text);
+
+	size_t runPrefix = text->base.runPrefix;
+
+	if (runPrefix == SIZE_MAX)
+		return SUCCESS_MPGX_RESULT;
+
+	const uint32_t* string = text->base.string;
+	size_t length = text->base.length;
+	TextRun* runs = text->base.runs;
+	size_t runCapacity = text->base.runCapacity;
+	size_t runCount = text->base.runCount;
+	SrgbColor color = text->base.color;
+
+	// Masked text is displayed without tags,
+	// as all characters are replaced by the mask.
+	bool useTags = text->base.useTags && text->base.mask == 0;
+
+	// Longest tag is 11 characters, so it can start
+	// before the changed character and include it.
+	size_t parseOffset = runPrefix > 10 ? runPrefix - 10 : 0;
+	size_t runIndex = 0;
+
+	// Base text style can be changed, so the
+	// style of the first run is not reused.
+	if (parseOffset > 0)
+	{
+		runIndex = findTextRun(runs, runCount, parseOffset);
+
+		if (runIndex < runCount && runs[runIndex].offset <= parseOffset)
+			runIndex++;
+	}
+
+	TextStyle style;
+	size_t i;
+
+	if (runIndex > 0)
+	{
+		TextRun* run = &runs[runIndex - 1];
+		size_t runEnd = run->offset + run->length;
+		style = run->style;
+
+		if (parseOffset < runEnd)
+		{
+			run->length = parseOffset - run->offset;
+			i = parseOffset;
+		}
+		else
+		{
+			i = runEnd;
+		}
+
+		runCount = run->length > 0 ? runIndex : runIndex - 1;
+	}
+	else
+	{
+		style.color = color;
+		style.isBold = text->base.isBold;
+		style.isItalic = text->base.isItalic;
+		memset(style._alignment, 0, sizeof(style._alignment));
+		runCount = 0;
+		i = 0;
+	}
+
+	for (; i < length; i++)
+	{
+		uint32_t value = string[i];
+
+		if ((value == '<') & useTags)
+		{
+			size_t tagLength = parseTextTag(
+				string,
+				length,
+				i,
+				color,
+				&style);
+
+			if (tagLength > 0)
+			{
+				i += tagLength - 1;
+				continue;
+			}
+		}
+
+		if (runCount > 0)
+		{
+			TextRun* run = &runs[runCount - 1];
+
+			if (run->offset + run->length == i)
+			{
+				run->length++;
+				continue;
+			}
+		}
+
+		if (runCount == runCapacity)
+		{
+			runCapacity = runCapacity > 0 ? runCapacity * 2 : 4;
+
+			TextRun* newRuns = realloc(
+				runs,
+				runCapacity * sizeof(TextRun));
+
+			if (!newRuns)
+			{
+				text->base.runCount = runCount;
+				return OUT_OF_HOST_MEMORY_MPGX_RESULT;
+			}
+
+			text->base.runs = runs = newRuns;
+			text->base.runCapacity = runCapacity;
+		}
+
+		TextRun* run = &runs[runCount++];
+		run->offset = i;
+		run->length = 1;
+		run->style = style;
+	}
+
+	text->base.runCount = runCount;
+	text->base.runPrefix = SIZE_MAX;
+	return SUCCESS_MPGX_RESULT;
+}
+
+inline static void markTextChanged(
+	Text text,
+	size_t prefix,
+	size_t suffix)
+{
+	assert(text);
+
+	if (text->base.cleanPrefix > prefix)
+		text->base.cleanPrefix = prefix;
+	if (text->base.cleanSuffix > suffix)
+		text->base.cleanSuffix = suffix;
+	if (text->base.runPrefix > prefix)
+		text->base.runPrefix = prefix;
+
+	text->base.isGlyphCacheValid = false;
+}
+inline static void invalidateTextLayout(Text text)
+{
+	assert(text);
+	text->base.cleanPrefix = 0;
+	text->base.cleanSuffix = 0;
+}
+inline static bool isTextChanged(Text text)
+{
+	assert(text);
+
+	size_t lineCount = text->base.lineCount;
+
+	if (lineCount == 0)
+		return true;
+
+	const TextLine* lastLine = &text->base.lines[lineCount - 1];
+	size_t length = text->base.length;
+
+	return lastLine->offset + lastLine->length != length ||
+		text->base.cleanPrefix != length ||
+		text->base.cleanSuffix != length;
+}
+/*
+ * Stamps glyph cells of the texts drawn in the
+ * current or previous frame, to keep them baked.
+ */
+inline static void stampFontAtlasCells(
+	FontAtlas fontAtlas,
+	Text skipText)
+{
+	assert(fontAtlas);
+
+	Handle handle = fontAtlas->pipeline->base.handle;
+	Text* texts = handle->base.texts;
+	size_t textCount = handle->base.textCount;
+	const Glyph* glyphs = fontAtlas->glyphs;
+	size_t glyphCount = fontAtlas->glyphCount;
+	const uint32_t* glyphCells = fontAtlas->glyphCells;
+	FontAtlasCell* cells = fontAtlas->cells;
+	uint64_t frameIndex = fontAtlas->frameIndex;
+
+	for (size_t i = 0; i < textCount; i++)
+	{
+		Text text = texts[i];
+
+		if (text == skipText || text->base.fontAtlas != fontAtlas ||
+			text->base.isEvicted || text->base.drawFrame + 1 < frameIndex)
+		{
+			continue;
+		}
+
+		const uint32_t* string = text->base.string;
+		size_t length = text->base.length;
+		uint32_t mask = text->base.mask;
+		uint64_t drawFrame = text->base.drawFrame;
+
+		for (size_t j = 0; j < length; j++)
+		{
+			uint32_t value = mask != 0 ? mask : string[j];
+
+			if (value == '\t')
+				value = ' ';
+
+			const Glyph* glyph = bsearch(
+				&value,
+				glyphs,
+				glyphCount,
+				sizeof(Glyph),
+				compareGlyph);
+
+			if (!glyph)
+				continue;
+
+			FontAtlasCell* cell = &cells[glyphCells[glyph - glyphs]];
+
+			if (cell->frame < drawFrame)
+				cell->frame = drawFrame;
+		}
+	}
+}
+/*
+ * Marks texts using the evicted glyphs to be baked again,
+ * glyph indices of the other atlas texts are also changed.
+ */
+inline static void evictFontAtlasTexts(
+	FontAtlas fontAtlas,
+	Text skipText,
+	const uint32_t* evictedValues,
+	size_t evictedCount)
+{
+	assert(fontAtlas);
+	assert(evictedValues || evictedCount == 0);
+
+	Handle handle = fontAtlas->pipeline->base.handle;
+	Text* texts = handle->base.texts;
+	size_t textCount = handle->base.textCount;
+
+	for (size_t i = 0; i < textCount; i++)
+	{
+		Text text = texts[i];
+
+		if (text->base.fontAtlas != fontAtlas)
+			continue;
+
+		text->base.isGlyphCacheValid = false;
+
+		if (evictedCount == 0 || text == skipText ||
+			text->base.isEvicted)
+		{
+			continue;
+		}
+
+		const uint32_t* string = text->base.string;
+		size_t length = text->base.length;
+		uint32_t mask = text->base.mask;
+
+		for (size_t j = 0; j < length; j++)
+		{
+			uint32_t value = mask != 0 ? mask : string[j];
+
+			if (value == '\t')
+				value = ' ';
+
+			const uint32_t* evictedValue = bsearch(
+				&value,
+				evictedValues,
+				evictedCount,
+				sizeof(uint32_t),
+				compareGlyphValue);
+
+			if (evictedValue)
+			{
+				text->base.isEvicted = true;
+				invalidateTextLayout(text);
+				break;
+			}
+		}
+	}
+}
+/*
+ * Adds missing text glyphs to the dynamic font atlas,
+ * reusing the least recently used glyph cells if full.
+ */
+inline static MpgxResult addFontAtlasGlyphs(
+	FontAtlas fontAtlas,
+	Text text,
+	bool* isChanged)
+{
+	assert(fontAtlas);
+	assert(text);
+	assert(isChanged);
+	assert(fontAtlas->isDynamic);
+
+	*isChanged = false;
+
+	const uint32_t* string = text->base.string;
+	const TextRun* runs = text->base.runs;
+	size_t runCount = text->base.runCount;
+	uint32_t mask = text->base.mask;
+	size_t length = 0;
+
+	for (size_t i = 0; i < runCount; i++)
+		length += runs[i].length;
+
+	if (length == 0)
+		return SUCCESS_MPGX_RESULT;
+
+	// Missing and evicted glyph values are
+	// both stored in the value buffer.
+	if (length * 2 > fontAtlas->valueCapacity)
+	{
+		size_t capacity = fontAtlas->valueCapacity * 2;
+
+		if (capacity < length * 2)
+			capacity = length * 2;
+
+		uint32_t* valueBuffer = realloc(
+			fontAtlas->valueBuffer,
+			capacity * sizeof(uint32_t));
+
+		if (!valueBuffer)
+			return OUT_OF_HOST_MEMORY_MPGX_RESULT;
+
+		fontAtlas->valueBuffer = valueBuffer;
+		fontAtlas->valueCapacity = capacity;
+	}
+
+	uint32_t* values = fontAtlas->valueBuffer;
+	Glyph* glyphs = fontAtlas->glyphs;
+	size_t glyphCapacity = fontAtlas->glyphCapacity;
+	size_t glyphCount = fontAtlas->glyphCount;
+	uint32_t* glyphCells = fontAtlas->glyphCells;
+	FontAtlasCell* cells = fontAtlas->cells;
+	uint64_t frameIndex = fontAtlas->frameIndex;
+	size_t valueCount = 0;
+
+	// Only visible characters are baked, without tags.
+	for (size_t i = 0; i < runCount; i++)
+	{
+		const uint32_t* runString = string + runs[i].offset;
+		size_t runLength = runs[i].length;
+
+		for (size_t j = 0; j < runLength; j++)
+		{
+			uint32_t value = mask != 0 ? mask : runString[j];
+
+			if (value == '\n') continue;
+			else if (value == '\t') value = ' ';
+
+			const Glyph* glyph = bsearch(
+				&value,
+				glyphs,
+				glyphCount,
+				sizeof(Glyph),
+				compareGlyph);
+
+			if (glyph)
+				cells[glyphCells[glyph - glyphs]].frame = frameIndex;
+			else
+				values[valueCount++] = value;
+		}
+	}
+
+	if (valueCount == 0)
+		return SUCCESS_MPGX_RESULT;
+
+	qsort(values,
+		valueCount,
+		sizeof(uint32_t),
+		compareGlyphValue);
+
+	size_t uniqueCount = 1;
+
+	for (size_t i = 1; i < valueCount; i++)
+	{
+		if (values[i] != values[uniqueCount - 1])
+			values[uniqueCount++] = values[i];
+	}
+
+	valueCount = uniqueCount;
+
+	size_t freeCount = glyphCapacity - glyphCount;
+	uint32_t* evictedValues = values + valueCount;
+	size_t evictedCount = 0;
+
+	if (freeCount < valueCount)
+	{
+		stampFontAtlasCells(fontAtlas, text);
+
+		FontAtlasCell* cellBuffer = fontAtlas->cellBuffer;
+		size_t candidateCount = 0;
+
+		// Glyphs used in the current or previous frame
+		// and the missing glyph fallback are not evicted.
+		for (size_t i = 0; i < glyphCapacity; i++)
+		{
+			FontAtlasCell cell = cells[i];
+
+			if (cell.value != FREE_FONT_ATLAS_CELL &&
+				cell.value != '\0' && cell.frame + 1 < frameIndex)
+			{
+				cellBuffer[candidateCount++] = cell;
+			}
+		}
+
+		size_t evictCount = valueCount - freeCount;
+
+		if (evictCount > candidateCount)
+			evictCount = candidateCount;
+
+		qsort(cellBuffer,
+			candidateCount,
+			sizeof(FontAtlasCell),
+			compareFontAtlasCell);
+
+		for (size_t i = 0; i < evictCount; i++)
+		{
+			FontAtlasCell* cell = &cells[cellBuffer[i].index];
+			evictedValues[evictedCount++] = cell->value;
+			cell->value = FREE_FONT_ATLAS_CELL;
+		}
+
+		qsort(evictedValues,
+			evictedCount,
+			sizeof(uint32_t),
+			compareGlyphValue);
+
+		size_t keepCount = 0;
+
+		for (size_t i = 0; i < glyphCount; i++)
+		{
+			if (cells[glyphCells[i]].value == FREE_FONT_ATLAS_CELL)
+				continue;
+
+			if (i != keepCount)
+			{
+				for (uint8_t j = 0; j < 4; j++)
+				{
+					glyphs[glyphCapacity * j + keepCount] =
+						glyphs[glyphCapacity * j + i];
+				}
+
+				glyphCells[keepCount] = glyphCells[i];
+			}
+
+			keepCount++;
+		}
+
+		glyphCount = keepCount;
+		freeCount += evictCount;
+
+		// Not baked glyphs are replaced with the
+		// missing glyph fallback until next frames.
+		if (freeCount < valueCount)
+		{
+			if (fontAtlas->logger)
+			{
+				logMessage(fontAtlas->logger, WARN_LOG_LEVEL,
+					"Dynamic font atlas is full. (glyphCount: %zu)",
+					glyphCapacity);
+			}
+
+			valueCount = freeCount;
+		}
+	}
+
+	// Merging new glyphs from the end, to keep them sorted.
+	size_t glyphIndex = glyphCount;
+	size_t valueIndex = valueCount;
+	size_t mergeIndex = glyphCount + valueCount;
+	size_t cellIndex = 0;
+
+	while (valueIndex > 0)
+	{
+		mergeIndex--;
+
+		if (glyphIndex > 0 && glyphs[glyphIndex - 1].value > values[valueIndex - 1])
+		{
+			glyphIndex--;
+
+			for (uint8_t j = 0; j < 4; j++)
+			{
+				glyphs[glyphCapacity * j + mergeIndex] =
+					glyphs[glyphCapacity * j + glyphIndex];
+			}
+
+			glyphCells[mergeIndex] = glyphCells[glyphIndex];
+		}
+		else
+		{
+			valueIndex--;
+
+			while (cells[cellIndex].value != FREE_FONT_ATLAS_CELL)
+				cellIndex++;
+
+			uint32_t value = values[valueIndex];
+			cells[cellIndex].value = value;
+			cells[cellIndex].frame = frameIndex;
+
+			for (uint8_t j = 0; j < 4; j++)
+				glyphs[glyphCapacity * j + mergeIndex].value = value;
+
+			glyphCells[mergeIndex] = (uint32_t)cellIndex;
+			cellIndex++;
+		}
+	}
+
+	if (valueCount == 0)
+		return SUCCESS_MPGX_RESULT;
+
+	glyphCount += valueCount;
+	fontAtlas->glyphCount = glyphCount;
+
+	evictFontAtlasTexts(
+		fontAtlas,
+		text,
+		evictedValues,
+		evictedCount);
+
+	*isChanged = true;
+
+	bool result = setFontsPixelSize(
+		fontAtlas->fonts,
+		fontAtlas->fontCount * 4,
+		fontAtlas->fontSize,
+		fontAtlas->logger);
+
+	if (!result)
+		return UNKNOWN_ERROR_MPGX_RESULT;
+
+	uint32_t cellLength = fontAtlas->cellLength;
+	uint32_t minCellY = UINT32_MAX, maxCellY = 0;
+
+	for (size_t i = 0; i < valueCount; i++)
+	{
+		const Glyph* glyph = bsearch(
+			&values[i],
+			glyphs,
+			glyphCount,
+			sizeof(Glyph),
+			compareGlyph);
+		assert(glyph);
+
+		size_t index = glyph - glyphs;
+		result = fillFontAtlasCell(fontAtlas, index);
+
+		if (!result)
+			return UNKNOWN_ERROR_MPGX_RESULT;
+
+		uint32_t cellY = glyphCells[index] / cellLength;
+
+		if (cellY < minCellY)
+			minCellY = cellY;
+		if (cellY > maxCellY)
+			maxCellY = cellY;
+	}
+
+	// Only rows containing new glyphs are uploaded.
+	uint32_t fontSize = fontAtlas->fontSize;
+	uint32_t pixelLength = cellLength * fontSize;
+	uint32_t pixelPosY = minCellY * fontSize;
+
+	return setFontAtlasImageData(
+		fontAtlas,
+		fontAtlas->pixels + (size_t)pixelPosY * pixelLength * 4,
+		vec3I(
+			(cmmt_int_t)pixelLength,
+			(cmmt_int_t)((maxCellY - minCellY + 1) * fontSize),
+			1),
+		vec3I(0, (cmmt_int_t)pixelPosY, 0));
+}
+inline static size_t findTextLine(
+	const TextLine* lines,
+	size_t lineCount,
+	size_t index)
+{
+	assert(lines);
+	assert(lineCount > 0);
+
+	size_t left = 0, right = lineCount;
+
+	while (right - left > 1)
+	{
+		size_t middle = left + (right - left) / 2;
+
+		if (lines[middle].offset <= index)
+			left = middle;
+		else
+			right = middle;
+	}
+
+	return left;
+}
+
+/*
+ * Updates cached text lines, vertices and cursor advances.
+ * Lines are laid out again only from the first edited line up
+ * to the first unchanged line with the same starting style,
+ * the rest is shifted. Wrapped text is laid out by the whole
+ * paragraphs. Changed vertex range is added to the pending
+ * upload range. Glyph cache is filled by the full layout.
+ */
+inline static MpgxResult updateTextLayout(
+	Text text,
+	TextScratch* scratch,
+	bool useGlyphCache)
+{
+	assert(text);
+	assert(scratch);
+
+	FontAtlas fontAtlas = text->base.fontAtlas;
+	const uint32_t* string = text->base.string;
+	size_t length = text->base.length;
+	TextLine* lines = text->base.lines;
+	size_t lineCount = text->base.lineCount;
+	size_t cleanPrefix = text->base.cleanPrefix;
+	size_t cleanSuffix = text->base.cleanSuffix;
+	size_t oldLength;
+
+	if (lineCount > 0)
+	{
+		TextLine* lastLine = &lines[lineCount - 1];
+		oldLength = lastLine->offset + lastLine->length;
+	}
+	else
+	{
+		oldLength = 0;
+	}
+
+	if (!isTextChanged(text))
+		return SUCCESS_MPGX_RESULT;
+
+	MpgxResult mpgxResult = updateTextRuns(text);
+
+	if (mpgxResult != SUCCESS_MPGX_RESULT)
+		return mpgxResult;
+
+	float* advances = text->base.advances;
+
+	if (length + 1 > text->base.advanceCapacity)
+	{
+		size_t capacity = text->base.advanceCapacity * 2;
+
+		if (capacity < length + 1)
+			capacity = length + 1;
+
+		float* newAdvances = realloc(
+			advances,
+			capacity * sizeof(float));
+
+		if (!newAdvances)
+			return OUT_OF_HOST_MEMORY_MPGX_RESULT;
+
+		text->base.advances = advances = newAdvances;
+		text->base.advanceCapacity = capacity;
+	}
+
+	TextWrapType wrap = text->base.wrap;
+	TextGlyph* glyphCache = NULL;
+	bool isGlyphCacheValid = false;
+
+	// Glyphs are cached only for the wrapped text, to fit
+	// lines again without the lookups when width is changed.
+	if (useGlyphCache && wrap != NONE_TEXT_WRAP_TYPE)
+	{
+		glyphCache = text->base.glyphCache;
+		isGlyphCacheValid = text->base.isGlyphCacheValid;
+
+		if (length > text->base.glyphCacheCapacity)
+		{
+			size_t capacity = text->base.glyphCacheCapacity * 2;
+
+			if (capacity < length)
+				capacity = length;
+
+			TextGlyph* newGlyphCache = realloc(
+				glyphCache,
+				capacity * sizeof(TextGlyph));
+
+			if (!newGlyphCache)
+				return OUT_OF_HOST_MEMORY_MPGX_RESULT;
+
+			text->base.glyphCache = glyphCache = newGlyphCache;
+			text->base.glyphCacheCapacity = capacity;
+			isGlyphCacheValid = false;
+		}
+	}
+
+	// Advances are line relative, so the clean suffix
+	// is only moved, relaid lines overwrite the rest.
+	if (lineCount > 0 && length != oldLength)
+	{
+		memmove(advances + (length - cleanSuffix),
+			advances + (oldLength - cleanSuffix),
+			(cleanSuffix + 1) * sizeof(float));
+	}
+
+	size_t firstLine, tailLine;
+	TextStyle style;
+
+	if (lineCount > 0)
+	{
+		firstLine = findTextLine(
+			lines,
+			lineCount,
+			cleanPrefix);
+
+		// Edited word can move to the previous wrapped line.
+		while (firstLine > 0 && lines[firstLine - 1].isWrapped)
+			firstLine--;
+
+		size_t suffixOffset = oldLength - cleanSuffix;
+
+		tailLine = findTextLine(
+			lines,
+			lineCount,
+			suffixOffset) + 1;
+
+		assert(tailLine > firstLine);
+	}
+	else
+	{
+		firstLine = tailLine = 0;
+	}
+
+	if (firstLine > 0)
+	{
+		style = lines[firstLine].style;
+	}
+	else
+	{
+		style.color = text->base.color;
+		style.isBold = text->base.isBold;
+		style.isItalic = text->base.isItalic;
+	}
+
+	int64_t offsetDelta = (int64_t)length - (int64_t)oldLength;
+	size_t lineOffset = lineCount > 0 ? lines[firstLine].offset : 0;
+	size_t vertexOffset = lineCount > 0 ? lines[firstLine].vertexOffset : 0;
+	size_t firstLineOffset = lineOffset;
+
+	TextVertex* vertexBuffer = scratch->vertexBuffer;
+	size_t vertexCapacity = scratch->vertexCapacity;
+
+	TextLine* lineBuffer = scratch->lineBuffer;
+	size_t lineCapacity = scratch->lineCapacity;
+	const Glyph* glyphs = fontAtlas->glyphs;
+	size_t glyphCapacity = fontAtlas->glyphCapacity;
+	size_t glyphCount = fontAtlas->glyphCount;
+	float fontSize = (float)fontAtlas->fontSize;
+	AlignmentType alignment = text->base.alignment;
+	const TextRun* runs = text->base.runs;
+	size_t runCount = text->base.runCount;
+	float maxWidth = text->base.maxWidth;
+	size_t newLineCount = 0, newVertexCount = 0;
+
+	size_t runIndex = findTextRun(
+		runs,
+		runCount,
+		lineOffset);
+
+	while (true)
+	{
+		if (newLineCount == lineCapacity)
+		{
+			lineCapacity = lineCapacity > 0 ? lineCapacity * 2 : 16;
+
+			TextLine* newLineBuffer = realloc(
+				lineBuffer,
+				lineCapacity * sizeof(TextLine));
+
+			if (!newLineBuffer)
+				return OUT_OF_HOST_MEMORY_MPGX_RESULT;
+
+			scratch->lineBuffer = lineBuffer = newLineBuffer;
+			scratch->lineCapacity = lineCapacity;
+		}
+
+		// Each line can contain the ellipsis, which
+		// is not included in the string characters.
+		size_t maxVertexCount = newVertexCount + (length - lineOffset + 3) * 4;
+
+		if (vertexCapacity < maxVertexCount)
+		{
+			vertexCapacity = vertexCapacity * 2;
+
+			if (vertexCapacity < maxVertexCount)
+				vertexCapacity = maxVertexCount;
+
+			TextVertex* newVertexBuffer = realloc(
+				vertexBuffer,
+				vertexCapacity * sizeof(TextVertex));
+
+			if (!newVertexBuffer)
+				return OUT_OF_HOST_MEMORY_MPGX_RESULT;
+
+			scratch->vertexBuffer = vertexBuffer = newVertexBuffer;
+			scratch->vertexCapacity = vertexCapacity;
+		}
+
+		TextLine* line = &lineBuffer[newLineCount];
+		line->offset = lineOffset;
+		line->vertexOffset = (uint32_t)(vertexOffset + newVertexCount);
+		line->style = style;
+
+		bool result = fillLineVertices(
+			string,
+			length,
+			text->base.mask,
+			runs,
+			runCount,
+			glyphs,
+			glyphCapacity,
+			glyphCount,
+			glyphCache,
+			isGlyphCacheValid,
+			wrap,
+			maxWidth,
+			fontSize,
+			alignment,
+			line,
+			&runIndex,
+			&style,
+			vertexBuffer + newVertexCount,
+			advances + lineOffset);
+
+		if (!result)
+			return BAD_VALUE_MPGX_RESULT;
+
+		newVertexCount += line->vertexCount;
+		newLineCount++;
+
+		lineOffset = line->offset + line->length;
+
+		if (!line->isWrapped)
+			lineOffset++;
+
+		if (lineOffset > length)
+		{
+			tailLine = lineCount;
+
+			if (glyphCache && firstLineOffset == 0)
+				text->base.isGlyphCacheValid = true;
+			break;
+		}
+
+		while (tailLine < lineCount && (int64_t)
+			lines[tailLine].offset + offsetDelta < (int64_t)lineOffset)
+		{
+			tailLine++;
+		}
+
+		if (!line->isWrapped && tailLine < lineCount &&
+			(int64_t)lines[tailLine].offset + offsetDelta == (int64_t)lineOffset &&
+			isTextStyleEqual(lines[tailLine].style, style))
+		{
+			break;
+		}
+	}
+
+	size_t oldVertexCount = text->base.vertexCount;
+
+	size_t tailVertexOffset = tailLine < lineCount ?
+		lines[tailLine].vertexOffset : oldVertexCount;
+	size_t tailVertexCount = oldVertexCount - tailVertexOffset;
+	size_t tailLineCount = lineCount - tailLine;
+	size_t headLineCount = firstLine;
+	size_t totalLineCount = headLineCount + newLineCount + tailLineCount;
+	size_t totalVertexCount = vertexOffset + newVertexCount + tailVertexCount;
+
+	if (totalVertexCount > UINT32_MAX / 6 * 4)
+		return BAD_VALUE_MPGX_RESULT;
+
+	if (totalLineCount > text->base.lineCapacity)
+	{
+		size_t capacity = text->base.lineCapacity > 0 ?
+			text->base.lineCapacity * 2 : 1;
+
+		while (capacity < totalLineCount)
+			capacity *= 2;
+
+		TextLine* newLines = realloc(
+			lines,
+			capacity * sizeof(TextLine));
+
+		if (!newLines)
+			return OUT_OF_HOST_MEMORY_MPGX_RESULT;
+
+		text->base.lines = lines = newLines;
+		text->base.lineCapacity = capacity;
+	}
+
+	TextVertex* vertices = text->base.vertices;
+
+	if (totalVertexCount > text->base.vertexCapacity)
+	{
+		size_t capacity = text->base.vertexCapacity > 0 ?
+			text->base.vertexCapacity * 2 : 4;
+
+		while (capacity < totalVertexCount)
+			capacity *= 2;
+
+		TextVertex* newVertices = realloc(
+			vertices,
+			capacity * sizeof(TextVertex));
+
+		if (!newVertices)
+			return OUT_OF_HOST_MEMORY_MPGX_RESULT;
+
+		text->base.vertices = vertices = newVertices;
+		text->base.vertexCapacity = capacity;
+	}
+
+	size_t newTailLine = headLineCount + newLineCount;
+	int64_t vertexDelta = (int64_t)(vertexOffset + newVertexCount) -
+		(int64_t)tailVertexOffset;
+
+	if (tailLineCount > 0 && newTailLine != tailLine)
+	{
+		memmove(lines + newTailLine, lines + tailLine,
+			tailLineCount * sizeof(TextLine));
+	}
+	if (tailVertexCount > 0 && vertexDelta != 0)
+	{
+		memmove(vertices + vertexOffset + newVertexCount,
+			vertices + tailVertexOffset,
+			tailVertexCount * sizeof(TextVertex));
+	}
+
+	if (offsetDelta != 0 || vertexDelta != 0)
+	{
+		for (size_t i = newTailLine; i < totalLineCount; i++)
+		{
+			TextLine* line = &lines[i];
+			line->offset = (size_t)((int64_t)line->offset + offsetDelta);
+			line->vertexOffset = (uint32_t)((int64_t)line->vertexOffset + vertexDelta);
+		}
+	}
+
+	memcpy(lines + headLineCount, lineBuffer,
+		newLineCount * sizeof(TextLine));
+
+	if (newVertexCount > 0)
+	{
+		memcpy(vertices + vertexOffset, vertexBuffer,
+			newVertexCount * sizeof(TextVertex));
+	}
+
+	float newLineAdvance = fontAtlas->newLineAdvance;
+	float sizeX = 0.0f;
+
+	for (size_t i = 0; i < totalLineCount; i++)
+	{
+		float width = lines[i].width;
+
+		if (sizeX < width)
+			sizeX = width;
+	}
+
+	float sizeY = getTextSizeY(
+		totalLineCount,
+		newLineAdvance,
+		fontSize);
+	float offsetY = getTextOffsetY(
+		alignment,
+		sizeY,
+		fontSize);
+
+	bool isFullUpload = lineCount == 0;
+
+	if (!isFullUpload && totalLineCount != lineCount)
+	{
+		float oldSizeY = getTextSizeY(
+			lineCount,
+			newLineAdvance,
+			fontSize);
+		float oldOffsetY = getTextOffsetY(
+			alignment,
+			oldSizeY,
+			fontSize);
+		isFullUpload = oldOffsetY != offsetY;
+	}
+
+	text->base.lineCount = totalLineCount;
+	text->base.vertexCount = totalVertexCount;
+	text->base.cleanPrefix = length;
+	text->base.cleanSuffix = length;
+	text->base.size = vec2F(sizeX, sizeY + newLineAdvance * 0.25f);
+
+	size_t uploadOffset, uploadEnd;
+
+	if (isFullUpload)
+	{
+		uploadOffset = 0;
+		uploadEnd = totalVertexCount;
+	}
+	else if (vertexDelta != 0 || newTailLine != tailLine)
+	{
+		uploadOffset = vertexOffset;
+		uploadEnd = totalVertexCount;
+	}
+	else
+	{
+		uploadOffset = vertexOffset;
+		uploadEnd = vertexOffset + newVertexCount;
+	}
+
+	// Text can be laid out several times before upload,
+	// for example to get cursor advance of the edited text.
+	if (text->base.uploadCount > 0)
+	{
+		size_t pendingOffset = text->base.uploadOffset;
+		size_t pendingEnd = pendingOffset + text->base.uploadCount;
+
+		if (uploadOffset > pendingOffset)
+			uploadOffset = pendingOffset;
+		if (uploadEnd < pendingEnd)
+			uploadEnd = pendingEnd;
+		if (uploadEnd > totalVertexCount)
+			uploadEnd = totalVertexCount;
+	}
+
+	text->base.uploadOffset = uploadOffset;
+	text->base.uploadCount = uploadEnd > uploadOffset ?
+		uploadEnd - uploadOffset : 0;
+	return SUCCESS_MPGX_RESULT;
+}
+/*
+ * Returns line index containing
+ * the specified vertex offset.
+ */
+inline static size_t findTextVertexLine(
+	const TextLine* lines,
+	size_t lineCount,
+	size_t offset)
+{
+	assert(lines);
+	assert(lineCount > 0);
+
+	size_t left = 0, right = lineCount;
+
+	while (right - left > 1)
+	{
+		size_t middle = left + (right - left) / 2;
+
+		if (lines[middle].vertexOffset <= offset)
+			left = middle;
+		else
+			right = middle;
+	}
+
+	return left;
+}
+inline static float getTextVertexOffsetY(Text text)
+{
+	assert(text);
+
+	FontAtlas fontAtlas = text->base.fontAtlas;
+	float fontSize = (float)fontAtlas->fontSize;
+	float newLineAdvance = fontAtlas->newLineAdvance;
+
+	float sizeY = getTextSizeY(
+		text->base.lineCount,
+		newLineAdvance,
+		fontSize);
+
+	return getFirstLineOffsetY(
+		newLineAdvance,
+		fontSize) + getTextOffsetY(
+		text->base.alignment,
+		sizeY,
+		fontSize);
+}
+/*
+ * Writes final text vertex positions
+ * of the specified range to the destination.
+ */
+inline static void writeTextVertices(
+	Text text,
+	size_t offset,
+	size_t count,
+	TextVertex* destination)
+{
+	assert(text);
+	assert(count > 0);
+	assert(offset + count <= text->base.vertexCount);
+	assert(destination);
+
+	float newLineAdvance = text->base.fontAtlas->newLineAdvance;
+	const TextLine* lines = text->base.lines;
+	size_t lineCount = text->base.lineCount;
+	const TextVertex* vertices = text->base.vertices;
+	float firstOffsetY = getTextVertexOffsetY(text);
+	size_t end = offset + count;
+
+	size_t firstLine = findTextVertexLine(
+		lines,
+		lineCount,
+		offset);
+
+	for (size_t i = firstLine; i < lineCount; i++)
+	{
+		const TextLine* line = &lines[i];
+		size_t lineVertexOffset = line->vertexOffset;
+
+		if (lineVertexOffset >= end)
+			break;
+
+		float lineOffsetY = firstOffsetY - (float)i * newLineAdvance;
+		size_t lineVertexCount = line->vertexCount;
+		size_t j = 0;
+
+		if (lineVertexOffset < offset)
+			j = offset - lineVertexOffset;
+		if (lineVertexOffset + lineVertexCount > end)
+			lineVertexCount = end - lineVertexOffset;
+
+		for (; j < lineVertexCount; j++)
+		{
+			TextVertex vertex = vertices[lineVertexOffset + j];
+			vertex.position.y += lineOffsetY;
+			destination[lineVertexOffset + j - offset] = vertex;
+		}
+	}
+}
+inline static int16_t packTextPosition(float value)
+{
+	value = floorf(value + 0.5f);
+
+	if (value > (float)INT16_MAX)
+		return INT16_MAX;
+	if (value < (float)INT16_MIN)
+		return INT16_MIN;
+	return (int16_t)value;
+}
+inline static uint16_t packTextTexCoords(
+	float value,
+	uint32_t atlasBit)
+{
+	uint32_t texCoords = (uint32_t)(value * 32767.0f + 0.5f);
+
+	if (texCoords > 32767)
+		texCoords = 32767;
+	return (uint16_t)(texCoords << 1u | atlasBit);
+}
+/*
+ * Writes final packed text vertices
+ * of the specified range to the destination.
+ * Text size is checked before, clamping only
+ * catches the italic and outline overhang.
+ */
+inline static void writePackedTextVertices(
+	Text text,
+	size_t offset,
+	size_t count,
+	PackedTextVertex* destination)
+{
+	assert(text);
+	assert(count > 0);
+	assert(offset + count <= text->base.vertexCount);
+	assert(destination);
+
+	FontAtlas fontAtlas = text->base.fontAtlas;
+	float positionScale = (float)fontAtlas->fontSize *
+		PACKED_TEXT_POSITION_STEPS;
+	float newLineAdvance = fontAtlas->newLineAdvance;
+	const TextLine* lines = text->base.lines;
+	size_t lineCount = text->base.lineCount;
+	const TextVertex* vertices = text->base.vertices;
+	float firstOffsetY = getTextVertexOffsetY(text);
+	size_t end = offset + count;
+
+	size_t firstLine = findTextVertexLine(
+		lines,
+		lineCount,
+		offset);
+
+	for (size_t i = firstLine; i < lineCount; i++)
+	{
+		const TextLine* line = &lines[i];
+		size_t lineVertexOffset = line->vertexOffset;
+
+		if (lineVertexOffset >= end)
+			break;
+
+		float lineOffsetY = firstOffsetY - (float)i * newLineAdvance;
+		size_t lineVertexCount = line->vertexCount;
+		size_t j = 0;
+
+		if (lineVertexOffset < offset)
+			j = offset - lineVertexOffset;
+		if (lineVertexOffset + lineVertexCount > end)
+			lineVertexCount = end - lineVertexOffset;
+
+		for (; j < lineVertexCount; j++)
+		{
+			const TextVertex* vertex = &vertices[lineVertexOffset + j];
+			uint32_t atlasIndex = (uint32_t)vertex->texCoords.z;
+
+			PackedTextVertex packedVertex;
+			packedVertex.positionX = packTextPosition(
+				vertex->position.x * positionScale);
+			packedVertex.positionY = packTextPosition(
+				(vertex->position.y + lineOffsetY) * positionScale);
+			packedVertex.texCoordsX = packTextTexCoords(
+				vertex->texCoords.x, atlasIndex & 1u);
+			packedVertex.texCoordsY = packTextTexCoords(
+				vertex->texCoords.y, atlasIndex >> 1u);
+			packedVertex.color = vertex->color;
+			destination[lineVertexOffset + j - offset] = packedVertex;
+		}
+	}
+}
+inline static uint32_t* createIndices(uint32_t indexCount)
+{
+	assert(indexCount > 0);
+
+	uint32_t* indices = malloc(
+		indexCount * sizeof(uint32_t));
+
+	if (!indices)
+		return NULL;
+
+	for (uint32_t i = 0, j = 0; i < indexCount; i += 6, j += 4)
+	{
+		indices[i + 0] = (uint32_t)j + 0;
+		indices[i + 1] = (uint32_t)j + 1;
+		indices[i + 2] = (uint32_t)j + 2;
+		indices[i + 3] = (uint32_t)j + 0;
+		indices[i + 4] = (uint32_t)j + 2;
+		indices[i + 5] = (uint32_t)j + 3;
+	}
+
+	return indices;
+}
+
+inline static bool allocateTextArenaRange(
+	Handle handle,
+	size_t count,
+	size_t* offset)
+{
+	assert(handle);
+	assert(count > 0);
+	assert(offset);
+
+	TextRange* freeRanges = handle->base.freeRanges;
+	size_t freeRangeCount = handle->base.freeRangeCount;
+
+	for (size_t i = 0; i < freeRangeCount; i++)
+	{
+		TextRange* range = &freeRanges[i];
+
+		if (range->count < count)
+			continue;
+
+		*offset = range->offset;
+
+		if (range->count == count)
+		{
+			for (size_t j = i + 1; j < freeRangeCount; j++)
+				freeRanges[j - 1] = freeRanges[j];
+			handle->base.freeRangeCount = freeRangeCount - 1;
+		}
+		else
+		{
+			range->offset += count;
+			range->count -= count;
+		}
+
+		return true;
+	}
+
+	return false;
+}
+inline static void freeTextArenaRange(
+	Handle handle,
+	size_t offset,
+	size_t count)
+{
+	assert(handle);
+
+	if (count == 0)
+		return;
+
+	TextRange* freeRanges = handle->base.freeRanges;
+	size_t freeRangeCount = handle->base.freeRangeCount;
+	size_t index = 0;
+
+	while (index < freeRangeCount &&
+		freeRanges[index].offset < offset)
+	{
+		index++;
+	}
+
+	bool mergePrevious = index > 0 &&
+		freeRanges[index - 1].offset +
+		freeRanges[index - 1].count == offset;
+	bool mergeNext = index < freeRangeCount &&
+		offset + count == freeRanges[index].offset;
+
+	if (mergePrevious && mergeNext)
+	{
+		freeRanges[index - 1].count += count + freeRanges[index].count;
+
+		for (size_t i = index + 1; i < freeRangeCount; i++)
+			freeRanges[i - 1] = freeRanges[i];
+		handle->base.freeRangeCount = freeRangeCount - 1;
+		return;
+	}
+	if (mergePrevious)
+	{
+		freeRanges[index - 1].count += count;
+		return;
+	}
+	if (mergeNext)
+	{
+		freeRanges[index].offset = offset;
+		freeRanges[index].count += count;
+		return;
+	}
+
+	if (freeRangeCount == handle->base.freeRangeCapacity)
+	{
+		size_t capacity = freeRangeCount > 0 ?
+			freeRangeCount * 2 : 16;
+
+		TextRange* newFreeRanges = realloc(
+			freeRanges,
+			capacity * sizeof(TextRange));
+
+		// Range is lost until the arena is
+		// resized, nothing else to do here.
+		if (!newFreeRanges)
+			return;
+
+		handle->base.freeRanges = freeRanges = newFreeRanges;
+		handle->base.freeRangeCapacity = capacity;
+	}
+
+	for (size_t i = freeRangeCount; i > index; i--)
+		freeRanges[i] = freeRanges[i - 1];
+
+	freeRanges[index].offset = offset;
+	freeRanges[index].count = count;
+	handle->base.freeRangeCount = freeRangeCount + 1;
+}
+/*
+ * Grows shared text vertex buffer and quad index buffer.
+ * All text vertices are kept in the CPU copy of the arena,
+ * so the new buffer is created already filled.
+ */
+inline static MpgxResult resizeTextArena(
+	Handle handle,
+	Window window,
+	size_t capacity)
+{
+	assert(handle);
+	assert(window);
+	assert(capacity % 4 == 0);
+	assert(capacity > handle->base.arenaCapacity);
+
+	if (capacity > UINT32_MAX / 6 * 4)
+		return BAD_VALUE_MPGX_RESULT;
+
+	size_t vertexSize = handle->base.vertexSize;
+
+	uint8_t* arenaVertices = realloc(
+		handle->base.arenaVertices,
+		capacity * vertexSize);
+
+	if (!arenaVertices)
+		return OUT_OF_HOST_MEMORY_MPGX_RESULT;
+
+	handle->base.arenaVertices = arenaVertices;
+
+	size_t arenaCapacity = handle->base.arenaCapacity;
+
+	memset(arenaVertices + arenaCapacity * vertexSize, 0,
+		(capacity - arenaCapacity) * vertexSize);
+
+	Buffer arenaBuffer;
+
+	MpgxResult mpgxResult = createBuffer(window,
+		VERTEX_BUFFER_TYPE,
+		CPU_TO_GPU_BUFFER_USAGE,
+		arenaVertices,
+		capacity * vertexSize,
+		&arenaBuffer);
+
+	if (mpgxResult != SUCCESS_MPGX_RESULT)
+		return mpgxResult;
+
+	uint32_t indexCount = (uint32_t)(capacity / 4) * 6;
+	uint32_t* indices = createIndices(indexCount);
+
+	if (!indices)
+	{
+		destroyBuffer(arenaBuffer);
+		return OUT_OF_HOST_MEMORY_MPGX_RESULT;
+	}
+
+	Buffer indexBuffer;
+
+	mpgxResult = createBuffer(window,
+		INDEX_BUFFER_TYPE,
+		GPU_ONLY_BUFFER_USAGE,
+		indices,
+		indexCount * sizeof(uint32_t),
+		&indexBuffer);
+
+	free(indices);
+
+	if (mpgxResult != SUCCESS_MPGX_RESULT)
+	{
+		destroyBuffer(arenaBuffer);
+		return mpgxResult;
+	}
+
+	GraphicsAPI api = getGraphicsAPI();
+
+	if (api == OPENGL_GRAPHICS_API)
+	{
+#if MPGX_SUPPORT_OPENGL
+		GraphicsMesh mesh = handle->gl.mesh;
+
+		if (mesh)
+		{
+			mesh->gl.vertexBuffer = arenaBuffer;
+			mesh->gl.indexBuffer = indexBuffer;
+			mesh->gl.indexCount = indexCount;
+		}
+		else
+		{
+			mpgxResult = createGraphicsMesh(
+				window,
+				UINT32_INDEX_TYPE,
+				indexCount,
+				0,
+				arenaBuffer,
+				indexBuffer,
+				&mesh);
+
+			if (mpgxResult != SUCCESS_MPGX_RESULT)
+			{
+				destroyBuffer(indexBuffer);
+				destroyBuffer(arenaBuffer);
+				return mpgxResult;
+			}
+
+			handle->gl.mesh = mesh;
+		}
+#else
+		abort();
+#endif
+	}
+
+	destroyBuffer(handle->base.indexBuffer);
+	destroyBuffer(handle->base.arenaBuffer);
+
+	handle->base.indexBuffer = indexBuffer;
+	handle->base.arenaBuffer = arenaBuffer;
+	handle->base.arenaCapacity = capacity;
+
+	freeTextArenaRange(
+		handle,
+		arenaCapacity,
+		capacity - arenaCapacity);
+	return SUCCESS_MPGX_RESULT;
+}
+/*
+ * Makes sure that the text arena range can hold the vertex
+ * count. Text vertices have to be uploaded again if moved.
+ */
+inline static MpgxResult reserveTextArena(
+	Text text,
+	Handle handle,
+	Window window,
+	size_t vertexCount,
+	bool* isMoved)
+{
+	assert(text);
+	assert(handle);
+	assert(window);
+	assert(isMoved);
+
+	size_t arenaCapacity = text->base.arenaCapacity;
+
+	if (vertexCount <= arenaCapacity)
+	{
+		*isMoved = false;
+		return SUCCESS_MPGX_RESULT;
+	}
+
+	size_t capacity = arenaCapacity * 2;
+
+	if (capacity < vertexCount)
+		capacity = vertexCount;
+
+	// Old range is freed only after the new one is
+	// allocated, so on failure text still owns it.
+	size_t offset;
+
+	if (!allocateTextArenaRange(handle, capacity, &offset))
+	{
+		size_t newCapacity = handle->base.arenaCapacity > 0 ?
+			handle->base.arenaCapacity * 2 : 4096;
+
+		while (newCapacity < handle->base.arenaCapacity + capacity)
+			newCapacity *= 2;
+
+		MpgxResult mpgxResult = resizeTextArena(
+			handle,
+			window,
+			newCapacity);
+
+		if (mpgxResult != SUCCESS_MPGX_RESULT)
+			return mpgxResult;
+
+		bool result = allocateTextArenaRange(
+			handle,
+			capacity,
+			&offset);
+
+		// Can fail only if free range list was lost.
+		if (!result)
+			return OUT_OF_HOST_MEMORY_MPGX_RESULT;
+	}
+
+	freeTextArenaRange(
+		handle,
+		text->base.arenaOffset,
+		arenaCapacity);
+
+	text->base.arenaOffset = offset;
+	text->base.arenaCapacity = capacity;
+	*isMoved = true;
+	return SUCCESS_MPGX_RESULT;
+}
+/*
+ * Writes text vertex range to the arena
+ * and uploads it to the shared vertex buffer.
+ */
+inline static MpgxResult uploadTextVertices(
+	Text text,
+	Handle handle,
+	Window window,
+	size_t offset,
+	size_t count)
+{
+	assert(text);
+	assert(handle);
+	assert(window);
+	assert(count > 0);
+	assert(offset + count <= text->base.arenaCapacity);
+
+	size_t arenaOffset = text->base.arenaOffset + offset;
+	size_t vertexSize = handle->base.vertexSize;
+	uint8_t* vertices = handle->base.arenaVertices + arenaOffset * vertexSize;
+
+	if (vertexSize == sizeof(PackedTextVertex))
+	{
+		writePackedTextVertices(
+			text,
+			offset,
+			count,
+			(PackedTextVertex*)vertices);
+	}
+	else
+	{
+		writeTextVertices(
+			text,
+			offset,
+			count,
+			(TextVertex*)vertices);
+	}
+
+	Buffer arenaBuffer = handle->base.arenaBuffer;
+	size_t size = count * vertexSize;
+	size_t bufferOffset = arenaOffset * vertexSize;
+	GraphicsAPI api = getGraphicsAPI();
+
+	if (api == VULKAN_GRAPHICS_API)
+	{
+#if MPGX_SUPPORT_VULKAN
+		VkWindow vkWindow = getVkWindow(window);
+
+		VkResult vkResult = vkQueueWaitIdle(
+			vkWindow->graphicsQueue);
+
+		if (vkResult != VK_SUCCESS)
+			return vkToMpgxResult(vkResult);
+
+		return setVkBufferData(
+			vkWindow->allocator,
+			arenaBuffer->vk.allocation,
+			vertices,
+			size,
+			bufferOffset);
+#else
+		abort();
+#endif
+	}
+	else if (api == OPENGL_GRAPHICS_API)
+	{
+#if MPGX_SUPPORT_OPENGL
+		return setGlBufferData(
+			arenaBuffer->gl.glType,
+			arenaBuffer->gl.handle,
+			vertices,
+			size,
+			bufferOffset);
+#else
+		abort();
+#endif
+	}
+	else
+	{
+		abort();
+	}
+}
+
+inline static void internalDestroyText(Text text)
+{
+	if (!text)
+		return;
+
+	FontAtlas fontAtlas = text->base.fontAtlas;
+	Handle handle = fontAtlas->pipeline->base.handle;
+
+	freeTextArenaRange(
+		handle,
+		text->base.arenaOffset,
+		text->base.arenaCapacity);
+
+	if (fontAtlas->isGenerated)
+		destroyFontAtlas(fontAtlas);
+
+	free(text->base.glyphCache);
+	free(text->base.runs);
+	free(text->base.advances);
+	free(text->base.vertices);
+	free(text->base.lines);
+	free(text->base.string);
+	free(text);
+}
+inline static MpgxResult internalCreateText(
+	FontAtlas fontAtlas,
+	uint32_t* string,
+	size_t length,
+	size_t capacity,
+	AlignmentType alignment,
+	SrgbColor color,
+	bool isBold,
+	bool isItalic,
+	bool useTags,
+	bool isConstant,
+	Text* text)
+{
+	assert(fontAtlas);
+	assert(capacity > 0);
+	assert(alignment < ALIGNMENT_TYPE_COUNT);
+	assert(text);
+	assert(textInitialized);
+
+	assert(length == 0 ||
+		(length > 0 && string));
+
+	Text textInstance = calloc(
+		1, sizeof(Text_T));
+
+	if (!textInstance)
+		return OUT_OF_HOST_MEMORY_MPGX_RESULT;
+
+	textInstance->base.fontAtlas = fontAtlas;
+	textInstance->base.string = string;
+	textInstance->base.capacity = capacity;
+	textInstance->base.length = length;
+	textInstance->base.color = color;
+	textInstance->base.alignment = alignment;
+	textInstance->base.wrap = NONE_TEXT_WRAP_TYPE;
+	textInstance->base.maxWidth = 0.0f;
+	textInstance->base.mask = 0;
+	textInstance->base.isBold = isBold;
+	textInstance->base.isItalic = isItalic;
+	textInstance->base.useTags = useTags;
+	textInstance->base.isConstant = isConstant;
+
+	GraphicsPipeline pipeline = fontAtlas->pipeline;
+	Handle handle = pipeline->base.handle;
+	assert(!handle->base.isEnumerating);
+
+	MpgxResult mpgxResult;
+
+	if (fontAtlas->isDynamic)
+	{
+		mpgxResult = updateTextRuns(textInstance);
+
+		if (mpgxResult != SUCCESS_MPGX_RESULT)
+		{
+			internalDestroyText(textInstance);
+			return mpgxResult;
+		}
+
+		bool isChanged;
+
+		mpgxResult = addFontAtlasGlyphs(
+			fontAtlas,
+			textInstance,
+			&isChanged);
+
+		if (mpgxResult != SUCCESS_MPGX_RESULT)
+		{
+			internalDestroyText(textInstance);
+			return mpgxResult;
+		}
+	}
+
+	mpgxResult = updateTextLayout(
+		textInstance,
+		&handle->base.scratch,
+		true);
+
+	if (mpgxResult != SUCCESS_MPGX_RESULT)
+	{
+		internalDestroyText(textInstance);
+		return mpgxResult;
+	}
+
+	Window window = pipeline->base.window;
+	size_t vertexCount = textInstance->base.vertexCount;
+
+	if (vertexCount > 0)
+	{
+		bool isMoved;
+
+		mpgxResult = reserveTextArena(
+			textInstance,
+			handle,
+			window,
+			vertexCount,
+			&isMoved);
+
+		if (mpgxResult != SUCCESS_MPGX_RESULT)
+		{
+			internalDestroyText(textInstance);
+			return mpgxResult;
+		}
+
+		mpgxResult = uploadTextVertices(
+			textInstance,
+			handle,
+			window,
+			0,
+			vertexCount);
+
+		if (mpgxResult != SUCCESS_MPGX_RESULT)
+		{
+			internalDestroyText(textInstance);
+			return mpgxResult;
+		}
+	}
+
+	textInstance->base.uploadCount = 0;
+	textInstance->base.indexCount = (uint32_t)(vertexCount / 4) * 6;
+
+	if (isConstant)
+	{
+		free(textInstance->base.runs);
+		textInstance->base.runs = NULL;
+		textInstance->base.runCapacity = 0;
+		textInstance->base.runCount = 0;
+
+		free(textInstance->base.vertices);
+		textInstance->base.vertices = NULL;
+		textInstance->base.vertexCapacity = 0;
+	}
+
+	Text* texts = handle->base.texts;
+	size_t textCount = handle->base.textCount;
+
+	if (textCount == handle->base.textCapacity)
+	{
+		capacity = handle->base.textCapacity * 2;
+
+		Text* newTexts = realloc(texts,
+			sizeof(Text) * capacity);
+
+		if (!newTexts)
+		{
+			internalDestroyText(textInstance);
+			return OUT_OF_HOST_MEMORY_MPGX_RESULT;
+		}
+
+		handle->base.texts = newTexts;
+		handle->base.textCapacity = capacity;
+	}
+
+	handle->base.texts[textCount] = textInstance;
+	handle->base.textCount = textCount + 1;
+
+	*text = textInstance;
+	return SUCCESS_MPGX_RESULT;
+}
+
+bool measureText(
+	FontAtlas fontAtlas,
+	const uint32_t* string,
+	size_t length,
+	bool isBold,
+	bool isItalic,
+	bool useTags,
+	Vec2F* size,
+	size_t* _lineCount,
+	float* lineWidths,
+	size_t lineCapacity)
+{
+	assert(fontAtlas);
+	assert(size);
+	assert(lineCapacity == 0 ||
+		(lineCapacity > 0 && lineWidths));
+	assert(textInitialized);
+
+	assert(length == 0 ||
+		(length > 0 && string));
+
+	const Glyph* _glyphs = fontAtlas->glyphs;
+	size_t glyphCapacity = fontAtlas->glyphCapacity;
+	size_t glyphCount = fontAtlas->glyphCount;
+
+	if (glyphCount == 0)
+		return false;
+
+	TextStyle style;
+	style.color = srgbColor(0, 0, 0, 0);
+	style.isBold = isBold;
+	style.isItalic = isItalic;
+
+	float atlasIndex;
+
+	const Glyph* glyphs = getStyleGlyphs(
+		_glyphs,
+		glyphCapacity,
+		isBold,
+		isItalic,
+		&atlasIndex);
+
+	float lineWidth = 0.0f, sizeX = 0.0f;
+	size_t lineCount = 0;
+
+	// Same as the text layout, but without vertices,
+	// runs and advances, so nothing is allocated.
+	for (size_t i = 0; i < length; i++)
+	{
+		uint32_t value = string[i];
+
+		if ((value == '<') & useTags)
+		{
+			size_t tagLength = parseTextTag(
+				string,
+				length,
+				i,
+				style.color,
+				&style);
+
+			if (tagLength > 0)
+			{
+				glyphs = getStyleGlyphs(
+					_glyphs,
+					glyphCapacity,
+					style.isBold,
+					style.isItalic,
+					&atlasIndex);
+				i += tagLength - 1;
+				continue;
+			}
+		}
+
+		if (value == '\n')
+		{
+			if (lineCount < lineCapacity)
+				lineWidths[lineCount] = lineWidth;
+			if (sizeX < lineWidth)
+				sizeX = lineWidth;
+
+			lineWidth = 0.0f;
+			lineCount++;
+			continue;
+		}
+		else if (value == '\t')
+		{
+			value = ' ';
+
+			const Glyph* glyph = bsearch(
+				&value,
+				glyphs,
+				glyphCount,
+				sizeof(Glyph),
+				compareGlyph);
+
+			if (!glyph)
+				return false;
+
+			lineWidth += glyph->advance * 4;
+			continue;
+		}
+
+		const Glyph* glyph = bsearch(
+			&value,
+			glyphs,
+			glyphCount,
+			sizeof(Glyph),
+			compareGlyph);
+
+		if (!glyph)
+		{
+			value = '\0';
+
+			glyph = bsearch(
+				&value,
+				glyphs,
+				glyphCount,
+				sizeof(Glyph),
+				compareGlyph);
+
+			if (!glyph)
+				return false;
+		}
+
+		lineWidth += glyph->advance;
+	}
+
+	if (lineCount < lineCapacity)
+		lineWidths[lineCount] = lineWidth;
+	if (sizeX < lineWidth)
+		sizeX = lineWidth;
+
+	lineCount++;
+
+	float newLineAdvance = fontAtlas->newLineAdvance;
+
+	float sizeY = getTextSizeY(
+		lineCount,
+		newLineAdvance,
+		(float)fontAtlas->fontSize);
+
+	*size = vec2F(
+		(cmmt_float_t)sizeX,
+		(cmmt_float_t)(sizeY + newLineAdvance * 0.25f));
+
+	if (_lineCount)
+		*_lineCount = lineCount;
+	return true;
+}
+bool measureText8(
+	FontAtlas fontAtlas,
+	const char* string,
+	size_t length,
+	bool isBold,
+	bool isItalic,
+	bool useTags,
+	Vec2F* size,
+	size_t* lineCount,
+	float* lineWidths,
+	size_t lineCapacity)
+{
+	assert(fontAtlas);
+	assert(size);
+	assert(textInitialized);
+
+	assert(length == 0 ||
+		(length > 0 && string));
+
+	uint32_t stackString[MEASURE_TEXT_STACK_LENGTH];
+	uint32_t* string32;
+
+	// Short strings are decoded on the stack,
+	// to keep measuring allocation free.
+	if (length > MEASURE_TEXT_STACK_LENGTH)
+	{
+		string32 = malloc(length * sizeof(uint32_t));
+
+		if (!string32)
+			return false;
+	}
+	else
+	{
+		string32 = stackString;
+	}
+
+	size_t length32;
+
+	if (length > 0)
+	{
+		length32 = stringUTF8toUTF32(
+			string,
+			length,
+			string32);
+
+		if (length32 == 0)
+		{
+			if (string32 != stackString)
+				free(string32);
+			return false;
+		}
+	}
+	else
+	{
+		length32 = 0;
+	}
+
+	bool result = measureText(
+		fontAtlas,
+		string32,
+		length32,
+		isBold,
+		isItalic,
+		useTags,
+		size,
+		lineCount,
+		lineWidths,
+		lineCapacity);
+
+	if (string32 != stackString)
+		free(string32);
+	return result;
+}
+
+MpgxResult createAtlasText(
+	FontAtlas fontAtlas,
+	const uint32_t* string,
+	size_t length,
+	AlignmentType alignment,
+	SrgbColor color,
+	bool isBold,
+	bool isItalic,
+	bool useTags,
+	bool isConstant,
+	Text* text)
+{
+	assert(fontAtlas);
+	assert(alignment < ALIGNMENT_TYPE_COUNT);
+	assert(text);
+	assert(!fontAtlas->isGenerated);
+	assert(!isConstant || !fontAtlas->isDynamic);
+	assert(textInitialized);
+
+	assert(length == 0 ||
+		(length > 0 && string));
+
+	uint32_t* stringArray;
+	size_t capacity;
+
+	if (length > 0)
+	{
+		stringArray = malloc(length * sizeof(uint32_t));
+
+		if (!stringArray)
+			return OUT_OF_HOST_MEMORY_MPGX_RESULT;
+
+		memcpy(stringArray, string,
+			sizeof(uint32_t) * length);
+		capacity = length;
+	}
+	else
+	{
+		stringArray = malloc(sizeof(uint32_t));
+
+		if (!stringArray)
+			return OUT_OF_HOST_MEMORY_MPGX_RESULT;
+
+		capacity = 1;
+	}
+
+	return internalCreateText(
+		fontAtlas,
+		stringArray,
+		length,
+		capacity,
+		alignment,
+		color,
+		isBold,
+		isItalic,
+		useTags,
+		isConstant,
+		text);
+}
+MpgxResult createAtlasText8(
+	FontAtlas fontAtlas,
+	const char* string,
+	size_t length,
+	AlignmentType alignment,
+	SrgbColor color,
+	bool isBold,
+	bool isItalic,
+	bool useTags,
+	bool isConstant,
+	Text* text)
+{
+	assert(fontAtlas);
+	assert(alignment < ALIGNMENT_TYPE_COUNT);
+	assert(text);
+	assert(!fontAtlas->isGenerated);
+	assert(!isConstant || !fontAtlas->isDynamic);
+	assert(textInitialized);
+
+	assert(length == 0 ||
+		(length > 0 && string));
+
+	uint32_t* string32;
+	size_t length32;
+	size_t capacity;
+
+	if (length > 0)
+	{
+		MpgxResult mpgxResult = allocateStringUTF32(
+			string,
+			length,
+			&string32,
+			&length32);
+
+		if (mpgxResult != SUCCESS_MPGX_RESULT)
+			return mpgxResult;
+
+		capacity = length32;
+	}
+	else
+	{
+		string32 = malloc(sizeof(uint32_t));
+
+		if (!string32)
+			return OUT_OF_HOST_MEMORY_MPGX_RESULT;
+
+		length32 = 0;
+		capacity = 1;
+	}
+
+	return internalCreateText(
+		fontAtlas,
+		string32,
+		length32,
+		capacity,
+		alignment,
+		color,
+		isBold,
+		isItalic,
+		useTags,
+		isConstant,
+		text);
+}
+
+MpgxResult createFontText(
+	GraphicsPipeline textPipeline,
+	Font* regularFonts,
+	Font* boldFonts,
+	Font* italicFonts,
+	Font* boldItalicFonts,
+	size_t fontCount,
+	uint32_t fontSize,
+	const uint32_t* string,
+	size_t length,
+	AlignmentType alignment,
+	SrgbColor color,
+	bool isBold,
+	bool isItalic,
+	bool useTags,
+	bool isConstant,
+	Logger logger,
+	Text* text)
+{
+	assert(textPipeline);
+	assert(regularFonts);
+	assert(boldFonts);
+	assert(italicFonts);
+	assert(boldItalicFonts);
+	assert(fontCount > 0);
+	assert(fontSize > 0);
+	assert(fontSize % 2 == 0);
+	assert(alignment < ALIGNMENT_TYPE_COUNT);
+	assert(text);
+	assert(textInitialized);
+
+	assert(length == 0 ||
+		(length > 0 && string));
+
+	const uint32_t chars[] = { '\0' };
+
+	FontAtlas fontAtlas;
+
+	MpgxResult mpgxResult = internalCreateFontAtlas(
+		textPipeline,
+		regularFonts,
+		boldFonts,
+		italicFonts,
+		boldItalicFonts,
+		fontCount,
+		fontSize,
+		length > 0 ? string : chars,
+		length > 0 ? length : 1,
+		NULL,
+		logger,
+		&fontAtlas,
+		true,
+		isConstant);
+
+	if (mpgxResult != SUCCESS_MPGX_RESULT)
+		return mpgxResult;
+
+	uint32_t* stringArray;
+	size_t capacity;
+
+	if (length > 0)
+	{
+		stringArray = malloc(length * sizeof(uint32_t));
+
+		if (!stringArray)
+			return OUT_OF_HOST_MEMORY_MPGX_RESULT;
+
+		memcpy(stringArray, string,
+			sizeof(uint32_t) * length);
+		capacity = length;
+	}
+	else
+	{
+		stringArray = malloc(sizeof(uint32_t));
+
+		if (!stringArray)
+			return OUT_OF_HOST_MEMORY_MPGX_RESULT;
+
+		capacity = 1;
+	}
+
+	mpgxResult = internalCreateText(
+		fontAtlas,
+		stringArray,
+		length,
+		capacity,
+		alignment,
+		color,
+		isBold,
+		isItalic,
+		useTags,
+		isConstant,
+		text);
+
+	if (mpgxResult != SUCCESS_MPGX_RESULT)
+	{
+		destroyFontAtlas(fontAtlas);
+		return mpgxResult;
+	}
+
+	return SUCCESS_MPGX_RESULT;
+}
+MpgxResult createFontText8(
+	GraphicsPipeline textPipeline,
+	Font* regularFonts,
+	Font* boldFonts,
+	Font* italicFonts,
+	Font* boldItalicFonts,
+	size_t fontCount,
+	uint32_t fontSize,
+	const char* string,
+	size_t length,
+	AlignmentType alignment,
+	SrgbColor color,
+	bool isBold,
+	bool isItalic,
+	bool useTags,
+	bool isConstant,
+	Logger logger,
+	Text* text)
+{
+	assert(textPipeline);
+	assert(regularFonts);
+	assert(boldFonts);
+	assert(italicFonts);
+	assert(boldItalicFonts);
+	assert(fontCount > 0);
+	assert(fontSize > 0);
+	assert(fontSize % 2 == 0);
+	assert(alignment < ALIGNMENT_TYPE_COUNT);
+	assert(text);
+	assert(textInitialized);
+
+	assert(length == 0 ||
+		(length > 0 && string));
+
+	uint32_t* string32;
+	size_t length32;
+	size_t capacity;
+
+	if (length > 0)
+	{
+		MpgxResult mpgxResult = allocateStringUTF32(
+			string,
+			length,
+			&string32,
+			&length32);
+
+		if (mpgxResult != SUCCESS_MPGX_RESULT)
+			return mpgxResult;
+
+		capacity = length32;
+	}
+	else
+	{
+		string32 = malloc(sizeof(uint32_t));
+
+		if (!string32)
+			return OUT_OF_HOST_MEMORY_MPGX_RESULT;
+
+		length32 = 0;
+		capacity = 1;
+	}
+
+	const uint32_t chars[] = { '\0' };
+
+	FontAtlas fontAtlas;
+
+	MpgxResult mpgxResult = internalCreateFontAtlas(
+		textPipeline,
+		regularFonts,
+		boldFonts,
+		italicFonts,
+		boldItalicFonts,
+		fontCount,
+		fontSize,
+		length32 > 0 ? string32 : chars,
+		length32 > 0 ? length32 : 1,
+		NULL,
+		logger,
+		&fontAtlas,
+		true,
+		isConstant);
+
+	if (mpgxResult != SUCCESS_MPGX_RESULT)
+		return mpgxResult;
+
+	mpgxResult = internalCreateText(
+		fontAtlas,
+		string32,
+		length32,
+		capacity,
+		alignment,
+		color,
+		isBold,
+		isItalic,
+		useTags,
+		isConstant,
+		text);
+
+	if (mpgxResult != SUCCESS_MPGX_RESULT)
+	{
+		destroyFontAtlas(fontAtlas);
+		return mpgxResult;
+	}
+
+	return SUCCESS_MPGX_RESULT;
+}
+
+void destroyText(Text text)
+{
+	if (!text)
+		return;
+
+	assert(textInitialized);
+
+	FontAtlas fontAtlas = text->base.fontAtlas;
+	Handle handle = fontAtlas->pipeline->base.handle;
+	assert(!handle->base.isEnumerating);
+	Text* texts = handle->base.texts;
+	size_t textCount = handle->base.textCount;
+
+	for (int64_t i = (int64_t)textCount - 1; i >= 0; i--)
+	{
+		if (texts[i] != text)
+			continue;
+
+		for (size_t j = i + 1; j < textCount; j++)
+			texts[j - 1] = texts[j];
+
+		internalDestroyText(text);
+		handle->base.textCount--;
+		return;
+	}
+
+	abort();
+}
+
+FontAtlas getTextFontAtlas(Text text)
+{
+	assert(text);
+	assert(textInitialized);
+	return text->base.fontAtlas;
+}
+Vec2F getTextSize(Text text)
+{
+	assert(text);
+	assert(textInitialized);
+	return text->base.size;
+}
+bool isTextConstant(Text text)
+{
+	assert(text);
+	assert(textInitialized);
+	return text->base.isConstant;
+}
+
+const uint32_t* getTextString(Text text)
+{
+	assert(text);
+	assert(textInitialized);
+	return text->base.string;
+}
+size_t getTextLength(Text text)
+{
+	assert(text);
+	assert(textInitialized);
+	return text->base.length;
+}
+
+/*
+ * Marks changed range between the old
+ * and the new text strings.
+ */
+inline static void markTextStringChanged(
+	Text text,
+	const uint32_t* oldString,
+	size_t oldLength,
+	const uint32_t* newString,
+	size_t newLength)
+{
+	assert(text);
+
+	size_t minLength = oldLength < newLength ?
+		oldLength : newLength;
+	size_t prefix = 0, suffix = 0;
+
+	while (prefix < minLength &&
+		oldString[prefix] == newString[prefix])
+	{
+		prefix++;
+	}
+
+	if (prefix == oldLength && oldLength == newLength)
+		return;
 
-	if (newPixelLength > pixelLength)
+	while (prefix + suffix < minLength &&
+		oldString[oldLength - suffix - 1] ==
+		newString[newLength - suffix - 1])
 	{
-		Image newImage;
+		suffix++;
+	}
 
-		MpgxResult mpgxResult = createImage(
-			window,
-			SAMPLED_IMAGE_TYPE,
-			IMAGE_2D,
-			R8G8B8A8_UNORM_IMAGE_FORMAT,
-			pixelBuffer,
-			vec3I(
-				(cmmt_int_t)newPixelLength,
-				(cmmt_int_t)newPixelLength,
-				1),
-			1,
-			false,
-			&newImage);
+	markTextChanged(text, prefix, suffix);
+}
 
-		if (mpgxResult != SUCCESS_MPGX_RESULT)
-			return mpgxResult;
+bool setTextString(
+	Text text,
+	const uint32_t* string,
+	size_t length)
+{
+	assert(text);
+	assert(textInitialized);
+	assert(!text->base.isConstant);
 
-#if MPGX_SUPPORT_VULKAN
-		if (api == VULKAN_GRAPHICS_API)
-		{
-			VkWindow vkWindow = getVkWindow(window);
-			VkDevice device = vkWindow->device;
+	assert(length == 0 ||
+		(length > 0 && string));
 
-			VkDescriptorPool descriptorPool;
+	if (length > text->base.capacity)
+	{
+		uint32_t* newString = realloc(
+			text->base.string,
+			length * sizeof(uint32_t));
 
-			mpgxResult = createVkDescriptorPool(
-				vkWindow->device,
-				&descriptorPool);
+		if (!newString)
+			return false;
 
-			if (mpgxResult != SUCCESS_MPGX_RESULT)
-			{
-				destroyImage(newImage);
-				return mpgxResult;
-			}
+		text->base.string = newString;
+		text->base.capacity = length;
+	}
 
-			VkDescriptorSet descriptorSet;
+	markTextStringChanged(
+		text,
+		text->base.string,
+		text->base.length,
+		string,
+		length);
 
-			mpgxResult = createVkDescriptorSet(
-				device,
-				pipelineHandle->vk.descriptorSetLayout,
-				descriptorPool,
-				pipelineHandle->vk.sampler->vk.handle,
-				newImage->vk.imageView,
-				&descriptorSet);
+	memcpy(text->base.string, string,
+		length * sizeof(uint32_t));
+	text->base.length = length;
+	return true;
+}
+bool setTextString8(
+	Text text,
+	const char* string,
+	size_t length)
+{
+	assert(text);
+	assert(textInitialized);
+	assert(!text->base.isConstant);
 
-			if (mpgxResult != SUCCESS_MPGX_RESULT)
-			{
-				vkDestroyDescriptorPool(
-					device,
-					descriptorPool,
-					NULL);
-				destroyImage(newImage);
-				return mpgxResult;
-			}
+	assert(length == 0 ||
+		(length > 0 && string));
 
-			VkResult vkResult = vkQueueWaitIdle(
-				vkWindow->graphicsQueue);
+	size_t oldLength = text->base.length;
 
-			if (vkResult != VK_SUCCESS)
-			{
-				vkDestroyDescriptorPool(
-					device,
-					descriptorPool,
-					NULL);
-				destroyImage(newImage);
-				return vkToMpgxResult(vkResult);
-			}
+	// New string is decoded after the old one,
+	// to compare them before the replacement.
+	if (oldLength + length > text->base.capacity)
+	{
+		size_t capacity = oldLength + length;
 
-			vkDestroyDescriptorPool(
-				device,
-				fontAtlas->descriptorPool,
-				NULL);
+		uint32_t* newString = realloc(
+			text->base.string,
+			capacity * sizeof(uint32_t));
 
-			fontAtlas->descriptorPool = descriptorPool;
-			fontAtlas->descriptorSet = descriptorSet;
-		}
+		if (!newString)
+			return false;
 
-		destroyImage(image);
-		fontAtlas->image = newImage;
-#endif
+		text->base.string = newString;
+		text->base.capacity = capacity;
+	}
+
+	uint32_t* baseString = text->base.string;
+	size_t newLength;
+
+	if (length > 0)
+	{
+		newLength = stringUTF8toUTF32(
+			string,
+			length,
+			baseString + oldLength);
 	}
 	else
 	{
-		MpgxResult mpgxResult;
+		newLength = 0;
+	}
 
-		if (api == VULKAN_GRAPHICS_API)
-		{
-#if MPGX_SUPPORT_VULKAN
-			VkWindow vkWindow = getVkWindow(window);
+	markTextStringChanged(
+		text,
+		baseString,
+		oldLength,
+		baseString + oldLength,
+		newLength);
 
-			VkResult vkResult = vkQueueWaitIdle(
-				vkWindow->graphicsQueue);
+	memmove(baseString, baseString + oldLength,
+		newLength * sizeof(uint32_t));
+	text->base.length = newLength;
+	return true;
+}
 
-			if (vkResult != VK_SUCCESS)
-				return vkToMpgxResult(vkResult);
+bool appendTextString32(
+	Text text,
+	const uint32_t* string,
+	size_t length,
+	size_t index)
+{
+	assert(text);
+	assert(string);
+	assert(length > 0);
+	assert(index <= text->base.length);
 
-			mpgxResult = setVkImageData(
-				vkWindow->device,
-				vkWindow->allocator,
-				vkWindow->transferQueue,
-				vkWindow->transferCommandBuffer,
-				vkWindow->transferFence,
-				image,
-				pixelBuffer,
-				vec3I(
-					(cmmt_int_t)pixelLength,
-					(cmmt_int_t)pixelLength,
-					1),
-				zeroVec3I,
-				0);
-#else
-			abort();
-#endif
-		}
-		else
-		{
-#if MPGX_SUPPORT_OPENGL
-			mpgxResult = setGlImageData(
-				image,
-				pixelBuffer,
-				vec3I(
-					(cmmt_int_t)pixelLength,
-					(cmmt_int_t)pixelLength,
-					1),
-				zeroVec3I,
-				0);
-#else
-			abort();
-#endif
-		}
+	assert((size_t)text->base.length +
+		(size_t)length <= UINT32_MAX);
 
-		if (mpgxResult != SUCCESS_MPGX_RESULT)
-			return mpgxResult;
+	size_t baseLength = text->base.length;
+
+	if (baseLength + length > text->base.capacity)
+	{
+		size_t capacity = baseLength + length;
+
+		uint32_t* newString = realloc(
+			text->base.string,
+			capacity * sizeof(uint32_t));
+
+		if (!newString)
+			return false;
+
+		text->base.string = newString;
+		text->base.capacity = capacity;
 	}
 
-	return SUCCESS_MPGX_RESULT;
-}
+	uint32_t* baseString = text->base.string;
 
-inline static bool hexToColor(
-	const uint32_t* string,
-	uint8_t* _value)
+	if (index < baseLength)
+	{
+		size_t offset = index + length;
+
+		for (int64_t i = (int64_t)baseLength - (int64_t)(index + 1); i >= 0; i--)
+			baseString[offset + i] = baseString[index + i];
+	}
+
+	memcpy(baseString + index, string,
+		length * sizeof(uint32_t));
+	text->base.length += length;
+
+	markTextChanged(
+		text,
+		index,
+		baseLength - index);
+	return true;
+}
+void removeTextChar(
+	Text text,
+	size_t index)
 {
-	// Note: skipping assertions for debug build speed.
+	assert(text);
+	assert(index < text->base.length);
 
-	uint8_t value = 0;
-	uint32_t charValue = string[0];
+	uint32_t* string = text->base.string;
+	size_t length = text->base.length;
 
-	if (charValue > '/' && charValue < ':')
-		value = (charValue - '/') << 4u;
-	else if (charValue > '`' && charValue < 'g')
-		value = (charValue - 'W') << 4u;
-	else
-		return false;
+	for (size_t i = index + 1; i < length; i++)
+		string[i - 1] = string[i];
 
-	charValue = string[1];
+	text->base.length--;
 
-	if (charValue > '/' && charValue < ':')
-		value |= charValue - '/';
-	else if (charValue > '`' && charValue < 'g')
-		value |= charValue - 'W';
-	else
-		return false;
+	markTextChanged(
+		text,
+		index,
+		length - index - 1);
+}
 
-	*_value = value;
-	return true;
+AlignmentType getTextAlignment(Text text)
+{
+	assert(text);
+	assert(textInitialized);
+	return text->base.alignment;
 }
-inline static bool fillVertices(
-	const uint32_t* string,
-	size_t length,
-	const Glyph* regularGlyphs,
-	const Glyph* boldGlyphs,
-	const Glyph* italicGlyphs,
-	const Glyph* boldItalicGlyphs,
-	size_t glyphCount,
-	float fontSize,
-	float newLineAdvance,
-	AlignmentType alignment,
-	SrgbColor color,
-	bool isBold,
-	bool isItalic,
-	bool useTags,
-	TextVertex* vertices,
-	uint32_t* vertexCount,
-	Vec2F* textSize)
+void setTextAlignment(
+	Text text,
+	AlignmentType alignment)
 {
-	assert(regularGlyphs);
-	assert(boldGlyphs);
-	assert(italicGlyphs);
-	assert(boldItalicGlyphs);
-	assert(glyphCount > 0);
-	assert(fontSize > 0);
+	assert(text);
+	assert(textInitialized);
 	assert(alignment < ALIGNMENT_TYPE_COUNT);
-	assert(vertices);
-	assert(vertexCount);
-	assert(textSize);
+	assert(!text->base.isConstant);
 
-	assert(length == 0 ||
-		(length > 0 && string));
+	if (text->base.alignment == alignment)
+		return;
 
-	SrgbColor useColor = color;
-	bool useBold = isBold, useItalic = isItalic;
-	float sizeX = 0.0f, sizeY = 0.0f;
-	float vertexOffsetX = 0.0f, vertexOffsetY = newLineAdvance * 0.5f;
-	uint32_t vertexIndex = 0, lastNewLineIndex = 0;
-	vertexOffsetY = -floorf(vertexOffsetY * fontSize) / fontSize;
+	text->base.alignment = alignment;
+	invalidateTextLayout(text);
+}
 
-	const Glyph* glyphs;
-	float atlasIndex;
+SrgbColor getTextColor(Text text)
+{
+	assert(text);
+	assert(textInitialized);
+	return text->base.color;
+}
+void setTextColor(
+	Text text,
+	SrgbColor color)
+{
+	assert(text);
+	assert(textInitialized);
+	assert(!text->base.isConstant);
 
-	if (isBold & isItalic)
-	{
-		glyphs = boldItalicGlyphs;
-		atlasIndex = 3.0f;
-	}
-	else if (isItalic)
-	{
-		glyphs = italicGlyphs;
-		atlasIndex = 2.0f;
-	}
-	else if (isBold)
-	{
-		glyphs = boldGlyphs;
-		atlasIndex = 1.0f;
-	}
-	else
+	SrgbColor oldColor = text->base.color;
+
+	if (oldColor.r == color.r && oldColor.g == color.g &&
+		oldColor.b == color.b && oldColor.a == color.a)
 	{
-		glyphs = regularGlyphs;
-		atlasIndex = 0.0f;
+		return;
 	}
 
-	float offset;
+	text->base.color = color;
+	text->base.runPrefix = 0;
+	text->base.isGlyphCacheValid = false;
+	invalidateTextLayout(text);
+}
 
-	for (size_t i = 0; i < length; i++)
-	{
-		uint32_t value = string[i];
+bool isTextBold(Text text)
+{
+	assert(text);
+	assert(textInitialized);
+	return text->base.isBold;
+}
+void setTextBold(
+	Text text,
+	bool isBold)
+{
+	assert(text);
+	assert(textInitialized);
+	assert(!text->base.isConstant);
 
-		if (value == '\n')
-		{
-			switch (alignment)
-			{
-			default:
-				abort();
-			case CENTER_ALIGNMENT_TYPE:
-				offset = vertexOffsetX * -0.5f;
-				offset = floorf(offset * fontSize) / fontSize;
-
-				for (uint32_t j = lastNewLineIndex; j < vertexIndex; j++)
-					vertices[j].position.x += offset;
-				break;
-			case LEFT_ALIGNMENT_TYPE:
-				break;
-			case RIGHT_ALIGNMENT_TYPE:
-				offset = -vertexOffsetX;
+	if (text->base.isBold == isBold)
+		return;
 
-				for (uint32_t j = lastNewLineIndex; j < vertexIndex; j++)
-					vertices[j].position.x += offset;
-				break;
-			case BOTTOM_ALIGNMENT_TYPE:
-				offset = vertexOffsetX * -0.5f;
-				offset = floorf(offset * fontSize) / fontSize;
+	text->base.isBold = isBold;
+	text->base.runPrefix = 0;
+	text->base.isGlyphCacheValid = false;
+	invalidateTextLayout(text);
+}
 
-				for (uint32_t j = lastNewLineIndex; j < vertexIndex; j++)
-					vertices[j].position.x += offset;
-				break;
-			case TOP_ALIGNMENT_TYPE:
-				offset = vertexOffsetX * -0.5f;
-				offset = floorf(offset * fontSize) / fontSize;
+bool isTextItalic(Text text)
+{
+	assert(text);
+	assert(textInitialized);
+	return text->base.isItalic;
+}
+void setTextItalic(
+	Text text,
+	bool isItalic)
+{
+	assert(text);
+	assert(textInitialized);
+	assert(!text->base.isConstant);
 
-				for (uint32_t j = lastNewLineIndex; j < vertexIndex; j++)
-					vertices[j].position.x += offset;
-				break;
-			case LEFT_BOTTOM_ALIGNMENT_TYPE:
-			case LEFT_TOP_ALIGNMENT_TYPE:
-				break;
-			case RIGHT_BOTTOM_ALIGNMENT_TYPE:
-				offset = -vertexOffsetX;
+	if (text->base.isItalic == isItalic)
+		return;
 
-				for (uint32_t j = lastNewLineIndex; j < vertexIndex; j++)
-					vertices[j].position.x += offset;
-				break;
-			case RIGHT_TOP_ALIGNMENT_TYPE:
-				offset = -vertexOffsetX;
+	text->base.isItalic = isItalic;
+	text->base.runPrefix = 0;
+	text->base.isGlyphCacheValid = false;
+	invalidateTextLayout(text);
+}
 
-				for (uint32_t j = lastNewLineIndex; j < vertexIndex; j++)
-					vertices[j].position.x += offset;
-				break;
-			}
+bool isTextUseTags(Text text)
+{
+	assert(text);
+	assert(textInitialized);
+	return text->base.useTags;
+}
+void setTextUseTags(
+	Text text,
+	bool useTags)
+{
+	assert(text);
+	assert(textInitialized);
+	assert(!text->base.isConstant);
 
-			lastNewLineIndex = vertexIndex;
+	if (text->base.useTags == useTags)
+		return;
 
-			if (sizeX < vertexOffsetX)
-				sizeX = vertexOffsetX;
+	text->base.useTags = useTags;
+	text->base.runPrefix = 0;
+	text->base.isGlyphCacheValid = false;
+	invalidateTextLayout(text);
+}
 
-			vertexOffsetY -= newLineAdvance;
-			vertexOffsetX = 0.0f;
-			continue;
-		}
-		else if (value == '\t')
-		{
-			value = ' ';
+uint32_t getTextMask(Text text)
+{
+	assert(text);
+	assert(textInitialized);
+	return text->base.mask;
+}
+void setTextMask(
+	Text text,
+	uint32_t mask)
+{
+	assert(text);
+	assert(textInitialized);
+	assert(!text->base.isConstant);
 
-			const Glyph* glyph = bsearch(
-				&value,
-				glyphs,
-				glyphCount,
-				sizeof(Glyph),
-				compareGlyph);
+	if (text->base.mask == mask)
+		return;
 
-			if (!glyph)
-				return false;
+	text->base.mask = mask;
+	text->base.runPrefix = 0;
+	text->base.isGlyphCacheValid = false;
+	invalidateTextLayout(text);
+}
 
-			vertexOffsetX += glyph->advance * 4;
-			continue;
-		}
-		else if ((value == '<') & useTags)
-		{
-			if (i + 2 < length && string[i + 2] == '>')
-			{
-				uint32_t tag = string[i + 1];
+uint32_t getTextFontSize(Text text)
+{
+	assert(text);
+	assert(text->base.fontAtlas->isGenerated);
+	assert(textInitialized);
+	return text->base.fontAtlas->fontSize;
+}
+void setTextFontSize(
+	Text text,
+	uint32_t fontSize)
+{
+	assert(text);
+	assert(text->base.fontAtlas->isGenerated);
+	assert(textInitialized);
+	text->base.fontAtlas->fontSize = fontSize;
+	text->base.isGlyphCacheValid = false;
+	invalidateTextLayout(text);
+}
 
-				if (tag == 'b')
-				{
-					if (useItalic)
-					{
-						glyphs = boldItalicGlyphs;
-						atlasIndex = 3.0f;
-					}
-					else
-					{
-						glyphs = boldGlyphs;
-						atlasIndex = 1.0f;
-					}
+TextWrapType getTextWrap(Text text)
+{
+	assert(text);
+	assert(textInitialized);
+	return text->base.wrap;
+}
+void setTextWrap(
+	Text text,
+	TextWrapType wrap)
+{
+	assert(text);
+	assert(wrap < TEXT_WRAP_TYPE_COUNT);
+	assert(textInitialized);
+	assert(!text->base.isConstant);
 
-					useBold = true;
-					i += 2;
-					continue;
-				}
-				else if (tag == 'i')
-				{
-					if (useBold)
-					{
-						glyphs = boldItalicGlyphs;
-						atlasIndex = 3.0f;
-					}
-					else
-					{
-						glyphs = italicGlyphs;
-						atlasIndex = 2.0f;
-					}
+	if (text->base.wrap == wrap)
+		return;
 
-					useItalic = true;
-					i += 2;
-					continue;
-				}
-			}
-			else if (i + 3 < length && string[i + 1] == '/' && string[i + 3] == '>')
-			{
-				uint32_t tag = string[i + 2];
+	text->base.wrap = wrap;
+	invalidateTextLayout(text);
+}
 
-				if (tag == 'b')
-				{
-					if (useItalic)
-					{
-						glyphs = italicGlyphs;
-						atlasIndex = 2.0f;
-					}
-					else
-					{
-						glyphs = regularGlyphs;
-						atlasIndex = 0.0f;
-					}
+float getTextMaxWidth(Text text)
+{
+	assert(text);
+	assert(textInitialized);
+	return text->base.maxWidth;
+}
+void setTextMaxWidth(
+	Text text,
+	float maxWidth)
+{
+	assert(text);
+	assert(maxWidth >= 0.0f);
+	assert(textInitialized);
+	assert(!text->base.isConstant);
 
-					useBold = false;
-					i += 3;
-					continue;
-				}
-				else if (tag == 'i')
-				{
-					if (useBold)
-					{
-						glyphs = boldGlyphs;
-						atlasIndex = 1.0f;
-					}
-					else
-					{
-						glyphs = regularGlyphs;
-						atlasIndex = 0.0f;
-					}
+	if (text->base.maxWidth == maxWidth)
+		return;
 
-					useItalic = false;
-					i += 3;
-					continue;
-				}
-				else if (tag == '#')
-				{
-					useColor = color;
-					i += 3;
-					continue;
-				}
-			}
-			else if (i + 8 < length && string[i + 1] == '#' && string[i + 8] == '>')
-			{
-				SrgbColor newColor;
-
-				bool result = hexToColor(
-					string + i + 2,
-					&newColor.r);
-				result &= hexToColor(
-					string + i + 4,
-					&newColor.g);
-				result &= hexToColor(
-					string + i + 6,
-					&newColor.b);
-
-				if (result)
-				{
-					newColor.a = UINT8_MAX;
-					useColor = newColor;
-					i += 8;
-					continue;
-				}
-			}
-			else if (i + 10 < length && string[i + 1] == '#' && string[i + 10] == '>')
-			{
-				SrgbColor newColor;
-
-				bool result = hexToColor(
-					string + i + 2,
-					&newColor.r);
-				result &= hexToColor(
-					string + i + 4,
-					&newColor.g);
-				result &= hexToColor(
-					string + i + 6,
-					&newColor.b);
-				result &= hexToColor(
-					string + i + 8,
-					&newColor.a);
-
-				if (result)
-				{
-					useColor = newColor;
-					i += 10;
-					continue;
-				}
-			}
-		}
+	text->base.maxWidth = maxWidth;
 
-		const Glyph* glyph = bsearch(
-			&value,
-			glyphs,
-			glyphCount,
-			sizeof(Glyph),
-			compareGlyph);
+	// Glyph cache is kept, only lines are fitted again.
+	if (text->base.wrap != NONE_TEXT_WRAP_TYPE)
+		invalidateTextLayout(text);
+}
 
-		if (!glyph)
-		{
-			value = '\0';
+inline static bool updateTextCursorLayout(Text text)
+{
+	assert(text);
 
-			glyph = bsearch(
-				&value,
-				glyphs,
-				glyphCount,
-				sizeof(Glyph),
-				compareGlyph);
+	if (!isTextChanged(text))
+		return true;
 
-			if (!glyph)
-				return false;
-		}
+	FontAtlas fontAtlas = text->base.fontAtlas;
+	Handle handle = fontAtlas->pipeline->base.handle;
 
-		if (glyph->isVisible)
-		{
-			float positionX = vertexOffsetX + glyph->positionX;
-			float positionY = vertexOffsetY + glyph->positionY;
-			float positionZ = vertexOffsetX + glyph->positionZ;
-			float positionW = vertexOffsetY + glyph->positionW;
-			float texCoordsX = glyph->texCoordsX;
-			float texCoordsY = glyph->texCoordsY;
-			float texCoordsZ = glyph->texCoordsZ;
-			float texCoordsW = glyph->texCoordsW;
-
-			TextVertex vertex;
-			vertex.position.x = positionX;
-			vertex.position.y = positionY;
-			vertex.texCoords.x = texCoordsX;
-			vertex.texCoords.y = texCoordsW;
-			vertex.texCoords.z = atlasIndex;
-			vertex.color = useColor;
-			vertices[vertexIndex + 0] = vertex;
-
-			vertex.position.x = positionX;
-			vertex.position.y = positionW;
-			vertex.texCoords.x = texCoordsX;
-			vertex.texCoords.y = texCoordsY;
-			vertices[vertexIndex + 1] = vertex;
-
-			vertex.position.x = positionZ;
-			vertex.position.y = positionW;
-			vertex.texCoords.x = texCoordsZ;
-			vertex.texCoords.y = texCoordsY;
-			vertices[vertexIndex + 2] = vertex;
-
-			vertex.position.x = positionZ;
-			vertex.position.y = positionY;
-			vertex.texCoords.x = texCoordsZ;
-			vertex.texCoords.y = texCoordsW;
-			vertices[vertexIndex + 3] = vertex;
-
-			vertexIndex += 4;
-		}
+	// Generated or dynamic atlas can be not baked yet,
+	// so its glyph lookups are not cached before the bake.
+	MpgxResult mpgxResult = updateTextLayout(
+		text,
+		&handle->base.scratch,
+		!fontAtlas->isGenerated && !fontAtlas->isDynamic);
 
-		vertexOffsetX += glyph->advance;
+	if (mpgxResult != SUCCESS_MPGX_RESULT)
+	{
+		invalidateTextLayout(text);
+		return false;
 	}
 
-	if (sizeX < vertexOffsetX)
-		sizeX = vertexOffsetX;
-	sizeY = -vertexOffsetY;
-
+	return true;
+}
+inline static float getTextCursorOffsetY(
+	AlignmentType alignment,
+	float sizeY,
+	float newLineAdvance)
+{
 	switch (alignment)
 	{
 	default:
 		abort();
 	case CENTER_ALIGNMENT_TYPE:
-		offset = vertexOffsetX * -0.5f;
-		offset = floorf(offset * fontSize) / fontSize;
+	case LEFT_ALIGNMENT_TYPE:
+	case RIGHT_ALIGNMENT_TYPE:
+		return (sizeY - (newLineAdvance * 0.5f +
+			newLineAdvance * 0.25f)) * 0.5f;
+	case BOTTOM_ALIGNMENT_TYPE:
+	case LEFT_BOTTOM_ALIGNMENT_TYPE:
+	case RIGHT_BOTTOM_ALIGNMENT_TYPE:
+		return sizeY - newLineAdvance * 0.5f;
+	case TOP_ALIGNMENT_TYPE:
+	case LEFT_TOP_ALIGNMENT_TYPE:
+	case RIGHT_TOP_ALIGNMENT_TYPE:
+		return -newLineAdvance * 0.25f;
+	}
+}
+
+bool getTextCursorAdvance(
+	Text text,
+	size_t index,
+	Vec2F* _advance)
+{
+	assert(text);
+	assert(index <= text->base.length);
+	assert(_advance);
+	assert(textInitialized);
+
+	if (!updateTextCursorLayout(text))
+		return false;
 
-		for (uint32_t i = lastNewLineIndex; i < vertexIndex; i++)
-			vertices[i].position.x += offset;
+	FontAtlas fontAtlas = text->base.fontAtlas;
+	AlignmentType alignment = text->base.alignment;
+	float newLineAdvance = fontAtlas->newLineAdvance;
 
-		offset = sizeY * 0.5f;
-		offset = floorf(offset * fontSize) / fontSize;
+	size_t lineIndex = findTextLine(
+		text->base.lines,
+		text->base.lineCount,
+		index);
+	const TextLine* line = &text->base.lines[lineIndex];
 
-		for (uint32_t i = 0; i < vertexIndex; i++)
-			vertices[i].position.y += offset;
-		break;
-	case LEFT_ALIGNMENT_TYPE:
-		offset = sizeY * 0.5f;
-		offset = floorf(offset * fontSize) / fontSize;
+	float offsetX = getLineOffsetX(
+		alignment,
+		line->width,
+		(float)fontAtlas->fontSize);
+	float offsetY = getTextCursorOffsetY(
+		alignment,
+		(float)text->base.size.y,
+		newLineAdvance);
 
-		for (uint32_t i = 0; i < vertexIndex; i++)
-			vertices[i].position.y += offset;
-		break;
-	case RIGHT_ALIGNMENT_TYPE:
-		offset = -vertexOffsetX;
+	*_advance = vec2F(
+		(cmmt_float_t)(text->base.advances[index] + offsetX),
+		(cmmt_float_t)(offsetY - (float)lineIndex * newLineAdvance));
+	return true;
+}
+bool getTextCursorIndex(
+	Text text,
+	Vec2F advance,
+	size_t* _index)
+{
+	assert(text);
+	assert(_index);
+	assert(textInitialized);
 
-		for (uint32_t i = lastNewLineIndex; i < vertexIndex; i++)
-			vertices[i].position.x += offset;
+	if (!updateTextCursorLayout(text))
+		return false;
 
-		offset = sizeY * 0.5f;
-		offset = floorf(offset * fontSize) / fontSize;
+	FontAtlas fontAtlas = text->base.fontAtlas;
+	AlignmentType alignment = text->base.alignment;
+	float newLineAdvance = fontAtlas->newLineAdvance;
+	size_t lineCount = text->base.lineCount;
 
-		for (uint32_t i = 0; i < vertexIndex; i++)
-			vertices[i].position.y += offset;
-		break;
-	case BOTTOM_ALIGNMENT_TYPE:
-		offset = vertexOffsetX * -0.5f;
-		offset = floorf(offset * fontSize) / fontSize;
+	float offsetY = getTextCursorOffsetY(
+		alignment,
+		(float)text->base.size.y,
+		newLineAdvance);
+	float lineValue = (offsetY - (float)advance.y) /
+		newLineAdvance + 0.5f;
 
-		for (uint32_t i = lastNewLineIndex; i < vertexIndex; i++)
-			vertices[i].position.x += offset;
+	size_t lineIndex;
 
-		offset = sizeY;
+	if (!(lineValue > 0.0f))
+		lineIndex = 0;
+	else if (lineValue >= (float)lineCount)
+		lineIndex = lineCount - 1;
+	else
+		lineIndex = (size_t)lineValue;
 
-		for (uint32_t i = 0; i < vertexIndex; i++)
-			vertices[i].position.y += offset;
-		break;
-	case TOP_ALIGNMENT_TYPE:
-		offset = vertexOffsetX * -0.5f;
-		offset = floorf(offset * fontSize) / fontSize;
+	const TextLine* line = &text->base.lines[lineIndex];
+	const float* advances = text->base.advances + line->offset;
 
-		for (uint32_t i = lastNewLineIndex; i < vertexIndex; i++)
-			vertices[i].position.x += offset;
-		break;
-	case LEFT_BOTTOM_ALIGNMENT_TYPE:
-		offset = sizeY;
+	// Wrapped line end is the next line start.
+	size_t advanceCount = line->isWrapped ?
+		line->length : line->length + 1;
 
-		for (uint32_t i = 0; i < vertexIndex; i++)
-			vertices[i].position.y += offset;
-		break;
-	case LEFT_TOP_ALIGNMENT_TYPE:
-		break;
-	case RIGHT_BOTTOM_ALIGNMENT_TYPE:
-		offset = -vertexOffsetX;
+	float positionX = (float)advance.x - getLineOffsetX(
+		alignment,
+		line->width,
+		(float)fontAtlas->fontSize);
 
-		for (uint32_t i = lastNewLineIndex; i < vertexIndex; i++)
-			vertices[i].position.x += offset;
+	size_t left = 0, right = advanceCount;
 
-		offset = sizeY;
+	while (left < right)
+	{
+		size_t middle = left + (right - left) / 2;
 
-		for (uint32_t i = 0; i < vertexIndex; i++)
-			vertices[i].position.y += offset;
-		break;
-	case RIGHT_TOP_ALIGNMENT_TYPE:
-		offset = -vertexOffsetX;
+		if (advances[middle] < positionX)
+			left = middle + 1;
+		else
+			right = middle;
+	}
 
-		for (uint32_t i = lastNewLineIndex; i < vertexIndex; i++)
-			vertices[i].position.x += offset;
-		break;
+	if (left == advanceCount)
+	{
+		left = advanceCount - 1;
+	}
+	else if (left > 0 && positionX - advances[left - 1] <=
+		advances[left] - positionX)
+	{
+		left--;
 	}
 
-	*vertexCount = vertexIndex;
-	*textSize = vec2F(sizeX, sizeY + newLineAdvance * 0.25f);
+	*_index = line->offset + left;
 	return true;
 }
-inline static uint32_t* createIndices(uint32_t indexCount)
-{
-	assert(indexCount > 0);
 
-	uint32_t* indices = malloc(
-		indexCount * sizeof(uint32_t));
+/*
+ * Bakes new text glyphs to the font atlas.
+ * Atlas is shared, so it is not thread safe.
+ */
+inline static MpgxResult bakeTextGlyphs(Text text)
+{
+	assert(text);
 
-	if (!indices)
-		return NULL;
+	FontAtlas fontAtlas = text->base.fontAtlas;
 
-	for (uint32_t i = 0, j = 0; i < indexCount; i += 6, j += 4)
+	// Text can be already laid out by the cursor
+	// functions, but without the new glyphs baked.
+	// Valid glyph cache means that only the wrap
+	// width is changed, so the atlas is not baked.
+	if (fontAtlas->isGenerated && !text->base.isGlyphCacheValid)
 	{
-		indices[i + 0] = (uint32_t)j + 0;
-		indices[i + 1] = (uint32_t)j + 1;
-		indices[i + 2] = (uint32_t)j + 2;
-		indices[i + 3] = (uint32_t)j + 0;
-		indices[i + 4] = (uint32_t)j + 2;
-		indices[i + 5] = (uint32_t)j + 3;
-	}
+		MpgxResult mpgxResult = updateTextRuns(text);
 
-	return indices;
-}
+		if (mpgxResult != SUCCESS_MPGX_RESULT)
+			return mpgxResult;
 
-inline static void internalDestroyText(Text text)
-{
-	if (!text)
-		return;
+		mpgxResult = bakeFontAtlas(
+			fontAtlas,
+			text->base.string,
+			text->base.runs,
+			text->base.runCount);
 
-	GraphicsAPI api = getGraphicsAPI();
+		if (mpgxResult != SUCCESS_MPGX_RESULT)
+			return mpgxResult;
 
-	if (api == VULKAN_GRAPHICS_API)
-	{
-#if MPGX_SUPPORT_VULKAN
-		destroyBuffer(text->vk.vertexBuffer);
-#else
-		abort();
-#endif
+		invalidateTextLayout(text);
 	}
-	else if (api == OPENGL_GRAPHICS_API)
+	else if (fontAtlas->isDynamic &&
+		(!text->base.isGlyphCacheValid || text->base.isEvicted))
 	{
-#if MPGX_SUPPORT_OPENGL
-		GraphicsMesh mesh = text->gl.mesh;
+		MpgxResult mpgxResult = updateTextRuns(text);
 
-		if (mesh)
-		{
-			Buffer vertexBuffer = getGraphicsMeshVertexBuffer(mesh);
-			destroyGraphicsMesh(mesh);
-			destroyBuffer(vertexBuffer);
-		}
-#else
-		abort();
-#endif
-	}
-	else
-	{
-		abort();
-	}
+		if (mpgxResult != SUCCESS_MPGX_RESULT)
+			return mpgxResult;
 
-	FontAtlas fontAtlas = text->base.fontAtlas;
+		bool isChanged;
 
-	if (fontAtlas && fontAtlas->isGenerated)
-		destroyFontAtlas(fontAtlas);
+		mpgxResult = addFontAtlasGlyphs(
+			fontAtlas,
+			text,
+			&isChanged);
 
-	free(text->base.string);
-	free(text);
+		if (mpgxResult != SUCCESS_MPGX_RESULT)
+			return mpgxResult;
+
+		if (isChanged)
+			invalidateTextLayout(text);
+
+		text->base.isEvicted = false;
+	}
+
+	return SUCCESS_MPGX_RESULT;
 }
-inline static MpgxResult internalCreateText(
-	FontAtlas fontAtlas,
-	uint32_t* string,
-	size_t length,
-	size_t capacity,
-	AlignmentType alignment,
-	SrgbColor color,
-	bool isBold,
-	bool isItalic,
-	bool useTags,
-	bool isConstant,
-	Text* text)
+/*
+ * Uploads laid out text vertices to the arena.
+ * Text is laid out here if it is still changed.
+ */
+inline static MpgxResult uploadBakedText(
+	Text text,
+	Handle handle)
 {
-	assert(fontAtlas);
-	assert(capacity > 0);
-	assert(alignment < ALIGNMENT_TYPE_COUNT);
 	assert(text);
-	assert(textInitialized);
-
-	assert(length == 0 ||
-		(length > 0 && string));
-
-	Text textInstance = calloc(
-		1, sizeof(Text_T));
+	assert(handle);
 
-	if (!textInstance)
-		return OUT_OF_HOST_MEMORY_MPGX_RESULT;
+	// Failed text is not drawn, its arena vertices
+	// can be partly written or not written at all.
+	MpgxResult mpgxResult = updateTextLayout(
+		text,
+		&handle->base.scratch,
+		true);
 
-	textInstance->base.fontAtlas = fontAtlas;
-	textInstance->base.string = string;
-	textInstance->base.capacity = capacity;
-	textInstance->base.length = length;
-	textInstance->base.color = color;
-	textInstance->base.alignment = alignment;
-	textInstance->base.isBold = isBold;
-	textInstance->base.isItalic = isItalic;
-	textInstance->base.useTags = useTags;
-	textInstance->base.isConstant = isConstant;
+	if (mpgxResult != SUCCESS_MPGX_RESULT)
+	{
+		invalidateTextLayout(text);
+		text->base.indexCount = 0;
+		return mpgxResult;
+	}
 
-	GraphicsPipeline pipeline = fontAtlas->pipeline;
-	Handle handle = pipeline->base.handle;
-	assert(!handle->base.isEnumerating);
-	TextVertex* vertexBuffer = handle->base.vertexBuffer;
-	size_t vertexCapacity = handle->base.vertexCapacity;
+	FontAtlas fontAtlas = text->base.fontAtlas;
 
-	if (vertexCapacity < length * 4)
+	// Packed positions are not clamped, text which
+	// does not fit the 16 bit range is not baked.
+	if (handle->base.vertexSize == sizeof(PackedTextVertex))
 	{
-		capacity = length * 4;
-		TextVertex* newVertexBuffer;
+		Vec2F size = text->base.size;
+		float positionScale = (float)fontAtlas->fontSize *
+			PACKED_TEXT_POSITION_STEPS;
 
-		if (vertexBuffer)
-		{
-			newVertexBuffer = realloc(
-				vertexBuffer,
-				capacity * sizeof(TextVertex));
-		}
-		else
+		if (size.x * positionScale > (float)INT16_MAX ||
+			size.y * positionScale > (float)INT16_MAX)
 		{
-			newVertexBuffer = malloc(
-				capacity * sizeof(TextVertex));
-		}
+			Logger logger = fontAtlas->logger;
 
-		if (!newVertexBuffer)
-		{
-			internalDestroyText(textInstance);
-			return OUT_OF_HOST_MEMORY_MPGX_RESULT;
-		}
+			if (logger)
+			{
+				logMessage(logger, ERROR_LOG_LEVEL,
+					"Text is too big for the packed vertices. "
+					"(width: %g, height: %g, fontSize: %u)",
+					(double)size.x, (double)size.y,
+					(unsigned int)fontAtlas->fontSize);
+			}
 
-		handle->base.vertexBuffer = vertexBuffer = newVertexBuffer;
-		handle->base.vertexCapacity = capacity;
+			invalidateTextLayout(text);
+			text->base.indexCount = 0;
+			return BAD_VALUE_MPGX_RESULT;
+		}
 	}
 
-	size_t glyphCapacity = fontAtlas->glyphCapacity;
-	const Glyph* glyphs = fontAtlas->glyphs;
-
-	uint32_t vertexCount;
+	Window window = fontAtlas->pipeline->base.window;
+	size_t vertexCount = text->base.vertexCount;
+	bool isMoved;
 
-	bool result = fillVertices(
-		string,
-		length,
-		glyphs,
-		glyphs + glyphCapacity,
-		glyphs + glyphCapacity * 2,
-		glyphs + glyphCapacity * 2,
-		fontAtlas->glyphCount,
-		(float)fontAtlas->fontSize,
-		fontAtlas->newLineAdvance,
-		alignment,
-		color,
-		isBold,
-		isItalic,
-		useTags,
-		vertexBuffer,
-		&vertexCount,
-		&textInstance->base.size);
+	mpgxResult = reserveTextArena(
+		text,
+		handle,
+		window,
+		vertexCount,
+		&isMoved);
 
-	if (!result)
+	if (mpgxResult != SUCCESS_MPGX_RESULT)
 	{
-		internalDestroyText(textInstance);
-		return BAD_VALUE_MPGX_RESULT;
+		invalidateTextLayout(text);
+		text->base.indexCount = 0;
+		return mpgxResult;
 	}
 
-	Window window = pipeline->base.window;
-	Buffer vertexBufferInstance;
+	size_t uploadOffset, uploadCount;
 
-	if (vertexCount > 0)
+	if (isMoved)
 	{
-		MpgxResult mpgxResult = createBuffer(window,
-			VERTEX_BUFFER_TYPE,
-			isConstant ? GPU_ONLY_BUFFER_USAGE : CPU_TO_GPU_BUFFER_USAGE,
-			vertexBuffer,
-			vertexCount * sizeof(TextVertex),
-			&vertexBufferInstance);
-
-		if (mpgxResult != SUCCESS_MPGX_RESULT)
-		{
-			internalDestroyText(textInstance);
-			return mpgxResult;
-		}
+		uploadOffset = 0;
+		uploadCount = vertexCount;
 	}
 	else
 	{
-		vertexBufferInstance = NULL;
+		uploadOffset = text->base.uploadOffset;
+		uploadCount = text->base.uploadCount;
 	}
 
-	GraphicsAPI api = getGraphicsAPI();
-	Buffer indexBuffer = handle->base.indexBuffer;
-	Text* texts = handle->base.texts;
-	size_t textCount = handle->base.textCount;
-	uint32_t indexCount = (vertexCount / 4) * 6;
-	size_t indexSize = indexCount * sizeof(uint32_t);
-
-	if (!indexBuffer || indexBuffer->base.size < indexSize)
+	if (uploadCount > 0)
 	{
-		uint32_t* indices = createIndices(indexCount);
+		mpgxResult = uploadTextVertices(
+			text,
+			handle,
+			window,
+			uploadOffset,
+			uploadCount);
 
-		if (!indices)
+		if (mpgxResult != SUCCESS_MPGX_RESULT)
 		{
-			destroyBuffer(vertexBufferInstance);
-			internalDestroyText(textInstance);
-			return OUT_OF_HOST_MEMORY_MPGX_RESULT;
+			invalidateTextLayout(text);
+			text->base.indexCount = 0;
+			return mpgxResult;
 		}
+	}
 
-		Buffer newIndexBuffer;
+	text->base.uploadCount = 0;
+	text->base.indexCount = (uint32_t)(vertexCount / 4) * 6;
+	return SUCCESS_MPGX_RESULT;
+}
+MpgxResult bakeText(Text text)
+{
+	assert(text);
+	assert(!text->base.isConstant);
+	assert(textInitialized);
 
-		MpgxResult mpgxResult = createBuffer(window,
-			INDEX_BUFFER_TYPE,
-			GPU_ONLY_BUFFER_USAGE,
-			indices,
-			indexSize,
-			&newIndexBuffer);
+	if (!isTextChanged(text) && text->base.uploadCount == 0)
+		return SUCCESS_MPGX_RESULT;
 
-		free(indices);
+	MpgxResult mpgxResult = bakeTextGlyphs(text);
 
-		if (mpgxResult != SUCCESS_MPGX_RESULT)
-		{
-			destroyBuffer(vertexBufferInstance);
-			internalDestroyText(textInstance);
-			return mpgxResult;
-		}
+	if (mpgxResult != SUCCESS_MPGX_RESULT)
+		return mpgxResult;
 
-		if (api == OPENGL_GRAPHICS_API)
-		{
-#if MPGX_SUPPORT_OPENGL
-			for (size_t i = 0; i < textCount; i++)
-			{
-				GraphicsMesh textMesh = texts[i]->gl.mesh;
-				textMesh->gl.indexBuffer = newIndexBuffer;
-			}
-#else
-			abort();
-#endif
-		}
+	Handle handle = text->base.fontAtlas->pipeline->base.handle;
+	assert(!handle->base.isEnumerating);
+
+	return uploadBakedText(
+		text,
+		handle);
+}
+
+inline static void destroyTextScratches(
+	TextScratch* scratch,
+	TextScratch* threadScratches,
+	size_t threadScratchCount)
+{
+	assert(scratch);
 
-		handle->base.indexBuffer = newIndexBuffer;
-		destroyBuffer(indexBuffer);
+	assert(threadScratchCount == 0 ||
+		(threadScratchCount > 0 && threadScratches));
+
+	for (size_t i = 0; i < threadScratchCount; i++)
+	{
+		free(threadScratches[i].lineBuffer);
+		free(threadScratches[i].vertexBuffer);
 	}
 
-	if (api == VULKAN_GRAPHICS_API)
+	free(threadScratches);
+	free(scratch->lineBuffer);
+	free(scratch->vertexBuffer);
+}
+
+typedef struct BakeData
+{
+	Text* texts;
+	size_t textCount;
+	TextScratch* scratches;
+	size_t threadCount;
+	atomic_int64 threadIndex;
+} BakeData;
+static void onTextsLayout(void* argument)
+{
+	assert(argument);
+	BakeData* data = (BakeData*)argument;
+	Text* texts = data->texts;
+	size_t textCount = data->textCount;
+	size_t threadCount = data->threadCount;
+
+	size_t threadIndex = (size_t)atomicFetchAdd64(
+		&data->threadIndex, 1);
+	TextScratch* scratch = &data->scratches[threadIndex];
+
+	// Failed layout is left changed,
+	// it is repeated by the upload.
+	for (size_t i = threadIndex; i < textCount; i += threadCount)
 	{
-#if MPGX_SUPPORT_VULKAN
-		textInstance->vk.vertexBuffer = vertexBufferInstance;
-		textInstance->vk.indexCount = indexCount;
-#else
-		abort();
-#endif
+		Text text = texts[i];
+
+		if (text->base.bakeIndex != i)
+			continue;
+
+		MpgxResult mpgxResult = updateTextLayout(
+			text,
+			scratch,
+			true);
+
+		if (mpgxResult != SUCCESS_MPGX_RESULT)
+			invalidateTextLayout(text);
 	}
-	else if (api == OPENGL_GRAPHICS_API)
+}
+MpgxResult bakeTexts(
+	GraphicsPipeline textPipeline,
+	Text* texts,
+	size_t textCount,
+	ThreadPool threadPool)
+{
+	assert(textPipeline);
+	assert(textCount == 0 ||
+		(textCount > 0 && texts));
+	assert(strcmp(textPipeline->base.name,
+		TEXT_PIPELINE_NAME) == 0);
+	assert(textInitialized);
+
+	Handle handle = textPipeline->base.handle;
+	assert(!handle->base.isEnumerating);
+
+	// Repeated text is baked only at its first index,
+	// otherwise several threads would lay out the same.
+	for (size_t i = 0; i < textCount; i++)
 	{
-#if MPGX_SUPPORT_OPENGL
-		GraphicsMesh mesh;
+		Text text = texts[i];
+		assert(text);
+		assert(!text->base.isConstant);
+		assert(text->base.fontAtlas->pipeline == textPipeline);
 
-		MpgxResult mpgxResult = createGraphicsMesh(
-			window,
-			UINT32_INDEX_TYPE,
-			indexCount,
-			0,
-			vertexBufferInstance,
-			handle->base.indexBuffer,
-			&mesh);
+		size_t bakeIndex = text->base.bakeIndex;
+
+		if (bakeIndex < i && texts[bakeIndex] == text)
+			continue;
+
+		text->base.bakeIndex = i;
+
+		if (!isTextChanged(text))
+			continue;
+
+		MpgxResult mpgxResult = bakeTextGlyphs(text);
 
 		if (mpgxResult != SUCCESS_MPGX_RESULT)
-		{
-			destroyBuffer(vertexBufferInstance);
-			internalDestroyText(textInstance);
 			return mpgxResult;
+	}
+
+	if (threadPool && textCount >= getThreadPoolThreadCount(threadPool))
+	{
+		size_t threadCount = getThreadPoolThreadCount(threadPool);
+		TextScratch* threadScratches = handle->base.threadScratches;
+		size_t threadScratchCount = handle->base.threadScratchCount;
+
+		if (threadScratchCount < threadCount)
+		{
+			TextScratch* newThreadScratches = realloc(
+				threadScratches,
+				threadCount * sizeof(TextScratch));
+
+			if (!newThreadScratches)
+				return OUT_OF_HOST_MEMORY_MPGX_RESULT;
+
+			memset(newThreadScratches + threadScratchCount, 0,
+				(threadCount - threadScratchCount) * sizeof(TextScratch));
+
+			handle->base.threadScratches = threadScratches = newThreadScratches;
+			handle->base.threadScratchCount = threadCount;
 		}
 
-		textInstance->gl.mesh = mesh;
-#else
-		abort();
+#ifndef NDEBUG
+		handle->base.isEnumerating = true;
+#endif
+
+		BakeData data = {
+			texts,
+			textCount,
+			threadScratches,
+			threadCount,
+			0,
+		};
+		ThreadPoolTask task = {
+			onTextsLayout,
+			&data,
+		};
+		addThreadPoolTaskNumber(
+			threadPool,
+			task,
+			threadCount);
+		waitThreadPool(threadPool);
+
+#ifndef NDEBUG
+		handle->base.isEnumerating = false;
 #endif
-	}
-	else
-	{
-		abort();
 	}
 
-	if (textCount == handle->base.textCapacity)
+	for (size_t i = 0; i < textCount; i++)
 	{
-		capacity = handle->base.textCapacity * 2;
-
-		Text* newTexts = realloc(texts,
-			sizeof(Text) * capacity);
+		Text text = texts[i];
 
-		if (!newTexts)
+		if (text->base.bakeIndex != i ||
+			(!isTextChanged(text) && text->base.uploadCount == 0))
 		{
-			internalDestroyText(textInstance);
-			return OUT_OF_HOST_MEMORY_MPGX_RESULT;
+			continue;
 		}
 
-		handle->base.texts = newTexts;
-		handle->base.textCapacity = capacity;
-	}
+		MpgxResult mpgxResult = uploadBakedText(
+			text,
+			handle);
 
-	handle->base.texts[textCount] = textInstance;
-	handle->base.textCount = textCount + 1;
+		if (mpgxResult != SUCCESS_MPGX_RESULT)
+			return mpgxResult;
+	}
 
-	*text = textInstance;
 	return SUCCESS_MPGX_RESULT;
 }
-
-MpgxResult createAtlasText(
-	FontAtlas fontAtlas,
-	const uint32_t* string,
-	size_t length,
-	AlignmentType alignment,
-	SrgbColor color,
-	bool isBold,
-	bool isItalic,
-	bool useTags,
-	bool isConstant,
-	Text* text)
+/*
+ * Returns MVP matrix scaling packed text
+ * vertex positions back to the font units.
+ */
+inline static mat4 getPackedTextMVP(
+	const mat4* mvp,
+	uint32_t fontSize)
 {
-	assert(fontAtlas);
-	assert(alignment < ALIGNMENT_TYPE_COUNT);
-	assert(text);
-	assert(!fontAtlas->isGenerated);
-	assert(textInitialized);
-
-	assert(length == 0 ||
-		(length > 0 && string));
+	assert(mvp);
+	assert(fontSize > 0);
 
-	uint32_t* stringArray;
-	size_t capacity;
+	mat4 packedMVP = *mvp;
+	float* values = (float*)&packedMVP;
+	float scale = 1.0f / ((float)fontSize *
+		PACKED_TEXT_POSITION_STEPS);
 
-	if (length > 0)
-	{
-		stringArray = malloc(length * sizeof(uint32_t));
+	// Only X and Y columns are scaled, Z is always zero.
+	for (uint8_t i = 0; i < 8; i++)
+		values[i] *= scale;
+	return packedMVP;
+}
+#if MPGX_SUPPORT_OPENGL
+/*
+ * Sets text vertex attribute pointers
+ * of the bound OpenGL vertex buffer.
+ */
+inline static void setGlTextVertexAttributes(Handle handle)
+{
+	assert(handle);
 
-		if (!stringArray)
-			return OUT_OF_HOST_MEMORY_MPGX_RESULT;
+	glEnableVertexAttribArray(0);
+	glEnableVertexAttribArray(1);
+	glEnableVertexAttribArray(2);
 
-		memcpy(stringArray, string,
-			sizeof(uint32_t) * length);
-		capacity = length;
+	if (handle->gl.vertexSize == sizeof(PackedTextVertex))
+	{
+		glVertexAttribIPointer(
+			0,
+			2,
+			GL_SHORT,
+			sizeof(PackedTextVertex),
+			0);
+		glVertexAttribIPointer(
+			1,
+			2,
+			GL_UNSIGNED_SHORT,
+			sizeof(PackedTextVertex),
+			(const void*)(sizeof(int16_t) * 2));
+		glVertexAttribIPointer(
+			2,
+			4,
+			GL_UNSIGNED_BYTE,
+			sizeof(PackedTextVertex),
+			(const void*)(sizeof(int16_t) * 2 + sizeof(uint16_t) * 2));
 	}
 	else
 	{
-		stringArray = malloc(sizeof(uint32_t));
-
-		if (!stringArray)
-			return OUT_OF_HOST_MEMORY_MPGX_RESULT;
-
-		capacity = 1;
+		glVertexAttribPointer(
+			0,
+			2,
+			GL_FLOAT,
+			GL_FALSE,
+			sizeof(TextVertex),
+			0);
+		glVertexAttribPointer(
+			1,
+			3,
+			GL_FLOAT,
+			GL_FALSE,
+			sizeof(TextVertex),
+			(const void*)sizeof(Vec2F));
+		glVertexAttribIPointer(
+			2,
+			4,
+			GL_UNSIGNED_BYTE,
+			sizeof(TextVertex),
+			(const void*)(sizeof(Vec2F) + sizeof(Vec3F)));
 	}
 
-	return internalCreateText(
-		fontAtlas,
-		stringArray,
-		length,
-		capacity,
-		alignment,
-		color,
-		isBold,
-		isItalic,
-		useTags,
-		isConstant,
-		text);
+	assertOpenGL();
 }
-MpgxResult createAtlasText8(
+#endif
+/*
+ * Draws text quad range of the vertex buffer. Vertex
+ * buffer and font atlas are bound only on change.
+ */
+inline static size_t drawTextRange(
+	GraphicsPipeline pipeline,
 	FontAtlas fontAtlas,
-	const char* string,
-	size_t length,
-	AlignmentType alignment,
-	SrgbColor color,
-	bool isBold,
-	bool isItalic,
-	bool useTags,
-	bool isConstant,
-	Text* text)
+	Buffer vertexBuffer,
+	const mat4* mvp,
+	const vec4* color,
+	size_t vertexOffset,
+	size_t vertexCount)
 {
+	assert(pipeline);
 	assert(fontAtlas);
-	assert(alignment < ALIGNMENT_TYPE_COUNT);
-	assert(text);
-	assert(!fontAtlas->isGenerated);
-	assert(textInitialized);
+	assert(vertexBuffer);
+	assert(mvp);
+	assert(color);
+	assert(vertexOffset % 4 == 0);
+	assert(vertexCount % 4 == 0);
 
-	assert(length == 0 ||
-		(length > 0 && string));
+	Handle handle = pipeline->base.handle;
 
-	uint32_t* string32;
-	size_t length32;
-	size_t capacity;
+	// Text vertices are suballocated from the shared buffer
+	// in whole quads, so the shared quad indices can be used.
+	uint32_t firstIndex = (uint32_t)(vertexOffset / 4) * 6;
+	uint32_t indexCount = (uint32_t)(vertexCount / 4) * 6;
 
-	if (length > 0)
-	{
-		MpgxResult mpgxResult = allocateStringUTF32(
-			string,
-			length,
-			&string32,
-			&length32);
+	// Batch buffer is never packed, its
+	// vertices are already transformed.
+	bool isPacked = handle->base.vertexSize == sizeof(PackedTextVertex) &&
+		vertexBuffer == handle->base.arenaBuffer;
 
-		if (mpgxResult != SUCCESS_MPGX_RESULT)
-			return mpgxResult;
+	GraphicsAPI api = getGraphicsAPI();
 
-		capacity = length32;
-	}
-	else
+	if (api == VULKAN_GRAPHICS_API)
 	{
-		string32 = malloc(sizeof(uint32_t));
-
-		if (!string32)
-			return OUT_OF_HOST_MEMORY_MPGX_RESULT;
-
-		length32 = 0;
-		capacity = 1;
-	}
-
-	return internalCreateText(
-		fontAtlas,
-		string32,
-		length32,
-		capacity,
-		alignment,
-		color,
-		isBold,
-		isItalic,
-		useTags,
-		isConstant,
-		text);
-}
-
-MpgxResult createFontText(
-	GraphicsPipeline textPipeline,
-	Font* regularFonts,
-	Font* boldFonts,
-	Font* italicFonts,
-	Font* boldItalicFonts,
-	size_t fontCount,
-	uint32_t fontSize,
-	const uint32_t* string,
-	size_t length,
-	AlignmentType alignment,
-	SrgbColor color,
-	bool isBold,
-	bool isItalic,
-	bool useTags,
-	bool isConstant,
-	Logger logger,
-	Text* text)
-{
-	assert(textPipeline);
-	assert(regularFonts);
-	assert(boldFonts);
-	assert(italicFonts);
-	assert(boldItalicFonts);
-	assert(fontCount > 0);
-	assert(fontSize > 0);
-	assert(fontSize % 2 == 0);
-	assert(alignment < ALIGNMENT_TYPE_COUNT);
-	assert(text);
-	assert(textInitialized);
-
-	assert(length == 0 ||
-		(length > 0 && string));
+#if MPGX_SUPPORT_VULKAN
+		VkWindow vkWindow = getVkWindow(pipeline->vk.window);
+		VkCommandBuffer commandBuffer = vkWindow->currenCommandBuffer;
+		VkPipelineLayout pipelineLayout = pipeline->vk.layout;
 
-	const uint32_t chars[] = { '\0' };
+		if (handle->vk.boundBuffer != vertexBuffer)
+		{
+			const VkDeviceSize offset = 0;
+
+			vkCmdBindVertexBuffers(
+				commandBuffer,
+				0,
+				1,
+				&vertexBuffer->vk.handle,
+				&offset);
+			handle->vk.boundBuffer = vertexBuffer;
+		}
 
-	FontAtlas fontAtlas;
+		VertexPushConstants vpc;
+		vpc.mvp = isPacked ? getPackedTextMVP(
+			mvp, fontAtlas->fontSize) : *mvp;
 
-	MpgxResult mpgxResult = internalCreateFontAtlas(
-		textPipeline,
-		regularFonts,
-		boldFonts,
-		italicFonts,
-		boldItalicFonts,
-		fontCount,
-		fontSize,
-		length > 0 ? string : chars,
-		length > 0 ? length : 1,
-		logger,
-		&fontAtlas,
-		true,
-		isConstant);
+		FragmentPushConstants fpc;
+		fpc.color = *color;
 
-	if (mpgxResult != SUCCESS_MPGX_RESULT)
-		return mpgxResult;
+		vkCmdPushConstants(
+			commandBuffer,
+			pipelineLayout,
+			VK_SHADER_STAGE_VERTEX_BIT,
+			0,
+			sizeof(VertexPushConstants),
+			&vpc);
+		vkCmdPushConstants(
+			commandBuffer,
+			pipelineLayout,
+			VK_SHADER_STAGE_FRAGMENT_BIT,
+			sizeof(VertexPushConstants),
+			sizeof(FragmentPushConstants),
+			&fpc);
 
-	uint32_t* stringArray;
-	size_t capacity;
+		if (handle->vk.boundAtlas != fontAtlas)
+		{
+			vkCmdBindDescriptorSets(
+				commandBuffer,
+				VK_PIPELINE_BIND_POINT_GRAPHICS,
+				pipelineLayout,
+				0,
+				1,
+				&fontAtlas->descriptorSet,
+				0,
+				NULL);
+			handle->vk.boundAtlas = fontAtlas;
+		}
 
-	if (length > 0)
+		vkCmdDrawIndexed(
+			commandBuffer,
+			indexCount,
+			1,
+			firstIndex,
+			0,
+			0);
+		return indexCount;
+#else
+		abort();
+#endif
+	}
+	else if (api == OPENGL_GRAPHICS_API)
 	{
-		stringArray = malloc(length * sizeof(uint32_t));
+#if MPGX_SUPPORT_OPENGL
+		if (handle->gl.boundAtlas != fontAtlas)
+		{
+			glBindTexture(
+				GL_TEXTURE_2D,
+				fontAtlas->image->gl.handle);
+			handle->gl.boundAtlas = fontAtlas;
+		}
+		if (handle->gl.boundBuffer != vertexBuffer)
+		{
+			glBindBuffer(
+				GL_ARRAY_BUFFER,
+				vertexBuffer->gl.handle);
+			handle->gl.boundBuffer = vertexBuffer;
+		}
 
-		if (!stringArray)
-			return OUT_OF_HOST_MEMORY_MPGX_RESULT;
+		mat4 drawMVP = isPacked ? getPackedTextMVP(
+			mvp, fontAtlas->fontSize) : *mvp;
 
-		memcpy(stringArray, string,
-			sizeof(uint32_t) * length);
-		capacity = length;
+		glUniformMatrix4fv(
+			handle->gl.mvpLocation,
+			1,
+			GL_FALSE,
+			(const float*)&drawMVP);
+		glUniform4fv(
+			handle->gl.colorLocation,
+			1,
+			(const GLfloat*)color);
+		setGlTextVertexAttributes(handle);
+
+		glDrawElements(
+			pipeline->gl.drawMode,
+			(GLsizei)indexCount,
+			GL_UNSIGNED_INT,
+			(const void*)(firstIndex * sizeof(uint32_t)));
+		assertOpenGL();
+
+		return indexCount;
+#else
+		abort();
+#endif
 	}
 	else
 	{
-		stringArray = malloc(sizeof(uint32_t));
-
-		if (!stringArray)
-			return OUT_OF_HOST_MEMORY_MPGX_RESULT;
-
-		capacity = 1;
+		abort();
 	}
+}
+/*
+ * Returns true if the text should be drawn,
+ * marks text as used by the dynamic atlas frame.
+ */
+inline static bool isTextDrawable(Text text)
+{
+	assert(text);
+	FontAtlas fontAtlas = text->base.fontAtlas;
 
-	mpgxResult = internalCreateText(
-		fontAtlas,
-		stringArray,
-		length,
-		capacity,
-		alignment,
-		color,
-		isBold,
-		isItalic,
-		useTags,
-		isConstant,
-		text);
-
-	if (mpgxResult != SUCCESS_MPGX_RESULT)
+	// Evicted text is baked again on the atlas update,
+	// if it was drawn in the frame before the update.
+	if (fontAtlas->isDynamic)
 	{
-		destroyFontAtlas(fontAtlas);
-		return mpgxResult;
+		text->base.drawFrame = fontAtlas->frameIndex;
+
+		if (text->base.isEvicted)
+			return false;
 	}
 
-	return SUCCESS_MPGX_RESULT;
+	return text->base.indexCount > 0;
 }
-MpgxResult createFontText8(
-	GraphicsPipeline textPipeline,
-	Font* regularFonts,
-	Font* boldFonts,
-	Font* italicFonts,
-	Font* boldItalicFonts,
-	size_t fontCount,
-	uint32_t fontSize,
-	const char* string,
-	size_t length,
-	AlignmentType alignment,
-	SrgbColor color,
-	bool isBold,
-	bool isItalic,
-	bool useTags,
-	bool isConstant,
-	Logger logger,
-	Text* text)
+size_t drawText(Text text)
 {
-	assert(textPipeline);
-	assert(regularFonts);
-	assert(boldFonts);
-	assert(italicFonts);
-	assert(boldItalicFonts);
-	assert(fontCount > 0);
-	assert(fontSize > 0);
-	assert(fontSize % 2 == 0);
-	assert(alignment < ALIGNMENT_TYPE_COUNT);
 	assert(text);
 	assert(textInitialized);
 
-	assert(length == 0 ||
-		(length > 0 && string));
+	FontAtlas fontAtlas = text->base.fontAtlas;
+	GraphicsPipeline pipeline = fontAtlas->pipeline;
+	Handle handle = pipeline->base.handle;
 
-	uint32_t* string32;
-	size_t length32;
-	size_t capacity;
+	// Batched texts were submitted earlier,
+	// so they have to be drawn first.
+	size_t indexCount = flushTextBatch(pipeline);
 
-	if (length > 0)
-	{
-		MpgxResult mpgxResult = allocateStringUTF32(
-			string,
-			length,
-			&string32,
-			&length32);
+	if (!isTextDrawable(text))
+		return indexCount;
 
-		if (mpgxResult != SUCCESS_MPGX_RESULT)
-			return mpgxResult;
+	return indexCount + drawTextRange(
+		pipeline,
+		fontAtlas,
+		handle->base.arenaBuffer,
+		&handle->base.vpc.mvp,
+		&handle->base.fpc.color,
+		text->base.arenaOffset,
+		(size_t)(text->base.indexCount / 6) * 4);
+}
 
-		capacity = length32;
-	}
-	else
-	{
-		string32 = malloc(sizeof(uint32_t));
+/*
+ * Returns true if the MVP keeps text vertex depth and W
+ * constant, so text can be transformed on the CPU side.
+ */
+inline static bool isTextMvpBatchable(const mat4* mvp)
+{
+	assert(mvp);
+	const float* values = (const float*)mvp;
 
-		if (!string32)
-			return OUT_OF_HOST_MEMORY_MPGX_RESULT;
+	return values[2] == 0.0f && values[3] == 0.0f &&
+		values[6] == 0.0f && values[7] == 0.0f &&
+		values[15] == 1.0f;
+}
+/*
+ * Grows text batch buffer. Batch vertices are drawn with the
+ * shared quad indices, so capacity is limited by the arena.
+ */
+inline static MpgxResult resizeTextBatch(
+	Handle handle,
+	Window window,
+	size_t capacity)
+{
+	assert(handle);
+	assert(window);
+	assert(capacity % 4 == 0);
+	assert(capacity > handle->base.batchCapacity);
 
-		length32 = 0;
-		capacity = 1;
-	}
+	TextVertex* batchVertices = realloc(
+		handle->base.batchVertices,
+		capacity * sizeof(TextVertex));
 
-	const uint32_t chars[] = { '\0' };
+	if (!batchVertices)
+		return OUT_OF_HOST_MEMORY_MPGX_RESULT;
 
-	FontAtlas fontAtlas;
+	handle->base.batchVertices = batchVertices;
 
-	MpgxResult mpgxResult = internalCreateFontAtlas(
-		textPipeline,
-		regularFonts,
-		boldFonts,
-		italicFonts,
-		boldItalicFonts,
-		fontCount,
-		fontSize,
-		length > 0 ? string32 : chars,
-		length > 0 ? length : 1,
-		logger,
-		&fontAtlas,
-		true,
-		isConstant);
+	size_t batchCapacity = handle->base.batchCapacity;
 
-	if (mpgxResult != SUCCESS_MPGX_RESULT)
-		return mpgxResult;
+	// CPU copy always matches the buffer,
+	// unchanged vertices are not uploaded.
+	memset(batchVertices + batchCapacity, 0,
+		(capacity - batchCapacity) * sizeof(TextVertex));
 
-	mpgxResult = internalCreateText(
-		fontAtlas,
-		string32,
-		length,
-		capacity,
-		alignment,
-		color,
-		isBold,
-		isItalic,
-		useTags,
-		isConstant,
-		text);
+	Buffer batchBuffer;
+
+	MpgxResult mpgxResult = createBuffer(window,
+		VERTEX_BUFFER_TYPE,
+		CPU_TO_GPU_BUFFER_USAGE,
+		batchVertices,
+		capacity * sizeof(TextVertex),
+		&batchBuffer);
 
 	if (mpgxResult != SUCCESS_MPGX_RESULT)
-	{
-		destroyFontAtlas(fontAtlas);
 		return mpgxResult;
-	}
 
+	destroyBuffer(handle->base.batchBuffer);
+	handle->base.batchBuffer = batchBuffer;
+	handle->base.batchCapacity = capacity;
 	return SUCCESS_MPGX_RESULT;
 }
-
-void destroyText(Text text)
+/*
+ * Grows text batch buffer to the vertex count if it is not used
+ * in the frame yet. Texts which do not fit are drawn from the arena.
+ */
+inline static void growTextBatch(
+	Handle handle,
+	Window window,
+	size_t vertexCount)
 {
-	if (!text)
-		return;
+	assert(handle);
+	assert(window);
+	assert(handle->base.batchCount == 0);
 
-	assert(textInitialized);
+	size_t arenaCapacity = handle->base.arenaCapacity;
 
-	FontAtlas fontAtlas = text->base.fontAtlas;
-	Handle handle = fontAtlas->pipeline->base.handle;
-	assert(!handle->base.isEnumerating);
-	Text* texts = handle->base.texts;
-	size_t textCount = handle->base.textCount;
+	if (vertexCount > arenaCapacity)
+		vertexCount = arenaCapacity;
+	if (vertexCount <= handle->base.batchCapacity)
+		return;
 
-	for (int64_t i = (int64_t)textCount - 1; i >= 0; i--)
-	{
-		if (texts[i] != text)
-			continue;
+	size_t capacity = handle->base.batchCapacity > 0 ?
+		handle->base.batchCapacity * 2 : 4096;
 
-		for (size_t j = i + 1; j < textCount; j++)
-			texts[j - 1] = texts[j];
+	while (capacity < vertexCount)
+		capacity *= 2;
 
-		internalDestroyText(text);
-		handle->base.textCount--;
-		return;
-	}
+	if (capacity > arenaCapacity)
+		capacity = arenaCapacity;
 
-	abort();
+	resizeTextBatch(
+		handle,
+		window,
+		capacity);
 }
-
-FontAtlas getTextFontAtlas(Text text)
+/*
+ * Starts a new text batch frame, batch buffer
+ * is grown to the previous frame vertex count.
+ */
+inline static void beginTextBatchFrame(
+	Handle handle,
+	Window window,
+	double updateTime)
 {
-	assert(text);
-	assert(textInitialized);
-	return text->base.fontAtlas;
+	assert(handle);
+	assert(window);
+
+	// Batch has to be flushed in the frame it was started.
+	assert(handle->base.batch.type == NONE_TEXT_BATCH_TYPE);
+	handle->base.batch.type = NONE_TEXT_BATCH_TYPE;
+	handle->base.batchCount = 0;
+
+	growTextBatch(
+		handle,
+		window,
+		handle->base.batchDemand);
+
+	handle->base.batchTime = updateTime;
+	handle->base.batchDemand = 0;
+	handle->base.isBatchSynced = false;
 }
-Vec2F getTextSize(Text text)
+/*
+ * Returns true if the color can be baked into the sRGB vertex
+ * colors, so texts with different colors share one stream draw.
+ */
+inline static bool isTextColorBakeable(const vec4* color)
 {
-	assert(text);
-	assert(textInitialized);
-	return text->base.size;
+	assert(color);
+
+	return color->x >= 0.0f && color->x <= 1.0f &&
+		color->y >= 0.0f && color->y <= 1.0f &&
+		color->z >= 0.0f && color->z <= 1.0f &&
+		color->w >= 0.0f && color->w <= 1.0f;
 }
-bool isTextConstant(Text text)
+/*
+ * Returns vertex color multiplied by the linear color,
+ * the same way as it is multiplied in the text shader.
+ */
+inline static SrgbColor bakeTextVertexColor(
+	SrgbColor vertexColor,
+	const vec4* color)
 {
-	assert(text);
-	assert(textInitialized);
-	return text->base.isConstant;
+	assert(color);
+
+	LinearColor value = srgbToLinearColor(vertexColor);
+	value.r *= (cmmt_float_t)color->x;
+	value.g *= (cmmt_float_t)color->y;
+	value.b *= (cmmt_float_t)color->z;
+	value.a *= (cmmt_float_t)color->w;
+	return linearToSrgbColor(value);
 }
+/*
+ * Writes transformed text vertices to the batch CPU copy,
+ * text color is baked into the vertex colors if it is not white.
+ * Returns true if any of the batch vertices is changed.
+ */
+inline static bool writeTextBatchVertices(
+	const TextVertex* vertices,
+	size_t vertexCount,
+	const mat4* mvp,
+	const vec4* color,
+	TextVertex* batchVertices)
+{
+	assert(vertices);
+	assert(mvp);
+	assert(color);
+	assert(batchVertices);
+
+	const float* values = (const float*)mvp;
+	bool isColored = color->x != 1.0f || color->y != 1.0f ||
+		color->z != 1.0f || color->w != 1.0f;
+	SrgbColor sourceColor = zeroSrgbColor;
+	SrgbColor bakedColor = zeroSrgbColor;
+	bool isBaked = false;
+	bool isChanged = false;
+
+	for (size_t i = 0; i < vertexCount; i++)
+	{
+		TextVertex vertex = vertices[i];
+		Vec2F position = vertex.position;
 
-const uint32_t* getTextString(Text text)
+		vertex.position.x = values[0] * position.x +
+			values[4] * position.y + values[12];
+		vertex.position.y = values[1] * position.x +
+			values[5] * position.y + values[13];
+
+		if (isColored)
+		{
+			// Text vertices usually share the same color.
+			if (!isBaked || memcmp(&vertex.color,
+				&sourceColor, sizeof(SrgbColor)) != 0)
+			{
+				sourceColor = vertex.color;
+				bakedColor = bakeTextVertexColor(sourceColor, color);
+				isBaked = true;
+			}
+
+			vertex.color = bakedColor;
+		}
+
+		if (memcmp(&batchVertices[i], &vertex, sizeof(TextVertex)) != 0)
+		{
+			batchVertices[i] = vertex;
+			isChanged = true;
+		}
+	}
+
+	return isChanged;
+}
+/*
+ * Uploads changed stream batch vertices to the batch buffer.
+ */
+inline static MpgxResult uploadTextBatch(
+	Handle handle,
+	Window window)
 {
-	assert(text);
-	assert(textInitialized);
-	return text->base.string;
+	assert(handle);
+	assert(window);
+
+	const TextBatch* batch = &handle->base.batch;
+	const TextVertex* vertices = handle->base.batchVertices + batch->offset;
+	Buffer batchBuffer = handle->base.batchBuffer;
+	size_t size = batch->count * sizeof(TextVertex);
+	size_t offset = batch->offset * sizeof(TextVertex);
+	GraphicsAPI api = getGraphicsAPI();
+
+	if (api == VULKAN_GRAPHICS_API)
+	{
+#if MPGX_SUPPORT_VULKAN
+		VkWindow vkWindow = getVkWindow(window);
+
+		// Frame commands are not submitted yet,
+		// so it is enough to wait once per frame.
+		if (!handle->vk.isBatchSynced)
+		{
+			VkResult vkResult = vkQueueWaitIdle(
+				vkWindow->graphicsQueue);
+
+			if (vkResult != VK_SUCCESS)
+				return vkToMpgxResult(vkResult);
+
+			handle->vk.isBatchSynced = true;
+		}
+
+		return setVkBufferData(
+			vkWindow->allocator,
+			batchBuffer->vk.allocation,
+			vertices,
+			size,
+			offset);
+#else
+		abort();
+#endif
+	}
+	else if (api == OPENGL_GRAPHICS_API)
+	{
+#if MPGX_SUPPORT_OPENGL
+		return setGlBufferData(
+			batchBuffer->gl.glType,
+			batchBuffer->gl.handle,
+			vertices,
+			size,
+			offset);
+#else
+		abort();
+#endif
+	}
+	else
+	{
+		abort();
+	}
 }
-size_t getTextLength(Text text)
+/*
+ * Returns batch vertices for the streamed quads, pending batch
+ * is drawn first if it can not be continued. Quads of one stream
+ * are drawn in the submission order, so depth only splits the
+ * stream if the pipeline writes it, batch is drawn at its first depth.
+ */
+inline static TextVertex* appendTextStream(
+	GraphicsPipeline pipeline,
+	FontAtlas fontAtlas,
+	Vec4I scissor,
+	float depth,
+	size_t vertexCount,
+	size_t* indexCount)
 {
-	assert(text);
-	assert(textInitialized);
-	return text->base.length;
-}
+	assert(pipeline);
+	assert(fontAtlas);
+	assert(vertexCount % 4 == 0);
+	assert(indexCount);
 
-bool setTextString(
+	Handle handle = pipeline->base.handle;
+	TextBatch* batch = &handle->base.batch;
+	size_t batchCount = handle->base.batchCount;
+	assert(batchCount + vertexCount <= handle->base.batchCapacity);
+
+	if (batch->type == STREAM_TEXT_BATCH_TYPE &&
+		batch->fontAtlas == fontAtlas &&
+		memcmp(&batch->scissor, &scissor, sizeof(Vec4I)) == 0 &&
+		(!pipeline->base.state.writeDepth ||
+		((const float*)&batch->mvp)[14] == depth))
+	{
+		*indexCount = 0;
+	}
+	else
+	{
+		*indexCount = flushTextBatch(pipeline);
+
+		// Stream vertices are already transformed,
+		// only the depth is left in the batch MVP.
+		mat4 batchMVP;
+		memset(&batchMVP, 0, sizeof(mat4));
+		float* values = (float*)&batchMVP;
+		values[0] = values[5] = values[10] = values[15] = 1.0f;
+		values[14] = depth;
+
+		// Colors are baked into the stream vertices.
+		vec4 batchColor;
+		batchColor.x = batchColor.y = batchColor.z = batchColor.w = 1.0f;
+
+		batch->mvp = batchMVP;
+		batch->color = batchColor;
+		batch->scissor = scissor;
+		batch->fontAtlas = fontAtlas;
+		batch->offset = batchCount;
+		batch->count = 0;
+		batch->isChanged = false;
+		batch->type = STREAM_TEXT_BATCH_TYPE;
+	}
+
+	batch->count += vertexCount;
+	handle->base.batchCount = batchCount + vertexCount;
+	return handle->base.batchVertices + batchCount;
+}
+size_t drawBatchedText(
 	Text text,
-	const uint32_t* string,
-	size_t length)
+	const Mat4F* mvp,
+	LinearColor color,
+	Vec4I scissor)
 {
 	assert(text);
+	assert(mvp);
 	assert(textInitialized);
-	assert(!text->base.isConstant);
 
-	assert(length == 0 ||
-		(length > 0 && string));
+	FontAtlas fontAtlas = text->base.fontAtlas;
+	GraphicsPipeline pipeline = fontAtlas->pipeline;
+	Window window = pipeline->base.window;
+	Handle handle = pipeline->base.handle;
+	double updateTime = getWindowUpdateTime(window);
 
-	if (length > text->base.capacity)
-	{
-		uint32_t* newString = realloc(
-			text->base.string,
-			length * sizeof(uint32_t));
+	if (handle->base.batchTime != updateTime)
+		beginTextBatchFrame(handle, window, updateTime);
 
-		if (!newString)
-			return false;
+	if (!isTextDrawable(text))
+		return 0;
 
-		text->base.string = newString;
-		text->base.capacity = length;
-	}
+	// Following quads are likely drawn with the same atlas.
+	handle->base.quadAtlas = fontAtlas;
 
-	memcpy(text->base.string, string,
-		length * sizeof(uint32_t));
-	text->base.length = length;
-	return true;
-}
-bool setTextString8(
-	Text text,
-	const char* string,
-	size_t length)
-{
-	assert(text);
-	assert(textInitialized);
-	assert(!text->base.isConstant);
+	Vec4I stateScissor = pipeline->base.state.scissor;
 
-	assert(length == 0 ||
-		(length > 0 && string));
+	if (stateScissor.z + stateScissor.w != 0)
+		scissor = vec4I(0, 0, 0, 0);
 
-	if (length > text->base.capacity)
+	mat4 textMVP = cmmtToMat4(*mvp);
+	vec4 textColor = cmmtColorToVec4(color);
+	size_t arenaOffset = text->base.arenaOffset;
+	size_t vertexCount = (size_t)(text->base.indexCount / 6) * 4;
+	TextBatch* batch = &handle->base.batch;
+
+	if (handle->base.vertexSize == sizeof(TextVertex) &&
+		isTextMvpBatchable(&textMVP) &&
+		isTextColorBakeable(&textColor))
 	{
-		uint32_t* newString = realloc(
-			text->base.string,
-			length * sizeof(uint32_t));
+		handle->base.batchDemand += vertexCount;
 
-		if (!newString)
-			return false;
+		if (handle->base.batchCount == 0)
+			growTextBatch(handle, window, vertexCount);
 
-		text->base.string = newString;
-		text->base.capacity = length;
-	}
+		if (handle->base.batchCount + vertexCount <=
+			handle->base.batchCapacity)
+		{
+			size_t indexCount;
+
+			TextVertex* batchVertices = appendTextStream(
+				pipeline,
+				fontAtlas,
+				scissor,
+				((const float*)&textMVP)[14],
+				vertexCount,
+				&indexCount);
+			const TextVertex* vertices = (const TextVertex*)
+				handle->base.arenaVertices + arenaOffset;
+
+			if (writeTextBatchVertices(vertices, vertexCount,
+				&textMVP, &textColor, batchVertices))
+			{
+				batch->isChanged = true;
+			}
 
-	if (length > 0)
-	{
-		text->base.length = stringUTF8toUTF32(
-			string,
-			length,
-			text->base.string);
+			return indexCount;
+		}
 	}
-	else
+
+	if (batch->type == ARENA_TEXT_BATCH_TYPE &&
+		batch->fontAtlas == fontAtlas &&
+		memcmp(&batch->color, &textColor, sizeof(vec4)) == 0 &&
+		memcmp(&batch->scissor, &scissor, sizeof(Vec4I)) == 0 &&
+		batch->offset + batch->count == arenaOffset &&
+		memcmp(&batch->mvp, &textMVP, sizeof(mat4)) == 0)
 	{
-		text->base.length = 0;
+		batch->count += vertexCount;
+		return 0;
 	}
 
-	return true;
+	size_t indexCount = flushTextBatch(pipeline);
+
+	batch->mvp = textMVP;
+	batch->color = textColor;
+	batch->scissor = scissor;
+	batch->fontAtlas = fontAtlas;
+	batch->offset = arenaOffset;
+	batch->count = vertexCount;
+	batch->isChanged = false;
+	batch->type = ARENA_TEXT_BATCH_TYPE;
+	return indexCount;
 }
-
-bool appendTextString32(
-	Text text,
-	const uint32_t* string,
-	size_t length,
-	size_t index)
+size_t drawBatchedQuad(
+	GraphicsPipeline textPipeline,
+	const Mat4F* mvp,
+	LinearColor color,
+	Vec4I scissor)
 {
-	assert(text);
-	assert(string);
-	assert(length > 0);
-	assert(index <= text->base.length);
+	assert(textPipeline);
+	assert(mvp);
+	assert(strcmp(textPipeline->base.name,
+		TEXT_PIPELINE_NAME) == 0);
+	assert(textInitialized);
 
-	assert((size_t)text->base.length +
-		(size_t)length <= UINT32_MAX);
+	Window window = textPipeline->base.window;
+	Handle handle = textPipeline->base.handle;
+	double updateTime = getWindowUpdateTime(window);
 
-	size_t baseLength = text->base.length;
+	if (handle->base.batchTime != updateTime)
+		beginTextBatchFrame(handle, window, updateTime);
 
-	if (baseLength + length > text->base.capacity)
-	{
-		size_t capacity = baseLength + length;
+	Vec4I stateScissor = textPipeline->base.state.scissor;
 
-		uint32_t* newString = realloc(
-			text->base.string,
-			capacity * sizeof(uint32_t));
+	if (stateScissor.z + stateScissor.w != 0)
+		scissor = vec4I(0, 0, 0, 0);
 
-		if (!newString)
-			return false;
+	mat4 quadMVP = cmmtToMat4(*mvp);
+	vec4 quadColor = cmmtColorToVec4(color);
+	const TextBatch* batch = &handle->base.batch;
 
-		text->base.string = newString;
-		text->base.capacity = capacity;
+	// Every atlas has the white texel,
+	// so quad continues the pending stream.
+	FontAtlas fontAtlas = batch->type == STREAM_TEXT_BATCH_TYPE ?
+		batch->fontAtlas : handle->base.quadAtlas;
+
+	if (!fontAtlas || handle->base.vertexSize != sizeof(TextVertex) ||
+		!isTextMvpBatchable(&quadMVP) || !isTextColorBakeable(&quadColor))
+	{
+		return 0;
 	}
 
-	uint32_t* baseString = text->base.string;
+	handle->base.batchDemand += 4;
 
-	if (index < baseLength)
-	{
-		size_t offset = index + length;
+	if (handle->base.batchCount == 0)
+		growTextBatch(handle, window, 4);
 
-		for (int64_t i = (int64_t)baseLength - (int64_t)(index + 1); i >= 0; i--)
-			baseString[offset + i] = baseString[index + i];
-	}
+	// Batch buffer is grown to the demand in the next frame.
+	if (handle->base.batchCount + 4 > handle->base.batchCapacity)
+		return 0;
 
-	memcpy(baseString + index, string,
-		length * sizeof(uint32_t));
-	text->base.length += length;
-	return true;
-}
-void removeTextChar(
-	Text text,
-	size_t index)
-{
-	assert(text);
-	assert(index < text->base.length);
+	uint32_t pixelLength = (uint32_t)fontAtlas->image->base.size.x;
+	float texCoords = ((float)pixelLength - 0.5f) / (float)pixelLength;
 
-	uint32_t* string = text->base.string;
-	size_t length = text->base.length;
+	TextVertex vertex;
+	vertex.texCoords.x = texCoords;
+	vertex.texCoords.y = texCoords;
+	vertex.texCoords.z = 0.0f;
+	vertex.color = linearToSrgbColor(color);
 
-	for (size_t i = index + 1; i < length; i++)
-		string[i - 1] = string[i];
+	// Quad vertices have the same order as the glyph vertices.
+	TextVertex vertices[4];
+	vertex.position.x = -0.5f;
+	vertex.position.y = -0.5f;
+	vertices[0] = vertex;
+	vertex.position.y = 0.5f;
+	vertices[1] = vertex;
+	vertex.position.x = 0.5f;
+	vertices[2] = vertex;
+	vertex.position.y = -0.5f;
+	vertices[3] = vertex;
 
-	text->base.length--;
-}
+	size_t indexCount;
 
-AlignmentType getTextAlignment(Text text)
-{
-	assert(text);
-	assert(textInitialized);
-	return text->base.alignment;
-}
-void setTextAlignment(
-	Text text,
-	AlignmentType alignment)
-{
-	assert(text);
-	assert(textInitialized);
-	assert(alignment < ALIGNMENT_TYPE_COUNT);
-	assert(!text->base.isConstant);
-	text->base.alignment = alignment;
-}
+	TextVertex* batchVertices = appendTextStream(
+		textPipeline,
+		fontAtlas,
+		scissor,
+		((const float*)&quadMVP)[14],
+		4,
+		&indexCount);
 
-SrgbColor getTextColor(Text text)
-{
-	assert(text);
-	assert(textInitialized);
-	return text->base.color;
-}
-void setTextColor(
-	Text text,
-	SrgbColor color)
-{
-	assert(text);
-	assert(textInitialized);
-	assert(!text->base.isConstant);
-	text->base.color = color;
-}
+	if (writeTextBatchVertices(vertices, 4, &quadMVP,
+		&handle->base.batch.color, batchVertices))
+	{
+		handle->base.batch.isChanged = true;
+	}
 
-bool isTextBold(Text text)
-{
-	assert(text);
-	assert(textInitialized);
-	return text->base.isBold;
+	return indexCount;
 }
-void setTextBold(
-	Text text,
-	bool isBold)
+size_t flushTextBatch(GraphicsPipeline textPipeline)
 {
-	assert(text);
+	assert(textPipeline);
+	assert(strcmp(textPipeline->base.name,
+		TEXT_PIPELINE_NAME) == 0);
 	assert(textInitialized);
-	assert(!text->base.isConstant);
-	text->base.isBold = isBold;
-}
 
-bool isTextItalic(Text text)
-{
-	assert(text);
-	assert(textInitialized);
-	return text->base.isItalic;
-}
-void setTextItalic(
-	Text text,
-	bool isItalic)
-{
-	assert(text);
-	assert(textInitialized);
-	assert(!text->base.isConstant);
-	text->base.isItalic = isItalic;
-}
+	Handle handle = textPipeline->base.handle;
+	TextBatch* batch = &handle->base.batch;
+	TextBatchType type = batch->type;
 
-bool isTextUseTags(Text text)
-{
-	assert(text);
-	assert(textInitialized);
-	return text->base.useTags;
-}
-void setTextUseTags(
-	Text text,
-	bool useTags)
-{
-	assert(text);
-	assert(textInitialized);
-	assert(!text->base.isConstant);
-	text->base.useTags = useTags;
-}
+	if (type == NONE_TEXT_BATCH_TYPE)
+		return 0;
 
-uint32_t getTextFontSize(Text text)
-{
-	assert(text);
-	assert(text->base.fontAtlas->isGenerated);
-	assert(textInitialized);
-	return text->base.fontAtlas->fontSize;
-}
-void setTextFontSize(
-	Text text,
-	uint32_t fontSize)
-{
-	assert(text);
-	assert(text->base.fontAtlas->isGenerated);
-	assert(textInitialized);
-	text->base.fontAtlas->fontSize = fontSize;
+	batch->type = NONE_TEXT_BATCH_TYPE;
+
+	Window window = textPipeline->base.window;
+	Vec4I stateScissor = textPipeline->base.state.scissor;
+
+	if (stateScissor.z + stateScissor.w == 0)
+		setWindowScissor(window, batch->scissor);
+
+	Buffer vertexBuffer;
+
+	if (type == STREAM_TEXT_BATCH_TYPE)
+	{
+		if (batch->isChanged)
+		{
+			MpgxResult mpgxResult = uploadTextBatch(
+				handle,
+				window);
+
+			if (mpgxResult != SUCCESS_MPGX_RESULT)
+			{
+				Logger logger = batch->fontAtlas->logger;
+
+				if (logger)
+				{
+					logMessage(logger, ERROR_LOG_LEVEL,
+						"Failed to upload text batch. (error: %s)",
+						mpgxResultToString(mpgxResult));
+				}
+
+				// CPU copy no longer matches the buffer,
+				// NaN vertices are never equal to the new ones.
+				memset(handle->base.batchVertices + batch->offset,
+					0xFF, batch->count * sizeof(TextVertex));
+				return 0;
+			}
+		}
+
+		vertexBuffer = handle->base.batchBuffer;
+	}
+	else
+	{
+		vertexBuffer = handle->base.arenaBuffer;
+	}
+
+	return drawTextRange(
+		textPipeline,
+		batch->fontAtlas,
+		vertexBuffer,
+		&batch->mvp,
+		&batch->color,
+		batch->offset,
+		batch->count);
 }
 
-bool getTextCursorAdvance(
-	Text text,
-	size_t index,
-	Vec2F* _advance)
+MpgxResult updateFontAtlas(FontAtlas fontAtlas)
 {
-	assert(text);
-	assert(index <= text->base.length);
-	assert(_advance);
+	assert(fontAtlas);
+	assert(fontAtlas->isDynamic);
 	assert(textInitialized);
 
-	FontAtlas fontAtlas = text->base.fontAtlas;
-	size_t glyphCapacity = fontAtlas->glyphCapacity;
-	const Glyph* _glyphs = fontAtlas->glyphs;
-	const Glyph* regularGlyphs = _glyphs;
-	const Glyph* boldGlyphs = _glyphs + glyphCapacity;
-	const Glyph* italicGlyphs = _glyphs + glyphCapacity * 2;
-	const Glyph* boldItalicGlyphs = _glyphs + glyphCapacity * 3;
-	size_t glyphCount = fontAtlas->glyphCount;
-	float newLineAdvance = fontAtlas->newLineAdvance;
-	const uint32_t* string = text->base.string;
-	size_t length = text->base.length;
-	bool useBold = text->base.isBold;
-	bool useItalic = text->base.isItalic;
-	bool useTags = text->base.useTags;
+	uint64_t frameIndex = fontAtlas->frameIndex + 1;
+	fontAtlas->frameIndex = frameIndex;
 
-	const Glyph* glyphs = regularGlyphs;
-	Vec2F advance = zeroVec2F;
-	float lineSizeX = 0.0f;
+	Handle handle = fontAtlas->pipeline->base.handle;
+	assert(!handle->base.isEnumerating);
 
-	for (size_t i = 0; i < length; i++)
+	Text* texts = handle->base.texts;
+	size_t textCount = handle->base.textCount;
+
+	// Only evicted texts drawn in the previous frame are
+	// baked, others are baked when they are drawn again.
+	for (size_t i = 0; i < textCount; i++)
 	{
-		uint32_t value = string[i];
+		Text text = texts[i];
 
-		if (value == '\n')
+		if (text->base.fontAtlas != fontAtlas ||
+			!text->base.isEvicted ||
+			text->base.drawFrame + 1 < frameIndex)
 		{
-			if (i >= index)
-				break;
-
-			advance.y -= newLineAdvance;
-			advance.x = lineSizeX = 0.0f;
 			continue;
 		}
-		else if (value == '\t')
-		{
-			value = ' ';
 
-			const Glyph* glyph = bsearch(
-				&value,
-				glyphs,
-				glyphCount,
-				sizeof(Glyph),
-				compareGlyph);
+		MpgxResult mpgxResult = bakeText(text);
 
-			if (!glyph)
-				return false;
+		if (mpgxResult != SUCCESS_MPGX_RESULT)
+			return mpgxResult;
+	}
 
-			advance.x += glyph->advance;
-			continue;
-		}
-		else if ((value == '<') & useTags)
-		{
-			if (i + 2 < length && string[i + 2] == '>')
-			{
-				uint32_t tag = string[i + 1];
+	return SUCCESS_MPGX_RESULT;
+}
 
-				if (tag == 'b')
-				{
-					if (useItalic) glyphs = boldItalicGlyphs;
-					else glyphs = boldGlyphs;
-					useBold = true;
-					i += 2;
-					continue;
-				}
-				else if (tag == 'i')
-				{
-					if (useBold) glyphs = boldItalicGlyphs;
-					else glyphs = italicGlyphs;
-					useItalic = true;
-					i += 2;
-					continue;
-				}
-			}
-			else if (i + 3 < length && string[i + 1] == '/' && string[i + 3] == '>')
-			{
-				uint32_t tag = string[i + 2];
+inline static size_t writeColorTag(
+	SrgbColor color,
+	uint32_t* string)
+{
+	// Note: skipping assertions for debug build speed.
 
-				if (tag == 'b')
-				{
-					if (useItalic) glyphs = italicGlyphs;
-					else glyphs = regularGlyphs;
-					useBold = false;
-					i += 3;
-					continue;
-				}
-				else if (tag == 'i')
-				{
-					if (useBold) glyphs = boldGlyphs;
-					else glyphs = regularGlyphs;
-					useItalic = false;
-					i += 3;
-					continue;
-				}
-				else if (tag == '#')
-				{
-					i += 3;
-					continue;
-				}
-			}
-			else if (i + 8 < length && string[i + 1] == '#' && string[i + 8] == '>')
-			{
-				i += 8;
-				continue;
-			}
-			else if (i + 10 < length && string[i + 1] == '#' && string[i + 10] == '>')
-			{
-				i += 10;
-				continue;
-			}
-		}
+	static const char hexDigits[] = "0123456789abcdef";
+	const uint8_t* values = &color.r;
 
-		const Glyph* glyph = bsearch(
-			&value,
-			glyphs,
-			glyphCount,
-			sizeof(Glyph),
-			compareGlyph);
+	string[0] = '<';
+	string[1] = '#';
 
-		if (!glyph)
-		{
-			value = '\0';
+	for (uint8_t i = 0; i < 4; i++)
+	{
+		string[2 + i * 2] = (uint32_t)hexDigits[values[i] >> 4u];
+		string[3 + i * 2] = (uint32_t)hexDigits[values[i] & 15u];
+	}
 
-			glyph = bsearch(
-				&value,
-				glyphs,
-				glyphCount,
-				sizeof(Glyph),
-				compareGlyph);
+	string[10] = '>';
+	return 11;
+}
+/*
+ * Writes tags switching the base text style to the
+ * specified one. Returns written tag character count.
+ */
+inline static size_t writeTextStyleTags(
+	Text text,
+	TextStyle style,
+	uint32_t* string)
+{
+	assert(text);
+	assert(string);
 
-			if (!glyph)
-				return false;
-		}
+	size_t count = 0;
 
-		if (i < index)
-			advance.x += glyph->advance;
-		lineSizeX += glyph->advance;
+	if (style.isBold != text->base.isBold)
+	{
+		if (style.isBold)
+		{
+			string[count++] = '<';
+			string[count++] = 'b';
+			string[count++] = '>';
+		}
+		else
+		{
+			string[count++] = '<';
+			string[count++] = '/';
+			string[count++] = 'b';
+			string[count++] = '>';
+		}
+	}
+	if (style.isItalic != text->base.isItalic)
+	{
+		if (style.isItalic)
+		{
+			string[count++] = '<';
+			string[count++] = 'i';
+			string[count++] = '>';
+		}
+		else
+		{
+			string[count++] = '<';
+			string[count++] = '/';
+			string[count++] = 'i';
+			string[count++] = '>';
+		}
 	}
 
-	AlignmentType alignment = text->base.alignment;
-	Vec2F size = text->base.size;
+	SrgbColor color = text->base.color;
 
-	switch (alignment)
+	if (style.color.r != color.r || style.color.g != color.g ||
+		style.color.b != color.b || style.color.a != color.a)
 	{
-	default:
-		abort();
-	case CENTER_ALIGNMENT_TYPE:
-		advance.x -= lineSizeX * (cmmt_float_t)0.5;
-		advance.y += (size.y - (newLineAdvance * 0.5f +
-			newLineAdvance * 0.25f)) * (cmmt_float_t)0.5;
-		break;
-	case LEFT_ALIGNMENT_TYPE:
-		advance.y += (size.y - (newLineAdvance * 0.5f +
-			newLineAdvance * 0.25f)) * (cmmt_float_t)0.5;
-		break;
-	case RIGHT_ALIGNMENT_TYPE:
-		advance.x -= lineSizeX;
-		advance.y += (size.y - (newLineAdvance * 0.5f +
-			newLineAdvance * 0.25f)) * (cmmt_float_t)0.5;
-		break;
-	case BOTTOM_ALIGNMENT_TYPE:
-		advance.x -= lineSizeX * (cmmt_float_t)0.5;
-		advance.y += size.y - newLineAdvance * 0.5f;
-		break;
-	case TOP_ALIGNMENT_TYPE:
-		advance.x -= lineSizeX * (cmmt_float_t)0.5;
-		advance.y -= newLineAdvance * 0.25f;
-		break;
-	case LEFT_BOTTOM_ALIGNMENT_TYPE:
-		advance.y += size.y - newLineAdvance * 0.5f;
-		break;
-	case LEFT_TOP_ALIGNMENT_TYPE:
-		advance.y -= newLineAdvance * 0.25f;
-		break;
-	case RIGHT_BOTTOM_ALIGNMENT_TYPE:
-		advance.x -= lineSizeX;
-		advance.y += size.y - newLineAdvance * 0.5f;
-		break;
-	case RIGHT_TOP_ALIGNMENT_TYPE:
-		advance.x -= lineSizeX;
-		advance.y -= newLineAdvance * 0.25f;
-		break;
+		count += writeColorTag(
+			style.color,
+			string + count);
 	}
 
-	*_advance = advance;
-	return true;
+	return count;
 }
-bool getTextCursorIndex(
-	Text text,
-	Vec2F advance,
-	size_t* _index)
+inline static TextStyle getTextDocumentLineStyle(
+	TextDocument textDocument,
+	size_t lineIndex)
 {
-	assert(text);
-	assert(_index);
-	assert(textInitialized);
+	assert(textDocument);
+	assert(lineIndex < textDocument->lineCount);
 
-	size_t length = text->base.length;
+	size_t blockIndex = lineIndex / TEXT_DOCUMENT_BLOCK_LINE_COUNT;
+	TextStyle style = textDocument->blockStyles[blockIndex];
+	Text text = textDocument->text;
 
-	cmmt_float_t bestDistance = INFINITY;
-	size_t index = 0;
+	if (!text->base.useTags)
+		return style;
+
+	const uint32_t* string = textDocument->string;
+	SrgbColor color = text->base.color;
 
-	// TODO: too heavy, use better solution
-	for (size_t i = 0; i <= length; i++)
+	// Tags can not contain new line, so the
+	// line offset is used as the string end.
+	size_t i = textDocument->lineOffsets[
+		blockIndex * TEXT_DOCUMENT_BLOCK_LINE_COUNT];
+	size_t end = textDocument->lineOffsets[lineIndex];
+
+	for (; i < end; i++)
 	{
-		Vec2F checkAdvance;
+		if (string[i] != '<')
+			continue;
 
-		bool result = getTextCursorAdvance(
-			text,
+		size_t tagLength = parseTextTag(
+			string,
+			end,
 			i,
-			&checkAdvance);
+			color,
+			&style);
 
-		if (!result)
+		if (tagLength > 0)
+			i += tagLength - 1;
+	}
+
+	return style;
+}
+/*
+ * Copies visible document lines to the view text,
+ * prefixed with tags of the first visible line style.
+ * Text layout is updated only for the changed lines.
+ */
+inline static bool updateTextDocumentView(
+	TextDocument textDocument)
+{
+	assert(textDocument);
+
+	Text text = textDocument->text;
+	size_t lineCount = textDocument->lineCount;
+	size_t firstLine = textDocument->viewLine;
+	size_t lastLine = firstLine + textDocument->viewLineCount;
+
+	if (lastLine > lineCount)
+		lastLine = lineCount;
+
+	if (firstLine >= lastLine)
+		return setTextString(text, NULL, 0);
+
+	const size_t* lineOffsets = textDocument->lineOffsets;
+	size_t offset = lineOffsets[firstLine];
+
+	size_t end = lastLine < lineCount ?
+		lineOffsets[lastLine] - 1 : textDocument->length;
+
+	// Longest style prefix is 4 + 4 + 11 characters.
+	size_t maxLength = (end - offset) + 19;
+	uint32_t* viewString = textDocument->viewString;
+
+	if (maxLength > textDocument->viewCapacity)
+	{
+		uint32_t* newViewString = realloc(
+			viewString,
+			maxLength * sizeof(uint32_t));
+
+		if (!newViewString)
 			return false;
 
-		float distance = distPowVec2F(
-			advance, checkAdvance);
+		textDocument->viewString = viewString = newViewString;
+		textDocument->viewCapacity = maxLength;
+	}
 
-		if (distance < bestDistance)
-		{
-			bestDistance = distance;
-			index = i;
-		}
+	size_t length = 0;
+
+	if (text->base.useTags)
+	{
+		TextStyle style = getTextDocumentLineStyle(
+			textDocument,
+			firstLine);
+		length = writeTextStyleTags(
+			text,
+			style,
+			viewString);
 	}
 
-	*_index = index;
-	return true;
+	if (end > offset)
+	{
+		memcpy(viewString + length,
+			textDocument->string + offset,
+			(end - offset) * sizeof(uint32_t));
+		length += end - offset;
+	}
+
+	return setTextString(
+		text,
+		viewString,
+		length);
 }
 
-MpgxResult bakeText(Text text)
+MpgxResult createTextDocument(
+	FontAtlas fontAtlas,
+	AlignmentType alignment,
+	SrgbColor color,
+	bool isBold,
+	bool isItalic,
+	bool useTags,
+	TextDocument* textDocument)
 {
-	assert(text);
-	assert(!text->base.isConstant);
+	assert(fontAtlas);
+	assert(alignment == TOP_ALIGNMENT_TYPE ||
+		alignment == LEFT_TOP_ALIGNMENT_TYPE ||
+		alignment == RIGHT_TOP_ALIGNMENT_TYPE);
+	assert(textDocument);
 	assert(textInitialized);
 
-	FontAtlas fontAtlas = text->base.fontAtlas;
-	const uint32_t* string = text->base.string;
-	size_t length = text->base.length;
+	TextDocument textDocumentInstance = calloc(1,
+		sizeof(TextDocument_T));
 
-	if (fontAtlas->isGenerated)
+	if (!textDocumentInstance)
+		return OUT_OF_HOST_MEMORY_MPGX_RESULT;
+
+	size_t* lineOffsets = malloc(
+		TEXT_DOCUMENT_BLOCK_LINE_COUNT * sizeof(size_t));
+
+	if (!lineOffsets)
 	{
-		MpgxResult mpgxResult = bakeFontAtlas(
-			fontAtlas,
-			string,
-			length);
+		destroyTextDocument(textDocumentInstance);
+		return OUT_OF_HOST_MEMORY_MPGX_RESULT;
+	}
 
-		if (mpgxResult != SUCCESS_MPGX_RESULT)
-			return mpgxResult;
+	textDocumentInstance->lineOffsets = lineOffsets;
+	textDocumentInstance->lineCapacity = TEXT_DOCUMENT_BLOCK_LINE_COUNT;
+
+	TextStyle* blockStyles = malloc(sizeof(TextStyle));
+
+	if (!blockStyles)
+	{
+		destroyTextDocument(textDocumentInstance);
+		return OUT_OF_HOST_MEMORY_MPGX_RESULT;
 	}
 
-	GraphicsPipeline pipeline = fontAtlas->pipeline;
-	Handle handle = pipeline->base.handle;
-	TextVertex* vertexBuffer = handle->base.vertexBuffer;
-	size_t vertexCapacity = handle->base.vertexCapacity;
+	textDocumentInstance->blockStyles = blockStyles;
 
-	if (vertexCapacity < length * 4)
+	float* blockWidths = malloc(sizeof(float));
+
+	if (!blockWidths)
 	{
-		size_t capacity = length * 4;
-		TextVertex* newVertexBuffer;
+		destroyTextDocument(textDocumentInstance);
+		return OUT_OF_HOST_MEMORY_MPGX_RESULT;
+	}
 
-		if (vertexBuffer)
-		{
-			newVertexBuffer = realloc(
-				vertexBuffer,
-				capacity * sizeof(TextVertex));
-		}
-		else
-		{
-			newVertexBuffer = malloc(
-				capacity * sizeof(TextVertex));
-		}
+	textDocumentInstance->blockWidths = blockWidths;
+	textDocumentInstance->blockCapacity = 1;
 
-		if (!newVertexBuffer)
-			return OUT_OF_HOST_MEMORY_MPGX_RESULT;
+	Text text;
+
+	MpgxResult mpgxResult = createAtlasText(
+		fontAtlas,
+		NULL,
+		0,
+		alignment,
+		color,
+		isBold,
+		isItalic,
+		useTags,
+		false,
+		&text);
 
-		handle->base.vertexBuffer = vertexBuffer = newVertexBuffer;
-		handle->base.vertexCapacity = capacity;
+	if (mpgxResult != SUCCESS_MPGX_RESULT)
+	{
+		destroyTextDocument(textDocumentInstance);
+		return mpgxResult;
 	}
 
-	const Glyph* glyphs = fontAtlas->glyphs;
-	size_t glyphCapacity = fontAtlas->glyphCapacity;
+	textDocumentInstance->text = text;
 
-	uint32_t vertexCount;
-	Vec2F textSize;
+	TextStyle style;
+	style.color = color;
+	style.isBold = isBold;
+	style.isItalic = isItalic;
+	memset(style._alignment, 0, sizeof(style._alignment));
 
-	bool result = fillVertices(
-		text->base.string,
-		text->base.length,
-		glyphs,
-		glyphs + glyphCapacity,
-		glyphs + glyphCapacity * 2,
-		glyphs + glyphCapacity * 3,
-		fontAtlas->glyphCount,
-		(float)fontAtlas->fontSize,
-		fontAtlas->newLineAdvance,
-		text->base.alignment,
-		text->base.color,
-		text->base.isBold,
-		text->base.isItalic,
-		text->base.useTags,
-		vertexBuffer,
-		&vertexCount,
-		&textSize);
+	lineOffsets[0] = 0;
+	blockStyles[0] = style;
+	blockWidths[0] = -1.0f;
+
+	textDocumentInstance->lineCount = 1;
+	textDocumentInstance->lastLineStyle = style;
+
+	*textDocument = textDocumentInstance;
+	return SUCCESS_MPGX_RESULT;
+}
+void destroyTextDocument(TextDocument textDocument)
+{
+	assert(textInitialized);
+
+	if (!textDocument)
+		return;
+
+	destroyText(textDocument->text);
+	free(textDocument->viewString);
+	free(textDocument->blockWidths);
+	free(textDocument->blockStyles);
+	free(textDocument->lineOffsets);
+	free(textDocument->string);
+	free(textDocument);
+}
+
+Text getTextDocumentText(TextDocument textDocument)
+{
+	assert(textDocument);
+	assert(textInitialized);
+	return textDocument->text;
+}
+const uint32_t* getTextDocumentString(TextDocument textDocument)
+{
+	assert(textDocument);
+	assert(textInitialized);
+	return textDocument->string;
+}
+size_t getTextDocumentLength(TextDocument textDocument)
+{
+	assert(textDocument);
+	assert(textInitialized);
+	return textDocument->length;
+}
+size_t getTextDocumentLineCount(TextDocument textDocument)
+{
+	assert(textDocument);
+	assert(textInitialized);
+	return textDocument->lineCount;
+}
+
+bool appendTextDocument(
+	TextDocument textDocument,
+	const uint32_t* string,
+	size_t length)
+{
+	assert(textDocument);
+	assert(textInitialized);
+
+	assert(length == 0 ||
+		(length > 0 && string));
 
-	if (!result)
-		return BAD_VALUE_MPGX_RESULT;
+	if (length == 0)
+		return true;
 
-	GraphicsAPI api = getGraphicsAPI();
-	Window window = pipeline->base.window;
-	Buffer indexBuffer = handle->base.indexBuffer;
-	Text* texts = handle->base.texts;
-	size_t textCount = handle->base.textCount;
-	uint32_t indexCount = (vertexCount / 4) * 6;
-	size_t indexSize = indexCount * sizeof(uint32_t);
+	size_t oldLength = textDocument->length;
+	size_t newLength = oldLength + length;
+	uint32_t* documentString = textDocument->string;
 
-	if (!indexBuffer || indexBuffer->base.size < indexSize)
+	if (newLength > textDocument->capacity)
 	{
-		uint32_t* indices = createIndices(indexCount);
+		size_t capacity = textDocument->capacity * 2;
 
-		if (!indices)
-			return OUT_OF_HOST_MEMORY_MPGX_RESULT;
+		if (capacity < newLength)
+			capacity = newLength;
 
-		Buffer newIndexBuffer;
+		uint32_t* newString = realloc(
+			documentString,
+			capacity * sizeof(uint32_t));
 
-		MpgxResult mpgxResult = createBuffer(window,
-			INDEX_BUFFER_TYPE,
-			GPU_ONLY_BUFFER_USAGE,
-			indices,
-			indexSize,
-			&newIndexBuffer);
+		if (!newString)
+			return false;
 
-		free(indices);
+		textDocument->string = documentString = newString;
+		textDocument->capacity = capacity;
+	}
 
-		if (mpgxResult != SUCCESS_MPGX_RESULT)
-			return mpgxResult;
+	memcpy(documentString + oldLength, string,
+		length * sizeof(uint32_t));
+	textDocument->length = newLength;
+
+	Text text = textDocument->text;
+	SrgbColor color = text->base.color;
+	bool useTags = text->base.useTags;
+	size_t* lineOffsets = textDocument->lineOffsets;
+	size_t lineCapacity = textDocument->lineCapacity;
+	size_t lineCount = textDocument->lineCount;
+	size_t oldLineCount = lineCount;
+	TextStyle style = textDocument->lastLineStyle;
+	TextStyle lastLineStyle = style;
+
+	// Tag can be split between appended strings,
+	// so the last line is parsed again from its start.
+	size_t i = useTags ? lineOffsets[lineCount - 1] : oldLength;
+
+	for (; i < newLength; i++)
+	{
+		uint32_t value = documentString[i];
 
-		if (api == OPENGL_GRAPHICS_API)
+		if ((value == '<') & useTags)
 		{
-#if MPGX_SUPPORT_OPENGL
-			for (size_t i = 0; i < textCount; i++)
+			size_t tagLength = parseTextTag(
+				documentString,
+				newLength,
+				i,
+				color,
+				&style);
+
+			if (tagLength > 0)
 			{
-				GraphicsMesh textMesh = texts[i]->gl.mesh;
-				textMesh->gl.indexBuffer = newIndexBuffer;
+				i += tagLength - 1;
+				continue;
 			}
-#else
-			abort();
-#endif
 		}
 
-		handle->base.indexBuffer = newIndexBuffer;
-		destroyBuffer(indexBuffer);
-	}
-
-	Buffer vertexBufferInstance;
-
-	if (api == VULKAN_GRAPHICS_API)
-	{
-#if MPGX_SUPPORT_VULKAN
-		vertexBufferInstance = text->vk.vertexBuffer;
-#else
-		abort();
-#endif
-	}
-	else if (api == OPENGL_GRAPHICS_API)
-	{
-#if MPGX_SUPPORT_OPENGL
-		vertexBufferInstance = text->gl.mesh->gl.vertexBuffer;
-#else
-		abort();
-#endif
-	}
-	else
-	{
-		abort();
-	}
-
-	size_t vertexSize = vertexCount * sizeof(TextVertex);
+		if (value != '\n')
+			continue;
 
-	if (!vertexBufferInstance || vertexBufferInstance->base.size < vertexSize)
-	{
-		Buffer newVertexBuffer;
+		if (lineCount == lineCapacity)
+		{
+			lineCapacity *= 2;
 
-		MpgxResult mpgxResult = createBuffer(window,
-			VERTEX_BUFFER_TYPE,
-			CPU_TO_GPU_BUFFER_USAGE,
-			vertexBuffer,
-			vertexSize,
-			&newVertexBuffer);
+			size_t* newLineOffsets = realloc(
+				lineOffsets,
+				lineCapacity * sizeof(size_t));
 
-		if (mpgxResult != SUCCESS_MPGX_RESULT)
-			return mpgxResult;
+			if (!newLineOffsets)
+			{
+				textDocument->length = oldLength;
+				return false;
+			}
 
-		if (api == VULKAN_GRAPHICS_API)
-		{
-#if MPGX_SUPPORT_VULKAN
-			text->vk.vertexBuffer = newVertexBuffer;
-			text->vk.indexCount = indexCount;
-#else
-			abort();
-#endif
-		}
-		else
-		{
-#if MPGX_SUPPORT_OPENGL
-			GraphicsMesh mesh = text->gl.mesh;
-			mesh->gl.vertexBuffer = newVertexBuffer;
-			mesh->gl.indexCount = indexCount;
-#else
-			abort();
-#endif
+			textDocument->lineOffsets = lineOffsets = newLineOffsets;
+			textDocument->lineCapacity = lineCapacity;
 		}
 
-		destroyBuffer(vertexBufferInstance);
-	}
-	else
-	{
-		if (api == VULKAN_GRAPHICS_API)
+		if (lineCount % TEXT_DOCUMENT_BLOCK_LINE_COUNT == 0)
 		{
-#if MPGX_SUPPORT_VULKAN
-			if (vertexSize > 0)
+			size_t blockIndex = lineCount / TEXT_DOCUMENT_BLOCK_LINE_COUNT;
+
+			if (blockIndex == textDocument->blockCapacity)
 			{
-				VkWindow vkWindow = getVkWindow(window);
+				size_t blockCapacity = blockIndex * 2;
 
-				VkResult vkResult = vkQueueWaitIdle(
-					vkWindow->graphicsQueue);
+				TextStyle* blockStyles = realloc(
+					textDocument->blockStyles,
+					blockCapacity * sizeof(TextStyle));
 
-				if (vkResult != VK_SUCCESS)
-					return vkToMpgxResult(vkResult);
+				if (!blockStyles)
+				{
+					textDocument->length = oldLength;
+					return false;
+				}
 
-				MpgxResult mpgxResult = setVkBufferData(
-					vkWindow->allocator,
-					vertexBufferInstance->vk.allocation,
-					vertexBuffer,
-					vertexSize,
-					0);
+				textDocument->blockStyles = blockStyles;
 
-				if (mpgxResult != SUCCESS_MPGX_RESULT)
-					return mpgxResult;
-			}
+				float* blockWidths = realloc(
+					textDocument->blockWidths,
+					blockCapacity * sizeof(float));
 
-			text->vk.indexCount = indexCount;
-#else
-			abort();
-#endif
-		}
-		else
-		{
-#if MPGX_SUPPORT_OPENGL
-			if (vertexSize > 0)
-			{
-				MpgxResult mpgxResult = setGlBufferData(
-					vertexBufferInstance->gl.glType,
-					vertexBufferInstance->gl.handle,
-					vertexBuffer,
-					vertexSize,
-					0);
-
-				if (mpgxResult != SUCCESS_MPGX_RESULT)
-					return mpgxResult;
+				if (!blockWidths)
+				{
+					textDocument->length = oldLength;
+					return false;
+				}
+
+				textDocument->blockWidths = blockWidths;
+				textDocument->blockCapacity = blockCapacity;
 			}
 
-			text->gl.mesh->gl.indexCount = indexCount;
-#else
-			abort();
-#endif
+			textDocument->blockStyles[blockIndex] = style;
+			textDocument->blockWidths[blockIndex] = -1.0f;
 		}
+
+		lineOffsets[lineCount++] = i + 1;
+		lastLineStyle = style;
 	}
 
-	text->base.size = textSize;
-	return SUCCESS_MPGX_RESULT;
+	textDocument->lineCount = lineCount;
+	textDocument->lastLineStyle = lastLineStyle;
+	textDocument->blockWidths[(oldLineCount - 1) /
+		TEXT_DOCUMENT_BLOCK_LINE_COUNT] = -1.0f;
+
+	// View text is updated only if it
+	// contains changed document lines.
+	if (textDocument->viewLine + textDocument->viewLineCount >= oldLineCount)
+		return updateTextDocumentView(textDocument);
+	return true;
 }
-size_t drawText(Text text)
+bool appendTextDocument8(
+	TextDocument textDocument,
+	const char* string,
+	size_t length)
 {
-	assert(text);
+	assert(textDocument);
 	assert(textInitialized);
 
-	FontAtlas fontAtlas = text->base.fontAtlas;
-	GraphicsPipeline pipeline = fontAtlas->pipeline;
+	assert(length == 0 ||
+		(length > 0 && string));
 
-	GraphicsAPI api = getGraphicsAPI();
+	if (length == 0)
+		return true;
 
-	if (api == VULKAN_GRAPHICS_API)
+	uint32_t stackString[MEASURE_TEXT_STACK_LENGTH];
+	uint32_t* string32;
+
+	if (length > MEASURE_TEXT_STACK_LENGTH)
 	{
-#if MPGX_SUPPORT_VULKAN
-		uint32_t indexCount = text->vk.indexCount;
+		string32 = malloc(length * sizeof(uint32_t));
 
-		if (indexCount == 0)
-			return 0;
+		if (!string32)
+			return false;
+	}
+	else
+	{
+		string32 = stackString;
+	}
 
-		VkWindow vkWindow = getVkWindow(pipeline->base.window);
-		VkCommandBuffer commandBuffer = vkWindow->currenCommandBuffer;
-		VkPipelineLayout pipelineLayout = pipeline->vk.layout;
-		Handle handle = pipeline->vk.handle;
-		const VkDeviceSize offset = 0;
+	size_t length32 = stringUTF8toUTF32(
+		string,
+		length,
+		string32);
 
-		vkCmdPushConstants(
-			commandBuffer,
-			pipelineLayout,
-			VK_SHADER_STAGE_VERTEX_BIT,
-			0,
-			sizeof(VertexPushConstants),
-			&handle->vk.vpc);
-		vkCmdPushConstants(
-			commandBuffer,
-			pipelineLayout,
-			VK_SHADER_STAGE_FRAGMENT_BIT,
-			sizeof(VertexPushConstants),
-			sizeof(FragmentPushConstants),
-			&handle->vk.fpc);
-		vkCmdBindDescriptorSets(
-			commandBuffer,
-			VK_PIPELINE_BIND_POINT_GRAPHICS,
-			pipelineLayout,
-			0,
-			1,
-			&fontAtlas->descriptorSet,
-			0,
-			NULL);
-		vkCmdBindVertexBuffers(
-			commandBuffer,
-			0,
-			1,
-			&text->vk.vertexBuffer->vk.handle,
-			&offset);
-		vkCmdDrawIndexed(
-			commandBuffer,
-			indexCount,
-			1,
-			0,
-			0,
-			0);
-		return indexCount;
-#else
-		abort();
-#endif
-	}
-	else if (api == OPENGL_GRAPHICS_API)
+	bool result = length32 > 0 && appendTextDocument(
+		textDocument,
+		string32,
+		length32);
+
+	if (string32 != stackString)
+		free(string32);
+	return result;
+}
+bool clearTextDocument(TextDocument textDocument)
+{
+	assert(textDocument);
+	assert(textInitialized);
+
+	TextStyle style = textDocument->blockStyles[0];
+	Text text = textDocument->text;
+	style.color = text->base.color;
+	style.isBold = text->base.isBold;
+	style.isItalic = text->base.isItalic;
+
+	textDocument->length = 0;
+	textDocument->lineCount = 1;
+	textDocument->blockStyles[0] = style;
+	textDocument->blockWidths[0] = -1.0f;
+	textDocument->lastLineStyle = style;
+	return updateTextDocumentView(textDocument);
+}
+
+bool getTextDocumentSize(
+	TextDocument textDocument,
+	Vec2F* size)
+{
+	assert(textDocument);
+	assert(size);
+	assert(textInitialized);
+
+	Text text = textDocument->text;
+	FontAtlas fontAtlas = text->base.fontAtlas;
+	const uint32_t* string = textDocument->string;
+	const size_t* lineOffsets = textDocument->lineOffsets;
+	const TextStyle* blockStyles = textDocument->blockStyles;
+	float* blockWidths = textDocument->blockWidths;
+	size_t lineCount = textDocument->lineCount;
+	size_t length = textDocument->length;
+	bool useTags = text->base.useTags;
+	float sizeX = 0.0f;
+
+	size_t blockCount = (lineCount + TEXT_DOCUMENT_BLOCK_LINE_COUNT - 1) /
+		TEXT_DOCUMENT_BLOCK_LINE_COUNT;
+
+	for (size_t i = 0; i < blockCount; i++)
 	{
-#if MPGX_SUPPORT_OPENGL
-		glBindTexture(
-			GL_TEXTURE_2D,
-			fontAtlas->image->gl.handle);
-		assertOpenGL();
+		// Only blocks changed after the last
+		// measurement are measured again.
+		if (blockWidths[i] < 0.0f)
+		{
+			size_t firstLine = i * TEXT_DOCUMENT_BLOCK_LINE_COUNT;
+			size_t lastLine = firstLine + TEXT_DOCUMENT_BLOCK_LINE_COUNT;
+			size_t offset = lineOffsets[firstLine];
+
+			size_t end = lastLine < lineCount ?
+				lineOffsets[lastLine] - 1 : length;
+
+			Vec2F blockSize;
+
+			bool result = measureText(
+				fontAtlas,
+				end > offset ? string + offset : NULL,
+				end - offset,
+				blockStyles[i].isBold,
+				blockStyles[i].isItalic,
+				useTags,
+				&blockSize,
+				NULL,
+				NULL,
+				0);
 
-		return drawGraphicsMesh(
-			pipeline,
-			text->gl.mesh);
-#else
-		abort();
-#endif
+			if (!result)
+				return false;
+
+			blockWidths[i] = (float)blockSize.x;
+		}
+
+		if (sizeX < blockWidths[i])
+			sizeX = blockWidths[i];
 	}
-	else
+
+	float newLineAdvance = fontAtlas->newLineAdvance;
+
+	float sizeY = getTextSizeY(
+		lineCount,
+		newLineAdvance,
+		(float)fontAtlas->fontSize);
+
+	*size = vec2F(
+		(cmmt_float_t)sizeX,
+		(cmmt_float_t)(sizeY + newLineAdvance * 0.25f));
+	return true;
+}
+
+size_t getTextDocumentViewLine(TextDocument textDocument)
+{
+	assert(textDocument);
+	assert(textInitialized);
+	return textDocument->viewLine;
+}
+size_t getTextDocumentViewLineCount(TextDocument textDocument)
+{
+	assert(textDocument);
+	assert(textInitialized);
+	return textDocument->viewLineCount;
+}
+bool setTextDocumentView(
+	TextDocument textDocument,
+	size_t firstLine,
+	size_t lineCount)
+{
+	assert(textDocument);
+	assert(textInitialized);
+
+	if (textDocument->viewLine == firstLine &&
+		textDocument->viewLineCount == lineCount)
 	{
-		abort();
+		return true;
 	}
+
+	textDocument->viewLine = firstLine;
+	textDocument->viewLineCount = lineCount;
+	return updateTextDocumentView(textDocument);
 }
 
 MpgxResult createTextSampler(
@@ -3830,6 +9218,33 @@ static const VkVertexInputAttributeDescription vertexInputAttributeDescriptions[
 		sizeof(Vec2F) + sizeof(Vec3F),
 	},
 };
+static const VkVertexInputBindingDescription packedVertexInputBindingDescriptions[1] = {
+	{
+		0,
+		sizeof(PackedTextVertex),
+		VK_VERTEX_INPUT_RATE_VERTEX,
+	},
+};
+static const VkVertexInputAttributeDescription packedVertexInputAttributeDescriptions[3] = {
+	{
+		0,
+		0,
+		VK_FORMAT_R16G16_SINT,
+		0,
+	},
+	{
+		1,
+		0,
+		VK_FORMAT_R16G16_UINT,
+		sizeof(int16_t) * 2,
+	},
+	{
+		2,
+		0,
+		VK_FORMAT_R8G8B8A8_UINT,
+		sizeof(int16_t) * 2 + sizeof(uint16_t) * 2,
+	},
+};
 static const VkPushConstantRange pushConstantRanges[2] = {
 	{
 		VK_SHADER_STAGE_VERTEX_BIT,
@@ -3848,16 +9263,27 @@ static void onVkBind(GraphicsPipeline graphicsPipeline)
 	assert(graphicsPipeline);
 
 	Handle handle = graphicsPipeline->vk.handle;
+	handle->vk.boundAtlas = NULL;
+	handle->vk.boundBuffer = handle->vk.arenaBuffer;
+
+	if (!handle->vk.arenaBuffer)
+		return;
+
 	VkWindow vkWindow = getVkWindow(graphicsPipeline->vk.window);
+	VkCommandBuffer commandBuffer = vkWindow->currenCommandBuffer;
+	const VkDeviceSize offset = 0;
 
-	if (handle->vk.indexBuffer)
-	{
-		vkCmdBindIndexBuffer(
-			vkWindow->currenCommandBuffer,
-			handle->vk.indexBuffer->vk.handle,
-			0,
-			VK_INDEX_TYPE_UINT32);
-	}
+	vkCmdBindVertexBuffers(
+		commandBuffer,
+		0,
+		1,
+		&handle->vk.arenaBuffer->vk.handle,
+		&offset);
+	vkCmdBindIndexBuffer(
+		commandBuffer,
+		handle->vk.indexBuffer->vk.handle,
+		0,
+		VK_INDEX_TYPE_UINT32);
 }
 static void onVkResize(
 	GraphicsPipeline graphicsPipeline,
@@ -3885,11 +9311,15 @@ static void onVkResize(
 		graphicsPipeline->vk.state.scissor = size;
 	}
 
+	bool isPacked = handle->vk.vertexSize == sizeof(PackedTextVertex);
+
 	VkGraphicsPipelineCreateData _createData = {
 		1,
-		vertexInputBindingDescriptions,
+		isPacked ? packedVertexInputBindingDescriptions :
+			vertexInputBindingDescriptions,
 		3,
-		vertexInputAttributeDescriptions,
+		isPacked ? packedVertexInputAttributeDescriptions :
+			vertexInputAttributeDescriptions,
 		1,
 		&handle->vk.descriptorSetLayout,
 		2,
@@ -3913,13 +9343,21 @@ static void onVkDestroy(
 	VkWindow vkWindow = getVkWindow(window);
 	VkDevice device = vkWindow->device;
 
+	destroyBuffer(handle->vk.batchBuffer);
+	destroyBuffer(handle->vk.arenaBuffer);
 	destroyBuffer(handle->vk.indexBuffer);
 	vkDestroyDescriptorSetLayout(
 		device,
 		handle->vk.descriptorSetLayout,
 		NULL);
+	free(handle->vk.batchVertices);
+	free(handle->vk.freeRanges);
+	free(handle->vk.arenaVertices);
 	free(handle->vk.pixelBuffer);
-	free(handle->vk.vertexBuffer);
+	destroyTextScratches(
+		&handle->vk.scratch,
+		handle->vk.threadScratches,
+		handle->vk.threadScratchCount);
 	free(handle->vk.texts);
 	free(handle);
 }
@@ -3975,11 +9413,15 @@ inline static MpgxResult createVkPipeline(
 		return vkToMpgxResult(vkResult);
 	}
 
+	bool isPacked = handle->vk.vertexSize == sizeof(PackedTextVertex);
+
 	VkGraphicsPipelineCreateData createData = {
 		1,
-		vertexInputBindingDescriptions,
+		isPacked ? packedVertexInputBindingDescriptions :
+			vertexInputBindingDescriptions,
 		3,
-		vertexInputAttributeDescriptions,
+		isPacked ? packedVertexInputAttributeDescriptions :
+			vertexInputAttributeDescriptions,
 		1,
 		&descriptorSetLayout,
 		2,
@@ -4009,11 +9451,25 @@ static void onGlBind(GraphicsPipeline graphicsPipeline)
 {
 	assert(graphicsPipeline);
 	Handle handle = graphicsPipeline->gl.handle;
+	GraphicsMesh mesh = handle->gl.mesh;
+	handle->gl.boundAtlas = NULL;
+	handle->gl.boundBuffer = handle->gl.arenaBuffer;
 
 	glUniform1i(handle->gl.atlasLocation, 0);
 	glActiveTexture(GL_TEXTURE0);
 	glBindSampler(0, handle->gl.sampler->gl.handle);
 
+	if (mesh)
+	{
+		glBindVertexArray(mesh->gl.handle);
+		glBindBuffer(
+			GL_ARRAY_BUFFER,
+			mesh->gl.vertexBuffer->gl.handle);
+		glBindBuffer(
+			GL_ELEMENT_ARRAY_BUFFER,
+			mesh->gl.indexBuffer->gl.handle);
+	}
+
 	assertOpenGL();
 }
 static void onGlUniformsSet(GraphicsPipeline graphicsPipeline)
@@ -4030,32 +9486,7 @@ static void onGlUniformsSet(GraphicsPipeline graphicsPipeline)
 		handle->gl.colorLocation,
 		1,
 		(const GLfloat*)&handle->gl.fpc.color);
-
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-	glEnableVertexAttribArray(2);
-
-	glVertexAttribPointer(
-		0,
-		2,
-		GL_FLOAT,
-		GL_FALSE,
-		sizeof(TextVertex),
-		0);
-	glVertexAttribPointer(
-		1,
-		3,
-		GL_FLOAT,
-		GL_FALSE,
-		sizeof(TextVertex),
-		(const void*)sizeof(Vec2F));
-	glVertexAttribIPointer(
-		2,
-		4,
-		GL_UNSIGNED_BYTE,
-		sizeof(TextVertex),
-		(const void*)(sizeof(Vec2F) + sizeof(Vec3F)));
-	assertOpenGL();
+	setGlTextVertexAttributes(handle);
 }
 static void onGlResize(
 	GraphicsPipeline graphicsPipeline,
@@ -4093,9 +9524,18 @@ static void onGlDestroy(
 
 	assert(handle->gl.textCount == 0);
 
+	destroyGraphicsMesh(handle->gl.mesh);
+	destroyBuffer(handle->gl.batchBuffer);
+	destroyBuffer(handle->gl.arenaBuffer);
 	destroyBuffer(handle->gl.indexBuffer);
+	free(handle->gl.batchVertices);
+	free(handle->gl.freeRanges);
+	free(handle->gl.arenaVertices);
 	free(handle->gl.pixelBuffer);
-	free(handle->gl.vertexBuffer);
+	destroyTextScratches(
+		&handle->gl.scratch,
+		handle->gl.threadScratches,
+		handle->gl.threadScratchCount);
 	free(handle->gl.texts);
 	free(handle);
 }
@@ -4180,6 +9620,7 @@ MpgxResult createTextPipeline(
 	Sampler sampler,
 	const GraphicsPipelineState* state,
 	bool useScissors,
+	bool usePackedVertices,
 	size_t capacity,
 	GraphicsPipeline* textPipeline)
 {
@@ -4218,11 +9659,30 @@ MpgxResult createTextPipeline(
 	handle->base.texts = texts;
 	handle->base.textCapacity = capacity;
 	handle->base.textCount = 0;
-	handle->base.vertexBuffer = NULL;
-	handle->base.vertexCapacity = 0;
+	handle->base.threadScratches = NULL;
+	handle->base.threadScratchCount = 0;
 	handle->base.pixelBuffer = NULL;
 	handle->base.pixelCapacity = 0;
 	handle->base.indexBuffer = NULL;
+	handle->base.arenaBuffer = NULL;
+	handle->base.arenaVertices = NULL;
+	handle->base.arenaCapacity = 0;
+	handle->base.freeRanges = NULL;
+	handle->base.freeRangeCapacity = 0;
+	handle->base.freeRangeCount = 0;
+	handle->base.boundAtlas = NULL;
+	handle->base.boundBuffer = NULL;
+	handle->base.vertexSize = usePackedVertices ?
+		sizeof(PackedTextVertex) : sizeof(TextVertex);
+	handle->base.batchBuffer = NULL;
+	handle->base.batchVertices = NULL;
+	handle->base.batchCapacity = 0;
+	handle->base.batchCount = 0;
+	handle->base.batchDemand = 0;
+	handle->base.batchTime = -1.0;
+	handle->base.batch.type = NONE_TEXT_BATCH_TYPE;
+	handle->base.quadAtlas = NULL;
+	handle->base.isBatchSynced = false;
 #ifndef NDEBUG
 	handle->base.isEnumerating = false;
 #endif
@@ -4323,6 +9783,15 @@ Sampler getTextPipelineSampler(
 	Handle handle = textPipeline->base.handle;
 	return handle->base.sampler;
 }
+bool isTextPipelinePacked(
+	GraphicsPipeline textPipeline)
+{
+	assert(textPipeline);
+	assert(strcmp(textPipeline->base.name,
+		TEXT_PIPELINE_NAME) == 0);
+	Handle handle = textPipeline->base.handle;
+	return handle->base.vertexSize == sizeof(PackedTextVertex);
+}
 size_t getTextPipelineCount(GraphicsPipeline textPipeline)
 {
 	assert(textPipeline);
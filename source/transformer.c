@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include "uran/transformer.h"
+#include "uran/slab.h"
 
 #include "mpgx/defines.h"
 #include "mpmt/atomic.h"
@@ -24,10 +25,12 @@
 struct Transformer_T
 {
 	ThreadPool threadPool;
+	Slab transformSlab;
 	Transform* transforms;
 	size_t transformCapacity;
 	size_t transformCount;
 	Transform camera;
+	atomic_int64 version;
 #ifndef NDEBUG
 	bool isEnumerating;
 #endif
@@ -42,10 +45,27 @@ struct Transform_T
 	Vec3F scale;
 	Vec3F position;
 	Vec3F pivot;
+	uint64_t version;
 	RotationType rotationType;
 	bool isActive;
 };
 
+/*
+ * Transforms can be changed from the
+ * enumeration threads, so version is atomic.
+ * Returns new transformer version.
+ */
+inline static uint64_t changeTransformer(Transformer transformer)
+{
+	assert(transformer);
+	return (uint64_t)atomicFetchAdd64(
+		&transformer->version, 1) + 1;
+}
+inline static bool isVec3Equal(Vec3F a, Vec3F b)
+{
+	return a.x == b.x && a.y == b.y && a.z == b.z;
+}
+
 inline static void updateTransformModel(
 	Transform transform,
 	Vec3F cameraPosition,
@@ -125,6 +145,7 @@ Transformer createTransformer(
 
 	transformer->threadPool = threadPool;
 	transformer->camera = NULL;
+	transformer->version = 0;
 #ifndef NDEBUG
 	transformer->isEnumerating = false;
 #endif
@@ -139,6 +160,20 @@ Transformer createTransformer(
 	}
 
 	transformer->transforms = transforms;
+
+	// Transforms are allocated from the blocks,
+	// so they are close in memory when updated.
+	Slab transformSlab = createSlab(
+		sizeof(Transform_T),
+		capacity);
+
+	if (!transformSlab)
+	{
+		destroyTransformer(transformer);
+		return NULL;
+	}
+
+	transformer->transformSlab = transformSlab;
 	transformer->transformCapacity = capacity;
 	transformer->transformCount = 0;
 	return transformer;
@@ -151,6 +186,7 @@ void destroyTransformer(Transformer transformer)
 	assert(transformer->transformCount == 0);
 	assert(!transformer->isEnumerating);
 
+	destroySlab(transformer->transformSlab);
 	free(transformer->transforms);
 	free(transformer);
 }
@@ -177,7 +213,19 @@ void setTransformerCamera(
 	Transform camera)
 {
 	assert(transformer);
-	transformer->camera = camera;
+
+	if (transformer->camera != camera)
+	{
+		transformer->camera = camera;
+		changeTransformer(transformer);
+	}
+}
+uint64_t getTransformerVersion(
+	Transformer transformer)
+{
+	assert(transformer);
+	return (uint64_t)atomicFetchAdd64(
+		&transformer->version, 0);
 }
 
 void enumerateTransformerItems(
@@ -285,16 +333,12 @@ void destroyAllTransformerItems(Transformer transformer)
 	assert(transformer);
 	assert(!transformer->isEnumerating);
 
-	Transform* transforms = transformer->transforms;
-	size_t transformCount = transformer->transformCount;
-
-	if (transformCount == 0)
+	if (transformer->transformCount == 0)
 		return;
 
-	for (size_t i = 0; i < transformCount; i++)
-		free(transforms[i]);
-
+	resetSlab(transformer->transformSlab);
 	transformer->transformCount = 0;
+	changeTransformer(transformer);
 }
 
 typedef struct UpdateData
@@ -403,7 +447,8 @@ Transform createTransform(
 		transformer == parent->transformer));
 	assert(!transformer->isEnumerating);
 
-	Transform transform = malloc(sizeof(Transform_T));
+	Transform transform = allocateSlabObject(
+		transformer->transformSlab);
 
 	if (!transform)
 		return NULL;
@@ -440,7 +485,7 @@ Transform createTransform(
 
 		if (!transforms)
 		{
-			free(transform);
+			freeSlabObject(transformer->transformSlab, transform);
 			return NULL;
 		}
 
@@ -450,6 +495,7 @@ Transform createTransform(
 
 	transformer->transforms[count] = transform;
 	transformer->transformCount = count + 1;
+	transform->version = changeTransformer(transformer);
 	return transform;
 }
 void destroyTransform(Transform transform)
@@ -471,8 +517,9 @@ void destroyTransform(Transform transform)
 		for (size_t j = i + 1; j < transformCount; j++)
 			transforms[j - 1] = transforms[j];
 
-		free(transform);
+		freeSlabObject(transformer->transformSlab, transform);
 		transformer->transformCount--;
+		changeTransformer(transformer);
 		return;
 	}
 
@@ -496,7 +543,13 @@ void setTransformPosition(
 	Vec3F position)
 {
 	assert(transform);
-	transform->position = position;
+
+	if (!isVec3Equal(transform->position, position))
+	{
+		transform->position = position;
+		transform->version = changeTransformer(
+			transform->transformer);
+	}
 }
 
 Vec3F getTransformScale(
@@ -510,7 +563,13 @@ void setTransformScale(
 	Vec3F scale)
 {
 	assert(transform);
-	transform->scale = scale;
+
+	if (!isVec3Equal(transform->scale, scale))
+	{
+		transform->scale = scale;
+		transform->version = changeTransformer(
+			transform->transformer);
+	}
 }
 
 Quat getTransformRotation(
@@ -525,6 +584,8 @@ void setTransformRotation(
 {
 	assert(transform);
 	transform->rotation = rotation;
+	transform->version = changeTransformer(
+		transform->transformer);
 }
 
 Vec3F getTransformEulerAngles(
@@ -539,6 +600,8 @@ void setTransformEulerAngles(
 {
 	assert(transform);
 	transform->rotation = eulerQuat(eulerAngles);
+	transform->version = changeTransformer(
+		transform->transformer);
 }
 
 Vec3F getTransformPivot(
@@ -552,7 +615,13 @@ void setTransformPivot(
 	Vec3F pivot)
 {
 	assert(transform);
-	transform->pivot = pivot;
+
+	if (!isVec3Equal(transform->pivot, pivot))
+	{
+		transform->pivot = pivot;
+		transform->version = changeTransformer(
+			transform->transformer);
+	}
 }
 
 RotationType getTransformRotationType(
@@ -568,6 +637,8 @@ void setTransformRotationType(
 	assert(transform);
 	assert(rotationType < ROTATION_TYPE_COUNT);
 	transform->rotationType = rotationType;
+	transform->version = changeTransformer(
+		transform->transformer);
 }
 
 Transform getTransformParent(
@@ -584,7 +655,13 @@ void setTransformParent(
 		transform->transformer ==
 		parent->transformer));
 	assert(!parent || (parent != transform));
-	transform->parent = parent;
+
+	if (transform->parent != parent)
+	{
+		transform->parent = parent;
+		transform->version = changeTransformer(
+			transform->transformer);
+	}
 }
 
 void* getTransformHandle(
@@ -612,7 +689,20 @@ void setTransformActive(
 	bool isActive)
 {
 	assert(transform);
-	transform->isActive = isActive;
+
+	if (transform->isActive != isActive)
+	{
+		transform->isActive = isActive;
+		transform->version = changeTransformer(
+			transform->transformer);
+	}
+}
+
+uint64_t getTransformVersion(
+	Transform transform)
+{
+	assert(transform);
+	return transform->version;
 }
 
 Mat4F getTransformModel(Transform transform)
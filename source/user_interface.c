@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include "uran/user_interface.h"
+#include "uran/slab.h"
 #include "openssl/crypto.h"
 
 #include <string.h>
@@ -25,19 +26,40 @@
 #define ACTION_START_DELAY 0.24
 #define ACTION_PRESS_DELAY 0.08
 
-// TODO: use better approach for the input field mask, cache buffers, etc.
+#define UI_HANDLE_BLOCK_LENGTH 32
+#define UI_LIST_OVERSCAN_COUNT 2
 
 struct UserInterface_T
 {
 	Window window;
+	Logger logger;
+	Font* fonts;
+	size_t fontCount;
+	uint32_t* fontSizes;
 	FontAtlas* fontAtlases;
 	size_t fontAtlasCount;
+	OnUserInterfaceFontAtlasCreate onFontAtlasCreate;
+	void* fontAtlasHandle;
+	Slab handleSlabs[CUSTOM_UI_TYPES];
 	Transformer transformer;
 	Interface interface;
+	GraphicsPipeline panelPipeline;
 	GraphicsRenderer panelRenderer;
 	GraphicsRenderer textRenderer;
 	GraphicsRender cursorRender;
 	InterfaceElement focusedInputField;
+	InterfaceElement* focusElements;
+	size_t focusCapacity;
+	size_t focusCount;
+	uint64_t focusOrder;
+	Text* labelTexts;
+	size_t labelTextCapacity;
+	uint64_t modelVersion;
+	uint64_t scissorVersion;
+	Vec2I scissorFramebufferSize;
+	cmmt_float_t scissorScale;
+	uint32_t* inputBuffer;
+	size_t inputCapacity;
 	double blinkDelay;
 	double buttonDelay;
 	size_t cursorIndex;
@@ -46,19 +68,28 @@ struct UserInterface_T
 	bool isTabPressed;
 };
 
+/*
+ * Scissor version is the greatest transform version
+ * of the element and its parents, when the scissor
+ * was calculated from the baked models.
+ */
 typedef struct UiBaseHandle_T
 {
 	UiType type;
+	uint64_t scissorVersion;
 } UiBaseHandle_T;
 typedef struct UiPanelHandle_T
 {
 	UiType type;
+	uint64_t scissorVersion;
+	UserInterface ui;
 	void* handle;
 	GraphicsRender render;
 } UiPanelHandle_T;
 typedef struct UiLabelHandle_T
 {
 	UiType type;
+	uint64_t scissorVersion;
 	UserInterface ui;
 	void* handle;
 	GraphicsRender render;
@@ -66,6 +97,7 @@ typedef struct UiLabelHandle_T
 typedef struct UiWindowHandle_T
 {
 	UiType type;
+	uint64_t scissorVersion;
 	UserInterface ui;
 	void* handle;
 	OnInterfaceElementEvent onUpdate;
@@ -79,6 +111,7 @@ typedef struct UiWindowHandle_T
 typedef struct UiButtonHandle_T
 {
 	UiType type;
+	uint64_t scissorVersion;
 	UserInterface ui;
 	void* handle;
 	OnInterfaceElementEvent onEnable;
@@ -98,6 +131,7 @@ typedef struct UiButtonHandle_T
 typedef struct UiInputFieldHandle_T
 {
 	UiType type;
+	uint64_t scissorVersion;
 	UserInterface ui;
 	void* handle;
 	OnInterfaceElementEvent onEnable;
@@ -111,15 +145,18 @@ typedef struct UiInputFieldHandle_T
 	LinearColor enabledColor;
 	LinearColor focusedColor;
 	size_t maxLength;
+	uint64_t focusOrder;
+	size_t focusIndex;
+	uint32_t tabIndex;
 	GraphicsRender panelRender;
 	GraphicsRender focusRender;
 	GraphicsRender textRender;
 	GraphicsRender placeholderRender;
-	uint32_t mask;
 } UiInputFieldHandle_T;
 typedef struct UiCheckboxHandle_T
 {
 	UiType type;
+	uint64_t scissorVersion;
 	UserInterface ui;
 	void* handle;
 	OnInterfaceElementEvent onEnable;
@@ -139,6 +176,28 @@ typedef struct UiCheckboxHandle_T
 	bool isPressed;
 	bool isChecked;
 } UiCheckboxHandle_T;
+typedef struct UiListHandle_T
+{
+	UiType type;
+	uint64_t scissorVersion;
+	UserInterface ui;
+	void* handle;
+	OnInterfaceElementEvent onUpdate;
+	OnInterfaceElementEvent onPress;
+	OnUiListRow onRow;
+	GraphicsRender panelRender;
+	GraphicsRender* rowRenders;
+	size_t* rowIndices;
+	Text* rowTexts;
+	size_t rowPoolCount;
+	size_t rowCount;
+	cmmt_float_t rowHeight;
+	cmmt_float_t scroll;
+	Vec2F viewSize;
+	Vec2F lastCursorPosition;
+	bool isDragging;
+	bool isChanged;
+} UiListHandle_T;
 
 typedef UiBaseHandle_T* UiBaseHandle;
 typedef UiPanelHandle_T* UiPanelHandle;
@@ -147,6 +206,17 @@ typedef UiWindowHandle_T* UiWindowHandle;
 typedef UiButtonHandle_T* UiButtonHandle;
 typedef UiInputFieldHandle_T* UiInputFieldHandle;
 typedef UiCheckboxHandle_T* UiCheckboxHandle;
+typedef UiListHandle_T* UiListHandle;
+
+static const size_t uiHandleSizes[CUSTOM_UI_TYPES] = {
+	sizeof(UiPanelHandle_T),
+	sizeof(UiLabelHandle_T),
+	sizeof(UiWindowHandle_T),
+	sizeof(UiButtonHandle_T),
+	sizeof(UiInputFieldHandle_T),
+	sizeof(UiCheckboxHandle_T),
+	sizeof(UiListHandle_T),
+};
 
 inline static GraphicsRender createCursorRenderInstance(
 	Transformer transformer,
@@ -197,16 +267,29 @@ inline static void destroyCursorRenderInstance(
 MpgxResult createUserInterface(
 	GraphicsPipeline panelPipeline,
 	GraphicsPipeline textPipeline,
-	FontAtlas* fontAtlases,
+	Font* regularFonts,
+	Font* boldFonts,
+	Font* italicFonts,
+	Font* boldItalicFonts,
+	size_t fontCount,
+	const uint32_t* fontSizes,
 	size_t fontAtlasCount,
+	OnUserInterfaceFontAtlasCreate onFontAtlasCreate,
+	void* fontAtlasHandle,
 	cmmt_float_t scale,
 	size_t capacity,
 	ThreadPool threadPool,
+	Logger logger,
 	UserInterface* ui)
 {
 	assert(panelPipeline);
 	assert(textPipeline);
-	assert(fontAtlases);
+	assert(regularFonts);
+	assert(boldFonts);
+	assert(italicFonts);
+	assert(boldItalicFonts);
+	assert(fontCount > 0);
+	assert(fontSizes);
 	assert(fontAtlasCount > 0);
 	assert(scale > 0.0);
 	assert(ui);
@@ -220,7 +303,21 @@ MpgxResult createUserInterface(
 		return OUT_OF_HOST_MEMORY_MPGX_RESULT;
 
 	userInterface->window = window;
+	userInterface->logger = logger;
+	userInterface->panelPipeline = panelPipeline;
+	userInterface->onFontAtlasCreate = onFontAtlasCreate;
+	userInterface->fontAtlasHandle = fontAtlasHandle;
 	userInterface->focusedInputField = NULL;
+	userInterface->focusElements = NULL;
+	userInterface->focusCapacity = 0;
+	userInterface->focusCount = 0;
+	userInterface->focusOrder = 0;
+	userInterface->labelTexts = NULL;
+	userInterface->labelTextCapacity = 0;
+	userInterface->modelVersion = 0;
+	userInterface->scissorVersion = UINT64_MAX;
+	userInterface->scissorFramebufferSize = zeroVec2I;
+	userInterface->scissorScale = (cmmt_float_t)0.0;
 	userInterface->blinkDelay = 0.0;
 	userInterface->buttonDelay = 0.0;
 	userInterface->cursorIndex = 0;
@@ -228,8 +325,61 @@ MpgxResult createUserInterface(
 	userInterface->isButtonPressed = false;
 	userInterface->isTabPressed = false;
 
-	FontAtlas* fontAtlasArray = malloc(
-		fontAtlasCount * sizeof(FontAtlas));
+	// Element handles of the same type are allocated
+	// from the blocks, so they are close in memory.
+	for (uint8_t i = 0; i < CUSTOM_UI_TYPES; i++)
+	{
+		Slab handleSlab = createSlab(
+			uiHandleSizes[i],
+			UI_HANDLE_BLOCK_LENGTH);
+
+		if (!handleSlab)
+		{
+			destroyUserInterface(userInterface);
+			return OUT_OF_HOST_MEMORY_MPGX_RESULT;
+		}
+
+		userInterface->handleSlabs[i] = handleSlab;
+	}
+
+	Font* fontArray = malloc(
+		fontCount * 4 * sizeof(Font));
+
+	if (!fontArray)
+	{
+		destroyUserInterface(userInterface);
+		return OUT_OF_HOST_MEMORY_MPGX_RESULT;
+	}
+
+	userInterface->fonts = fontArray;
+	userInterface->fontCount = fontCount;
+
+	memcpy(fontArray, regularFonts,
+		fontCount * sizeof(Font));
+	memcpy(fontArray + fontCount, boldFonts,
+		fontCount * sizeof(Font));
+	memcpy(fontArray + fontCount * 2, italicFonts,
+		fontCount * sizeof(Font));
+	memcpy(fontArray + fontCount * 3, boldItalicFonts,
+		fontCount * sizeof(Font));
+
+	uint32_t* fontSizeArray = malloc(
+		fontAtlasCount * sizeof(uint32_t));
+
+	if (!fontSizeArray)
+	{
+		destroyUserInterface(userInterface);
+		return OUT_OF_HOST_MEMORY_MPGX_RESULT;
+	}
+
+	userInterface->fontSizes = fontSizeArray;
+
+	memcpy(fontSizeArray, fontSizes,
+		fontAtlasCount * sizeof(uint32_t));
+
+	// Font atlases are created on the first use.
+	FontAtlas* fontAtlasArray = calloc(
+		fontAtlasCount, sizeof(FontAtlas));
 
 	if (!fontAtlasArray)
 	{
@@ -240,9 +390,6 @@ MpgxResult createUserInterface(
 	userInterface->fontAtlases = fontAtlasArray;
 	userInterface->fontAtlasCount = fontAtlasCount;
 
-	memcpy(fontAtlasArray, fontAtlases,
-		fontAtlasCount * sizeof(FontAtlas));
-
 	Transformer transformer = createTransformer(1, threadPool);
 
 	if (!transformer)
@@ -267,35 +414,61 @@ MpgxResult createUserInterface(
 
 	userInterface->interface = interface;
 
-	GraphicsRenderer panelRenderer = createPanelRenderer(
-		panelPipeline,
+	GraphicsRenderer textRenderer = createTextRenderer(
+		textPipeline,
 		UI_DESCENDING_GRAPHICS_RENDER_SORTING,
 		false,
 		1,
 		threadPool);
 
-	if (!panelRenderer)
+	if (!textRenderer)
 	{
 		destroyUserInterface(userInterface);
 		return OUT_OF_HOST_MEMORY_MPGX_RESULT;
 	}
 
-	userInterface->panelRenderer = panelRenderer;
+	userInterface->textRenderer = textRenderer;
 
-	GraphicsRenderer textRenderer = createTextRenderer(
-		textPipeline,
-		UI_DESCENDING_GRAPHICS_RENDER_SORTING,
-		false,
-		1,
-		threadPool);
+	GraphicsRenderer panelRenderer;
 
-	if (!textRenderer)
+	// Panels are merged with the texts into one vertex stream,
+	// they sample white texel of the default font atlas.
+	if (!isTextPipelinePacked(textPipeline))
+	{
+		MpgxResult mpgxResult = warmUserInterfaceFontAtlas(
+			userInterface,
+			(cmmt_float_t)1.0);
+
+		if (mpgxResult != SUCCESS_MPGX_RESULT)
+		{
+			destroyUserInterface(userInterface);
+			return mpgxResult;
+		}
+
+		panelRenderer = createBatchedPanelRenderer(
+			textPipeline,
+			UI_DESCENDING_GRAPHICS_RENDER_SORTING,
+			false,
+			1,
+			threadPool);
+	}
+	else
+	{
+		panelRenderer = createPanelRenderer(
+			panelPipeline,
+			UI_DESCENDING_GRAPHICS_RENDER_SORTING,
+			false,
+			1,
+			threadPool);
+	}
+
+	if (!panelRenderer)
 	{
 		destroyUserInterface(userInterface);
 		return OUT_OF_HOST_MEMORY_MPGX_RESULT;
 	}
 
-	userInterface->textRenderer = textRenderer;
+	userInterface->panelRenderer = panelRenderer;
 
 	GraphicsRender cursorRender = createCursorRenderInstance(
 		transformer,
@@ -317,15 +490,48 @@ void destroyUserInterface(UserInterface ui)
 	if (!ui)
 		return;
 
+	ui->focusedInputField = NULL;
 	destroyCursorRenderInstance(ui->cursorRender);
 	destroyGraphicsRenderer(ui->textRenderer);
 	destroyGraphicsRenderer(ui->panelRenderer);
 	destroyInterface(ui->interface);
 	destroyTransformer(ui->transformer);
-	free(ui->fontAtlases);
+	free(ui->labelTexts);
+	free(ui->focusElements);
+
+	uint32_t* inputBuffer = ui->inputBuffer;
+
+	if (inputBuffer)
+	{
+		OPENSSL_cleanse(inputBuffer,
+			ui->inputCapacity * sizeof(uint32_t));
+		free(inputBuffer);
+	}
+
+	FontAtlas* fontAtlases = ui->fontAtlases;
+
+	if (fontAtlases)
+	{
+		size_t fontAtlasCount = ui->fontAtlasCount;
+
+		for (size_t i = 0; i < fontAtlasCount; i++)
+			destroyFontAtlas(fontAtlases[i]);
+	}
+
+	for (uint8_t i = 0; i < CUSTOM_UI_TYPES; i++)
+		destroySlab(ui->handleSlabs[i]);
+
+	free(fontAtlases);
+	free(ui->fontSizes);
+	free(ui->fonts);
 	free(ui);
 }
 
+GraphicsPipeline getUserInterfacePanelPipeline(UserInterface ui)
+{
+	assert(ui);
+	return ui->panelPipeline;
+}
 GraphicsRenderer getUserInterfacePanelRenderer(UserInterface ui)
 {
 	assert(ui);
@@ -336,16 +542,51 @@ GraphicsRenderer getUserInterfaceTextRenderer(UserInterface ui)
 	assert(ui);
 	return ui->textRenderer;
 }
+Font* getUserInterfaceRegularFonts(UserInterface ui)
+{
+	assert(ui);
+	return ui->fonts;
+}
+Font* getUserInterfaceBoldFonts(UserInterface ui)
+{
+	assert(ui);
+	return ui->fonts + ui->fontCount;
+}
+Font* getUserInterfaceItalicFonts(UserInterface ui)
+{
+	assert(ui);
+	return ui->fonts + ui->fontCount * 2;
+}
+Font* getUserInterfaceBoldItalicFonts(UserInterface ui)
+{
+	assert(ui);
+	return ui->fonts + ui->fontCount * 3;
+}
+size_t getUserInterfaceFontCount(UserInterface ui)
+{
+	assert(ui);
+	return ui->fontCount;
+}
 FontAtlas* getUserInterfaceFontAtlases(UserInterface ui)
 {
 	assert(ui);
 	return ui->fontAtlases;
 }
+const uint32_t* getUserInterfaceFontSizes(UserInterface ui)
+{
+	assert(ui);
+	return ui->fontSizes;
+}
 size_t getUserInterfaceFontAtlasCount(UserInterface ui)
 {
 	assert(ui);
 	return ui->fontAtlasCount;
 }
+Logger getUserInterfaceLogger(UserInterface ui)
+{
+	assert(ui);
+	return ui->logger;
+}
 Transformer getUserInterfaceTransformer(UserInterface ui)
 {
 	assert(ui);
@@ -362,154 +603,194 @@ GraphicsRender getUserInterfaceCursor(UserInterface ui)
 	return ui->cursorRender;
 }
 
-typedef struct TabData
-{
-	InterfaceElement element;
-	Vec3F position;
-	cmmt_float_t value;
-} TabData;
-static void onTabBottomElement(
-	InterfaceElement element,
-	void* handle)
+/*
+ * Input fields are kept in the focus order, sorted by the
+ * tab index and then by the creation order, so the next
+ * field is found without enumerating all elements.
+ */
+inline static bool insertUiFocusElement(
+	UserInterface ui,
+	InterfaceElement element)
 {
+	assert(ui);
 	assert(element);
-	assert(handle);
 
-	TabData* data = (TabData*)handle;
-	UiBaseHandle base = getInterfaceElementHandle(element);
-	Transform transform = getInterfaceElementTransform(element);
+	size_t focusCount = ui->focusCount;
 
-	if (!isTransformActive(transform) ||
-		!isInterfaceElementEnabled(element) ||
-		base->type != INPUT_FIELD_UI_TYPE)
+	if (focusCount == ui->focusCapacity)
 	{
-		return;
+		size_t capacity = ui->focusCapacity > 0 ?
+			ui->focusCapacity * 2 : 16;
+
+		InterfaceElement* focusElements = realloc(
+			ui->focusElements,
+			capacity * sizeof(InterfaceElement));
+
+		if (!focusElements)
+			return false;
+
+		ui->focusElements = focusElements;
+		ui->focusCapacity = capacity;
 	}
 
-	Vec3F basePosition = data->position;
-	Vec3F newPosition = getInterfaceElementPosition(element);
-	cmmt_float_t distancePow = distPowVec3F(basePosition, newPosition);
+	InterfaceElement* focusElements = ui->focusElements;
+	UiInputFieldHandle handle = getInterfaceElementHandle(element);
+	uint32_t tabIndex = handle->tabIndex;
+	uint64_t focusOrder = handle->focusOrder;
+	size_t index = focusCount;
 
-	if (distancePow >= data->value ||
-		(newPosition.x >= basePosition.x &&
-		newPosition.y >= basePosition.y))
+	while (index > 0)
 	{
-		return;
+		InterfaceElement lastElement = focusElements[index - 1];
+		UiInputFieldHandle lastHandle =
+			getInterfaceElementHandle(lastElement);
+
+		if (lastHandle->tabIndex < tabIndex ||
+			(lastHandle->tabIndex == tabIndex &&
+			lastHandle->focusOrder < focusOrder))
+		{
+			break;
+		}
+
+		focusElements[index] = lastElement;
+		lastHandle->focusIndex = index;
+		index--;
 	}
 
-	data->element = element;
-	data->value = distancePow;
+	focusElements[index] = element;
+	handle->focusIndex = index;
+	ui->focusCount = focusCount + 1;
+	return true;
 }
-static void onTabTopElement(
-	InterfaceElement element,
-	void* handle)
+inline static void removeUiFocusElement(
+	UserInterface ui,
+	UiInputFieldHandle handle)
 {
-	assert(element);
+	assert(ui);
 	assert(handle);
+	assert(handle->focusIndex < ui->focusCount);
 
-	TabData* data = (TabData*)handle;
-	UiBaseHandle base = getInterfaceElementHandle(element);
-	Transform transform = getInterfaceElementTransform(element);
+	InterfaceElement* focusElements = ui->focusElements;
+	size_t focusCount = ui->focusCount;
 
-	if (!isTransformActive(transform) ||
-		!isInterfaceElementEnabled(element) ||
-		base->type != INPUT_FIELD_UI_TYPE)
+	for (size_t i = handle->focusIndex + 1; i < focusCount; i++)
 	{
-		return;
+		InterfaceElement element = focusElements[i];
+		UiInputFieldHandle elementHandle =
+			getInterfaceElementHandle(element);
+		elementHandle->focusIndex = i - 1;
+		focusElements[i - 1] = element;
 	}
 
-	Vec3F basePosition = data->position;
-	Vec3F newPosition = getInterfaceElementPosition(element);
-	cmmt_float_t distancePow = distPowVec3F(basePosition, newPosition);
+	handle->focusIndex = SIZE_MAX;
+	ui->focusCount = focusCount - 1;
+}
+inline static bool isUiElementFocusable(InterfaceElement element)
+{
+	assert(element);
+
+	if (!isInterfaceElementEnabled(element))
+		return false;
+
+	Transform transform = getInterfaceElementTransform(element);
 
-	if (distancePow <= data->value ||
-		(newPosition.x <= basePosition.x &&
-		newPosition.y <= basePosition.y))
+	while (transform)
 	{
-		return;
+		if (!isTransformActive(transform))
+			return false;
+		transform = getTransformParent(transform);
 	}
 
-	data->element = element;
-	data->value = distancePow;
+	return true;
 }
-static void onTabAnyElement(
-	InterfaceElement element,
-	void* handle)
+inline static InterfaceElement getNextUiFocusElement(
+	UserInterface ui,
+	bool isReverse)
 {
-	assert(element);
-	assert(handle);
+	assert(ui);
 
-	TabData* data = (TabData*)handle;
-	UiBaseHandle base = getInterfaceElementHandle(element);
-	Transform transform = getInterfaceElementTransform(element);
+	size_t focusCount = ui->focusCount;
+
+	if (focusCount == 0)
+		return NULL;
+
+	InterfaceElement* focusElements = ui->focusElements;
+	InterfaceElement focusedInputField = ui->focusedInputField;
+	size_t index, stepCount;
 
-	if (!isTransformActive(transform) ||
-		!isInterfaceElementEnabled(element) ||
-		base->type != INPUT_FIELD_UI_TYPE)
+	if (focusedInputField)
 	{
-		return;
+		UiInputFieldHandle handle =
+			getInterfaceElementHandle(focusedInputField);
+		index = handle->focusIndex;
+		stepCount = focusCount - 1;
+	}
+	else
+	{
+		index = isReverse ? 0 : focusCount - 1;
+		stepCount = focusCount;
 	}
 
-	Vec3F bestPosition = data->position;
-	Vec3F newPosition = getInterfaceElementPosition(element);
-
-	if (newPosition.x <= bestPosition.x &&
-		newPosition.y <= bestPosition.y)
+	// Disabled and hidden fields are skipped,
+	// and the focus wraps around the order.
+	for (size_t i = 0; i < stepCount; i++)
 	{
-		return;
+		index = isReverse ?
+			(index + focusCount - 1) % focusCount :
+			(index + 1) % focusCount;
+
+		InterfaceElement element = focusElements[index];
+
+		if (isUiElementFocusable(element))
+			return element;
 	}
 
-	data->element = element;
-	data->position = newPosition;
+	return NULL;
 }
-inline static MpgxResult bakeInputFieldText(
-	Text text,
-	uint32_t mask)
+/*
+ * Reserves the user interface input buffer, which is
+ * reused by the input fields and securely wiped after use.
+ */
+inline static uint32_t* reserveUiInputBuffer(
+	UserInterface ui,
+	size_t length)
 {
-	assert(text);
-
-	MpgxResult mpgxResult = OUT_OF_HOST_MEMORY_MPGX_RESULT;
-	size_t length = getTextLength(text);
+	assert(ui);
 
-	if (length > 0 && mask != 0)
-	{
-		const uint32_t* string = getTextString(text);
-		uint32_t* textString = malloc(length * 2 * sizeof(uint32_t));
+	if (length <= ui->inputCapacity)
+		return ui->inputBuffer;
 
-		if (textString)
-		{
-			uint32_t* maskString = textString + length;
+	size_t capacity = ui->inputCapacity > 0 ?
+		ui->inputCapacity * 2 : 64;
 
-			memcpy(textString, string,
-				length * sizeof(uint32_t));
+	if (capacity < length)
+		capacity = length;
 
-			for (size_t i = 0; i < length; ++i)
-				maskString[i] = mask;
+	uint32_t* inputBuffer = malloc(
+		capacity * sizeof(uint32_t));
 
-			bool result = setTextString(text, maskString, length);
+	if (!inputBuffer)
+		return NULL;
 
-			if (result)
-			{
-				mpgxResult = bakeText(text);
-				setTextString(text, textString, length);
-			}
-		}
+	// Old buffer is wiped instead of reallocated,
+	// so the input characters are never left in memory.
+	uint32_t* oldBuffer = ui->inputBuffer;
 
-		OPENSSL_cleanse(textString, length * 2 * sizeof(uint32_t));
-		free(textString);
-	}
-	else
+	if (oldBuffer)
 	{
-		mpgxResult = bakeText(text);
+		OPENSSL_cleanse(oldBuffer,
+			ui->inputCapacity * sizeof(uint32_t));
+		free(oldBuffer);
 	}
 
-	return mpgxResult;
+	ui->inputBuffer = inputBuffer;
+	ui->inputCapacity = capacity;
+	return inputBuffer;
 }
 inline static void updateCursor(
 	UserInterface ui,
 	Transform textTransform,
-	Text text,
-	uint32_t mask)
+	Text text)
 {
 	assert(ui);
 	assert(textTransform);
@@ -521,46 +802,10 @@ inline static void updateCursor(
 
 	Vec2F cursorOffset;
 
-	bool offsetResult = false;
-
-	if (getTextLength(text) > 0 && mask != 0)
-	{
-		const uint32_t* string = getTextString(text);
-		size_t length = getTextLength(text);
-		uint32_t* textString = malloc(length * 2 * sizeof(uint32_t));
-
-		if (textString)
-		{
-			uint32_t* maskString = textString + length;
-
-			memcpy(textString, string,
-				length * sizeof(uint32_t));
-
-			for (size_t i = 0; i < length; ++i)
-				maskString[i] = mask;
-
-			bool result = setTextString(text, maskString, length);
-
-			if (result)
-			{
-				offsetResult = getTextCursorAdvance(
-					text,
-					ui->cursorIndex,
-					&cursorOffset);
-				setTextString(text, textString, length);
-			}
-		}
-
-		OPENSSL_cleanse(textString, length * 2 * sizeof(uint32_t));
-		free(textString);
-	}
-	else
-	{
-		offsetResult = getTextCursorAdvance(
-			text,
-			ui->cursorIndex,
-			&cursorOffset);
-	}
+	bool offsetResult = getTextCursorAdvance(
+		text,
+		ui->cursorIndex,
+		&cursorOffset);
 
 	if (offsetResult)
 	{
@@ -616,50 +861,19 @@ inline static void updateInputFields(UserInterface ui)
 	{
 		if (!ui->isTabPressed)
 		{
-			TabData data;
-			data.element = NULL;
+			bool isReverse =
+				getWindowKeyboardKey(window, LEFT_SHIFT_KEYBOARD_KEY) ||
+				getWindowKeyboardKey(window, RIGHT_SHIFT_KEYBOARD_KEY);
+			InterfaceElement element = getNextUiFocusElement(
+				ui, isReverse);
 
-			if (ui->focusedInputField)
+			if (element)
 			{
-				data.position = getInterfaceElementPosition(
-					ui->focusedInputField);
-				data.value = INFINITY;
-
-				enumerateInterfaceElements(
-					ui->interface,
-					onTabBottomElement,
-					&data);
-
-				if (!data.element)
-				{
-					data.value = 0.0f;
-
-					enumerateInterfaceElements(
-						ui->interface,
-						onTabTopElement,
-						&data);
-				}
-
-				if (data.element)
+				if (ui->focusedInputField)
 					defocusUserInterface(ui);
-			}
-			else
-			{
-				data.position = vec3F(
-					-INFINITY,
-					-INFINITY,
-					(cmmt_float_t)0.0);
-
-				enumerateInterfaceElements(
-					ui->interface,
-					onTabAnyElement,
-					&data);
-			}
 
-			if (data.element)
-			{
 				UiInputFieldHandle handle = (UiInputFieldHandle)
-					getInterfaceElementHandle(data.element);
+					getInterfaceElementHandle(element);
 				setPanelRenderColor(
 					handle->focusRender,
 					handle->focusedColor);
@@ -669,10 +883,10 @@ inline static void updateInputFields(UserInterface ui)
 					getTextLength(text) > 0 ?
 					handle->textRender : handle->placeholderRender);
 				ui->cursorIndex = getTextLength(text);
-				updateCursor(ui, textTransform, text, handle->mask);
+				updateCursor(ui, textTransform, text);
 
 				ui->blinkDelay = getWindowUpdateTime(window) + 0.5f;
-				ui->focusedInputField = data.element;
+				ui->focusedInputField = element;
 			}
 
 			ui->isTabPressed = true;
@@ -747,38 +961,34 @@ inline static void updateInputFields(UserInterface ui)
 			const char* clipboard = getWindowClipboard(window);
 			size_t length = strlen(clipboard);
 
-			if (length > 0)
-			{
-				uint32_t* clipboard32;
-				size_t length32;
+			uint32_t* inputBuffer = reserveUiInputBuffer(ui, length);
 
-				MpgxResult mpgxResult = allocateStringUTF32(
+			if (length > 0 && inputBuffer)
+			{
+				size_t length32 = stringUTF8toUTF32(
 					clipboard,
 					length,
-					&clipboard32,
-					&length32);
+					inputBuffer);
+
+				if (getTextLength(text) + length32 > handle->maxLength)
+					length32 = handle->maxLength - getTextLength(text);
 
-				if (mpgxResult == SUCCESS_MPGX_RESULT)
+				if (length32 > 0)
 				{
-					if (getTextLength(text) + length32 > handle->maxLength)
-						length32 = handle->maxLength - getTextLength(text);
+					bool result = appendTextString32(text,
+						inputBuffer,
+						length32,
+						ui->cursorIndex);
 
-					if (length32 > 0)
+					if (result)
 					{
-						bool result = appendTextString32(text,
-							clipboard32,
-							length32,
-							ui->cursorIndex);
-
-						if (result)
-						{
-							ui->cursorIndex += length32;
-							isTextChanged = isCursorChanged = true;
-						}
+						ui->cursorIndex += length32;
+						isTextChanged = isCursorChanged = true;
 					}
-
-					free(clipboard32);
 				}
+
+				OPENSSL_cleanse(inputBuffer,
+					length * sizeof(uint32_t));
 			}
 
 			ui->buttonDelay = ui->isButtonPressed ?
@@ -814,11 +1024,11 @@ inline static void updateInputFields(UserInterface ui)
 	{
 		if (getTextLength(text) > 0)
 		{
-			MpgxResult mpgxResult = bakeInputFieldText(text, handle->mask);
+			MpgxResult mpgxResult = bakeText(text);
 
 			if (mpgxResult != SUCCESS_MPGX_RESULT)
 			{
-				Logger logger = getFontAtlasLogger(ui->fontAtlases[0]);
+				Logger logger = ui->logger;
 
 				if (logger)
 				{
@@ -849,7 +1059,7 @@ inline static void updateInputFields(UserInterface ui)
 		Transform textTransform = getGraphicsRenderTransform(
 			getTextLength(text) > 0 ?
 			handle->textRender : handle->placeholderRender);
-		updateCursor(ui, textTransform, text, handle->mask);
+		updateCursor(ui, textTransform, text);
 	}
 
 	if (updateTime > ui->blinkDelay)
@@ -862,12 +1072,45 @@ inline static void updateInputFields(UserInterface ui)
 		ui->blinkDelay = updateTime + 0.5;
 	}
 }
+inline static void updateFontAtlases(UserInterface ui)
+{
+	assert(ui);
+
+	FontAtlas* fontAtlases = ui->fontAtlases;
+	size_t fontAtlasCount = ui->fontAtlasCount;
+
+	// Texts with the evicted glyphs are not drawn
+	// until the dynamic font atlas is updated.
+	for (size_t i = 0; i < fontAtlasCount; i++)
+	{
+		FontAtlas fontAtlas = fontAtlases[i];
+
+		if (!fontAtlas || !isFontAtlasDynamic(fontAtlas))
+			continue;
+
+		MpgxResult mpgxResult = updateFontAtlas(fontAtlas);
+
+		if (mpgxResult != SUCCESS_MPGX_RESULT)
+		{
+			Logger logger = ui->logger;
+
+			if (logger)
+			{
+				logMessage(logger, ERROR_LOG_LEVEL,
+					"Failed to update font atlas. (error: %s)",
+					mpgxResultToString(mpgxResult));
+			}
+		}
+	}
+}
 void updateUserInterface(UserInterface ui)
 {
 	assert(ui);
 	updateInputFields(ui);
+	updateFontAtlases(ui);
 	updateInterface(ui->interface);
 	updateTransformer(ui->transformer);
+	ui->modelVersion = getTransformerVersion(ui->transformer);
 }
 
 inline static Transform getUiElementTransform(InterfaceElement element)
@@ -896,6 +1139,9 @@ inline static Transform getUiElementTransform(InterfaceElement element)
 	case CHECKBOX_UI_TYPE:
 		return getGraphicsRenderTransform(
 			((UiCheckboxHandle)base)->panelRender);
+	case LIST_UI_TYPE:
+		return getGraphicsRenderTransform(
+			((UiListHandle)base)->panelRender);
 	default:
 		return NULL;
 	}
@@ -982,6 +1228,14 @@ inline static Vec4I calculateUiElementScissor(
 
 	return scissor;
 }
+typedef struct ScissorData
+{
+	Vec2I framebufferSize;
+	cmmt_float_t scale;
+	uint64_t modelVersion;
+	bool isChanged;
+} ScissorData;
+
 static void onElementScissor(
 	InterfaceElement element,
 	void* _handle)
@@ -994,16 +1248,33 @@ static void onElementScissor(
 	if (base->type >= CUSTOM_UI_TYPES)
 		return;
 
-	UserInterface ui = (UserInterface)_handle;
+	ScissorData* data = (ScissorData*)_handle;
 	Transform transform = getUiElementTransform(element);
 
 	if (!transform || !isTransformActive(transform))
 		return;
 
-	Framebuffer framebuffer = getWindowFramebuffer(ui->window);
-	cmmt_float_t scale = getPlatformScale(framebuffer) *
-		getInterfaceScale(getUserInterface(ui));
-	Vec2I framebufferSize = getFramebufferSize(framebuffer);
+	uint64_t version = getTransformVersion(transform);
+	Transform parent = getTransformParent(transform);
+
+	while (parent)
+	{
+		uint64_t parentVersion = getTransformVersion(parent);
+
+		if (parentVersion > version)
+			version = parentVersion;
+		parent = getTransformParent(parent);
+	}
+
+	if (!data->isChanged && version == base->scissorVersion)
+		return;
+
+	// Changed after the models were baked, so it is
+	// calculated again after the next interface update.
+	base->scissorVersion = version <= data->modelVersion ? version : 0;
+
+	Vec2I framebufferSize = data->framebufferSize;
+	cmmt_float_t scale = data->scale;
 
 	Vec4I scissor = calculateUiElementScissor(
 		transform, framebufferSize, scale);
@@ -1055,42 +1326,92 @@ static void onElementScissor(
 		setPanelRenderScissor(handle->checkRender, scissor);
 		setTextRenderScissor(handle->textRender, scissor);
 	}
+	else if (type == LIST_UI_TYPE)
+	{
+		UiListHandle handle = (UiListHandle)base;
+		setPanelRenderScissor(handle->panelRender, scissor);
+
+		GraphicsRender* rowRenders = handle->rowRenders;
+		size_t rowPoolCount = handle->rowPoolCount;
+
+		if (rowPoolCount == 0)
+			return;
+
+		// All rows are clipped by the same list panel.
+		scissor = calculateUiElementScissor(
+			getGraphicsRenderTransform(rowRenders[0]),
+			framebufferSize, scale);
+
+		for (size_t i = 0; i < rowPoolCount; i++)
+			setTextRenderScissor(rowRenders[i], scissor);
+	}
 	else
 	{
 		abort();
 	}
 }
-GraphicsRendererResult drawUserInterface(UserInterface ui)
+/*
+ * Scissors depend only on the interface transforms,
+ * scale and framebuffer size. Element scissor is
+ * calculated again only if its transform or parent
+ * is changed, or if the scale or size is changed.
+ * Transforms changed after the update have not baked
+ * models yet, so they are calculated after the next one.
+ */
+inline static void updateUiScissors(UserInterface ui)
 {
 	assert(ui);
 
+	Framebuffer framebuffer = getWindowFramebuffer(ui->window);
+	cmmt_float_t scale = getPlatformScale(framebuffer) *
+		getInterfaceScale(getUserInterface(ui));
+	Vec2I framebufferSize = getFramebufferSize(framebuffer);
+	uint64_t version = getTransformerVersion(ui->transformer);
+
+	bool isChanged = scale != ui->scissorScale ||
+		framebufferSize.x != ui->scissorFramebufferSize.x ||
+		framebufferSize.y != ui->scissorFramebufferSize.y;
+
+	if (!isChanged && version == ui->scissorVersion)
+		return;
+
+	ScissorData data = {
+		framebufferSize,
+		scale,
+		ui->modelVersion,
+		isChanged,
+	};
+
 	if (getInterfaceThreadPool(ui->interface))
 	{
 		threadedEnumerateInterfaceElements(
 			ui->interface,
 			onElementScissor,
-			ui);
+			&data);
 	}
 	else
 	{
 		enumerateInterfaceElements(
 			ui->interface,
 			onElementScissor,
-			ui);
+			&data);
 	}
 
-	Framebuffer framebuffer = getWindowFramebuffer(ui->window);
-	cmmt_float_t scale = getPlatformScale(framebuffer) *
-		getInterfaceScale(getUserInterface(ui));
-	Vec2I framebufferSize = getFramebufferSize(framebuffer);
 	Vec4I scissor = calculateUiElementScissor(
 		getGraphicsRenderTransform(ui->cursorRender),
 		framebufferSize, scale);
 	setPanelRenderScissor(ui->cursorRender, scissor);
 
-	GraphicsRendererResult result =
-		createGraphicsRendererResult();
-	GraphicsRendererResult tmpResult;
+	ui->scissorVersion = version == ui->modelVersion ?
+		version : UINT64_MAX;
+	ui->scissorFramebufferSize = framebufferSize;
+	ui->scissorScale = scale;
+}
+GraphicsRendererResult drawUserInterface(UserInterface ui)
+{
+	assert(ui);
+
+	updateUiScissors(ui);
 
 	Mat4F view = translateMat4F(identMat4F, vec3F(
 		(cmmt_float_t)0.0, (cmmt_float_t)0.0, (cmmt_float_t)0.5));
@@ -1099,12 +1420,13 @@ GraphicsRendererResult drawUserInterface(UserInterface ui)
 	GraphicsRendererData data = createGraphicsRenderData(
 		view, camera, false);
 
-	tmpResult = drawGraphicsRenderer(ui->panelRenderer, &data);
-	result = addGraphicsRendererResult(result, tmpResult);
+	GraphicsRenderer renderers[2] = {
+		ui->panelRenderer,
+		ui->textRenderer,
+	};
 
-	tmpResult = drawGraphicsRenderer(ui->textRenderer, &data);
-	result = addGraphicsRendererResult(result, tmpResult);
-	return result;
+	return drawGraphicsRenderers(
+		renderers, 2, &data);
 }
 void defocusUserInterface(UserInterface ui)
 {
@@ -1147,7 +1469,8 @@ static void onUiPanelDestroy(void* _handle)
 		destroyTransform(transform);
 	}
 
-	free(handle);
+	freeSlabObject(handle->ui->handleSlabs[
+		PANEL_UI_TYPE], handle);
 }
 MpgxResult createUiPanel(
 	UserInterface ui,
@@ -1169,13 +1492,15 @@ MpgxResult createUiPanel(
 	assert(!parent || (parent && ui->transformer ==
 		getTransformTransformer(parent)));
 
-	UiPanelHandle handle = calloc(1,
-		sizeof(UiPanelHandle_T));
+	UiPanelHandle handle = allocateSlabObject(
+		ui->handleSlabs[PANEL_UI_TYPE]);
 
 	if (!handle)
 		return OUT_OF_HOST_MEMORY_MPGX_RESULT;
 
 	handle->type = PANEL_UI_TYPE;
+	handle->scissorVersion = 0;
+	handle->ui = ui;
 	handle->handle = _handle;
 
 	Transform transform = createTransform(
@@ -1251,47 +1576,102 @@ GraphicsRender getUiPanelRender(InterfaceElement panel)
 	return handle->render;
 }
 
-inline static FontAtlas getBestFontAtlas(
-	Framebuffer framebuffer,
-	FontAtlas* fontAtlases,
-	size_t fontAtlasCount,
-	cmmt_float_t uiScale,
+inline static uint32_t getUiFontSize(
+	UserInterface ui,
 	cmmt_float_t fontScale)
 {
-	assert(framebuffer);
-	assert(fontAtlases);
-	assert(fontAtlasCount > 0);
+	assert(ui);
 
 	uint32_t fontSize = (uint32_t)(fontScale *
-		uiScale * getPlatformScale(framebuffer));
+		getInterfaceScale(ui->interface) *
+		getPlatformScale(getWindowFramebuffer(ui->window)));
 
 	if (fontSize % 2 != 0)
 		fontSize += 1;
+	return fontSize;
+}
+inline static MpgxResult getBestFontAtlas(
+	UserInterface ui,
+	cmmt_float_t fontScale,
+	FontAtlas* fontAtlas)
+{
+	assert(ui);
+	assert(fontAtlas);
+
+	uint32_t fontSize = getUiFontSize(ui, fontScale);
+	const uint32_t* fontSizes = ui->fontSizes;
+	size_t fontAtlasCount = ui->fontAtlasCount;
+	size_t bestIndex = 0;
 
 	for (size_t i = 0; i < fontAtlasCount; i++)
 	{
-		FontAtlas atlas = fontAtlases[i];
+		if (fontSize == fontSizes[i])
+		{
+			bestIndex = i;
+			break;
+		}
 
-		if (fontSize == getFontAtlasFontSize(atlas))
-			return atlas;
+		if (fontSizes[i] > fontSizes[bestIndex])
+			bestIndex = i;
 	}
 
-	FontAtlas biggestFontAtlas = fontAtlases[0];
-	uint32_t biggestFontSize = getFontAtlasFontSize(biggestFontAtlas);
+	FontAtlas* fontAtlases = ui->fontAtlases;
 
-	for (size_t i = 0; i < fontAtlasCount; i++)
+	if (fontAtlases[bestIndex])
 	{
-		FontAtlas atlas = fontAtlases[i];
-		uint32_t size = getFontAtlasFontSize(atlas);
+		*fontAtlas = fontAtlases[bestIndex];
+		return SUCCESS_MPGX_RESULT;
+	}
 
-		if (size > biggestFontSize)
-		{
-			biggestFontAtlas = atlas;
-			biggestFontSize = size;
-		}
+	GraphicsPipeline textPipeline =
+		getGraphicsRendererPipeline(ui->textRenderer);
+	Font* fonts = ui->fonts;
+	size_t fontCount = ui->fontCount;
+	FontAtlas fontAtlasInstance;
+	MpgxResult mpgxResult;
+
+	if (ui->onFontAtlasCreate)
+	{
+		mpgxResult = ui->onFontAtlasCreate(
+			textPipeline,
+			fonts,
+			fonts + fontCount,
+			fonts + fontCount * 2,
+			fonts + fontCount * 3,
+			fontCount,
+			fontSizes[bestIndex],
+			ui->logger,
+			ui->fontAtlasHandle,
+			&fontAtlasInstance);
+	}
+	else
+	{
+		mpgxResult = createAsciiFontAtlas(
+			textPipeline,
+			fonts,
+			fonts + fontCount,
+			fonts + fontCount * 2,
+			fonts + fontCount * 3,
+			fontCount,
+			fontSizes[bestIndex],
+			ui->logger,
+			&fontAtlasInstance);
 	}
 
-	return biggestFontAtlas;
+	if (mpgxResult != SUCCESS_MPGX_RESULT)
+		return mpgxResult;
+
+	fontAtlases[bestIndex] = fontAtlasInstance;
+	*fontAtlas = fontAtlasInstance;
+	return SUCCESS_MPGX_RESULT;
+}
+MpgxResult warmUserInterfaceFontAtlas(
+	UserInterface ui,
+	cmmt_float_t fontScale)
+{
+	assert(ui);
+	FontAtlas fontAtlas;
+	return getBestFontAtlas(ui, fontScale, &fontAtlas);
 }
 
 static void onUiLabelDestroy(void* _handle)
@@ -1311,7 +1691,8 @@ static void onUiLabelDestroy(void* _handle)
 		destroyTransform(transform);
 	}
 
-	free(handle);
+	freeSlabObject(handle->ui->handleSlabs[
+		LABEL_UI_TYPE], handle);
 }
 inline static MpgxResult internalCreateUiLabel(
 	UserInterface ui,
@@ -1343,13 +1724,14 @@ inline static MpgxResult internalCreateUiLabel(
 	assert(!parent || (parent && ui->transformer ==
 		getTransformTransformer(parent)));
 
-	UiLabelHandle handle = calloc(1,
-		sizeof(UiButtonHandle_T));
+	UiLabelHandle handle = allocateSlabObject(
+		ui->handleSlabs[LABEL_UI_TYPE]);
 
 	if (!handle)
 		return OUT_OF_HOST_MEMORY_MPGX_RESULT;
 
 	handle->type = LABEL_UI_TYPE;
+	handle->scissorVersion = 0;
 	handle->ui = ui;
 	handle->handle = _handle;
 
@@ -1375,23 +1757,21 @@ inline static MpgxResult internalCreateUiLabel(
 
 	if (isUniversal)
 	{
-		uint32_t fontSize = (uint32_t)(scale *
-			getInterfaceScale(ui->interface) *
-			getPlatformScale(getWindowFramebuffer(ui->window)));
-		FontAtlas fontAtlas = ui->fontAtlases[0];
-
-		if (fontSize % 2 != 0)
-			fontSize += 1;
+		uint32_t fontSize = getUiFontSize(ui, scale);
+		GraphicsPipeline textPipeline =
+			getGraphicsRendererPipeline(ui->textRenderer);
+		Font* fonts = ui->fonts;
+		size_t fontCount = ui->fontCount;
 
 		if (isUTF8)
 		{
 			mpgxResult = createFontText8(
-				getFontAtlasPipeline(fontAtlas),
-				getFontAtlasRegularFonts(fontAtlas),
-				getFontAtlasBoldFonts(fontAtlas),
-				getFontAtlasItalicFonts(fontAtlas),
-				getFontAtlasBoldItalicFonts(fontAtlas),
-				getFontAtlasFontCount(fontAtlas),
+				textPipeline,
+				fonts,
+				fonts + fontCount,
+				fonts + fontCount * 2,
+				fonts + fontCount * 3,
+				fontCount,
 				fontSize,
 				string,
 				stringLength,
@@ -1401,18 +1781,18 @@ inline static MpgxResult internalCreateUiLabel(
 				isItalic,
 				useTags,
 				isConstant,
-				getFontAtlasLogger(fontAtlas),
+				ui->logger,
 				&text);
 		}
 		else
 		{
 			mpgxResult = createFontText(
-				getFontAtlasPipeline(fontAtlas),
-				getFontAtlasRegularFonts(fontAtlas),
-				getFontAtlasBoldFonts(fontAtlas),
-				getFontAtlasItalicFonts(fontAtlas),
-				getFontAtlasBoldItalicFonts(fontAtlas),
-				getFontAtlasFontCount(fontAtlas),
+				textPipeline,
+				fonts,
+				fonts + fontCount,
+				fonts + fontCount * 2,
+				fonts + fontCount * 3,
+				fontCount,
 				fontSize,
 				string,
 				stringLength,
@@ -1422,18 +1802,25 @@ inline static MpgxResult internalCreateUiLabel(
 				isItalic,
 				useTags,
 				isConstant,
-				getFontAtlasLogger(fontAtlas),
+				ui->logger,
 				&text);
 		}
 	}
 	else
 	{
-		FontAtlas fontAtlas = getBestFontAtlas(
-			getWindowFramebuffer(ui->window),
-			ui->fontAtlases,
-			ui->fontAtlasCount,
-			getInterfaceScale(ui->interface),
-			scale);
+		FontAtlas fontAtlas;
+
+		mpgxResult = getBestFontAtlas(
+			ui,
+			scale,
+			&fontAtlas);
+
+		if (mpgxResult != SUCCESS_MPGX_RESULT)
+		{
+			destroyTransform(transform);
+			onUiLabelDestroy(handle);
+			return mpgxResult;
+		}
 
 		if (isUTF8)
 		{
@@ -1509,6 +1896,8 @@ inline static MpgxResult internalCreateUiLabel(
 		return OUT_OF_HOST_MEMORY_MPGX_RESULT;
 	}
 
+	// Label scale is the text height, not its size.
+	setInterfaceElementResizable(element, false);
 	setTransformHandle(transform, element);
 
 	*uiLabel = element;
@@ -1700,6 +2089,125 @@ MpgxResult setUiLabelText8(
 	return bakeText(text);
 }
 
+/*
+ * Bakes label texts together, so they are
+ * laid out across the interface thread pool.
+ */
+inline static MpgxResult bakeUiLabelTexts(
+	UserInterface ui,
+	InterfaceElement* labels,
+	size_t labelCount)
+{
+	assert(ui);
+	assert(labels);
+	assert(labelCount > 0);
+
+	if (labelCount > ui->labelTextCapacity)
+	{
+		size_t capacity = ui->labelTextCapacity > 0 ?
+			ui->labelTextCapacity * 2 : 16;
+
+		while (capacity < labelCount)
+			capacity *= 2;
+
+		Text* labelTexts = realloc(ui->labelTexts,
+			capacity * sizeof(Text));
+
+		if (!labelTexts)
+			return OUT_OF_HOST_MEMORY_MPGX_RESULT;
+
+		ui->labelTexts = labelTexts;
+		ui->labelTextCapacity = capacity;
+	}
+
+	Text* labelTexts = ui->labelTexts;
+
+	for (size_t i = 0; i < labelCount; i++)
+	{
+		UiLabelHandle handle =
+			getInterfaceElementHandle(labels[i]);
+		labelTexts[i] = getTextRenderText(handle->render);
+	}
+
+	return bakeTexts(
+		getGraphicsRendererPipeline(ui->textRenderer),
+		labelTexts,
+		labelCount,
+		getInterfaceThreadPool(ui->interface));
+}
+MpgxResult setUiLabelTexts(
+	InterfaceElement* labels,
+	const uint32_t** strings,
+	const size_t* lengths,
+	size_t labelCount)
+{
+	assert(labels);
+	assert(strings);
+	assert(lengths);
+
+	if (labelCount == 0)
+		return SUCCESS_MPGX_RESULT;
+
+	UserInterface ui = ((UiLabelHandle)
+		getInterfaceElementHandle(labels[0]))->ui;
+
+	for (size_t i = 0; i < labelCount; i++)
+	{
+		UiLabelHandle handle =
+			getInterfaceElementHandle(labels[i]);
+		Text text = getTextRenderText(handle->render);
+		assert(handle->type == LABEL_UI_TYPE);
+		assert(handle->ui == ui);
+		assert(!isTextConstant(text));
+		assert(lengths[i] == 0 ||
+			(lengths[i] > 0 && strings[i]));
+
+		bool result = setTextString(text,
+			strings[i], lengths[i]);
+
+		if (!result)
+			return OUT_OF_HOST_MEMORY_MPGX_RESULT;
+	}
+
+	return bakeUiLabelTexts(ui, labels, labelCount);
+}
+MpgxResult setUiLabelTexts8(
+	InterfaceElement* labels,
+	const char** strings,
+	const size_t* lengths,
+	size_t labelCount)
+{
+	assert(labels);
+	assert(strings);
+	assert(lengths);
+
+	if (labelCount == 0)
+		return SUCCESS_MPGX_RESULT;
+
+	UserInterface ui = ((UiLabelHandle)
+		getInterfaceElementHandle(labels[0]))->ui;
+
+	for (size_t i = 0; i < labelCount; i++)
+	{
+		UiLabelHandle handle =
+			getInterfaceElementHandle(labels[i]);
+		Text text = getTextRenderText(handle->render);
+		assert(handle->type == LABEL_UI_TYPE);
+		assert(handle->ui == ui);
+		assert(!isTextConstant(text));
+		assert(lengths[i] == 0 ||
+			(lengths[i] > 0 && strings[i]));
+
+		bool result = setTextString8(text,
+			strings[i], lengths[i]);
+
+		if (!result)
+			return OUT_OF_HOST_MEMORY_MPGX_RESULT;
+	}
+
+	return bakeUiLabelTexts(ui, labels, labelCount);
+}
+
 static void onUiWindowPress(InterfaceElement element)
 {
 	assert(element);
@@ -1785,7 +2293,8 @@ static void onUiWindowDestroy(void* _handle)
 		destroyTransform(transform);
 	}
 
-	free(handle);
+	freeSlabObject(handle->ui->handleSlabs[
+		WINDOW_UI_TYPE], handle);
 }
 inline static MpgxResult internalCreateUiWindow(
 	UserInterface ui,
@@ -1812,13 +2321,14 @@ inline static MpgxResult internalCreateUiWindow(
 	assert(!parent || (parent && ui->transformer ==
 		getTransformTransformer(parent)));
 
-	UiWindowHandle handle = calloc(1,
-		sizeof(UiWindowHandle_T));
+	UiWindowHandle handle = allocateSlabObject(
+		ui->handleSlabs[WINDOW_UI_TYPE]);
 
 	if (!handle)
 		return OUT_OF_HOST_MEMORY_MPGX_RESULT;
 
 	handle->type = WINDOW_UI_TYPE;
+	handle->scissorVersion = 0;
 	handle->ui = ui;
 	handle->handle = _handle;
 	handle->lastCursorPosition = zeroVec2F;
@@ -1928,15 +2438,21 @@ inline static MpgxResult internalCreateUiWindow(
 		return OUT_OF_HOST_MEMORY_MPGX_RESULT;
 	}
 
-	FontAtlas fontAtlas = getBestFontAtlas(
-		getWindowFramebuffer(ui->window),
-		ui->fontAtlases,
-		ui->fontAtlasCount,
-		getInterfaceScale(ui->interface),
-		DEFAULT_UI_TEXT_HEIGHT);
+	FontAtlas fontAtlas;
+
+	MpgxResult mpgxResult = getBestFontAtlas(
+		ui,
+		DEFAULT_UI_TEXT_HEIGHT,
+		&fontAtlas);
+
+	if (mpgxResult != SUCCESS_MPGX_RESULT)
+	{
+		destroyTransform(titleTransform);
+		onUiWindowDestroy(handle);
+		return mpgxResult;
+	}
 
 	Text text;
-	MpgxResult mpgxResult;
 
 	if (isUTF8)
 	{
@@ -2262,7 +2778,8 @@ static void onUiButtonDestroy(void* _handle)
 		destroyTransform(transform);
 	}
 
-	free(handle);
+	freeSlabObject(handle->ui->handleSlabs[
+		BUTTON_UI_TYPE], handle);
 }
 inline static MpgxResult internalCreateUiButton(
 	UserInterface ui,
@@ -2290,13 +2807,14 @@ inline static MpgxResult internalCreateUiButton(
 	assert(!parent || (parent && ui->transformer ==
 		getTransformTransformer(parent)));
 
-	UiButtonHandle handle = calloc(1,
-		sizeof(UiButtonHandle_T));
+	UiButtonHandle handle = allocateSlabObject(
+		ui->handleSlabs[BUTTON_UI_TYPE]);
 
 	if (!handle)
 		return OUT_OF_HOST_MEMORY_MPGX_RESULT;
 
 	handle->type = BUTTON_UI_TYPE;
+	handle->scissorVersion = 0;
 	handle->ui = ui;
 	handle->handle = _handle;
 	handle->disabledColor = srgbToLinearColor(DEFAULT_UI_DISABLED_BUTTON_COLOR);
@@ -2369,15 +2887,21 @@ inline static MpgxResult internalCreateUiButton(
 			return OUT_OF_HOST_MEMORY_MPGX_RESULT;
 		}
 
-		FontAtlas fontAtlas = getBestFontAtlas(
-			getWindowFramebuffer(ui->window),
-			ui->fontAtlases,
-			ui->fontAtlasCount,
-			getInterfaceScale(ui->interface),
-			DEFAULT_UI_TEXT_HEIGHT + 2);
+		FontAtlas fontAtlas;
+
+		MpgxResult mpgxResult = getBestFontAtlas(
+			ui,
+			DEFAULT_UI_TEXT_HEIGHT + 2,
+			&fontAtlas);
+
+		if (mpgxResult != SUCCESS_MPGX_RESULT)
+		{
+			destroyTransform(textTransform);
+			onUiButtonDestroy(handle);
+			return mpgxResult;
+		}
 
 		Text textInstance;
-		MpgxResult mpgxResult;
 
 		if (isUTF8)
 		{
@@ -2787,43 +3311,10 @@ static void onUiInputFieldPress(InterfaceElement element)
 	cursorPosition.y = (cursorPosition.y - textPosition.y) / textScale.y;
 
 	size_t index = 0;
-
-	if (getTextLength(text) > 0 && handle->mask != 0)
-	{
-		const uint32_t* string = getTextString(text);
-		size_t length = getTextLength(text);
-		uint32_t* textString = malloc(length * 2 * sizeof(uint32_t));
-
-		if (textString)
-		{
-			uint32_t* maskString = textString + length;
-
-			memcpy(textString, string,
-				length * sizeof(uint32_t));
-			uint32_t mask = handle->mask;
-
-			for (size_t i = 0; i < length; ++i)
-				maskString[i] = mask;
-
-			bool result = setTextString(text, maskString, length);
-
-			if (result)
-			{
-				getTextCursorIndex(text, cursorPosition, &index);
-				setTextString(text, textString, length);
-			}
-		}
-
-		OPENSSL_cleanse(textString, length * 2 * sizeof(uint32_t));
-		free(textString);
-	}
-	else
-	{
-		getTextCursorIndex(text, cursorPosition, &index);
-	}
+	getTextCursorIndex(text, cursorPosition, &index);
 
 	ui->cursorIndex = index;
-	updateCursor(ui, textTransform, text, handle->mask);
+	updateCursor(ui, textTransform, text);
 
 	ui->blinkDelay = getWindowUpdateTime(window) + 0.5f;
 	ui->focusedInputField = element;
@@ -2837,6 +3328,22 @@ static void onUiInputFieldDestroy(void* _handle)
 	UiInputFieldHandle handle = (UiInputFieldHandle)_handle;
 	assert(handle->type == INPUT_FIELD_UI_TYPE);
 
+	UserInterface ui = handle->ui;
+	InterfaceElement focusedInputField = ui->focusedInputField;
+
+	if (focusedInputField &&
+		getInterfaceElementHandle(focusedInputField) == handle)
+	{
+		Transform cursorTransform = getGraphicsRenderTransform(
+			ui->cursorRender);
+		setTransformParent(cursorTransform, NULL);
+		setTransformActive(cursorTransform, false);
+		ui->focusedInputField = NULL;
+	}
+
+	if (handle->focusIndex != SIZE_MAX)
+		removeUiFocusElement(ui, handle);
+
 	Transform transform;
 	GraphicsRender render = handle->placeholderRender;
 
@@ -2878,7 +3385,8 @@ static void onUiInputFieldDestroy(void* _handle)
 		destroyTransform(transform);
 	}
 
-	free(handle);
+	freeSlabObject(ui->handleSlabs[
+		INPUT_FIELD_UI_TYPE], handle);
 }
 inline static MpgxResult internalCreateUiInputField(
 	UserInterface ui,
@@ -2911,13 +3419,14 @@ inline static MpgxResult internalCreateUiInputField(
 	assert(!parent || (parent && ui->transformer ==
 		getTransformTransformer(parent)));
 
-	UiInputFieldHandle handle = calloc(1,
-		sizeof(UiInputFieldHandle_T));
+	UiInputFieldHandle handle = allocateSlabObject(
+		ui->handleSlabs[INPUT_FIELD_UI_TYPE]);
 
 	if (!handle)
 		return OUT_OF_HOST_MEMORY_MPGX_RESULT;
 
 	handle->type = INPUT_FIELD_UI_TYPE;
+	handle->scissorVersion = 0;
 	handle->ui = ui;
 	handle->handle = _handle;
 	handle->onChange = onChange;
@@ -2926,7 +3435,9 @@ inline static MpgxResult internalCreateUiInputField(
 	handle->enabledColor = srgbToLinearColor(DEFAULT_UI_ENABLED_INPUT_COLOR);
 	handle->focusedColor = srgbToLinearColor(DEFAULT_UI_FOCUSED_INPUT_COLOR);
 	handle->maxLength = maxLength;
-	handle->mask = mask;
+	handle->focusOrder = ui->focusOrder++;
+	handle->focusIndex = SIZE_MAX;
+	handle->tabIndex = 0;
 
 	Transformer transformer = ui->transformer;
 	GraphicsRenderer panelRenderer = ui->panelRenderer;
@@ -3034,23 +3545,21 @@ inline static MpgxResult internalCreateUiInputField(
 
 	Text textInstance;
 
-	uint32_t fontSize = (uint32_t)(DEFAULT_UI_TEXT_HEIGHT *
-		getInterfaceScale(ui->interface) *
-		getPlatformScale(getWindowFramebuffer(ui->window)));
-
-	if (fontSize % 2 != 0)
-		fontSize += 1;
+	uint32_t fontSize = getUiFontSize(ui, DEFAULT_UI_TEXT_HEIGHT);
+	GraphicsPipeline textPipeline =
+		getGraphicsRendererPipeline(ui->textRenderer);
+	Font* fonts = ui->fonts;
+	size_t fontCount = ui->fontCount;
 
 	const uint32_t text[] = { '-', };
-	FontAtlas fontAtlas = ui->fontAtlases[0];
 
 	MpgxResult mpgxResult = createFontText(
-		getFontAtlasPipeline(fontAtlas),
-		getFontAtlasRegularFonts(fontAtlas),
-		getFontAtlasBoldFonts(fontAtlas),
-		getFontAtlasItalicFonts(fontAtlas),
-		getFontAtlasBoldItalicFonts(fontAtlas),
-		getFontAtlasFontCount(fontAtlas),
+		textPipeline,
+		fonts,
+		fonts + fontCount,
+		fonts + fontCount * 2,
+		fonts + fontCount * 3,
+		fontCount,
 		fontSize,
 		text,
 		1,
@@ -3060,7 +3569,7 @@ inline static MpgxResult internalCreateUiInputField(
 		false,
 		false,
 		false,
-		getFontAtlasLogger(fontAtlas),
+		ui->logger,
 		&textInstance);
 
 	if (mpgxResult != SUCCESS_MPGX_RESULT)
@@ -3071,6 +3580,7 @@ inline static MpgxResult internalCreateUiInputField(
 	}
 
 	removeTextChar(textInstance, 0);
+	setTextMask(textInstance, mask);
 
 	GraphicsRender textRender = createTextRender(
 		textRenderer,
@@ -3115,12 +3625,19 @@ inline static MpgxResult internalCreateUiInputField(
 		return OUT_OF_HOST_MEMORY_MPGX_RESULT;
 	}
 
-	fontAtlas = getBestFontAtlas(
-		getWindowFramebuffer(ui->window),
-		ui->fontAtlases,
-		ui->fontAtlasCount,
-		getInterfaceScale(ui->interface),
-		DEFAULT_UI_TEXT_HEIGHT);
+	FontAtlas fontAtlas;
+
+	mpgxResult = getBestFontAtlas(
+		ui,
+		DEFAULT_UI_TEXT_HEIGHT,
+		&fontAtlas);
+
+	if (mpgxResult != SUCCESS_MPGX_RESULT)
+	{
+		destroyTransform(placeholderTransform);
+		onUiInputFieldDestroy(handle);
+		return mpgxResult;
+	}
 
 	Text placeholderInstance;
 
@@ -3215,6 +3732,12 @@ inline static MpgxResult internalCreateUiInputField(
 	setTransformHandle(textTransform, element);
 	setTransformHandle(placeholderTransform, element);
 
+	if (!insertUiFocusElement(ui, element))
+	{
+		destroyInterfaceElement(element);
+		return OUT_OF_HOST_MEMORY_MPGX_RESULT;
+	}
+
 	*uiInputField = element;
 	return SUCCESS_MPGX_RESULT;
 }
@@ -3421,6 +3944,33 @@ size_t getUiInputFieldMaxLength(InterfaceElement inputField)
 	assert(handle->type == INPUT_FIELD_UI_TYPE);
 	return handle->maxLength;
 }
+uint32_t getUiInputFieldTabIndex(InterfaceElement inputField)
+{
+	assert(inputField);
+	UiInputFieldHandle handle =
+		getInterfaceElementHandle(inputField);
+	assert(handle->type == INPUT_FIELD_UI_TYPE);
+	return handle->tabIndex;
+}
+void setUiInputFieldTabIndex(
+	InterfaceElement inputField,
+	uint32_t tabIndex)
+{
+	assert(inputField);
+	UiInputFieldHandle handle =
+		getInterfaceElementHandle(inputField);
+	assert(handle->type == INPUT_FIELD_UI_TYPE);
+
+	if (tabIndex == handle->tabIndex)
+		return;
+
+	UserInterface ui = handle->ui;
+	removeUiFocusElement(ui, handle);
+	handle->tabIndex = tabIndex;
+
+	// Removed place is reused, so insertion can not fail.
+	insertUiFocusElement(ui, inputField);
+}
 bool isUiInputFieldFocused(InterfaceElement inputField)
 {
 	assert(inputField);
@@ -3497,7 +4047,8 @@ uint32_t getUiInputFieldMask(
 	UiInputFieldHandle handle =
 		getInterfaceElementHandle(inputField);
 	assert(handle->type == INPUT_FIELD_UI_TYPE);
-	return handle->mask;
+	Text text = getTextRenderText(handle->textRender);
+	return getTextMask(text);
 }
 MpgxResult setUiInputFieldMask(
 	InterfaceElement inputField,
@@ -3509,21 +4060,24 @@ MpgxResult setUiInputFieldMask(
 	assert(handle->type == INPUT_FIELD_UI_TYPE);
 	Text text = getTextRenderText(handle->textRender);
 
+	if (getTextMask(text) == mask)
+		return SUCCESS_MPGX_RESULT;
+
+	setTextMask(text, mask);
+
 	if (getTextLength(text) > 0)
 	{
 		UserInterface ui = handle->ui;
-		MpgxResult mpgxResult = bakeInputFieldText(text, mask);
+		MpgxResult mpgxResult = bakeText(text);
 
 		if (mpgxResult != SUCCESS_MPGX_RESULT)
 			return mpgxResult;
 
 		Transform textTransform = getGraphicsRenderTransform(
-			getTextLength(text) > 0 ?
-			handle->textRender : handle->placeholderRender);
-		updateCursor(ui, textTransform, text, handle->mask);
+			handle->textRender);
+		updateCursor(ui, textTransform, text);
 	}
 
-	handle->mask = mask;
 	return SUCCESS_MPGX_RESULT;
 }
 
@@ -3569,7 +4123,7 @@ MpgxResult setUiInputFieldText(
 	if (!result)
 		return OUT_OF_HOST_MEMORY_MPGX_RESULT;
 
-	MpgxResult mpgxResult = bakeInputFieldText(text, handle->mask);
+	MpgxResult mpgxResult = bakeText(text);
 
 	if (mpgxResult != SUCCESS_MPGX_RESULT)
 		return mpgxResult;
@@ -3595,7 +4149,7 @@ MpgxResult setUiInputFieldText(
 		Transform textTransform = getGraphicsRenderTransform(
 			getTextLength(text) > 0 ?
 			handle->textRender : handle->placeholderRender);
-		updateCursor(ui, textTransform, text, handle->mask);
+		updateCursor(ui, textTransform, text);
 	}
 
 	return SUCCESS_MPGX_RESULT;
@@ -3619,7 +4173,7 @@ MpgxResult setUiInputFieldText8(
 	if (!result)
 		return OUT_OF_HOST_MEMORY_MPGX_RESULT;
 
-	MpgxResult mpgxResult = bakeInputFieldText(text, handle->mask);
+	MpgxResult mpgxResult = bakeText(text);
 
 	if (mpgxResult != SUCCESS_MPGX_RESULT)
 		return mpgxResult;
@@ -3645,7 +4199,7 @@ MpgxResult setUiInputFieldText8(
 		Transform textTransform = getGraphicsRenderTransform(
 			getTextLength(text) > 0 ?
 			handle->textRender : handle->placeholderRender);
-		updateCursor(ui, textTransform, text, handle->mask);
+		updateCursor(ui, textTransform, text);
 	}
 
 	return SUCCESS_MPGX_RESULT;
@@ -3782,7 +4336,8 @@ static void onUiCheckboxDestroy(void* _handle)
 		destroyTransform(transform);
 	}
 
-	free(handle);
+	freeSlabObject(handle->ui->handleSlabs[
+		CHECKBOX_UI_TYPE], handle);
 }
 inline static MpgxResult internalCreateUiCheckbox(
 	UserInterface ui,
@@ -3810,13 +4365,14 @@ inline static MpgxResult internalCreateUiCheckbox(
 	assert(!parent || (parent && ui->transformer ==
 		getTransformTransformer(parent)));
 
-	UiCheckboxHandle handle = calloc(1,
-		sizeof(UiCheckboxHandle_T));
+	UiCheckboxHandle handle = allocateSlabObject(
+		ui->handleSlabs[CHECKBOX_UI_TYPE]);
 
 	if (!handle)
 		return OUT_OF_HOST_MEMORY_MPGX_RESULT;
 
 	handle->type = CHECKBOX_UI_TYPE;
+	handle->scissorVersion = 0;
 	handle->ui = ui;
 	handle->handle = _handle;
 	handle->disabledColor = srgbToLinearColor(DEFAULT_UI_DISABLED_CHECKBOX_COLOR);
@@ -3965,15 +4521,21 @@ inline static MpgxResult internalCreateUiCheckbox(
 		return OUT_OF_HOST_MEMORY_MPGX_RESULT;
 	}
 
-	FontAtlas fontAtlas = getBestFontAtlas(
-		getWindowFramebuffer(ui->window),
-		ui->fontAtlases,
-		ui->fontAtlasCount,
-		getInterfaceScale(ui->interface),
-		DEFAULT_UI_TEXT_HEIGHT);
+	FontAtlas fontAtlas;
+
+	MpgxResult mpgxResult = getBestFontAtlas(
+		ui,
+		DEFAULT_UI_TEXT_HEIGHT,
+		&fontAtlas);
+
+	if (mpgxResult != SUCCESS_MPGX_RESULT)
+	{
+		destroyTransform(textTransform);
+		onUiCheckboxDestroy(handle);
+		return mpgxResult;
+	}
 
 	Text textInstance;
-	MpgxResult mpgxResult;
 
 	if (isUTF8)
 	{
@@ -4346,3 +4908,638 @@ void setCheckboxChecked(
 		isChecked);
 	handle->isChecked = isChecked;
 }
+
+static void onUiListDestroy(void* _handle)
+{
+	assert(_handle);
+	UiListHandle handle = (UiListHandle)_handle;
+	assert(handle->type == LIST_UI_TYPE);
+
+	Transform transform;
+	GraphicsRender* rowRenders = handle->rowRenders;
+	size_t rowPoolCount = handle->rowPoolCount;
+
+	for (size_t i = 0; i < rowPoolCount; i++)
+	{
+		GraphicsRender render = rowRenders[i];
+		Text text = getTextRenderText(render);
+		transform = getGraphicsRenderTransform(render);
+		destroyGraphicsRender(render);
+		destroyText(text);
+		destroyTransform(transform);
+	}
+
+	free(handle->rowTexts);
+	free(handle->rowIndices);
+	free(rowRenders);
+
+	GraphicsRender render = handle->panelRender;
+
+	if (render)
+	{
+		transform = getGraphicsRenderTransform(render);
+		destroyGraphicsRender(render);
+		destroyTransform(transform);
+	}
+
+	freeSlabObject(handle->ui->handleSlabs[
+		LIST_UI_TYPE], handle);
+}
+inline static MpgxResult reserveUiListRows(
+	InterfaceElement element,
+	UiListHandle handle,
+	size_t count)
+{
+	assert(element);
+	assert(handle);
+
+	size_t rowPoolCount = handle->rowPoolCount;
+
+	if (count <= rowPoolCount)
+		return SUCCESS_MPGX_RESULT;
+
+	GraphicsRender* rowRenders = realloc(
+		handle->rowRenders,
+		count * sizeof(GraphicsRender));
+
+	if (!rowRenders)
+		return OUT_OF_HOST_MEMORY_MPGX_RESULT;
+
+	handle->rowRenders = rowRenders;
+
+	size_t* rowIndices = realloc(
+		handle->rowIndices,
+		count * sizeof(size_t));
+
+	if (!rowIndices)
+		return OUT_OF_HOST_MEMORY_MPGX_RESULT;
+
+	handle->rowIndices = rowIndices;
+
+	Text* rowTexts = realloc(
+		handle->rowTexts,
+		count * sizeof(Text));
+
+	if (!rowTexts)
+		return OUT_OF_HOST_MEMORY_MPGX_RESULT;
+
+	handle->rowTexts = rowTexts;
+
+	UserInterface ui = handle->ui;
+	Transform panelTransform = getGraphicsRenderTransform(
+		handle->panelRender);
+
+	FontAtlas fontAtlas;
+
+	MpgxResult mpgxResult = getBestFontAtlas(
+		ui,
+		DEFAULT_UI_TEXT_HEIGHT,
+		&fontAtlas);
+
+	if (mpgxResult != SUCCESS_MPGX_RESULT)
+		return mpgxResult;
+
+	for (size_t i = rowPoolCount; i < count; i++)
+	{
+		Transform transform = createTransform(
+			ui->transformer,
+			zeroVec3F,
+			vec3F(
+				(cmmt_float_t)DEFAULT_UI_TEXT_HEIGHT,
+				(cmmt_float_t)DEFAULT_UI_TEXT_HEIGHT,
+				(cmmt_float_t)1.0),
+			oneQuat,
+			zeroVec3F,
+			NO_ROTATION_TYPE,
+			panelTransform,
+			element,
+			false);
+
+		if (!transform)
+			return OUT_OF_HOST_MEMORY_MPGX_RESULT;
+
+		Text text;
+
+		mpgxResult = createAtlasText(
+			fontAtlas,
+			NULL,
+			0,
+			LEFT_ALIGNMENT_TYPE,
+			DEFAULT_UI_TEXT_COLOR,
+			false,
+			false,
+			false,
+			false,
+			&text);
+
+		if (mpgxResult != SUCCESS_MPGX_RESULT)
+		{
+			destroyTransform(transform);
+			return mpgxResult;
+		}
+
+		GraphicsRender render = createTextRender(
+			ui->textRenderer,
+			transform,
+			createTextBox3F(
+				LEFT_ALIGNMENT_TYPE,
+				getTextSize(text)),
+			whiteLinearColor,
+			text,
+			zeroVec4I);
+
+		if (!render)
+		{
+			destroyText(text);
+			destroyTransform(transform);
+			return OUT_OF_HOST_MEMORY_MPGX_RESULT;
+		}
+
+		rowRenders[i] = render;
+		rowIndices[i] = SIZE_MAX;
+		handle->rowPoolCount = i + 1;
+	}
+
+	return SUCCESS_MPGX_RESULT;
+}
+/*
+ * Data row is always bound to the pool row with the
+ * index modulo pool size, so while the list is scrolled
+ * only rows that entered the range are bound again.
+ */
+inline static MpgxResult updateUiListRows(
+	InterfaceElement element,
+	UiListHandle handle,
+	bool rebindRows)
+{
+	assert(element);
+	assert(handle);
+
+	Vec3F scale = getTransformScale(
+		getGraphicsRenderTransform(handle->panelRender));
+	cmmt_float_t rowHeight = handle->rowHeight;
+	size_t rowCount = handle->rowCount;
+
+	size_t visibleCount = (size_t)(scale.y / rowHeight) + 2;
+
+	MpgxResult mpgxResult = reserveUiListRows(
+		element,
+		handle,
+		visibleCount + UI_LIST_OVERSCAN_COUNT * 2);
+
+	if (mpgxResult != SUCCESS_MPGX_RESULT)
+		return mpgxResult;
+
+	cmmt_float_t scroll = handle->scroll;
+	cmmt_float_t maxScroll =
+		(cmmt_float_t)rowCount * rowHeight - scale.y;
+
+	if (scroll > maxScroll)
+		scroll = maxScroll;
+	if (scroll < (cmmt_float_t)0.0)
+		scroll = (cmmt_float_t)0.0;
+
+	handle->scroll = scroll;
+
+	size_t rowPoolCount = handle->rowPoolCount;
+	size_t firstRow = (size_t)(scroll / rowHeight);
+
+	firstRow = firstRow > UI_LIST_OVERSCAN_COUNT ?
+		firstRow - UI_LIST_OVERSCAN_COUNT : 0;
+
+	size_t lastRow = firstRow + rowPoolCount;
+
+	if (lastRow > rowCount)
+		lastRow = rowCount;
+
+	GraphicsRender* rowRenders = handle->rowRenders;
+	size_t* rowIndices = handle->rowIndices;
+	Text* rowTexts = handle->rowTexts;
+	OnUiListRow onRow = handle->onRow;
+	size_t firstSlot = firstRow % rowPoolCount;
+	size_t textCount = 0;
+
+	cmmt_float_t halfWidth = scale.x * (cmmt_float_t)0.5;
+	cmmt_float_t halfHeight = scale.y * (cmmt_float_t)0.5;
+	cmmt_float_t halfRowHeight = rowHeight * (cmmt_float_t)0.5;
+
+	for (size_t i = 0; i < rowPoolCount; i++)
+	{
+		size_t index = firstRow +
+			(i + rowPoolCount - firstSlot) % rowPoolCount;
+		GraphicsRender render = rowRenders[i];
+		Transform transform = getGraphicsRenderTransform(render);
+
+		if (index >= lastRow)
+		{
+			setTransformActive(transform, false);
+			continue;
+		}
+
+		if (rowIndices[i] != index || rebindRows)
+		{
+			Text text = getTextRenderText(render);
+
+			if (!onRow(element, index, text))
+			{
+				rowIndices[i] = SIZE_MAX;
+				setTransformActive(transform, false);
+				mpgxResult = OUT_OF_HOST_MEMORY_MPGX_RESULT;
+				continue;
+			}
+
+			rowIndices[i] = index;
+			rowTexts[textCount++] = text;
+		}
+
+		cmmt_float_t y = halfHeight + scroll -
+			((cmmt_float_t)index * rowHeight + halfRowHeight);
+
+		setTransformPosition(transform, vec3F(
+			-halfWidth + (cmmt_float_t)DEFAULT_UI_TEXT_HEIGHT *
+				(cmmt_float_t)0.5,
+			y,
+			(cmmt_float_t)-0.001));
+
+		// Overscan rows stay bound, but are not drawn.
+		setTransformActive(transform,
+			y - halfRowHeight < halfHeight &&
+			y + halfRowHeight > -halfHeight);
+	}
+
+	if (textCount > 0)
+	{
+		UserInterface ui = handle->ui;
+
+		MpgxResult bakeResult = bakeTexts(
+			getGraphicsRendererPipeline(ui->textRenderer),
+			rowTexts,
+			textCount,
+			getInterfaceThreadPool(ui->interface));
+
+		if (bakeResult != SUCCESS_MPGX_RESULT)
+		{
+			for (size_t i = 0; i < rowPoolCount; i++)
+				rowIndices[i] = SIZE_MAX;
+			return bakeResult;
+		}
+
+		for (size_t i = 0; i < rowPoolCount; i++)
+		{
+			GraphicsRender render = rowRenders[i];
+
+			setGraphicsRenderBounds(render, createTextBox3F(
+				LEFT_ALIGNMENT_TYPE,
+				getTextSize(getTextRenderText(render))));
+		}
+	}
+
+	if (mpgxResult != SUCCESS_MPGX_RESULT)
+		return mpgxResult;
+
+	handle->viewSize = vec2F(scale.x, scale.y);
+	handle->isChanged = false;
+	return SUCCESS_MPGX_RESULT;
+}
+static void onUiListPress(InterfaceElement element)
+{
+	assert(element);
+	UiListHandle handle = (UiListHandle)
+		getInterfaceElementHandle(element);
+	assert(handle->type == LIST_UI_TYPE);
+
+	if (!handle->isDragging)
+	{
+		handle->lastCursorPosition =
+			getWindowCursorPosition(handle->ui->window);
+		handle->isDragging = true;
+	}
+
+	if (handle->onPress)
+		handle->onPress(element);
+}
+static void onUiListUpdate(InterfaceElement element)
+{
+	assert(element);
+	UiListHandle handle = (UiListHandle)
+		getInterfaceElementHandle(element);
+	assert(handle->type == LIST_UI_TYPE);
+
+	if (handle->isDragging)
+	{
+		Window window = handle->ui->window;
+
+		if (getWindowMouseButton(window, LEFT_MOUSE_BUTTON))
+		{
+			Vec2F cursorPosition = getWindowCursorPosition(window);
+			cmmt_float_t offset = cursorPosition.y -
+				handle->lastCursorPosition.y;
+
+			if (offset != (cmmt_float_t)0.0)
+			{
+				handle->scroll -= offset /
+					getInterfaceScale(handle->ui->interface);
+				handle->isChanged = true;
+			}
+
+			handle->lastCursorPosition = cursorPosition;
+		}
+		else
+		{
+			handle->isDragging = false;
+		}
+	}
+
+	Vec3F scale = getTransformScale(
+		getGraphicsRenderTransform(handle->panelRender));
+
+	// Failed rows are bound again on the next update.
+	if (handle->isChanged ||
+		scale.x != handle->viewSize.x ||
+		scale.y != handle->viewSize.y)
+	{
+		updateUiListRows(element, handle, false);
+	}
+
+	if (handle->onUpdate)
+		handle->onUpdate(element);
+}
+MpgxResult createUiList(
+	UserInterface ui,
+	AlignmentType alignment,
+	Vec3F position,
+	Vec2F scale,
+	cmmt_float_t rowHeight,
+	size_t rowCount,
+	OnUiListRow onRow,
+	Transform parent,
+	const InterfaceElementEvents* events,
+	void* _handle,
+	bool isActive,
+	InterfaceElement* uiList)
+{
+	assert(ui);
+	assert(alignment < ALIGNMENT_TYPE_COUNT);
+	assert(scale.x > 0.0);
+	assert(scale.y > 0.0);
+	assert(rowHeight > 0.0);
+	assert(onRow);
+	assert(uiList);
+
+	assert(!parent || (parent && ui->transformer ==
+		getTransformTransformer(parent)));
+
+	UiListHandle handle = allocateSlabObject(
+		ui->handleSlabs[LIST_UI_TYPE]);
+
+	if (!handle)
+		return OUT_OF_HOST_MEMORY_MPGX_RESULT;
+
+	handle->type = LIST_UI_TYPE;
+	handle->scissorVersion = 0;
+	handle->ui = ui;
+	handle->handle = _handle;
+	handle->onRow = onRow;
+	handle->rowRenders = NULL;
+	handle->rowIndices = NULL;
+	handle->rowTexts = NULL;
+	handle->rowPoolCount = 0;
+	handle->rowCount = rowCount;
+	handle->rowHeight = rowHeight;
+	handle->scroll = (cmmt_float_t)0.0;
+	handle->viewSize = zeroVec2F;
+	handle->lastCursorPosition = zeroVec2F;
+	handle->isDragging = false;
+	handle->isChanged = true;
+
+	Transform transform = createTransform(
+		ui->transformer,
+		zeroVec3F,
+		vec3F(scale.x, scale.y, (cmmt_float_t)1.0),
+		oneQuat,
+		zeroVec3F,
+		NO_ROTATION_TYPE,
+		parent,
+		NULL,
+		isActive);
+
+	if (!transform)
+	{
+		onUiListDestroy(handle);
+		return OUT_OF_HOST_MEMORY_MPGX_RESULT;
+	}
+
+	GraphicsRender render = createPanelRender(
+		ui->panelRenderer,
+		transform,
+		oneSizeBox3F,
+		srgbToLinearColor(DEFAULT_UI_LIST_PANEL_COLOR),
+		zeroVec4I);
+
+	if (!render)
+	{
+		destroyTransform(transform);
+		onUiListDestroy(handle);
+		return OUT_OF_HOST_MEMORY_MPGX_RESULT;
+	}
+
+	handle->panelRender = render;
+
+	InterfaceElementEvents elementEvents = events ?
+		*events : emptyInterfaceElementEvents;
+	handle->onUpdate = elementEvents.onUpdate;
+	handle->onPress = elementEvents.onPress;
+	elementEvents.onUpdate = onUiListUpdate;
+	elementEvents.onPress = onUiListPress;
+
+	InterfaceElement element = createInterfaceElement(
+		ui->interface,
+		transform,
+		alignment,
+		position,
+		oneSizeBox2F,
+		true,
+		onUiListDestroy,
+		&elementEvents,
+		handle);
+
+	if (!element)
+	{
+		onUiListDestroy(handle);
+		return OUT_OF_HOST_MEMORY_MPGX_RESULT;
+	}
+
+	setTransformHandle(transform, element);
+
+	MpgxResult mpgxResult = updateUiListRows(
+		element,
+		handle,
+		false);
+
+	if (mpgxResult != SUCCESS_MPGX_RESULT)
+	{
+		destroyInterfaceElement(element);
+		return mpgxResult;
+	}
+
+	*uiList = element;
+	return SUCCESS_MPGX_RESULT;
+}
+
+void* getUiListHandle(InterfaceElement list)
+{
+	assert(list);
+	UiListHandle handle =
+		getInterfaceElementHandle(list);
+	assert(handle->type == LIST_UI_TYPE);
+	return handle->handle;
+}
+GraphicsRender getUiListPanelRender(InterfaceElement list)
+{
+	assert(list);
+	UiListHandle handle =
+		getInterfaceElementHandle(list);
+	assert(handle->type == LIST_UI_TYPE);
+	return handle->panelRender;
+}
+OnUiListRow getUiListOnRow(InterfaceElement list)
+{
+	assert(list);
+	UiListHandle handle =
+		getInterfaceElementHandle(list);
+	assert(handle->type == LIST_UI_TYPE);
+	return handle->onRow;
+}
+OnInterfaceElementEvent getUiListOnUpdateEvent(InterfaceElement list)
+{
+	assert(list);
+	UiListHandle handle =
+		getInterfaceElementHandle(list);
+	assert(handle->type == LIST_UI_TYPE);
+	return handle->onUpdate;
+}
+OnInterfaceElementEvent getUiListOnPressEvent(InterfaceElement list)
+{
+	assert(list);
+	UiListHandle handle =
+		getInterfaceElementHandle(list);
+	assert(handle->type == LIST_UI_TYPE);
+	return handle->onPress;
+}
+cmmt_float_t getUiListRowHeight(InterfaceElement list)
+{
+	assert(list);
+	UiListHandle handle =
+		getInterfaceElementHandle(list);
+	assert(handle->type == LIST_UI_TYPE);
+	return handle->rowHeight;
+}
+size_t getUiListRowPoolCount(InterfaceElement list)
+{
+	assert(list);
+	UiListHandle handle =
+		getInterfaceElementHandle(list);
+	assert(handle->type == LIST_UI_TYPE);
+	return handle->rowPoolCount;
+}
+
+size_t getUiListRowCount(
+	InterfaceElement list)
+{
+	assert(list);
+	UiListHandle handle =
+		getInterfaceElementHandle(list);
+	assert(handle->type == LIST_UI_TYPE);
+	return handle->rowCount;
+}
+MpgxResult setUiListRowCount(
+	InterfaceElement list,
+	size_t rowCount)
+{
+	assert(list);
+	UiListHandle handle =
+		getInterfaceElementHandle(list);
+	assert(handle->type == LIST_UI_TYPE);
+
+	if (rowCount == handle->rowCount)
+		return SUCCESS_MPGX_RESULT;
+
+	handle->rowCount = rowCount;
+	handle->isChanged = true;
+	return updateUiListRows(list, handle, false);
+}
+
+cmmt_float_t getUiListScroll(
+	InterfaceElement list)
+{
+	assert(list);
+	UiListHandle handle =
+		getInterfaceElementHandle(list);
+	assert(handle->type == LIST_UI_TYPE);
+	return handle->scroll;
+}
+MpgxResult setUiListScroll(
+	InterfaceElement list,
+	cmmt_float_t scroll)
+{
+	assert(list);
+	UiListHandle handle =
+		getInterfaceElementHandle(list);
+	assert(handle->type == LIST_UI_TYPE);
+
+	if (scroll == handle->scroll)
+		return SUCCESS_MPGX_RESULT;
+
+	handle->scroll = scroll;
+	handle->isChanged = true;
+	return updateUiListRows(list, handle, false);
+}
+
+MpgxResult refreshUiList(InterfaceElement list)
+{
+	assert(list);
+	UiListHandle handle =
+		getInterfaceElementHandle(list);
+	assert(handle->type == LIST_UI_TYPE);
+	handle->isChanged = true;
+	return updateUiListRows(list, handle, true);
+}
+bool getUiListCursorRow(
+	InterfaceElement list,
+	size_t* index)
+{
+	assert(list);
+	assert(index);
+
+	UiListHandle handle =
+		getInterfaceElementHandle(list);
+	assert(handle->type == LIST_UI_TYPE);
+
+	Transform transform = getGraphicsRenderTransform(
+		handle->panelRender);
+	Vec3F position = getTranslationMat4F(
+		getTransformModel(transform));
+	Vec3F scale = getTransformScale(transform);
+	Vec2F cursorPosition = getInterfaceCursorPosition(
+		handle->ui->interface);
+
+	cmmt_float_t x = cursorPosition.x - position.x;
+	cmmt_float_t y = position.y +
+		scale.y * (cmmt_float_t)0.5 - cursorPosition.y;
+
+	if (x < scale.x * (cmmt_float_t)-0.5 ||
+		x > scale.x * (cmmt_float_t)0.5 ||
+		y < (cmmt_float_t)0.0 || y > scale.y)
+	{
+		return false;
+	}
+
+	size_t row = (size_t)((y + handle->scroll) /
+		handle->rowHeight);
+
+	if (row >= handle->rowCount)
+		return false;
+
+	*index = row;
+	return true;
+}